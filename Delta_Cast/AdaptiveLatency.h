@@ -0,0 +1,210 @@
+﻿#pragma once
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "CommandQueue.h"
+
+// ---------------------------------------------------------------------------
+// 자동 레이턴시 (적응형 지터 버퍼)
+// 생산측(버퍼 스위치) 블록 도착 간격과 소비측(장치 주기) 간격의 초과분 분포를 모아
+// 목표 언더런 확률을 만족하는 가장 작은 재생 임계값(ms)을 고름
+// 필요량 = 생산 블록 + 소비 주기 + 각 초과분의 (1 - p) 분위수
+// 증가는 즉시, 감소는 일정 시간 계속 낮을 때만 (히스테리시스)
+// ---------------------------------------------------------------------------
+struct AutoLatencySettings {
+    bool enabled = false;
+    double minMs = 3.0;
+    double maxMs = 50.0;
+    double underrunProbability = 0.001; // 블록당 허용 언더런 확률
+};
+
+class AdaptiveLatency {
+public:
+    static const int BINS = 256;
+    static constexpr double BIN_MS = 0.25;          // 초과분 해상도 (최대 64ms)
+    static constexpr double UPDATE_SEC = 0.2;       // 목표 재계산 간격
+    static constexpr double DECAY_SEC = 10.0;       // 히스토그램 절반 감쇠 간격
+    static constexpr double DECREASE_HOLD_SEC = 5.0;
+    static constexpr double DECREASE_RATIO = 0.9;   // 10% 이상 낮아야 감소
+    static constexpr double UNDERRUN_BOOST = 1.25;  // 실제 언더런 시 즉시 상향
+
+    using Clock = std::chrono::steady_clock;
+
+    // 제어 스레드 (Start 전 또는 실행 중)
+    void Configure(const AutoLatencySettings& settings) {
+        m_minMs.store(settings.minMs, std::memory_order_relaxed);
+        m_maxMs.store(std::max(settings.maxMs, settings.minMs), std::memory_order_relaxed);
+        m_probability.store(std::clamp(settings.underrunProbability, 1e-6, 0.5), std::memory_order_relaxed);
+        m_enabled.store(settings.enabled, std::memory_order_release);
+    }
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_acquire); }
+
+    // 현재 선택된 목표 (ms, 비활성 또는 측정 전이면 0)
+    double GetTargetMs() const { return m_targetMs.load(std::memory_order_acquire); }
+
+    static int64_t NowNs() {
+        return (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    // --- 생산측 (버퍼 스위치 스레드) ---
+    void RecordProducerBlock(uint32_t frames) { RecordProducerBlock(frames, NowNs()); }
+    // 시각 지정 (테스트에서 가상 시각으로 구동)
+    void RecordProducerBlock(uint32_t frames, int64_t timeNs) {
+        if (!IsEnabled()) return;
+        BlockStamp stamp;
+        stamp.timeNs = timeNs;
+        stamp.frames = frames;
+        m_producerStamps.Push(stamp); // 가득 차면 버림 (통계 손실만)
+    }
+
+    // --- 소비측 (렌더 스레드) ---
+    // 스트림 시작 시. initialMs 는 측정 전 사용할 목표
+    void Reset(double producerRate, double initialMs) {
+        m_producerRate = producerRate;
+        std::fill(std::begin(m_producerHist), std::end(m_producerHist), 0.0);
+        std::fill(std::begin(m_consumerHist), std::end(m_consumerHist), 0.0);
+        m_producerCount = m_consumerCount = 0.0;
+        m_lastProducerNs = m_lastConsumerNs = 0;
+        m_producerBlockMs = m_consumerPeriodMs = 0.0;
+        m_elapsedSec = m_sinceDecaySec = m_lowSinceSec = 0.0;
+        m_currentMs = std::clamp(initialMs, m_minMs.load(), m_maxMs.load());
+        BlockStamp stale;
+        while (m_producerStamps.Pop(stale)) {}
+        m_targetMs.store(IsEnabled() ? m_currentMs : 0.0, std::memory_order_release);
+    }
+
+    // 스트림 중 입력 레이트 변경 (측정값은 ms 기준이라 유지)
+    void SetProducerRate(double producerRate) { m_producerRate = producerRate; }
+
+    // 생산측 정체 감지 시. 재개 후 첫 블록 간격(정체 구간 전체)이 분포에 들어가지 않게 기준을 지움
+    void ResetProducerClock() { m_lastProducerNs = 0; }
+
+    // 장치 주기마다. 목표가 바뀌면 true (newTargetMs 갱신)
+    bool OnConsumerPeriod(uint32_t framesNeeded, double outRate, double& newTargetMs) {
+        return OnConsumerPeriod(framesNeeded, outRate, NowNs(), newTargetMs);
+    }
+    bool OnConsumerPeriod(uint32_t framesNeeded, double outRate, int64_t nowNs, double& newTargetMs) {
+        if (!IsEnabled()) return false;
+
+        // 생산측 도착 간격
+        BlockStamp stamp;
+        while (m_producerStamps.Pop(stamp)) {
+            double nominalMs = stamp.frames * 1000.0 / m_producerRate;
+            m_producerBlockMs = nominalMs;
+            if (m_lastProducerNs != 0) {
+                AddSample(m_producerHist, m_producerCount, (stamp.timeNs - m_lastProducerNs) * 1e-6 - nominalMs);
+            }
+            m_lastProducerNs = stamp.timeNs;
+        }
+
+        // 소비측 주기 간격 (요청 프레임 기준 명목 주기 대비 초과분)
+        double periodMs = framesNeeded * 1000.0 / outRate;
+        double intervalSec = 0.0;
+        if (m_lastConsumerNs != 0) {
+            double intervalMs = (nowNs - m_lastConsumerNs) * 1e-6;
+            intervalSec = intervalMs * 0.001;
+            m_consumerPeriodMs += (intervalMs - m_consumerPeriodMs) * 0.05;
+            AddSample(m_consumerHist, m_consumerCount, intervalMs - periodMs);
+        }
+        m_lastConsumerNs = nowNs;
+
+        m_elapsedSec += intervalSec;
+        m_sinceDecaySec += intervalSec;
+        if (m_sinceDecaySec >= DECAY_SEC) {
+            m_sinceDecaySec = 0.0;
+            Decay(m_producerHist, m_producerCount);
+            Decay(m_consumerHist, m_consumerCount);
+        }
+        if (m_elapsedSec < UPDATE_SEC) return false;
+        double elapsed = m_elapsedSec;
+        m_elapsedSec = 0.0;
+
+        if (m_producerCount < 32.0 || m_consumerCount < 32.0) return false;
+        double p = m_probability.load(std::memory_order_relaxed);
+        double requiredMs = m_producerBlockMs + m_consumerPeriodMs
+            + Quantile(m_producerHist, m_producerCount, p) + Quantile(m_consumerHist, m_consumerCount, p);
+        return Decide(requiredMs, elapsed, newTargetMs);
+    }
+
+    // 실제 언더런 발생 (렌더 스레드)
+    bool OnUnderrun(double& newTargetMs) {
+        if (!IsEnabled()) return false;
+        m_lowSinceSec = 0.0;
+        return SetTarget(m_currentMs * UNDERRUN_BOOST, newTargetMs);
+    }
+
+private:
+    struct BlockStamp {
+        int64_t timeNs = 0;
+        uint32_t frames = 0;
+    };
+
+    static void AddSample(double* hist, double& count, double excessMs) {
+        int bin = (int)(std::max(excessMs, 0.0) / BIN_MS);
+        hist[std::min(bin, BINS - 1)] += 1.0;
+        count += 1.0;
+    }
+
+    static void Decay(double* hist, double& count) {
+        for (int i = 0; i < BINS; i++) hist[i] *= 0.5;
+        count *= 0.5;
+    }
+
+    // 초과 확률이 p 이하가 되는 최소 초과분 (ms)
+    static double Quantile(const double* hist, double count, double p) {
+        double allowed = count * p;
+        double above = count;
+        for (int i = 0; i < BINS; i++) {
+            above -= hist[i];
+            if (above <= allowed) return (i + 1) * BIN_MS;
+        }
+        return BINS * BIN_MS;
+    }
+
+    bool Decide(double requiredMs, double elapsedSec, double& newTargetMs) {
+        if (requiredMs > m_currentMs) {
+            m_lowSinceSec = 0.0;
+            return SetTarget(requiredMs, newTargetMs);
+        }
+        if (requiredMs < m_currentMs * DECREASE_RATIO) {
+            m_lowSinceSec += elapsedSec;
+            if (m_lowSinceSec >= DECREASE_HOLD_SEC) {
+                m_lowSinceSec = 0.0;
+                return SetTarget(requiredMs, newTargetMs);
+            }
+        }
+        else {
+            m_lowSinceSec = 0.0;
+        }
+        return false;
+    }
+
+    bool SetTarget(double ms, double& newTargetMs) {
+        ms = std::clamp(ms, m_minMs.load(std::memory_order_relaxed), m_maxMs.load(std::memory_order_relaxed));
+        if (std::abs(ms - m_currentMs) < BIN_MS) return false;
+        m_currentMs = ms;
+        m_targetMs.store(ms, std::memory_order_release);
+        newTargetMs = ms;
+        return true;
+    }
+
+    std::atomic<bool> m_enabled{ false };
+    std::atomic<double> m_minMs{ 3.0 };
+    std::atomic<double> m_maxMs{ 50.0 };
+    std::atomic<double> m_probability{ 0.001 };
+    std::atomic<double> m_targetMs{ 0.0 };
+
+    SpscQueue<BlockStamp, 256> m_producerStamps;
+
+    // 렌더 스레드 전용
+    double m_producerRate = 48000.0;
+    double m_producerHist[BINS] = {};
+    double m_consumerHist[BINS] = {};
+    double m_producerCount = 0.0, m_consumerCount = 0.0;
+    int64_t m_lastProducerNs = 0, m_lastConsumerNs = 0;
+    double m_producerBlockMs = 0.0, m_consumerPeriodMs = 0.0;
+    double m_elapsedSec = 0.0, m_sinceDecaySec = 0.0, m_lowSinceSec = 0.0;
+    double m_currentMs = 10.0;
+};
@@ -0,0 +1,94 @@
+﻿#pragma once
+#ifndef MY_ASIO
+#define MY_ASIO
+#include <iasiodrv.h>
+#endif
+#include <atomic>
+#include <thread>
+#include <utility>
+
+// ---------------------------------------------------------------------------
+// 인스턴스별 ASIO 콜백 디스패치
+// ASIOCallbacks 는 컨텍스트 포인터가 없는 C 함수 포인터이므로
+// 슬롯 번호를 템플릿 인자로 박은 정적 썽크 테이블을 두고 인스턴스마다 슬롯 하나를 할당
+// ---------------------------------------------------------------------------
+class IAsioCallbackTarget {
+public:
+    virtual ~IAsioCallbackTarget() = default;
+    virtual void OnBufferSwitch(long index, ASIOBool directProcess) = 0;
+    virtual ASIOTime* OnBufferSwitchTimeInfo(ASIOTime* timeInfo, long index, ASIOBool processNow) = 0;
+    virtual void OnSampleRateChanged(ASIOSampleRate rate) = 0;
+    virtual long OnAsioMessage(long selector, long value, void* message, double* opt) = 0;
+};
+
+namespace AsioCallbackSlots {
+    // 한 프로세스에서 동시에 버퍼를 가진 드라이버 인스턴스 수
+    const int MAX_SLOTS = 8;
+
+    inline std::atomic<IAsioCallbackTarget*> g_targets[MAX_SLOTS] = {};
+    // 슬롯별 실행 중인 콜백 수 (Release 가 끝날 때까지 기다림)
+    inline std::atomic<int> g_inFlight[MAX_SLOTS] = {};
+    // 현재 스레드가 실행 중인 슬롯별 콜백 깊이 (콜백 안에서 Release 해도 자기 자신은 기다리지 않음)
+    inline thread_local int t_depth[MAX_SLOTS] = {};
+
+    // 콜백 하나의 실행 구간. seq_cst: Release 의 nullptr 저장과 둘 다 놓치는 경우 없음
+    template <int N>
+    struct InFlight {
+        IAsioCallbackTarget* target;
+        InFlight() {
+            g_inFlight[N].fetch_add(1, std::memory_order_seq_cst);
+            t_depth[N]++;
+            target = g_targets[N].load(std::memory_order_seq_cst);
+        }
+        ~InFlight() {
+            t_depth[N]--;
+            g_inFlight[N].fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    template <int N>
+    struct Thunk {
+        static void BufferSwitch(long index, ASIOBool directProcess) {
+            InFlight<N> call;
+            if (call.target) call.target->OnBufferSwitch(index, directProcess);
+        }
+        static ASIOTime* BufferSwitchTimeInfo(ASIOTime* timeInfo, long index, ASIOBool processNow) {
+            InFlight<N> call;
+            return call.target ? call.target->OnBufferSwitchTimeInfo(timeInfo, index, processNow) : nullptr;
+        }
+        static void SampleRateChanged(ASIOSampleRate rate) {
+            InFlight<N> call;
+            if (call.target) call.target->OnSampleRateChanged(rate);
+        }
+        static long AsioMessage(long selector, long value, void* message, double* opt) {
+            InFlight<N> call;
+            return call.target ? call.target->OnAsioMessage(selector, value, message, opt) : 0;
+        }
+    };
+
+    template <size_t... I>
+    constexpr ASIOCallbacks MakeTable(size_t slot, std::index_sequence<I...>) {
+        ASIOCallbacks table[] = { { &Thunk<(int)I>::BufferSwitch, &Thunk<(int)I>::SampleRateChanged,
+            &Thunk<(int)I>::AsioMessage, &Thunk<(int)I>::BufferSwitchTimeInfo }... };
+        return table[slot];
+    }
+
+    // 빈 슬롯에 대상을 등록하고 해당 슬롯의 콜백 세트를 돌려줌. 실패 시 -1
+    inline int Acquire(IAsioCallbackTarget* target, ASIOCallbacks* callbacks) {
+        for (int i = 0; i < MAX_SLOTS; i++) {
+            IAsioCallbackTarget* expected = nullptr;
+            if (g_targets[i].compare_exchange_strong(expected, target, std::memory_order_acq_rel)) {
+                *callbacks = MakeTable(i, std::make_index_sequence<MAX_SLOTS>{});
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // 등록 해제 후 이미 대상을 읽은 콜백이 모두 끝날 때까지 대기 (이후 대상 파괴 가능)
+    inline void Release(int slot) {
+        if (slot < 0 || slot >= MAX_SLOTS) return;
+        g_targets[slot].store(nullptr, std::memory_order_seq_cst);
+        while (g_inFlight[slot].load(std::memory_order_acquire) > t_depth[slot]) std::this_thread::yield();
+    }
+}
@@ -0,0 +1,134 @@
+﻿#include "AudioArena.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool CAudioArena::EnableLockMemoryPrivilege() {
+    HANDLE hToken = nullptr;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &hToken)) return false;
+
+    TOKEN_PRIVILEGES tp = {};
+    tp.PrivilegeCount = 1;
+    tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    bool ok = LookupPrivilegeValueW(nullptr, L"SeLockMemoryPrivilege", &tp.Privileges[0].Luid) &&
+        AdjustTokenPrivileges(hToken, FALSE, &tp, 0, nullptr, nullptr) &&
+        GetLastError() == ERROR_SUCCESS; // 권한이 없으면 ERROR_NOT_ALL_ASSIGNED
+    CloseHandle(hToken);
+    return ok;
+}
+
+bool CAudioArena::Commit(const ArenaOptions& options) {
+    if (m_base) return true;
+    if (m_used == 0) return false;
+
+    // 큰 페이지 (항상 상주, 잠금/선행 폴트 불필요)
+    size_t largePage = GetLargePageMinimum();
+    if (options.largePages && largePage > 0 && EnableLockMemoryPrivilege()) {
+        size_t size = (m_used + largePage - 1) & ~(largePage - 1);
+        m_base = (uint8_t*)VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (m_base) {
+            m_committed = size;
+            m_largePages = true;
+            m_locked = true;
+            return true;
+        }
+    }
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t pageSize = info.dwPageSize ? info.dwPageSize : 4096;
+    size_t size = (m_used + pageSize - 1) & ~(pageSize - 1);
+    m_base = (uint8_t*)VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!m_base) return false;
+    m_committed = size;
+
+    // 선행 페이지 폴트 (실시간 스레드의 첫 접근에서 폴트가 나지 않도록)
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        ((volatile uint8_t*)m_base)[offset] = 0;
+    }
+
+    if (options.lock) {
+        // 잠금 가능한 양은 작업 집합 최소값에 묶여 있음
+        SIZE_T minWs = 0, maxWs = 0;
+        HANDLE hProcess = GetCurrentProcess();
+        if (GetProcessWorkingSetSize(hProcess, &minWs, &maxWs)) {
+            SetProcessWorkingSetSize(hProcess, minWs + size, maxWs + size);
+        }
+        m_locked = VirtualLock(m_base, size) != FALSE;
+    }
+    return true;
+}
+
+void CAudioArena::Release() {
+    if (m_base) {
+        if (m_locked && !m_largePages) {
+            VirtualUnlock(m_base, m_committed);
+            SIZE_T minWs = 0, maxWs = 0;
+            HANDLE hProcess = GetCurrentProcess();
+            if (GetProcessWorkingSetSize(hProcess, &minWs, &maxWs) && minWs > m_committed && maxWs > m_committed) {
+                SetProcessWorkingSetSize(hProcess, minWs - m_committed, maxWs - m_committed);
+            }
+        }
+        VirtualFree(m_base, 0, MEM_RELEASE);
+    }
+    m_base = nullptr;
+    m_used = 0;
+    m_committed = 0;
+    m_largePages = false;
+    m_locked = false;
+}
+
+#else
+
+bool CAudioArena::Commit(const ArenaOptions& options) {
+    if (m_base) return true;
+    if (m_used == 0) return false;
+
+    // 큰 페이지 (hugetlbfs 예약분이 있을 때만, 2MB 가정)
+    const size_t largePage = 2u << 20;
+    if (options.largePages) {
+        size_t size = (m_used + largePage - 1) & ~(largePage - 1);
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            m_base = (uint8_t*)p;
+            m_committed = size;
+            m_largePages = true;
+            m_locked = mlock(m_base, size) == 0;
+            return true;
+        }
+    }
+
+    long page = sysconf(_SC_PAGESIZE);
+    size_t pageSize = page > 0 ? (size_t)page : 4096;
+    size_t size = (m_used + pageSize - 1) & ~(pageSize - 1);
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return false;
+    m_base = (uint8_t*)p;
+    m_committed = size;
+
+    // 선행 페이지 폴트
+    for (size_t offset = 0; offset < size; offset += pageSize) {
+        ((volatile uint8_t*)m_base)[offset] = 0;
+    }
+    // 잠금 한도 (RLIMIT_MEMLOCK) 를 넘으면 실패, 잠그지 않은 채 사용
+    if (options.lock) m_locked = mlock(m_base, size) == 0;
+    return true;
+}
+
+void CAudioArena::Release() {
+    if (m_base) {
+        if (m_locked) munlock(m_base, m_committed);
+        munmap(m_base, m_committed);
+    }
+    m_base = nullptr;
+    m_used = 0;
+    m_committed = 0;
+    m_largePages = false;
+    m_locked = false;
+}
+
+#endif
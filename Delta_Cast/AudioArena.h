@@ -0,0 +1,53 @@
+﻿#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <cstdint>
+#include <cstddef>
+
+struct ArenaOptions {
+    bool largePages = false; // SeLockMemoryPrivilege 필요, 실패 시 일반 페이지 (Linux: MAP_HUGETLB)
+    bool lock = true;        // VirtualLock (작업 집합 최소값을 함께 늘림), Linux: mlock
+};
+
+// ---------------------------------------------------------------------------
+// 스트림 메모리 아레나 (제어 스레드에서 할당/해제)
+// 구획을 먼저 등록(Reserve)하고 Commit 에서 한 번에 할당 -> 64바이트 정렬, 선행 페이지 폴트, 잠금
+// 실시간 스레드는 Commit 이후 At() 포인터만 사용
+// ---------------------------------------------------------------------------
+class CAudioArena {
+public:
+    static const size_t ALIGNMENT = 64;
+
+    ~CAudioArena() { Release(); }
+
+    // 구획 등록, 아레나 내 오프셋 반환 (Commit 전)
+    size_t Reserve(size_t bytes) {
+        size_t offset = m_used;
+        m_used += (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        return offset;
+    }
+
+    bool Commit(const ArenaOptions& options);
+    // 해제 후 등록된 구획도 비움
+    void Release();
+
+    template <class T> T* At(size_t offset) const { return reinterpret_cast<T*>(m_base + offset); }
+
+    bool IsCommitted() const { return m_base != nullptr; }
+    size_t GetUsedBytes() const { return m_used; }
+    size_t GetCommittedBytes() const { return m_committed; }
+    bool IsLargePages() const { return m_largePages; }
+    bool IsLocked() const { return m_locked; }
+
+private:
+#ifdef _WIN32
+    static bool EnableLockMemoryPrivilege();
+#endif
+
+    uint8_t* m_base = nullptr;
+    size_t m_used = 0;
+    size_t m_committed = 0;
+    bool m_largePages = false;
+    bool m_locked = false;
+};
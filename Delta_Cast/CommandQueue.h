@@ -0,0 +1,120 @@
+﻿#pragma once
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+// ---------------------------------------------------------------------------
+// 제어 스레드 -> 실시간 스레드 명령 채널
+// SpscQueue : 대기 없는 고정 크기 단일 생산자/단일 소비자 큐
+// ControlQueue : 여러 제어 스레드가 쓸 수 있도록 생산측만 잠금 (소비측은 대기 없음)
+// RtHandoff : 큰 객체(필터, 라우팅 테이블 등) 교체. 실시간 스레드는 포인터 교환만 하고
+//             다 쓴 객체는 회수 큐로 돌려 제어 스레드에서 해제
+// ---------------------------------------------------------------------------
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert((N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+public:
+    bool Push(const T& item) {
+        size_t w = m_write.load(std::memory_order_relaxed);
+        if (w - m_read.load(std::memory_order_acquire) >= N) return false; // 가득 참
+        m_items[w & (N - 1)] = item;
+        m_write.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& item) {
+        size_t r = m_read.load(std::memory_order_relaxed);
+        if (r == m_write.load(std::memory_order_acquire)) return false;
+        item = m_items[r & (N - 1)];
+        m_read.store(r + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool CanPush() const {
+        return m_write.load(std::memory_order_relaxed) - m_read.load(std::memory_order_acquire) < N;
+    }
+
+private:
+    T m_items[N] = {};
+    alignas(64) std::atomic<size_t> m_write{ 0 };
+    alignas(64) std::atomic<size_t> m_read{ 0 };
+};
+
+// 실시간 명령 (작은 값만. 큰 객체는 RtHandoff)
+struct RtCommand {
+    uint32_t type = 0;
+    int32_t a = 0;
+    int32_t b = 0;
+    double value = 0.0;
+};
+
+class ControlQueue {
+public:
+    static const size_t CAPACITY = 64;
+
+    // 제어 스레드 (가득 차면 false, 호출측에서 다음 주기에 재시도)
+    bool Post(const RtCommand& command) {
+        std::lock_guard<std::mutex> lock(m_producerLock);
+        return m_queue.Push(command);
+    }
+
+    // 실시간 스레드
+    bool Pop(RtCommand& command) { return m_queue.Pop(command); }
+
+private:
+    std::mutex m_producerLock;
+    SpscQueue<RtCommand, CAPACITY> m_queue;
+};
+
+template <typename T>
+class RtHandoff {
+public:
+    static const size_t RETIRE_CAPACITY = 16;
+
+    ~RtHandoff() {
+        delete m_pending.exchange(nullptr);
+        CollectRetired();
+        delete m_current;
+    }
+
+    // --- 제어 스레드 ---
+    // 새 객체 게시. 실시간 스레드가 아직 가져가지 않은 이전 게시물은 바로 해제
+    void Publish(T* object) {
+        delete m_pending.exchange(object, std::memory_order_acq_rel);
+        CollectRetired();
+    }
+
+    void CollectRetired() {
+        T* retired = nullptr;
+        while (m_retired.Pop(retired)) delete retired;
+    }
+
+    // --- 실시간 스레드 ---
+    // 새 게시물이 있으면 교체 후 현재 객체 반환 (회수 큐가 가득 차면 다음 주기로 미룸)
+    T* Acquire() {
+        if (m_pending.load(std::memory_order_relaxed) && m_retired.CanPush()) {
+            T* next = m_pending.exchange(nullptr, std::memory_order_acq_rel);
+            if (next) {
+                if (m_current) m_retired.Push(m_current);
+                m_current = next;
+            }
+        }
+        return m_current;
+    }
+
+    // 현재 객체를 바로 교체 (장치 열기/초기화)
+    // 다른 스레드의 Publish / Acquire 와 동시에 부르지 않을 것:
+    // 렌더 엔진은 렌더 스레드의 OpenSink 에서 부르고, 게시측은 같은 m_limiterLock 안에서만 Publish
+    void Reset(T* object) {
+        delete m_pending.exchange(nullptr);
+        CollectRetired();
+        delete m_current;
+        m_current = object;
+    }
+
+private:
+    std::atomic<T*> m_pending{ nullptr };
+    T* m_current = nullptr; // 실시간 스레드 전용
+    SpscQueue<T*, RETIRE_CAPACITY> m_retired;
+};
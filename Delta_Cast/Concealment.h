@@ -0,0 +1,148 @@
+﻿#pragma once
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+// ---------------------------------------------------------------------------
+// 언더런 은닉 (렌더 스레드, 출력 레이트)
+// 모자란 구간: 마지막 출력을 거울 반사해 이어 붙이고 코사인으로 페이드 아웃 (값 연속)
+// 재개 시: 남은 은닉 꼬리와 새 오디오를 등전력 크로스페이드
+// 이어 붙이기 (레이트 전환): 지점 직전 출력으로 꼬리를 만들고 지점부터 같은 크로스페이드
+// ---------------------------------------------------------------------------
+class UnderrunConcealer {
+public:
+    static constexpr double FADE_MS = 5.0;
+
+    // 비실시간 (메모리 할당)
+    void Setup(double sampleRate) {
+        m_fade = std::max((size_t)16, (size_t)std::lround(FADE_MS * 0.001 * sampleRate));
+        m_fadeOut.resize(m_fade);
+        m_fadeInSin.resize(m_fade);
+        m_fadeInCos.resize(m_fade);
+        const double halfPi = 1.57079632679489661923;
+        for (size_t k = 0; k < m_fade; k++) {
+            double x = (k + 0.5) / m_fade;
+            double c = std::cos(halfPi * x);
+            m_fadeOut[k] = (float)(c * c);
+            m_fadeInSin[k] = (float)std::sin(halfPi * x);
+            m_fadeInCos[k] = (float)c;
+        }
+        for (int c = 0; c < 2; c++) {
+            m_history[c].assign(m_fade, 0.0f);
+            m_tail[c].assign(m_fade, 0.0f);
+        }
+        Reset();
+    }
+
+    void Reset() {
+        for (int c = 0; c < 2; c++) {
+            std::fill(m_history[c].begin(), m_history[c].end(), 0.0f);
+            std::fill(m_tail[c].begin(), m_tail[c].end(), 0.0f);
+        }
+        m_tailPos = m_fade;
+        m_fadeInPos = m_fade;
+        m_concealing = false;
+    }
+
+    bool IsConcealing() const { return m_concealing; }
+    bool IsFading() const { return m_fadeInPos < m_fade; }
+
+    // 소리가 끊긴 상태로 표시 (장치 재연결 후 첫 오디오를 페이드 인)
+    void MarkSilent() {
+        m_concealing = true;
+        m_tailPos = m_fade;
+    }
+
+    // [0, valid) 는 정상 오디오, [valid, total) 을 은닉 신호로 채움 (제자리)
+    // spliceAt < valid 이면 그 지점에서 앞뒤가 이어지지 않는 오디오로 보고 크로스페이드
+    void Process(float* left, float* right, size_t valid, size_t total, size_t spliceAt = SIZE_MAX) {
+        float* out[2] = { left, right };
+
+        // 재개: 블록 시작부터 크로스페이드
+        if (valid > 0 && m_concealing) {
+            m_concealing = false;
+            m_fadeInPos = 0;
+        }
+        if (spliceAt < valid) {
+            FadeIn(out, 0, spliceAt);
+            BeginTail(out, spliceAt);
+            m_fadeInPos = 0;
+            FadeIn(out, spliceAt, valid);
+        }
+        else {
+            FadeIn(out, 0, valid);
+        }
+
+        // 모자란 구간
+        if (valid < total) {
+            if (!m_concealing) {
+                BeginTail(out, valid);
+                m_concealing = true;
+            }
+            for (size_t i = valid; i < total; i++) {
+                for (int c = 0; c < 2; c++) {
+                    out[c][i] = (m_tailPos < m_fade) ? m_tail[c][m_tailPos] : 0.0f;
+                }
+                if (m_tailPos < m_fade) m_tailPos++;
+            }
+        }
+
+        UpdateHistory(out, total);
+    }
+
+private:
+    // [from, to) 에 진행 중인 크로스페이드 적용
+    void FadeIn(float* const* out, size_t from, size_t to) {
+        if (m_fadeInPos >= m_fade || from >= to) return;
+        size_t n = std::min(to - from, m_fade - m_fadeInPos);
+        for (size_t k = 0; k < n; k++) {
+            size_t f = m_fadeInPos + k;
+            size_t t = m_tailPos + k;
+            for (int c = 0; c < 2; c++) {
+                float tail = (t < m_fade) ? m_tail[c][t] : 0.0f;
+                out[c][from + k] = out[c][from + k] * m_fadeInSin[f] + tail * m_fadeInCos[f];
+            }
+        }
+        m_fadeInPos += n;
+        m_tailPos = std::min(m_tailPos + n, m_fade);
+    }
+
+    // 모자란 지점 직전 출력 (k = 0 이 가장 최근)
+    float SampleBefore(float* const* out, int c, size_t valid, size_t k) const {
+        if (k < valid) return out[c][valid - 1 - k];
+        return m_history[c][m_fade - 1 - (k - valid)];
+    }
+
+    void BeginTail(float* const* out, size_t valid) {
+        for (int c = 0; c < 2; c++) {
+            for (size_t k = 0; k < m_fade; k++) {
+                m_tail[c][k] = SampleBefore(out, c, valid, k) * m_fadeOut[k];
+            }
+        }
+        m_tailPos = 0;
+    }
+
+    // 최근 출력 m_fade 개 유지 (끝이 가장 최근)
+    void UpdateHistory(float* const* out, size_t total) {
+        for (int c = 0; c < 2; c++) {
+            float* hist = m_history[c].data();
+            if (total >= m_fade) {
+                memcpy(hist, out[c] + (total - m_fade), m_fade * sizeof(float));
+            }
+            else {
+                memmove(hist, hist + total, (m_fade - total) * sizeof(float));
+                memcpy(hist + (m_fade - total), out[c], total * sizeof(float));
+            }
+        }
+    }
+
+    size_t m_fade = 240;
+    std::vector<float> m_fadeOut, m_fadeInSin, m_fadeInCos;
+    std::vector<float> m_history[2];
+    std::vector<float> m_tail[2];
+    size_t m_tailPos = 0;
+    size_t m_fadeInPos = 0;
+    bool m_concealing = false;
+};
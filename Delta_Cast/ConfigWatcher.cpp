@@ -0,0 +1,56 @@
+﻿#include "ConfigWatcher.h"
+
+bool CConfigWatcher::Start(const std::wstring& filePath, std::function<void()> onChanged) {
+    if (m_running) return true;
+
+    size_t lastSlash = filePath.find_last_of(L"\\/");
+    if (lastSlash == std::wstring::npos) return false;
+    std::wstring directory = filePath.substr(0, lastSlash + 1);
+
+    m_hChange = FindFirstChangeNotificationW(directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (m_hChange == INVALID_HANDLE_VALUE) return false;
+
+    m_filePath = filePath;
+    m_onChanged = std::move(onChanged);
+    ReadWriteTime(m_lastWrite);
+
+    m_hStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    m_running = true;
+    m_thread = std::thread(&CConfigWatcher::WatchThreadFunc, this);
+    return true;
+}
+
+void CConfigWatcher::Stop() {
+    if (!m_running) return;
+    m_running = false;
+    if (m_hStopEvent) SetEvent(m_hStopEvent);
+    if (m_thread.joinable()) m_thread.join();
+
+    if (m_hChange != INVALID_HANDLE_VALUE) { FindCloseChangeNotification(m_hChange); m_hChange = INVALID_HANDLE_VALUE; }
+    if (m_hStopEvent) { CloseHandle(m_hStopEvent); m_hStopEvent = nullptr; }
+}
+
+bool CConfigWatcher::ReadWriteTime(FILETIME& time) const {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(m_filePath.c_str(), GetFileExInfoStandard, &data)) return false;
+    time = data.ftLastWriteTime;
+    return true;
+}
+
+void CConfigWatcher::WatchThreadFunc() {
+    HANDLE handles[2] = { m_hStopEvent, m_hChange };
+    while (m_running) {
+        DWORD result = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        if (result != WAIT_OBJECT_0 + 1) break;
+
+        // 편집기가 여러 번 나눠 쓰는 경우를 묶음
+        if (WaitForSingleObject(m_hStopEvent, DEBOUNCE_MS) == WAIT_OBJECT_0) break;
+        FindNextChangeNotification(m_hChange);
+
+        FILETIME writeTime;
+        if (ReadWriteTime(writeTime) && CompareFileTime(&writeTime, &m_lastWrite) != 0) {
+            m_lastWrite = writeTime;
+            if (m_onChanged) m_onChanged();
+        }
+    }
+}
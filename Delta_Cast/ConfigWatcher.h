@@ -0,0 +1,32 @@
+﻿#pragma once
+#include <windows.h>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <functional>
+
+// ---------------------------------------------------------------------------
+// INI 파일 변경 감시 (제어 스레드)
+// 디렉터리 변경 알림을 받아 파일 수정 시각이 바뀌었을 때만 콜백 (짧은 디바운스 포함)
+// ---------------------------------------------------------------------------
+class CConfigWatcher {
+public:
+    static constexpr DWORD DEBOUNCE_MS = 150;
+
+    ~CConfigWatcher() { Stop(); }
+
+    bool Start(const std::wstring& filePath, std::function<void()> onChanged);
+    void Stop();
+
+private:
+    void WatchThreadFunc();
+    bool ReadWriteTime(FILETIME& time) const;
+
+    std::wstring m_filePath;
+    std::function<void()> m_onChanged;
+    std::thread m_thread;
+    std::atomic<bool> m_running{ false };
+    HANDLE m_hStopEvent = nullptr;
+    HANDLE m_hChange = INVALID_HANDLE_VALUE;
+    FILETIME m_lastWrite = {};
+};
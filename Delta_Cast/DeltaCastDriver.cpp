@@ -1,36 +1,22 @@
 ﻿#include "DeltaCastDriver.h"
 #include "DeltaCastGuids.h"
 #include "timer.h"
+#include "SampleConvert.h"
+#include "WasapiSink.h"
+#include "FileSink.h"
+#include "RtCheck.h"
+#include "Logger.h"
 #include <windows.h>
 #include <stdio.h>
 #include <string>
 #include <vector>
-#include <avrt.h>
-#pragma comment(lib, "avrt.lib")
-
-const float INT32_TO_FLOAT = 4.65661287e-10f;  // 1 / 2^31
-const float INT24_TO_FLOAT = 1.19209290e-7f;   // 1 / 2^23
-const float INT16_TO_FLOAT = 3.05175781e-5f;   // 1 / 2^15
-
-// 디버그 로그 
-void DebugLog(const char* fmt, ...) {
-#ifdef _DEBUG
-    char buf[2048];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, args);
-    va_end(args);
-    OutputDebugStringA(buf);
-#endif
-}
+#include <algorithm>
+#include <shlobj.h>
+#pragma comment(lib, "shell32.lib")
 
 const IID kIID_IASIO = { 0x5B96C901, 0x7195, 0x11D2, { 0x9C, 0xB1, 0x00, 0x60, 0x08, 0x03, 0x92, 0x2C } };
 extern HMODULE g_hModule;
 
-// 전역 포인터 초기화
-CDeltaCastDriver* CDeltaCastDriver::g_pThis = nullptr;
-
-
 // ---------------------------------------------------------------------------
 // 가상 백엔드 (Virtual)
 // ---------------------------------------------------------------------------
@@ -43,11 +29,53 @@ VirtualBackend::~VirtualBackend() {
     Stop();
 }
 
+ASIOError VirtualBackend::Init(void* sysHandle) {
+    m_mixClient = m_owner && m_owner->m_virtualMix;
+    m_sinkClocked = m_owner && m_owner->m_sinkClocked;
+    if (m_owner) {
+        m_numOutputs = m_owner->m_virtualOutputs;
+        m_numInputs = m_owner->m_virtualInputs;
+    }
+    DebugLog("[VirtualBackend] Channels: %ld Out, %ld Loopback In\n", m_numOutputs, m_numInputs);
+    if (m_sinkClocked) {
+        // 호스트 버퍼 크기를 싱크 주기에 맞추기 위해 미리 조회
+        m_sinkPeriodSeconds = CWasapiSink::QueryDevicePeriod(m_owner->m_targetWasapiId);
+        DebugLog("[VirtualBackend] Sink Clocked. Device Period: %.3f ms\n", m_sinkPeriodSeconds * 1000.0);
+    }
+    return ASE_OK;
+}
+
+ASIOError VirtualBackend::GetBufferSize(long* min, long* max, long* pref, long* gran) {
+    *min = 128; *max = 2048; *pref = 256; *gran = -1;
+    if (m_sinkClocked && m_sinkPeriodSeconds > 0.0) {
+        // 싱크 주기와 동일한 블록 크기 권장 (임의 크기 허용)
+        long periodFrames = (long)std::lround(m_sinkPeriodSeconds * m_sampleRate);
+        *pref = std::clamp(periodFrames, *min, *max);
+        *gran = 1;
+    }
+    return ASE_OK;
+}
+
 ASIOError VirtualBackend::Start() {
     if (!m_running) {
         m_running = true;
-        m_thread = std::thread(&VirtualBackend::VirtualClockLoop, this);
-        DebugLog("[VirtualBackend] Thread Started\n");
+        m_doubleBufferIndex = 0;
+        if (m_mixClient) {
+            // 믹스 서버의 클럭이 필요할 때 블록을 당겨감
+            if (!CVirtualMixServer::Instance().Register(this)) {
+                m_running = false;
+                return ASE_HWMalfunction;
+            }
+        }
+        else if (m_sinkClocked) {
+            // 자체 타이머 없이 렌더러 이벤트에 종속
+            m_owner->m_renderer.SetPeriodListener(this);
+            DebugLog("[VirtualBackend] Sink Clock Attached\n");
+        }
+        else {
+            m_thread = std::thread(&VirtualBackend::VirtualClockLoop, this);
+            DebugLog("[VirtualBackend] Thread Started\n");
+        }
     }
     return ASE_OK;
 }
@@ -55,6 +83,12 @@ ASIOError VirtualBackend::Start() {
 ASIOError VirtualBackend::Stop() {
     if (m_running) {
         m_running = false;
+        if (m_mixClient) {
+            CVirtualMixServer::Instance().Unregister(this);
+        }
+        else if (m_sinkClocked) {
+            m_owner->m_renderer.SetPeriodListener(nullptr);
+        }
         if (m_thread.joinable()) {
             m_thread.join();
         }
@@ -63,46 +97,91 @@ ASIOError VirtualBackend::Stop() {
     return ASE_OK;
 }
 
-void VirtualBackend::VirtualClockLoop() {
-	// 타이머 해상도, 스레드 우선순위 설정
-    DWORD taskIndex = 0;
-    HANDLE hTask = AvSetMmThreadCharacteristics(L"Pro Audio", &taskIndex);
-    if (hTask == NULL) {
-        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
-        DebugLog("[VirtualBackend] MMCSS Failed, using Time Critical fallback\n");
+void VirtualBackend::RenderOneBlock() {
+    if (m_owner && m_owner->m_bufferInfos) {
+        long index = m_doubleBufferIndex;
+        // 루프백 복사 + 송출 채널 클리어 (Delta_Cast_Tests/ChannelBench 와 같은 코드)
+        ASIOBufferInfo* infos = m_owner->m_bufferInfos;
+        long indexL = m_owner->m_outIndexL, indexR = m_owner->m_outIndexR;
+        VirtualChannels::PrepareBlock(m_loopbacks, index, (size_t)m_bufferSize * sizeof(float),
+            (indexL >= 0) ? infos[indexL].buffers[index] : nullptr,
+            (indexR >= 0) ? infos[indexR].buffers[index] : nullptr);
+        m_owner->TriggerBufferSwitch(index);
+    }
+    // 샘플 위치 갱신
+    m_samplePos += m_bufferSize;
+    m_doubleBufferIndex = (m_doubleBufferIndex + 1) % 2;
+}
+
+void VirtualBackend::OnRenderPeriod(size_t bytesNeeded) {
+    if (!m_running || !m_owner || !m_owner->m_bufferInfos || m_bufferSize <= 0) return;
+
+    // 싱크가 요구하는 만큼만 호스트 블록 생성 (링 점유 최소화)
+    const int MAX_BLOCKS_PER_PERIOD = 16;
+    for (int i = 0; i < MAX_BLOCKS_PER_PERIOD; i++) {
+        if (m_owner->m_loopbackBufferL.GetFillSize() >= bytesNeeded) break;
+        RenderOneBlock();
     }
+}
+
+void VirtualBackend::VirtualClockLoop() {
+	// 타이머 해상도, 스레드 우선순위/코어 배치 설정 (이 스레드가 호스트 콜백을 부름)
+    ThreadPlacement::Scope placement(ThreadRole::Clock);
+    DebugLog("[VirtualBackend] Thread Placement: %s, CPUs %s%s\n", ThreadPlacement::PriorityName(placement.GetPriority()),
+        ThreadPlacement::FormatMask(placement.GetResult().mask).c_str(), placement.GetResult().priorityOk ? "" : " (Priority Fallback)");
     TimerResolutionSetter timerRes;
 
     // 블록당 시간 계산 (나노초)
+    m_rateChanged.store(false, std::memory_order_relaxed);
     double idealSeconds = (double)m_bufferSize / m_sampleRate;
-    auto idealDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::duration<double>(idealSeconds)
-    );
 
     // 기준 시간
     auto wakeUpTime = std::chrono::steady_clock::now();
-    long doubleBufferIndex = 0;
 
-    size_t bufferCapacity = Config::RING_BUFFER_SIZE;
+    // 페이싱 윈도우 = 레이턴시 임계값의 2배 (목표 기본값이 임계값과 일치)
+    int sampleSize = 4;
+    double target = Config::BUFFER_TARGET_DEFAULT;
+    if (m_owner) {
+        sampleSize = m_owner->GetSampleSize(m_owner->m_sampleType);
+        if (sampleSize <= 0) sampleSize = 4;
+        target = std::clamp(m_owner->m_pacingTarget, Config::BUFFER_TARGET_LOW, Config::BUFFER_TARGET_HIGH);
+    }
+    double bytesPerSecond = sampleSize * m_sampleRate;
+
+    // 임계값이 실행 중 바뀌면 (설정 변경, 자동 레이턴시) 이 스레드에서 다시 설정
+    size_t threshold = 0;
+    auto setupPacer = [&]() {
+        size_t window = Config::RING_BUFFER_SIZE;
+        if (m_owner) {
+            threshold = m_owner->GetLatencyThreshold();
+            window = std::min(threshold * 2, m_owner->m_loopbackBufferR.GetCapacity());
+        }
+        double windowSeconds = window / bytesPerSecond;
+        m_pacer.Setup(idealSeconds, windowSeconds * target,
+            windowSeconds * Config::BUFFER_TARGET_LOW, windowSeconds * Config::BUFFER_TARGET_HIGH);
+        DebugLog("[VirtualBackend] Loop Running... Buffer: %d, Pacing Target: %.2f ms\n", m_bufferSize, windowSeconds * target * 1000.0);
+    };
 
     DebugLog("[VirtualBackend] Simple Loop Started. Block Time: %.3f ms\n", idealSeconds * 1000.0);
-    DebugLog("[VirtualBackend] Loop Running... Buffer: %d\n", m_bufferSize);
+    setupPacer();
 
     while (m_running) {
-        // 누적 오차 방지
+        // 재생 중 레이트 변경: 블록 시간과 페이싱 윈도우를 새 레이트로
+        if (m_rateChanged.exchange(false, std::memory_order_acquire)) {
+            idealSeconds = (double)m_bufferSize / m_sampleRate;
+            bytesPerSecond = sampleSize * m_sampleRate;
+            setupPacer();
+        }
+        if (m_owner && m_owner->GetLatencyThreshold() != threshold) setupPacer();
+
+        // 채움량 기반 연속 보정 (PLL)
         size_t currentFill = 0;
         if (m_owner) currentFill = m_owner->m_loopbackBufferR.GetFillSize();
 
-        auto currentSleepTime = idealDuration;
-
-        if (currentFill > bufferCapacity * 0.9) {
-            // 오버런 임박 (90% 이상 참) -> 속도를 늦춤
-            currentSleepTime += std::chrono::microseconds(10);
-        }
-        else if (currentFill < bufferCapacity * 0.1) {
-            // 언더런 임박 (10% 미만 남음) -> 속도를 높임
-            currentSleepTime -= std::chrono::microseconds(10);
-        }
+        double scale = m_pacer.Update(currentFill / bytesPerSecond);
+        auto currentSleepTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>(idealSeconds * scale)
+        );
         wakeUpTime += currentSleepTime;
         
         if (wakeUpTime < std::chrono::steady_clock::now()) {
@@ -111,45 +190,54 @@ void VirtualBackend::VirtualClockLoop() {
 
         PrecisionClock::WaitUntil(wakeUpTime);
 
-        if (m_owner && m_owner->m_bufferInfos) {
-            long numCh = m_owner->m_numChannels;
-			// 채널별로 버퍼 클리어
-            for (long i = 0; i < numCh; i++) {
-                // 버퍼 포인터 가져오기
-                void* pBuf = m_owner->m_bufferInfos[i].buffers[doubleBufferIndex];
-                if (pBuf) memset(pBuf, 0, m_owner->m_bufferSize * sizeof(float));
-            }
-            m_owner->TriggerBufferSwitch(doubleBufferIndex);
-        }
-        // 샘플 위치 갱신
-        m_samplePos += m_bufferSize;
-        doubleBufferIndex = (doubleBufferIndex + 1) % 2;
+        RenderOneBlock();
     }
-    if (hTask) AvRevertMmThreadCharacteristics(hTask);
+}
+
+ASIOError VirtualBackend::CanSampleRate(ASIOSampleRate sampleRate) {
+    if (!IsSupportedRate(sampleRate)) return ASE_NoClock;
+    // 믹스 서버가 다른 클라이언트로 동작 중이면 서버 레이트만 허용
+    if (m_mixClient && !m_running && CVirtualMixServer::Instance().IsRateLocked(sampleRate)) return ASE_NoClock;
+    return ASE_OK;
 }
 
 ASIOError VirtualBackend::CreateBuffers(ASIOBufferInfo* bufferInfos, long numChannels, long bufferSize, ASIOCallbacks* callbacks) {
     m_bufferSize = bufferSize;
+    if (!m_bufferStorage) return ASE_NoMemory;
 
-    try {
-        m_buffers.resize(numChannels);
-        for (long i = 0; i < numChannels; i++) {
-            // 초기화
-            m_buffers[i].assign(bufferSize * 2, 0.0f);
+    // 채널 반쪽마다 캐시 라인 정렬 (아레나 시작은 64바이트 정렬)
+    size_t stride = VirtualChannels::ChannelStride(bufferSize);
+    for (long i = 0; i < numChannels; i++) {
+        long count = bufferInfos[i].isInput ? m_numInputs : m_numOutputs;
+        if (bufferInfos[i].channelNum < 0 || bufferInfos[i].channelNum >= count) return ASE_InvalidParameter;
+        // ASIO 더블 버퍼링 포인터 연결 (아레나는 0 으로 초기화된 상태)
+        float* channel = m_bufferStorage + (size_t)i * stride * 2;
+        bufferInfos[i].buffers[0] = channel;
+        bufferInfos[i].buffers[1] = channel + stride;
+    }
 
-            // ASIO 더블 버퍼링 포인터 연결
-            bufferInfos[i].buffers[0] = m_buffers[i].data();
-            bufferInfos[i].buffers[1] = m_buffers[i].data() + bufferSize;
+    // 루프백: 호스트가 같은 번호 출력을 만들지 않았으면 입력은 무음
+    m_loopbacks.clear();
+    for (long i = 0; i < numChannels; i++) {
+        if (!bufferInfos[i].isInput) continue;
+        for (long k = 0; k < numChannels; k++) {
+            if (bufferInfos[k].isInput || bufferInfos[k].channelNum != bufferInfos[i].channelNum) continue;
+            VirtualChannels::LoopbackCopy copy;
+            for (int half = 0; half < 2; half++) {
+                copy.input[half] = static_cast<float*>(bufferInfos[i].buffers[half]);
+                copy.output[half] = static_cast<float*>(bufferInfos[k].buffers[half]);
+            }
+            m_loopbacks.push_back(copy);
+            break;
         }
-        return ASE_OK;
-    }
-    catch (...) {
-        return ASE_NoMemory;
     }
+    DebugLog("[VirtualBackend] Buffers: %ld Channels, Stride %zu, Loopbacks %zu\n", numChannels, stride, m_loopbacks.size());
+    return ASE_OK;
 }
 
 ASIOError VirtualBackend::DisposeBuffers() {
-    m_buffers.clear();
+    m_bufferStorage = nullptr;
+    m_loopbacks.clear();
     return ASE_OK;
 }
 
@@ -172,17 +260,20 @@ ASIOError VirtualBackend::GetSamplePosition(ASIOSamples* sPos, ASIOTimeStamp* tS
 // 드라이버 본체
 // ---------------------------------------------------------------------------
 CDeltaCastDriver::CDeltaCastDriver() {
-    g_pThis = this;
     memset(&m_hostCallbacks, 0, sizeof(m_hostCallbacks));
     memset(&m_myCallbacks, 0, sizeof(m_myCallbacks));
     DebugLog("[DeltaCast] Driver Created\n");
 }
 
 CDeltaCastDriver::~CDeltaCastDriver() {
+    m_configWatcher.Stop();
     stop();
+    m_renderer.Close();
+    m_outputs.Close();
     m_backendImpl.reset();
-    if (g_pThis == this) g_pThis = nullptr;
+    AsioCallbackSlots::Release(m_callbackSlot);
     DebugLog("[DeltaCast] Driver Destroyed\n");
+    if (m_logStarted) DeltaLog::Stop();
 }
 
 // ---------------------------------------------------------------------------
@@ -196,15 +287,115 @@ void CDeltaCastDriver::LoadConfiguration() {
     size_t lastSlash = configPath.find_last_of(L"\\/");
     if (lastSlash != std::wstring::npos) configPath = configPath.substr(0, lastSlash + 1);
     configPath += L"Delta_Cast.ini";
+    m_configPath = configPath;
 
     // INI 에서 읽어옴
     WCHAR clsidStr[64] = { 0 };
     GetPrivateProfileStringW(L"Settings", L"TargetDriverCLSID", L"", clsidStr, 64, configPath.c_str());
 
-    WCHAR wasapiIdBuf[256] = { 0 };
-    GetPrivateProfileStringW(L"Settings", L"TargetWasapiID", L"", wasapiIdBuf, 256, configPath.c_str());
-    m_latencyMode = GetPrivateProfileIntW(L"Settings", L"LatencyMode", 1, configPath.c_str());
-    m_targetWasapiId = wasapiIdBuf;
+    // 가상 모드 클럭 소스 (Timer: 자체 타이머, Sink: 출력 장치 이벤트)
+    WCHAR clockStr[16] = { 0 };
+    GetPrivateProfileStringW(L"Settings", L"VirtualClock", L"Timer", clockStr, 16, configPath.c_str());
+    m_sinkClocked = (_wcsicmp(clockStr, L"Sink") == 0);
+    // 가상 모드 다중 클라이언트 (같은 프로세스의 인스턴스들을 하나의 장치로 합산)
+    m_virtualMix = GetPrivateProfileIntW(L"Settings", L"VirtualMix", 0, configPath.c_str()) != 0;
+    // 가상 장치 채널 (입력은 같은 번호 출력의 루프백, 녹음 프로그램용)
+    m_virtualOutputs = std::clamp((long)GetPrivateProfileIntW(L"Settings", L"VirtualOutputs", 2, configPath.c_str()), 2L, Config::MAX_VIRTUAL_CHANNELS);
+    m_virtualInputs = std::clamp((long)GetPrivateProfileIntW(L"Settings", L"VirtualInputs", 0, configPath.c_str()), 0L, Config::MAX_VIRTUAL_CHANNELS);
+
+    // 녹음 설정
+    m_recordEnabled = GetPrivateProfileIntW(L"Recorder", L"Enabled", 0, configPath.c_str()) != 0;
+    WCHAR recordDirBuf[MAX_PATH] = { 0 };
+    GetPrivateProfileStringW(L"Recorder", L"Directory", L"", recordDirBuf, MAX_PATH, configPath.c_str());
+    m_recordDirectory = recordDirBuf;
+    if (m_recordDirectory.empty()) {
+        // 기본값: 사용자 음악 폴더
+        PWSTR musicPath = nullptr;
+        if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_Music, 0, nullptr, &musicPath))) m_recordDirectory = musicPath;
+        CoTaskMemFree(musicPath);
+    }
+    WCHAR recordFormatBuf[16] = { 0 };
+    GetPrivateProfileStringW(L"Recorder", L"Format", L"Float32", recordFormatBuf, 16, configPath.c_str());
+    m_recordFormat = (_wcsicmp(recordFormatBuf, L"Int24") == 0) ? WavSampleFormat::Int24 : WavSampleFormat::Float32;
+    WCHAR recordContainerBuf[16] = { 0 };
+    GetPrivateProfileStringW(L"Recorder", L"Container", L"Wav", recordContainerBuf, 16, configPath.c_str());
+    m_recordContainer = (_wcsicmp(recordContainerBuf, L"W64") == 0) ? WavContainer::W64 : WavContainer::Wav;
+
+    // 리플레이 설정 (클립은 녹음 폴더에 저장)
+    m_replayEnabled = GetPrivateProfileIntW(L"Replay", L"Enabled", 0, configPath.c_str()) != 0;
+    m_replayMemoryBytes = (size_t)std::max(4, (int)GetPrivateProfileIntW(L"Replay", L"MemoryMB", 64, configPath.c_str())) << 20;
+    m_replaySeconds = (double)std::max(1, (int)GetPrivateProfileIntW(L"Replay", L"Seconds", 120, configPath.c_str()));
+    // 라우드니스 미터
+    m_meterEnabled = GetPrivateProfileIntW(L"Meter", L"Enabled", 0, configPath.c_str()) != 0;
+    // 공유 메모리 송출 (링 크기는 2의 거듭제곱으로 올림)
+    m_ipcEnabled = GetPrivateProfileIntW(L"IPC", L"Enabled", 0, configPath.c_str()) != 0;
+    size_t ipcRingKB = (size_t)std::clamp((int)GetPrivateProfileIntW(L"IPC", L"RingKB", 256, configPath.c_str()), 16, 16384);
+    m_ipcRingBytes = 1024;
+    while (m_ipcRingBytes < ipcRingKB * 1024) m_ipcRingBytes <<= 1;
+    // 스트림 메모리 (큰 페이지는 SeLockMemoryPrivilege 필요, 없으면 일반 페이지 + 잠금)
+    m_arenaOptions.largePages = GetPrivateProfileIntW(L"Memory", L"LargePages", 0, configPath.c_str()) != 0;
+    m_arenaOptions.lock = GetPrivateProfileIntW(L"Memory", L"Lock", 1, configPath.c_str()) != 0;
+    // 스레드 배치 ([Threads] <역할>Priority / <역할>Cores / <역할>Pin / <역할>Avoid, 공용 Avoid / AvoidScope)
+    ThreadPlacement::Configure(ReadThreadPlacement(configPath));
+    // 페이싱 목표 (%, 35 ~ 65)
+    int pacingPercent = GetPrivateProfileIntW(L"Settings", L"PacingTarget", (int)(Config::BUFFER_TARGET_DEFAULT * 100), configPath.c_str());
+    m_pacingTarget = std::clamp(pacingPercent / 100.0, Config::BUFFER_TARGET_LOW, Config::BUFFER_TARGET_HIGH);
+    // 출력 싱크 (Wasapi: 장치, Null: 출력 없음, File: 최종 출력을 WAV 로)
+    WCHAR sinkBuf[16] = { 0 };
+    GetPrivateProfileStringW(L"Output", L"Sink", L"Wasapi", sinkBuf, 16, configPath.c_str());
+    if (_wcsicmp(sinkBuf, L"Null") == 0) m_sinkType = SinkType::Null;
+    else if (_wcsicmp(sinkBuf, L"File") == 0) m_sinkType = SinkType::File;
+    else m_sinkType = SinkType::Wasapi;
+    WCHAR sinkPathBuf[MAX_PATH] = { 0 };
+    GetPrivateProfileStringW(L"Output", L"FilePath", L"", sinkPathBuf, MAX_PATH, configPath.c_str());
+    m_sinkFilePath = sinkPathBuf;
+    if (m_sinkFilePath.empty()) {
+        m_sinkFilePath = m_recordDirectory;
+        if (!m_sinkFilePath.empty() && m_sinkFilePath.back() != L'\\' && m_sinkFilePath.back() != L'/') m_sinkFilePath += L'\\';
+        m_sinkFilePath += L"DeltaCast_Output.wav";
+    }
+    // 추가 출력 ([Output2] ~ [Output8], Sink 가 없으면 사용 안 함)
+    std::vector<OutputConfig> extraOutputs;
+    for (size_t i = 0; i < COutputGroup::MAX_EXTRA_OUTPUTS; i++) {
+        std::wstring section = L"Output" + std::to_wstring(i + 2);
+        WCHAR extraSinkBuf[16] = { 0 };
+        GetPrivateProfileStringW(section.c_str(), L"Sink", L"", extraSinkBuf, 16, configPath.c_str());
+        if (extraSinkBuf[0] == 0) continue;
+        OutputConfig output;
+        if (_wcsicmp(extraSinkBuf, L"Null") == 0) output.type = SinkType::Null;
+        else if (_wcsicmp(extraSinkBuf, L"File") == 0) output.type = SinkType::File;
+        else output.type = SinkType::Wasapi;
+        WCHAR extraDeviceBuf[256] = { 0 };
+        GetPrivateProfileStringW(section.c_str(), L"Device", L"", extraDeviceBuf, 256, configPath.c_str());
+        output.deviceId = extraDeviceBuf;
+        WCHAR extraPathBuf[MAX_PATH] = { 0 };
+        GetPrivateProfileStringW(section.c_str(), L"FilePath", L"", extraPathBuf, MAX_PATH, configPath.c_str());
+        output.filePath = extraPathBuf;
+        if (output.filePath.empty()) {
+            output.filePath = m_recordDirectory;
+            if (!output.filePath.empty() && output.filePath.back() != L'\\' && output.filePath.back() != L'/') output.filePath += L'\\';
+            output.filePath += L"DeltaCast_" + section + L".wav";
+        }
+        extraOutputs.push_back(output);
+    }
+    m_outputs.Configure(extraOutputs, m_arenaOptions);
+    // 로그 (기본: %LOCALAPPDATA%\Delta_Cast\DeltaCast.log, 빈 File 이면 디버거 출력만)
+    m_logEnabled = GetPrivateProfileIntW(L"Log", L"Enabled", 1, configPath.c_str()) != 0;
+    WCHAR logPathBuf[MAX_PATH] = { 0 };
+    GetPrivateProfileStringW(L"Log", L"File", L"<default>", logPathBuf, MAX_PATH, configPath.c_str());
+    m_logPath = logPathBuf;
+    if (m_logPath == L"<default>") {
+        m_logPath.clear();
+        PWSTR appDataPath = nullptr;
+        if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &appDataPath))) {
+            m_logPath = std::wstring(appDataPath) + L"\\Delta_Cast";
+            CreateDirectoryW(m_logPath.c_str(), nullptr);
+            m_logPath += L"\\DeltaCast.log";
+        }
+        CoTaskMemFree(appDataPath);
+    }
+    // 실행 중 변경 가능한 항목 (장치, 레이턴시, 게인, 덕킹, 리미터, 라우팅)
+    ApplyRuntimeSettings(ReadRuntimeSettings(configPath), false);
 
     // 모드 선택
     if (wcscmp(clsidStr, L"Virtual") == 0) {
@@ -233,16 +424,293 @@ void CDeltaCastDriver::LoadConfiguration() {
     }
 }
 
+ThreadPlacementSettings CDeltaCastDriver::ReadThreadPlacement(const std::wstring& configPath) {
+    static const wchar_t* ROLE_KEYS[] = { L"Clock", L"Render", L"Worker", L"Background" };
+    static const wchar_t* PRIORITY_NAMES[] = { L"Background", L"Low", L"Normal", L"High", L"Realtime" };
+    static const wchar_t* CORE_NAMES[] = { L"Any", L"Performance", L"Efficiency" };
+    static const wchar_t* SCOPE_NAMES[] = { L"Cpu", L"Smt", L"L2" };
+    auto readList = [&](const std::wstring& key) {
+        WCHAR buf[128] = { 0 };
+        GetPrivateProfileStringW(L"Threads", key.c_str(), L"", buf, 128, configPath.c_str());
+        std::string text;
+        for (const WCHAR* p = buf; *p; p++) text += (*p < 128) ? (char)*p : ' ';
+        return ThreadPlacement::ParseCpuList(text);
+    };
+    auto readChoice = [&](const std::wstring& key, const wchar_t* const* names, int count, int fallback) {
+        WCHAR buf[32] = { 0 };
+        GetPrivateProfileStringW(L"Threads", key.c_str(), L"", buf, 32, configPath.c_str());
+        for (int i = 0; i < count; i++) {
+            if (_wcsicmp(buf, names[i]) == 0) return i;
+        }
+        return fallback;
+    };
+
+    ThreadPlacementSettings settings;
+    settings.avoid = readList(L"Avoid");
+    settings.avoidScope = (AvoidScope)readChoice(L"AvoidScope", SCOPE_NAMES, 3, (int)settings.avoidScope);
+    for (int role = 0; role < (int)ThreadRole::Count; role++) {
+        ThreadPolicy& policy = settings.policy[role];
+        std::wstring prefix = ROLE_KEYS[role];
+        policy.priority = (ThreadPriorityClass)readChoice(prefix + L"Priority", PRIORITY_NAMES, 5, (int)policy.priority);
+        policy.cores = (CoreClass)readChoice(prefix + L"Cores", CORE_NAMES, 3, (int)policy.cores);
+        policy.pin = readList(prefix + L"Pin");
+        policy.avoid = readList(prefix + L"Avoid");
+    }
+
+    const CpuTopology& topology = ThreadPlacement::GetTopology();
+    uint64_t performance = 0;
+    for (const CpuInfo& info : topology.cpus) {
+        if (info.efficiency == topology.maxEfficiency && info.cpu < ThreadPlacement::MAX_CPUS) performance |= 1ull << info.cpu;
+    }
+    DebugLog("[DeltaCast] CPU Topology: %zu CPUs, %s, Performance CPUs %s\n", topology.cpus.size(),
+        topology.hybrid ? "Hybrid" : "Uniform", ThreadPlacement::FormatMask(topology.hybrid ? performance : 0).c_str());
+    for (int role = 0; role < (int)ThreadRole::Count; role++) {
+        const ThreadPolicy& policy = settings.policy[role];
+        std::vector<int> avoid = settings.avoid;
+        avoid.insert(avoid.end(), policy.avoid.begin(), policy.avoid.end());
+        uint64_t mask = ThreadPlacement::ResolveMask(topology, policy, avoid, settings.avoidScope);
+        DebugLog("[DeltaCast] Thread %ls: %s, %s Cores, CPUs %s\n", ROLE_KEYS[role], ThreadPlacement::PriorityName(policy.priority),
+            ThreadPlacement::CoreClassName(policy.cores), ThreadPlacement::FormatMask(mask).c_str());
+    }
+    return settings;
+}
+
+RuntimeSettings CDeltaCastDriver::ReadRuntimeSettings(const std::wstring& configPath) {
+    RuntimeSettings s;
+    WCHAR wasapiIdBuf[256] = { 0 };
+    GetPrivateProfileStringW(L"Settings", L"TargetWasapiID", L"", wasapiIdBuf, 256, configPath.c_str());
+    s.wasapiId = wasapiIdBuf;
+    // 레이턴시 (LatencyMode 0~3: 42/21/10/5 ms, 4: 자동, LatencyMs 지정 시 우선)
+    static const double MODE_MS[] = { 42.0, 21.0, 10.0, 5.0 };
+    int latencyMode = GetPrivateProfileIntW(L"Settings", L"LatencyMode", 1, configPath.c_str());
+    s.autoLatency.enabled = (latencyMode == 4);
+    s.latencyMs = MODE_MS[(latencyMode >= 0 && latencyMode <= 3) ? latencyMode : 1];
+    WCHAR valueBuf[32] = { 0 };
+    GetPrivateProfileStringW(L"Settings", L"LatencyMs", L"0", valueBuf, 32, configPath.c_str());
+    if (_wtof(valueBuf) > 0.0) s.latencyMs = std::clamp(_wtof(valueBuf), 1.0, 200.0);
+    // 자동 레이턴시 범위와 허용 언더런 확률 (%)
+    GetPrivateProfileStringW(L"Settings", L"AutoMinMs", L"3", valueBuf, 32, configPath.c_str());
+    s.autoLatency.minMs = std::clamp(_wtof(valueBuf), 1.0, 200.0);
+    GetPrivateProfileStringW(L"Settings", L"AutoMaxMs", L"50", valueBuf, 32, configPath.c_str());
+    s.autoLatency.maxMs = std::clamp(_wtof(valueBuf), s.autoLatency.minMs, 200.0);
+    GetPrivateProfileStringW(L"Settings", L"AutoUnderrunPercent", L"0.1", valueBuf, 32, configPath.c_str());
+    s.autoLatency.underrunProbability = std::clamp(_wtof(valueBuf) / 100.0, 1e-6, 0.5);
+    s.concealment = GetPrivateProfileIntW(L"Settings", L"Concealment", 1, configPath.c_str()) != 0;
+
+    // 송출 게인 (하드웨어 출력에는 적용 안 함)
+    GetPrivateProfileStringW(L"Loopback", L"GainDbL", L"0", valueBuf, 32, configPath.c_str());
+    s.gainDb[0] = _wtof(valueBuf);
+    GetPrivateProfileStringW(L"Loopback", L"GainDbR", L"0", valueBuf, 32, configPath.c_str());
+    s.gainDb[1] = _wtof(valueBuf);
+    s.mute = GetPrivateProfileIntW(L"Loopback", L"Mute", 0, configPath.c_str()) != 0;
+    // 송출 채널 (ASIO 출력 채널 번호)
+    s.outputLeft = (long)(int)GetPrivateProfileIntW(L"Loopback", L"OutputLeft", -1, configPath.c_str());
+    s.outputRight = (long)(int)GetPrivateProfileIntW(L"Loopback", L"OutputRight", -1, configPath.c_str());
+
+    // 덕킹 (키: ASIO 입력 채널)
+    s.ducking.enabled = GetPrivateProfileIntW(L"Ducking", L"Enabled", 0, configPath.c_str()) != 0;
+    s.ducking.inputChannel = GetPrivateProfileIntW(L"Ducking", L"InputChannel", 0, configPath.c_str());
+    GetPrivateProfileStringW(L"Ducking", L"ThresholdDb", L"-40", valueBuf, 32, configPath.c_str());
+    s.ducking.thresholdDb = _wtof(valueBuf);
+    GetPrivateProfileStringW(L"Ducking", L"DepthDb", L"-12", valueBuf, 32, configPath.c_str());
+    s.ducking.depthDb = _wtof(valueBuf);
+    GetPrivateProfileStringW(L"Ducking", L"AttackMs", L"10", valueBuf, 32, configPath.c_str());
+    s.ducking.attackMs = _wtof(valueBuf);
+    GetPrivateProfileStringW(L"Ducking", L"ReleaseMs", L"300", valueBuf, 32, configPath.c_str());
+    s.ducking.releaseMs = _wtof(valueBuf);
+
+    // 리미터 (룩어헤드 ms, 실링 dBTP, 릴리즈 ms)
+    s.limiter.enabled = GetPrivateProfileIntW(L"Limiter", L"Enabled", 0, configPath.c_str()) != 0;
+    GetPrivateProfileStringW(L"Limiter", L"LookaheadMs", L"1.5", valueBuf, 32, configPath.c_str());
+    s.limiter.lookaheadMs = _wtof(valueBuf);
+    GetPrivateProfileStringW(L"Limiter", L"CeilingDb", L"-1.0", valueBuf, 32, configPath.c_str());
+    s.limiter.ceilingDb = _wtof(valueBuf);
+    GetPrivateProfileStringW(L"Limiter", L"ReleaseMs", L"60", valueBuf, 32, configPath.c_str());
+    s.limiter.releaseMs = _wtof(valueBuf);
+
+    // 이펙트 체인 ([Effect1] ~ [Effect8] 순서대로, Type 이 없거나 모르는 값이면 건너뜀)
+    static const struct { const wchar_t* name; EffectType type; } EFFECT_TYPES[] = {
+        { L"HighPass", EffectType::HighPass }, { L"LowPass", EffectType::LowPass }, { L"Peak", EffectType::Peak },
+        { L"LowShelf", EffectType::LowShelf }, { L"HighShelf", EffectType::HighShelf }, { L"Compressor", EffectType::Compressor },
+    };
+    if (GetPrivateProfileIntW(L"Effects", L"Enabled", 0, configPath.c_str()) != 0) {
+        for (size_t i = 0; i < EffectChain::MAX_EFFECTS; i++) {
+            std::wstring section = L"Effect" + std::to_wstring(i + 1);
+            GetPrivateProfileStringW(section.c_str(), L"Type", L"", valueBuf, 32, configPath.c_str());
+            EffectSettings effect;
+            for (const auto& entry : EFFECT_TYPES) {
+                if (_wcsicmp(valueBuf, entry.name) == 0) effect.type = entry.type;
+            }
+            if (effect.type == EffectType::None) continue;
+            GetPrivateProfileStringW(section.c_str(), L"FrequencyHz", L"1000", valueBuf, 32, configPath.c_str());
+            effect.frequencyHz = _wtof(valueBuf);
+            GetPrivateProfileStringW(section.c_str(), L"Q", L"0.7071", valueBuf, 32, configPath.c_str());
+            effect.q = _wtof(valueBuf);
+            GetPrivateProfileStringW(section.c_str(), L"GainDb", L"0", valueBuf, 32, configPath.c_str());
+            effect.gainDb = _wtof(valueBuf);
+            effect.order = (int)GetPrivateProfileIntW(section.c_str(), L"Order", 2, configPath.c_str());
+            GetPrivateProfileStringW(section.c_str(), L"ThresholdDb", L"-18", valueBuf, 32, configPath.c_str());
+            effect.thresholdDb = _wtof(valueBuf);
+            GetPrivateProfileStringW(section.c_str(), L"Ratio", L"3", valueBuf, 32, configPath.c_str());
+            effect.ratio = _wtof(valueBuf);
+            GetPrivateProfileStringW(section.c_str(), L"KneeDb", L"6", valueBuf, 32, configPath.c_str());
+            effect.kneeDb = _wtof(valueBuf);
+            GetPrivateProfileStringW(section.c_str(), L"AttackMs", L"5", valueBuf, 32, configPath.c_str());
+            effect.attackMs = _wtof(valueBuf);
+            GetPrivateProfileStringW(section.c_str(), L"ReleaseMs", L"120", valueBuf, 32, configPath.c_str());
+            effect.releaseMs = _wtof(valueBuf);
+            GetPrivateProfileStringW(section.c_str(), L"MakeupDb", L"0", valueBuf, 32, configPath.c_str());
+            effect.makeupDb = _wtof(valueBuf);
+            s.effects.push_back(effect);
+        }
+    }
+    return s;
+}
+
+// live: 스트리밍 중 적용 (작은 값은 원자값/명령 큐, 큰 객체는 교체 후 비실시간 해제)
+// 반환: 호스트에 레이턴시 변경 통지 필요 여부
+bool CDeltaCastDriver::ApplyRuntimeSettings(const RuntimeSettings& s, bool live) {
+    // 게인/뮤트/덕킹 파라미터는 원자값 (렌더 측 램프가 따라감)
+    m_gain.SetGainDb(0, s.gainDb[0]);
+    m_gain.SetGainDb(1, s.gainDb[1]);
+    m_gain.SetMute(s.mute);
+    m_gain.SetDucking(s.ducking);
+    m_outputs.SetGain(s.gainDb, s.mute, s.ducking);
+    bool duckInputChanged = (s.ducking.enabled != m_duckSettings.enabled || s.ducking.inputChannel != m_duckSettings.inputChannel);
+    m_duckSettings = s.ducking;
+
+    bool latencyChanged = (s.latencyMs != m_latencyMs.load() || s.autoLatency.enabled != m_autoLatency.enabled);
+    m_latencyMs.store(s.latencyMs);
+    m_autoLatency = s.autoLatency;
+    m_renderer.SetAutoLatency(m_autoLatency);
+    m_concealment = s.concealment;
+    m_renderer.SetConcealment(m_concealment);
+    m_outputs.SetConcealment(m_concealment);
+
+    const LimiterSettings& prev = m_limiterSettings;
+    bool limiterChanged = (s.limiter.enabled != prev.enabled || s.limiter.lookaheadMs != prev.lookaheadMs ||
+        s.limiter.ceilingDb != prev.ceilingDb || s.limiter.releaseMs != prev.releaseMs);
+    bool latencyFramesChanged = (s.limiter.enabled != prev.enabled ||
+        (s.limiter.enabled && Limiter::LatencyFramesFor(s.limiter, m_sampleRate) != Limiter::LatencyFramesFor(prev, m_sampleRate)));
+    m_limiterSettings = s.limiter;
+
+    bool effectsChanged = (s.effects != m_effectSettings);
+    m_effectSettings = s.effects;
+    if (effectsChanged) {
+        DebugLog("[DeltaCast] Effect Chain: %zu Nodes\n", m_effectSettings.size());
+        for (size_t i = 0; i < m_effectSettings.size(); i++) {
+            const EffectSettings& effect = m_effectSettings[i];
+            if (effect.type == EffectType::Compressor) {
+                DebugLog("[DeltaCast]   %zu: Compressor %.1f dB, %.1f:1, Attack %.1f ms, Release %.1f ms\n",
+                    i + 1, effect.thresholdDb, effect.ratio, effect.attackMs, effect.releaseMs);
+            }
+            else {
+                DebugLog("[DeltaCast]   %zu: %s %.1f Hz, Q %.2f, %.1f dB\n",
+                    i + 1, EffectTypeName(effect.type), effect.frequencyHz, effect.q, effect.gainDb);
+            }
+        }
+    }
+
+    bool deviceChanged = (s.wasapiId != m_targetWasapiId);
+    m_targetWasapiId = s.wasapiId;
+
+    bool routingChanged = (s.outputLeft != m_routeLeft || s.outputRight != m_routeRight);
+    m_routeLeft = s.outputLeft;
+    m_routeRight = s.outputRight;
+
+    if (!live) return false;
+
+    // 버퍼 스위치 측 인덱스 교체
+    if (m_bufferInfos) {
+        if (routingChanged) {
+            RtCommand command;
+            command.type = CMD_SET_ROUTING;
+            long indexL, indexR;
+            FindRouting(indexL, indexR);
+            command.a = (int32_t)indexL;
+            command.b = (int32_t)indexR;
+            m_callbackCommands.Post(command);
+        }
+        if (duckInputChanged) {
+            RtCommand command;
+            command.type = CMD_SET_DUCK_INPUT;
+            command.a = (int32_t)FindDuckInput();
+            m_callbackCommands.Post(command);
+        }
+    }
+
+    // 믹스 모드의 출력 경로는 믹스 서버 소유
+    if (m_isVirtualMode && m_virtualMix) return false;
+
+    if (latencyChanged && !m_autoLatency.enabled && !(m_isVirtualMode && m_sinkClocked)) m_renderer.SetThreshold(GetLatencyThreshold());
+    if (latencyChanged && !m_autoLatency.enabled) m_outputs.SetThreshold(GetLatencyThreshold());
+    if (limiterChanged) {
+        m_renderer.SetLimiter(m_limiterSettings);
+        m_outputs.SetLimiter(m_limiterSettings);
+    }
+    if (effectsChanged) {
+        m_renderer.SetEffects(m_effectSettings);
+        m_outputs.SetEffects(m_effectSettings);
+    }
+
+    if (deviceChanged && m_renderer.IsOpen()) {
+        // 장치 교체는 렌더 스레드가 싱크만 다시 엶 (호스트 스트림, 재생 상태 유지)
+        DebugLog("[DeltaCast] Output Device Changed: %ls\n", m_targetWasapiId.c_str());
+        m_renderer.SetDevice(m_targetWasapiId);
+    }
+    return limiterChanged && latencyFramesChanged && m_isVirtualMode;
+}
+
+void CDeltaCastDriver::OnConfigChanged() {
+    RuntimeSettings settings = ReadRuntimeSettings(m_configPath);
+    bool notifyLatency = false;
+    {
+        std::lock_guard<std::mutex> lock(m_controlLock);
+        notifyLatency = ApplyRuntimeSettings(settings, true);
+    }
+    DebugLog("[DeltaCast] Configuration Reloaded. Latency: %s %.2f ms\n",
+        settings.autoLatency.enabled ? "Auto" : "Fixed",
+        settings.autoLatency.enabled ? m_renderer.GetAutoLatencyMs() : settings.latencyMs);
+
+    // 호스트가 getLatencies 를 다시 부르도록 (잠금 밖에서)
+    if (notifyLatency && m_callbackSlot >= 0) OnAsioMessage(kAsioLatenciesChanged, 0, nullptr, nullptr);
+}
+
 ASIOBool CDeltaCastDriver::init(void* sysHandle) {
     LoadConfiguration();
+    if (m_logEnabled && !m_logStarted) {
+        DeltaLog::Start(m_logPath);
+        m_logStarted = true;
+    }
     if (!m_backendImpl) return ASIOFalse;
-    return (m_backendImpl->Init(sysHandle) == ASE_OK) ? ASIOTrue : ASIOFalse;
+    if (!m_configPath.empty()) m_configWatcher.Start(m_configPath, [this]() { OnConfigChanged(); });
+    if (m_backendImpl->Init(sysHandle) != ASE_OK) return ASIOFalse;
+
+    // 렌더 엔진은 드라이버 수명 동안 유지 (start/stop 은 재생만 전환, 믹스 모드는 서버 소유)
+    if (!(m_isVirtualMode && m_virtualMix)) {
+        std::lock_guard<std::mutex> lock(m_controlLock);
+        m_renderer.SetGainStage(&m_gain);
+        m_renderer.SetLimiter(m_limiterSettings);
+        m_renderer.SetEffects(m_effectSettings);
+        m_renderer.SetSink(CreateOutputSink());
+        m_renderer.SetArenaOptions(m_arenaOptions);
+        // 호스트 정체 감시 (싱크 클럭 모드에서는 렌더러가 무시)
+        m_renderer.SetStallTimeout(Config::VIRTUAL_TIMEOUT);
+        m_renderer.Open(m_targetWasapiId);
+        m_outputs.SetLimiter(m_limiterSettings);
+        m_outputs.SetEffects(m_effectSettings);
+        m_outputs.SetStallTimeout(Config::VIRTUAL_TIMEOUT);
+        m_outputs.Open();
+        if (m_outputs.GetCount() > 0) DebugLog("[DeltaCast] Extra Outputs: %zu\n", m_outputs.GetCount());
+    }
+    return ASIOTrue;
 }
 
 // ---------------------------------------------------------------------------
 // 오디오 제어
 // ---------------------------------------------------------------------------
 ASIOError CDeltaCastDriver::createBuffers(ASIOBufferInfo* bufferInfos, long numChannels, long bufferSize, ASIOCallbacks* callbacks) {
+    std::lock_guard<std::mutex> lock(m_controlLock);
     m_hostCallbacks = *callbacks;
     m_bufferInfos = bufferInfos;
     m_numChannels = numChannels;
@@ -253,100 +721,350 @@ ASIOError CDeltaCastDriver::createBuffers(ASIOBufferInfo* bufferInfos, long numC
     m_backendImpl->GetSampleRate(&rate);
     m_sampleRate = rate;
 
-    // 복제 콜백 연결
-    m_myCallbacks.bufferSwitch = &CDeltaCastDriver::bufferSwitch;
-    m_myCallbacks.bufferSwitchTimeInfo = &CDeltaCastDriver::bufferSwitchTimeInfo;
-    m_myCallbacks.sampleRateDidChange = &CDeltaCastDriver::sampleRateChanged;
-    m_myCallbacks.asioMessage = &CDeltaCastDriver::asioMessage;
+    // 복제 콜백 연결 (인스턴스 전용 슬롯)
+    if (m_callbackSlot < 0) {
+        m_callbackSlot = AsioCallbackSlots::Acquire(this, &m_myCallbacks);
+        if (m_callbackSlot < 0) {
+            DebugLog("[DeltaCast] No Free Callback Slot\n");
+            return ASE_NoMemory;
+        }
+    }
+
+    // 출력 채널 인덱스 찾기 (링 크기가 샘플 포맷에 달려 있으므로 버퍼 생성 전에)
+    FindRouting(m_outIndexL, m_outIndexR);
+    m_duckInputIndex = FindDuckInput();
+
+    // 채널 타입 확인
+    ASIOChannelInfo info = { 0 };
+    info.channel = bufferInfos[m_outIndexL].channelNum;
+    info.isInput = ASIOFalse;
+    ASIOError infoResult = m_backendImpl->GetChannelInfo(&info);
+    if (infoResult == ASE_OK) {
+        m_sampleType = info.type;
+    }
+    else {
+        // 기본값으로 Int32 사용
+        m_sampleType = ASIOSTInt32LSB;
+    }
+
+    // 스트림 메모리 (송출 링, 가상 호스트 버퍼)
+    if (!BuildStreamArena()) {
+        DebugLog("[DeltaCast] Stream Arena Allocation Failed\n");
+        return ASE_NoMemory;
+    }
 
     // 백엔드에서 버퍼 생성
     ASIOError result = m_backendImpl->CreateBuffers(bufferInfos, numChannels, bufferSize, &m_myCallbacks);
-
-    // 출력 채널 인덱스 찾기
     if (result == ASE_OK) {
-        m_outIndexL = -1;
-        m_outIndexR = -1;
-        for (long i = 0; i < numChannels; i++) {
-            if (bufferInfos[i].isInput == ASIOFalse) {
-                if (m_outIndexL == -1) m_outIndexL = i;
-                else if (m_outIndexR == -1) { m_outIndexR = i; break; }
-            }
-        }
-        if (m_outIndexL == -1) { m_outIndexL = 0; m_outIndexR = 1; }
-        if (m_outIndexR == -1) m_outIndexR = m_outIndexL;
-
-        // 채널 타입 확인
-        ASIOChannelInfo info = { 0 };
-        info.channel = bufferInfos[m_outIndexL].channelNum;
-        info.isInput = ASIOFalse;
-        ASIOError infoResult = m_backendImpl->GetChannelInfo(&info);
-        if (infoResult == ASE_OK) {
-            m_sampleType = info.type;
-        }
-        else {
-			// 기본값으로 Int32 사용
-            m_sampleType = ASIOSTInt32LSB;
-        }
+        // 이전 세션에서 남은 명령 폐기 (콜백이 돌기 전)
+        RtCommand stale;
+        while (m_callbackCommands.Pop(stale)) {}
+    }
+    else {
+        ReleaseStreamArena();
     }
     return result;
 }
 
+// 송출 링 크기: 최대 레이턴시(고정값과 자동 상한 중 큰 쪽)의 페이싱 윈도우 + 호스트 블록 여유
+size_t CDeltaCastDriver::ComputeRingBytes() const {
+    int sampleSize = std::max(GetAsioSampleSize(m_sampleType), 1);
+    double maxMs = std::max(m_latencyMs.load(), m_autoLatency.maxMs);
+    size_t frames = (size_t)std::lround(maxMs * 0.001 * m_sampleRate) * 2 + (size_t)m_bufferSize * Config::RING_HEADROOM_BLOCKS;
+    size_t bytes = Config::RING_MIN_SIZE;
+    while (bytes < frames * sampleSize) bytes <<= 1;
+    return bytes;
+}
+
+bool CDeltaCastDriver::BuildStreamArena() {
+    ReleaseStreamArena();
+
+    size_t ringBytes = ComputeRingBytes();
+    size_t hostBytes = m_backendImpl->GetBufferStorageBytes(m_numChannels, m_bufferSize);
+    size_t ringL = m_arena.Reserve(ringBytes);
+    size_t ringR = m_arena.Reserve(ringBytes);
+    size_t host = m_arena.Reserve(hostBytes);
+    if (!m_arena.Commit(m_arenaOptions)) {
+        m_arena.Release();
+        return false;
+    }
+
+    m_loopbackBufferL.AttachStorage(m_arena.At<uint8_t>(ringL), ringBytes);
+    m_loopbackBufferR.AttachStorage(m_arena.At<uint8_t>(ringR), ringBytes);
+    m_backendImpl->SetBufferStorage(hostBytes > 0 ? m_arena.At<uint8_t>(host) : nullptr);
+
+    DebugLog("[DeltaCast] Stream Arena: %zu KB (Rings 2 x %zu KB, Host Buffers %zu KB)%s%s\n",
+        m_arena.GetCommittedBytes() >> 10, ringBytes >> 10, hostBytes >> 10,
+        m_arena.IsLargePages() ? ", Large Pages" : "", m_arena.IsLocked() ? ", Locked" : "");
+    return true;
+}
+
+void CDeltaCastDriver::ReleaseStreamArena() {
+    // 링을 쓰는 스레드(렌더/녹음/미터/콜백)가 모두 멈춘 뒤에만 호출
+    m_loopbackBufferL.AttachStorage(nullptr, 0);
+    m_loopbackBufferR.AttachStorage(nullptr, 0);
+    m_backendImpl->SetBufferStorage(nullptr);
+    m_arena.Release();
+}
+
+// 송출 채널 (지정 채널 우선, 없으면 처음 두 출력)
+void CDeltaCastDriver::FindRouting(long& indexL, long& indexR) const {
+    indexL = -1;
+    indexR = -1;
+    long first = -1, second = -1;
+    for (long i = 0; i < m_numChannels; i++) {
+        if (m_bufferInfos[i].isInput != ASIOFalse) continue;
+        if (m_routeLeft >= 0 && m_bufferInfos[i].channelNum == m_routeLeft) indexL = i;
+        if (m_routeRight >= 0 && m_bufferInfos[i].channelNum == m_routeRight) indexR = i;
+        if (first == -1) first = i;
+        else if (second == -1) second = i;
+    }
+    if (indexL == -1) indexL = first;
+    if (indexR == -1) indexR = second;
+    if (indexL == -1) { indexL = 0; indexR = (m_numChannels > 1) ? 1 : 0; }
+    if (indexR == -1) indexR = indexL;
+}
+
+// 덕킹 키 입력 (호스트가 해당 입력 버퍼를 만든 경우만)
+long CDeltaCastDriver::FindDuckInput() const {
+    if (!m_duckSettings.enabled) return -1;
+    for (long i = 0; i < m_numChannels; i++) {
+        if (m_bufferInfos[i].isInput == ASIOTrue && m_bufferInfos[i].channelNum == m_duckSettings.inputChannel) return i;
+    }
+    return -1;
+}
+
+size_t CDeltaCastDriver::GetLatencyFrames() const {
+    size_t frames = (size_t)std::lround(m_latencyMs.load(std::memory_order_relaxed) * 0.001 * m_sampleRate);
+    // 링버퍼 절반 이내 (페이싱 윈도우 = 임계값의 2배)
+    int sampleSize = std::max(GetAsioSampleSize(m_sampleType), 1);
+    size_t ringBytes = m_loopbackBufferL.GetCapacity();
+    if (ringBytes == 0) ringBytes = Config::RING_BUFFER_SIZE;
+    return std::clamp(frames, (size_t)32, ringBytes / 2 / sampleSize);
+}
+
+size_t CDeltaCastDriver::GetLatencyThreshold() const {
+    if (m_renderer.IsAutoLatency()) {
+        size_t current = m_renderer.GetThreshold();
+        if (m_renderer.IsRunning() && current > 0) return current;
+    }
+    return GetLatencyFrames() * std::max(GetAsioSampleSize(m_sampleType), 1);
+}
+
 ASIOError CDeltaCastDriver::start() {
+    std::lock_guard<std::mutex> lock(m_controlLock);
     if (!m_backendImpl) {
         return ASE_NotPresent;
     }
-    size_t threshold = 8192;
-    switch (m_latencyMode) {
-    case 0: threshold = 16384; break; // 42ms
-    case 1: threshold = 8192;  break; // 21ms
-    case 2: threshold = 4096;  break; // 10ms
-    case 3: threshold = 2048;  break; // 5ms
-    default: threshold = 8192; break;
+    size_t threshold = GetLatencyThreshold();
+    // 싱크 클럭 모드는 주기마다 필요한 만큼만 생성하므로 선행 버퍼링 없음
+    if (m_isVirtualMode && m_sinkClocked) threshold = 0;
+    // 믹스 모드에서는 링버퍼가 믹스 서버의 클라이언트 큐 (출력과 공유 메모리는 서버가 담당)
+    bool mixClient = m_isVirtualMode && m_virtualMix;
+    if (!mixClient) {
+        m_renderer.Start(&m_loopbackBufferL, &m_loopbackBufferR, m_targetWasapiId, m_sampleType, m_sampleRate, threshold);
+        // 추가 출력은 링을 소비하지 않으므로 싱크 클럭 모드에서도 임계값만큼 버퍼링
+        m_outputs.Start(&m_loopbackBufferL, &m_loopbackBufferR, m_sampleType, m_sampleRate, GetLatencyThreshold());
     }
-    m_renderer.Start(&m_loopbackBufferL, &m_loopbackBufferR, m_targetWasapiId, m_sampleType, m_sampleRate, threshold);
+    StartRecorder();
+    StartReplay();
+    StartMeter();
+    if (!mixClient) StartIpc();
     return m_backendImpl->Start();
 }
 
+std::unique_ptr<IOutputSink> CDeltaCastDriver::CreateOutputSink() const {
+    return CreateSink(m_sinkType, m_sinkFilePath);
+}
+
+void CDeltaCastDriver::StartRecorder() {
+    // 파일은 버퍼 수명 동안 유지 (start/stop 마다 새 파일을 만들지 않음)
+    if (!m_recordEnabled || m_recorder.IsRunning()) return;
+
+    std::string date = PrecisionClock::GetDateString();
+    std::wstring path = m_recordDirectory;
+    if (!path.empty() && path.back() != L'\\' && path.back() != L'/') path += L'\\';
+    path += L"DeltaCast_" + std::wstring(date.begin(), date.end());
+    path += (m_recordContainer == WavContainer::W64) ? L".w64" : L".wav";
+
+    if (!m_recorder.Start(&m_loopbackBufferL, &m_loopbackBufferR, path, m_sampleType, m_sampleRate,
+        m_recordFormat, m_recordContainer)) {
+        DebugLog("[DeltaCast] Recorder Failed: %ls\n", path.c_str());
+        return;
+    }
+    DebugLog("[DeltaCast] Recording: %ls\n", path.c_str());
+}
+
+void CDeltaCastDriver::StartReplay() {
+    if (!m_replayEnabled || m_replay.IsRunning()) return;
+
+    if (!m_replay.Start(&m_loopbackBufferL, &m_loopbackBufferR, m_sampleType, m_sampleRate,
+        m_replayMemoryBytes, m_replaySeconds, m_recordDirectory)) {
+        DebugLog("[DeltaCast] Replay Buffer Failed\n");
+        return;
+    }
+    DebugLog("[DeltaCast] Replay Buffer: %zu MB, Clip %.0f s\n", m_replayMemoryBytes >> 20, m_replaySeconds);
+}
+
+void CDeltaCastDriver::StartMeter() {
+    if (!m_meterEnabled || m_meter.IsRunning()) return;
+
+    if (!m_meter.Start(&m_loopbackBufferL, &m_loopbackBufferR, m_sampleType, m_sampleRate)) {
+        DebugLog("[DeltaCast] Meter Failed\n");
+        return;
+    }
+    DebugLog("[DeltaCast] Meter Started\n");
+}
+
+void CDeltaCastDriver::StartIpc() {
+    if (!m_ipcEnabled || m_ipcWriter.IsOpen()) return;
+
+    int sampleSize = GetSampleSize(m_sampleType);
+    if (!m_ipcWriter.Create(2, (int32_t)m_sampleType, (uint32_t)sampleSize, m_sampleRate, m_ipcRingBytes)) {
+        DebugLog("[DeltaCast] IPC Failed\n");
+        return;
+    }
+    DebugLog("[DeltaCast] IPC: Slot %d, %zu KB x 2ch, Type %ld\n", m_ipcWriter.GetSlot(), m_ipcRingBytes >> 10, m_sampleType);
+}
+
 ASIOError CDeltaCastDriver::stop() {
-    m_renderer.Stop();
+    std::lock_guard<std::mutex> lock(m_controlLock);
+    if (m_renderer.IsRunning()) {
+        m_renderer.Stop();
+        m_outputs.Stop();
+        RenderEngineStats stats = m_renderer.GetStats();
+        DebugLog("[DeltaCast] Start To First Audio: %.1f ms (%s)\n", stats.firstAudioMs, stats.warmStart ? "Warm" : "Cold");
+    }
     return m_backendImpl ? m_backendImpl->Stop() : ASE_OK;
 }
 
 ASIOError CDeltaCastDriver::disposeBuffers() {
-    return m_backendImpl ? m_backendImpl->DisposeBuffers() : ASE_OK;
+    std::lock_guard<std::mutex> lock(m_controlLock);
+    // 링 메모리를 해제하므로 렌더 엔진이 링에서 손을 떼게 함 (stop 없이 호출된 경우)
+    m_renderer.Stop();
+    m_outputs.Stop();
+    if (m_recorder.IsRunning()) {
+        RecorderStats stats = m_recorder.GetStats();
+        m_recorder.Stop();
+        DebugLog("[DeltaCast] Recorder Stopped. Frames: %llu, Dropped: %llu\n", stats.framesWritten, stats.framesDropped);
+    }
+    if (m_replay.IsRunning()) {
+        ReplayStats stats = m_replay.GetStats();
+        m_replay.Stop();
+        DebugLog("[DeltaCast] Replay Stopped. Retained: %.1f s, %llu / %llu bytes, Clips: %u (Rejected %u), Dropped: %llu frames\n",
+            stats.retainedSeconds, stats.compressedBytes, stats.rawBytes, stats.clipsSaved, stats.clipsRejected, stats.droppedFrames);
+    }
+    if (m_meter.IsRunning()) {
+        DeltaCastIpc::MeterSnapshot snapshot;
+        if (m_meter.GetSnapshot(snapshot)) {
+            DebugLog("[DeltaCast] Meter Stopped. Integrated: %.1f LUFS, True Peak: %.1f / %.1f dBTP\n",
+                snapshot.integratedLufs, snapshot.truePeakDb[0], snapshot.truePeakDb[1]);
+        }
+        m_meter.Stop();
+    }
+    if (m_autoLatency.enabled) {
+        DebugLog("[DeltaCast] Auto Latency: %.2f ms\n", m_renderer.GetAutoLatencyMs());
+    }
+    RenderEngineStats renderStats = m_renderer.GetStats();
+    DebugLog("[DeltaCast] Output Glitches: %llu, Reconnects: %u (Last %.1f ms)%s\n", renderStats.glitches,
+        renderStats.reconnects, renderStats.lastReconnectMs, renderStats.usingFallback ? ", Default Fallback" : "");
+    DebugLog("[DeltaCast] Render Load: %.2f%% (Peak %.2f%%), Silent Periods: %llu\n",
+        renderStats.cpuLoad * 100.0, renderStats.cpuPeak * 100.0, renderStats.silentPeriods);
+    DebugLog("[DeltaCast] Host Stalls: %u (Last %.1f ms, Longest %.1f ms)\n",
+        renderStats.stalls, renderStats.lastStallMs, renderStats.longestStallMs);
+    for (size_t i = 0; i < renderStats.effects && i < m_effectSettings.size(); i++) {
+        DebugLog("[DeltaCast] Effect %zu (%s): Load %.2f%% (Peak %.2f%%)\n", i + 1,
+            EffectTypeName(m_effectSettings[i].type), renderStats.effectLoad[i] * 100.0, renderStats.effectPeak[i] * 100.0);
+    }
+    if (renderStats.effects > 0) DebugLog("[DeltaCast] Effect Latency: %zu frames\n", renderStats.effectLatencyFrames);
+    m_outputs.LogStats();
+    m_ipcWriter.Close();
+    AsioCallbackSlots::Release(m_callbackSlot);
+    m_callbackSlot = -1;
+    ASIOError result = m_backendImpl ? m_backendImpl->DisposeBuffers() : ASE_OK;
+    m_bufferInfos = nullptr;
+    m_outIndexL = -1;
+    if (m_arena.IsCommitted()) {
+        DebugLog("[DeltaCast] Session Memory: %zu KB (Stream %zu KB, Render Scratch %zu KB)\n",
+            (m_arena.GetCommittedBytes() + renderStats.scratchBytes) >> 10, m_arena.GetCommittedBytes() >> 10, renderStats.scratchBytes >> 10);
+    }
+    if (m_backendImpl) ReleaseStreamArena();
+    // 실시간 경로 위반 보고 (DELTA_RT_CHECK 빌드): 위반이 있으면 호스트에 실패로 알림
+    uint64_t rtViolations = RT_CHECK_REPORT();
+    if (rtViolations > 0) {
+        DebugLog("[DeltaCast] Error: %llu Real-Time Violations\n", (unsigned long long)rtViolations);
+        if (result == ASE_OK) result = ASE_HWMalfunction;
+    }
+    return result;
 }
 // ---------------------------------------------------------------------------
 // 오디오 처리
 // ---------------------------------------------------------------------------
 void CDeltaCastDriver::TriggerBufferSwitch(long index) {
-    // 호스트 콜백
+    RT_SCOPE("TriggerBufferSwitch");
+    // 호스트 콜백 (호스트 코드는 검사 제외)
     if (m_hostCallbacks.bufferSwitch) {
+        RT_EXTERNAL();
         m_hostCallbacks.bufferSwitch(index, ASIOFalse);
     }
     // 오디오 복제 및 변환
     CopyAudioToRingBuffer(index);
 }
 
-// 정적 래퍼들
-void CDeltaCastDriver::bufferSwitch(long index, ASIOBool directProcess) {
-    if (g_pThis) g_pThis->TriggerBufferSwitch(index);
+// 콜백 (슬롯 썽크 -> 인스턴스)
+void CDeltaCastDriver::OnBufferSwitch(long index, ASIOBool directProcess) {
+    TriggerBufferSwitch(index);
 }
-ASIOTime* CDeltaCastDriver::bufferSwitchTimeInfo(ASIOTime* timeInfo, long index, ASIOBool processNow) {
+ASIOTime* CDeltaCastDriver::OnBufferSwitchTimeInfo(ASIOTime* timeInfo, long index, ASIOBool processNow) {
+    RT_SCOPE("BufferSwitchTimeInfo");
     ASIOTime* result = nullptr;
-    if (g_pThis) {
-        if (g_pThis->m_hostCallbacks.bufferSwitchTimeInfo)
-            result = g_pThis->m_hostCallbacks.bufferSwitchTimeInfo(timeInfo, index, processNow);
-        g_pThis->CopyAudioToRingBuffer(index);
+    if (m_hostCallbacks.bufferSwitchTimeInfo) {
+        RT_EXTERNAL();
+        result = m_hostCallbacks.bufferSwitchTimeInfo(timeInfo, index, processNow);
     }
+    CopyAudioToRingBuffer(index);
     return result;
 }
 
 void CDeltaCastDriver::CopyAudioToRingBuffer(long index) {
+    RT_SCOPE("CopyAudioToRingBuffer");
     if (m_outIndexL == -1 || m_lastProcessedBufferIndex == index) return;
     m_lastProcessedBufferIndex = index;
 
-    static const size_t frameSize = 4;
-    size_t bytesToCopy = m_bufferSize * frameSize;
+    // 제어 스레드 명령 (라우팅/덕킹 키 교체, 레이트 표시, 대기 없음)
+    RtCommand command;
+    while (m_callbackCommands.Pop(command)) {
+        if (command.type == CMD_SET_ROUTING) { m_outIndexL = command.a; m_outIndexR = command.b; }
+        else if (command.type == CMD_SET_DUCK_INPUT) m_duckInputIndex = command.a;
+        // 이 블록부터 새 레이트 (렌더러/녹음/리플레이/미터는 이 위치에서 전환, 공유 메모리는 새 세션)
+        else if (command.type == CMD_SET_RATE) {
+            m_loopbackBufferL.MarkRate(command.value);
+            m_ipcWriter.SetSampleRate(command.value);
+        }
+    }
+
+    size_t bytesToCopy = (size_t)m_bufferSize * GetSampleSize(m_sampleType);
+
+    // 원본 데이터 포인터 획득
+    void* pRawL = m_bufferInfos[m_outIndexL].buffers[index];
+    void* pRawR = (m_outIndexR != -1) ? m_bufferInfos[m_outIndexR].buffers[index] : nullptr;
+
+    // 블록 도착 시각 (자동 레이턴시, 정체 감시)
+    m_renderer.RecordProducerBlock((uint32_t)m_bufferSize);
+    m_outputs.RecordProducerBlock((uint32_t)m_bufferSize);
+
+    // 덕킹 키 (읽기만 함)
+    if (m_duckInputIndex != -1) {
+        float keyPeak = MeasureBlockPeak(m_sampleType, m_bufferInfos[m_duckInputIndex].buffers[index], (size_t)m_bufferSize);
+        m_gain.PushKeyPeak(keyPeak);
+        m_outputs.PushKeyPeak(keyPeak);
+    }
+
+    // 공유 메모리 (-> 외부 캡처 프로그램). 리더를 기다리지 않으므로 WASAPI 오버런과 무관
+    if (m_ipcWriter.IsOpen()) {
+        const void* channels[2] = { pRawL, pRawR ? pRawR : pRawL };
+        m_ipcWriter.Write(channels, bytesToCopy);
+    }
 
 	// 링버퍼 여유 공간 확인
     size_t available = m_loopbackBufferL.GetAvailableWrite();
@@ -355,9 +1073,10 @@ void CDeltaCastDriver::CopyAudioToRingBuffer(long index) {
         return;
     }
 
-    // 원본 데이터 포인터 획득
-    void* pRawL = m_bufferInfos[m_outIndexL].buffers[index];
-    void* pRawR = (m_outIndexR != -1) ? m_bufferInfos[m_outIndexR].buffers[index] : nullptr;
+    // 무음 블록 표시 (렌더 측이 변환/리샘플을 건너뜀). 유음 블록은 끝 위치를 Push 전에 공개
+    if (!IsBlockSilent(m_sampleType, pRawL, bytesToCopy) || (pRawR && !IsBlockSilent(m_sampleType, pRawR, bytesToCopy))) {
+        m_loopbackBufferL.MarkAudible(bytesToCopy);
+    }
 
     // 링버퍼 (-> WASAPI)
     m_loopbackBufferL.Push(pRawL, bytesToCopy);
@@ -373,7 +1092,7 @@ ASIOError CDeltaCastDriver::getSampleRate(ASIOSampleRate* rate) {
 }
 ASIOError CDeltaCastDriver::setSampleRate(ASIOSampleRate rate) {
     ASIOError err = m_backendImpl ? m_backendImpl->SetSampleRate(rate) : ASE_NotPresent;
-    if (err == ASE_OK) m_sampleRate = rate;
+    if (err == ASE_OK) OnStreamRateChanged(rate);
     return err;
 }
 ASIOError CDeltaCastDriver::getChannels(long* in, long* out) {
@@ -405,7 +1124,13 @@ void CDeltaCastDriver::getErrorMessage(char* string) {
     else strcpy_s(string, 32, "No Backend");
 }
 ASIOError CDeltaCastDriver::getLatencies(long* inputLatency, long* outputLatency) {
-    return m_backendImpl ? m_backendImpl->GetLatencies(inputLatency, outputLatency) : ASE_NotPresent;
+    if (!m_backendImpl) return ASE_NotPresent;
+    ASIOError result = m_backendImpl->GetLatencies(inputLatency, outputLatency);
+    // 가상 모드는 출력이 곧 송출이므로 리미터 룩어헤드를 포함
+    if (result == ASE_OK && m_isVirtualMode && m_limiterSettings.enabled) {
+        *outputLatency += (long)Limiter::LatencyFramesFor(m_limiterSettings, m_sampleRate);
+    }
+    return result;
 }
 
 ASIOError CDeltaCastDriver::canSampleRate(ASIOSampleRate sampleRate) {
@@ -433,12 +1158,27 @@ ULONG STDMETHODCALLTYPE CDeltaCastDriver::Release() {
 }
 
 
-// 정적 콜백들
-void CDeltaCastDriver::sampleRateChanged(ASIOSampleRate sRate) {
-    if (g_pThis && g_pThis->m_hostCallbacks.sampleRateDidChange) g_pThis->m_hostCallbacks.sampleRateDidChange(sRate);
+void CDeltaCastDriver::OnSampleRateChanged(ASIOSampleRate sRate) {
+    // 하드웨어 클럭 변경 (프록시 모드). 이후 블록은 새 레이트
+    OnStreamRateChanged(sRate);
+    if (m_hostCallbacks.sampleRateDidChange) m_hostCallbacks.sampleRateDidChange(sRate);
+}
+
+// 재생 중 레이트 변경: 다음 호스트 블록 위치에 표시 (렌더러/추가 출력이 그 샘플에서 비율 전환)
+// 제어 잠금을 잡지 않음 (하드웨어 드라이버가 setSampleRate 안에서 통지할 수 있음)
+void CDeltaCastDriver::OnStreamRateChanged(ASIOSampleRate rate) {
+    if (rate <= 0.0) return;
+    ASIOSampleRate previous = m_sampleRate.exchange(rate);
+    if (previous == rate) return;
+    DebugLog("[DeltaCast] Sample Rate %.1f -> %.1f Hz%s\n", previous, rate, m_bufferInfos ? " (Live)" : "");
+    if (!m_bufferInfos) return;
+    RtCommand command;
+    command.type = CMD_SET_RATE;
+    command.value = rate;
+    m_callbackCommands.Post(command);
 }
-long CDeltaCastDriver::asioMessage(long selector, long value, void* message, double* opt) {
-    if (g_pThis && g_pThis->m_hostCallbacks.asioMessage) return g_pThis->m_hostCallbacks.asioMessage(selector, value, message, opt);
+long CDeltaCastDriver::OnAsioMessage(long selector, long value, void* message, double* opt) {
+    if (m_hostCallbacks.asioMessage) return m_hostCallbacks.asioMessage(selector, value, message, opt);
     return 0;
 }
 
@@ -7,25 +7,63 @@
 #include <atomic>
 #include <memory>
 #include <chrono>
+#include <mutex>
 
 #include "RingBuffer.h"
 #include "DriverBackend.h"
-#include "WasapiRenderer.h"
+#include "RenderEngine.h"
 #include "Resampler.h"
+#include "WavRecorder.h"
+#include "ReplayBuffer.h"
+#include "LoudnessMeter.h"
+#include "DeltaCastIpc.h"
+#include "AsioCallbackSlots.h"
+#include "VirtualMixServer.h"
+#include "CommandQueue.h"
+#include "ConfigWatcher.h"
+#include "AudioArena.h"
+#include "OutputGroup.h"
+#include "ThreadPlacement.h"
 
 namespace Config {
-	// 링버퍼 크기: 64KB 
+	// 믹스 서버 링버퍼 크기: 128KB (드라이버 송출 링은 레이턴시 설정으로 계산)
     const size_t RING_BUFFER_SIZE = 131072;
 
+    // 송출 링 최소 크기 / 최대 레이턴시 외 호스트 블록 여유
+    const size_t RING_MIN_SIZE = 32768;
+    const size_t RING_HEADROOM_BLOCKS = 8;
+
+    // 가상 장치 채널 수 상한 (출력/입력 각각)
+    const long MAX_VIRTUAL_CHANNELS = 32;
+
     // 가상 모드 타임아웃 (20ms)
     const auto VIRTUAL_TIMEOUT = std::chrono::milliseconds(20);
 
     // 클럭 제어 범위 (35% ~ 65%)
+    // 페이싱 윈도우(레이턴시 임계값의 2배) 기준 비율
     const double BUFFER_TARGET_LOW = 0.35;
     const double BUFFER_TARGET_HIGH = 0.65;
+
+    // 페이싱 목표 기본값 (밴드 중앙)
+    const double BUFFER_TARGET_DEFAULT = 0.5;
 }
 
-class CDeltaCastDriver : public IASIO {
+// 실행 중 변경 가능한 설정 (INI 수정 시 다시 읽어 적용)
+struct RuntimeSettings {
+    double latencyMs = 21.0;           // 고정 재생 임계값 (자동 모드에서는 시작값)
+    AutoLatencySettings autoLatency;
+    bool concealment = true;           // 언더런 은닉 (페이드/크로스페이드)
+    std::wstring wasapiId;
+    double gainDb[2] = { 0.0, 0.0 };
+    bool mute = false;
+    DuckingSettings ducking;
+    LimiterSettings limiter;
+    std::vector<EffectSettings> effects; // 송출 이펙트 체인 ([Effects] Enabled=0 이면 비움)
+    long outputLeft = -1;  // 송출 ASIO 출력 채널 번호 (-1: 첫 번째 출력)
+    long outputRight = -1; // (-1: 두 번째 출력)
+};
+
+class CDeltaCastDriver : public IASIO, public IAsioCallbackTarget {
 public:
     CDeltaCastDriver();
     virtual ~CDeltaCastDriver();
@@ -57,22 +95,32 @@ public:
     virtual ULONG STDMETHODCALLTYPE AddRef() override;
     virtual ULONG STDMETHODCALLTYPE Release() override;
 
-    // --- 전역 접근 포인터 ---
-    static CDeltaCastDriver* g_pThis;
-
-	// --- 송출 버퍼 ---
-	ByteRingBuffer m_loopbackBufferL{ Config::RING_BUFFER_SIZE };
-    ByteRingBuffer m_loopbackBufferR{ Config::RING_BUFFER_SIZE };
+	// --- 송출 버퍼 (createBuffers 에서 스트림 아레나에 연결) ---
+	ByteRingBuffer m_loopbackBufferL{ 0 };
+    ByteRingBuffer m_loopbackBufferR{ 0 };
 
 	// --- 버퍼 스위치 트리거 ---
     void TriggerBufferSwitch(long doubleBufferIndex);
 
+    // 재생 시작 임계값: 시간 목표를 현재 스트림 레이트로 환산 (프레임 / 샘플 포맷 바이트)
+    // 자동 모드에서 렌더러가 동작 중이면 렌더러가 고른 값
+    size_t GetLatencyFrames() const;
+    size_t GetLatencyThreshold() const;
+
     friend class VirtualBackend;
     friend class ProxyBackend;
+    friend class CVirtualMixServer;
 
 private:
     // --- 설정 ---
     void LoadConfiguration();
+    static RuntimeSettings ReadRuntimeSettings(const std::wstring& configPath);
+    static ThreadPlacementSettings ReadThreadPlacement(const std::wstring& configPath);
+    bool ApplyRuntimeSettings(const RuntimeSettings& settings, bool live);
+    void OnConfigChanged();
+    void OnStreamRateChanged(ASIOSampleRate rate);
+    void FindRouting(long& indexL, long& indexR) const;
+    long FindDuckInput() const;
 
     // 실제 동작을 담당할 전략 객체
     std::unique_ptr<IDriverBackend> m_backendImpl;
@@ -82,25 +130,72 @@ private:
 
     int GetSampleSize(ASIOSampleType type);
 
+    // 스트림 메모리 (링, 가상 호스트 버퍼를 한 아레나에)
+    size_t ComputeRingBytes() const;
+    bool BuildStreamArena();
+    void ReleaseStreamArena();
+    CAudioArena m_arena;
+    ArenaOptions m_arenaOptions;
+
     ASIOCallbacks m_hostCallbacks;
     ASIOCallbacks m_myCallbacks;
     ASIOBufferInfo* m_bufferInfos = nullptr;
     ASIOSampleType m_sampleType = ASIOSTFloat32LSB;
-    ASIOSampleRate m_sampleRate = 48000.0;
+    std::atomic<ASIOSampleRate> m_sampleRate{ 48000.0 };   // 레이트 통지 스레드에서 갱신, 클럭 스레드가 읽음
     long m_numChannels = 0;
     long m_bufferSize = 0;
     long m_outIndexL = -1;
     long m_outIndexR = -1;
     long m_lastProcessedBufferIndex = -1;
 
-    // WASAPI 렌더러
-    CWasapiRenderer m_renderer;
-
-    // --- ASIO 표준 함수 ---
-    static void bufferSwitch(long doubleBufferIndex, ASIOBool directProcess);
-    static ASIOTime* bufferSwitchTimeInfo(ASIOTime* timeInfo, long index, ASIOBool processNow);
-    static void sampleRateChanged(ASIOSampleRate sRate);
-    static long asioMessage(long selector, long value, void* message, double* opt);
+    // 콜백 명령 (제어 스레드 -> 버퍼 스위치)
+    enum CallbackCommand : uint32_t {
+        CMD_SET_ROUTING = 1,
+        CMD_SET_DUCK_INPUT,
+        CMD_SET_RATE,       // value: 새 샘플 레이트
+    };
+    ControlQueue m_callbackCommands;
+
+    // 설정 파일 감시 / 제어 경로 직렬화 (호스트 스레드와 감시 스레드)
+    std::wstring m_configPath;
+    CConfigWatcher m_configWatcher;
+    std::mutex m_controlLock;
+
+    // 렌더 엔진 (출력 싱크 구동, 장치 소실 시 자동 복구)
+    CRenderEngine m_renderer;
+    // 추가 출력 (같은 송출을 다른 장치/레이트로, 믹스 모드 제외)
+    COutputGroup m_outputs;
+
+    // 송출 녹음
+    CWavRecorder m_recorder;
+    void StartRecorder();
+
+    // 인스턴트 리플레이
+    CReplayBuffer m_replay;
+    void StartReplay();
+
+    // 송출 게인/뮤트/덕킹 (렌더 스레드 또는 믹스 서버에서 적용)
+    GainStage m_gain;
+    DuckingSettings m_duckSettings;
+    long m_duckInputIndex = -1; // 키 입력의 버퍼 인덱스
+
+    // 라우드니스 미터
+    CLoudnessMeter m_meter;
+    void StartMeter();
+
+    // 공유 메모리 송출
+    DeltaCastIpc::Writer m_ipcWriter;
+    void StartIpc();
+
+    // 출력 싱크 (INI [Output] Sink)
+    std::unique_ptr<IOutputSink> CreateOutputSink() const;
+
+    // --- ASIO 콜백 (인스턴스별 슬롯 썽크에서 호출) ---
+    void OnBufferSwitch(long doubleBufferIndex, ASIOBool directProcess) override;
+    ASIOTime* OnBufferSwitchTimeInfo(ASIOTime* timeInfo, long index, ASIOBool processNow) override;
+    void OnSampleRateChanged(ASIOSampleRate sRate) override;
+    long OnAsioMessage(long selector, long value, void* message, double* opt) override;
+    int m_callbackSlot = -1;
 
     // COM 참조 카운트
     std::atomic<ULONG> m_refCount{ 1 };
@@ -109,7 +204,51 @@ private:
     CLSID m_targetClsid = { 0 };
     std::wstring m_targetWasapiId;
     bool m_isVirtualMode = false;
-
-	// 레이턴시 모드 (기본: 1)
-    int m_latencyMode = 1;
+    bool m_sinkClocked = false;
+    bool m_virtualMix = false; // 가상 모드 다중 클라이언트 믹스
+    long m_virtualOutputs = 2;  // 가상 장치 출력 채널 수
+    long m_virtualInputs = 0;   // 가상 장치 루프백 입력 채널 수
+
+	// 레이턴시 목표 (ms, 가상 클럭 스레드가 임계값 변경 감지)
+    std::atomic<double> m_latencyMs{ 21.0 };
+    AutoLatencySettings m_autoLatency;
+    bool m_concealment = true;
+
+    // 송출 채널 (ASIO 채널 번호, -1: 자동)
+    long m_routeLeft = -1;
+    long m_routeRight = -1;
+
+    // 가상 클럭 페이싱 목표 (페이싱 윈도우 대비 비율)
+    double m_pacingTarget = Config::BUFFER_TARGET_DEFAULT;
+
+    // 녹음 설정
+    bool m_recordEnabled = false;
+    std::wstring m_recordDirectory;
+    WavSampleFormat m_recordFormat = WavSampleFormat::Float32;
+    WavContainer m_recordContainer = WavContainer::Wav;
+
+    // 리플레이 설정
+    bool m_replayEnabled = false;
+    size_t m_replayMemoryBytes = 64u << 20;
+    double m_replaySeconds = 120.0;
+
+    // 미터 설정
+    bool m_meterEnabled = false;
+
+    // 출력단 리미터 / 이펙트 체인 설정
+    LimiterSettings m_limiterSettings;
+    std::vector<EffectSettings> m_effectSettings;
+
+    // 공유 메모리 송출 설정
+    bool m_ipcEnabled = false;
+    size_t m_ipcRingBytes = 256u << 10;
+
+    // 출력 싱크 설정
+    SinkType m_sinkType = SinkType::Wasapi;
+    std::wstring m_sinkFilePath;
+
+    // 로그 설정 (기록 스레드는 프로세스 공용, 인스턴스별 참조)
+    bool m_logEnabled = true;
+    std::wstring m_logPath;
+    bool m_logStarted = false;
 };
\ No newline at end of file
@@ -0,0 +1,576 @@
+﻿#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// 공유 메모리 송출 (IPC)
+// 명명된 공유 메모리에 채널별 락프리 링 + 버전 헤더를 두고
+// 다른 프로세스가 매핑해 복사 없이 읽음. 쓰기측은 리더를 기다리지 않음
+//
+// 레이아웃: [Header (HEADER_BYTES)] [ch0 ring] [ch1 ring] ...
+// 샘플은 ASIO 원본 포맷 그대로 (sampleType/sampleSize 참고)
+//
+// 슬롯: 쓰기측마다 이름이 다름 (0: SHM_NAME, 1: SHM_NAME_2, ...)
+// 쓰기측은 살아 있는 다른 쓰기측이 없는 첫 슬롯을 씀 (소유 표시는 프로세스가 죽으면 OS 가 해제)
+// 깨우기: 대기 중인 리더 모두 (Windows 세마포어에 대기 수만큼 / Linux futex 전체)
+//
+// 리더 사용 예:
+//   DeltaCastIpc::Reader reader;
+//   if (reader.Open()) {                              // 슬롯 0 (드라이버 로그의 Slot 값)
+//       DeltaCastIpc::Span span;
+//       while (reader.Wait(100)) {
+//           size_t bytes = reader.Peek(0, 4096, span); // span.data[0..1] 직접 읽기
+//           ...
+//           if (!reader.Consume(bytes)) { /* 읽는 중 덮어써짐 */ }
+//       }
+//   }
+// ---------------------------------------------------------------------------
+namespace DeltaCastIpc {
+    const uint32_t MAGIC = 0x50494344; // "DCIP"
+    const uint32_t VERSION = 2;        // 2: 슬롯 이름, 세마포어 깨우기
+    const uint32_t HEADER_BYTES = 4096;
+    const uint32_t MAX_CHANNELS = 8;
+    const uint32_t MAX_SLOTS = 8;      // 동시에 게시할 수 있는 쓰기측 수
+    const long MAX_WAKE_COUNT = 64;    // 세마포어 최대값 (대기 리더 수 상한)
+
+#ifdef _WIN32
+    typedef std::wstring NameString;
+    const wchar_t* const SHM_NAME = L"Local\\DeltaCast_Loopback";
+    const wchar_t* const METER_NAME = L"Local\\DeltaCast_Meter";
+    inline NameString SlotName(const wchar_t* base, uint32_t slot, const wchar_t* suffix = L"") {
+        NameString name = base;
+        if (slot > 0) name += L"_" + std::to_wstring(slot + 1);
+        return name + suffix;
+    }
+#else
+    typedef std::string NameString;
+    const char* const SHM_NAME = "/DeltaCast_Loopback";
+    const char* const METER_NAME = "/DeltaCast_Meter";
+    inline NameString SlotName(const char* base, uint32_t slot, const char* suffix = "") {
+        NameString name = base;
+        if (slot > 0) name += "_" + std::to_string(slot + 1);
+        return name + suffix;
+    }
+#endif
+
+    struct Header {
+        // --- 세션 시작 시 기록 (불변) ---
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerBytes;
+        uint32_t channels;
+        int32_t sampleType;  // ASIOSampleType
+        uint32_t sampleSize; // 바이트
+        std::atomic<double> sampleRate; // 재생 중 레이트가 바뀌면 갱신 (sessionId 증가)
+        uint64_t ringBytes;  // 채널당 링 크기 (2의 거듭제곱)
+
+        // --- 쓰기측 갱신 ---
+        alignas(64) std::atomic<uint64_t> writeIndex;  // 채널당 누적 바이트
+        std::atomic<uint64_t> writeTimeNs;             // 마지막 쓰기 시각 (모노토닉 ns)
+        std::atomic<uint32_t> sessionId;               // 포맷이 바뀔 때마다 증가
+
+        // --- 깨우기 ---
+        alignas(64) std::atomic<uint32_t> wakeSeq;     // 쓰기마다 증가 (futex 워드)
+        std::atomic<uint32_t> readersWaiting;          // 대기 중인 리더 수
+    };
+    static_assert(sizeof(Header) <= HEADER_BYTES, "Header too large");
+
+    // 프로세스 간 비교 가능한 모노토닉 시각
+    inline uint64_t NowNs() {
+#ifdef _WIN32
+        static LARGE_INTEGER freq = { 0 };
+        if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+    }
+
+    // 진행 중인 쓰기와 겹치지 않도록 확보하는 여유분 (링의 1/4)
+    inline uint64_t SafeSpan(uint64_t ringBytes) { return ringBytes - ringBytes / 4; }
+
+    // -----------------------------------------------------------------------
+    // 명명된 공유 메모리 한 구역
+    // 생성측은 슬롯 소유 표시를 함께 잡음 (Windows: 이름 있는 뮤텍스 핸들, Linux: flock)
+    // 리더는 소유 표시를 건드리지 않으므로 남아 있는 매핑만으로 슬롯이 막히지 않음
+    // -----------------------------------------------------------------------
+    class SharedRegion {
+    public:
+        SharedRegion() = default;
+        SharedRegion(const SharedRegion&) = delete;
+        SharedRegion& operator=(const SharedRegion&) = delete;
+        ~SharedRegion() { Close(); }
+
+        // 살아 있는 쓰기측이 없는 첫 슬롯에 생성. 기존 매핑이 남아 있으면 재사용 (내용은 호출측이 초기화)
+        bool CreateFirstFree(const NameString::value_type* baseName, size_t bytes) {
+            Close();
+            for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+                if (CreateAt(SlotName(baseName, slot), bytes)) { m_slot = (int)slot; return true; }
+            }
+            return false;
+        }
+
+        // 읽기측. 매핑 크기는 실제 구역 크기 (헤더 검증용)
+        bool Open(const NameString::value_type* baseName, uint32_t slot) {
+            Close();
+            NameString name = SlotName(baseName, slot);
+#ifdef _WIN32
+            m_hMap = OpenFileMappingW(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, name.c_str());
+            if (!m_hMap) return false;
+            m_base = (uint8_t*)MapViewOfFile(m_hMap, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0);
+            MEMORY_BASIC_INFORMATION info;
+            if (m_base && VirtualQuery(m_base, &info, sizeof(info)) == sizeof(info)) m_size = info.RegionSize;
+#else
+            int fd = shm_open(name.c_str(), O_RDWR, 0);
+            if (fd < 0) return false;
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); return false; }
+            void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            m_base = (p == MAP_FAILED) ? nullptr : (uint8_t*)p;
+            m_size = (size_t)st.st_size;
+#endif
+            if (!m_base || m_size == 0) { Close(); return false; }
+            m_slot = (int)slot;
+            return true;
+        }
+
+        void Close() {
+#ifdef _WIN32
+            if (m_base) UnmapViewOfFile(m_base);
+            if (m_hMap) CloseHandle(m_hMap);
+            if (m_hOwner) CloseHandle(m_hOwner);
+            m_hMap = m_hOwner = nullptr;
+#else
+            if (m_base) munmap(m_base, m_size);
+            if (m_ownerFd >= 0) close(m_ownerFd); // flock 해제
+            m_ownerFd = -1;
+#endif
+            m_base = nullptr;
+            m_size = 0;
+            m_slot = -1;
+        }
+
+        uint8_t* Data() const { return m_base; }
+        size_t Size() const { return m_size; }
+        int Slot() const { return m_slot; }
+
+    private:
+        bool CreateAt(const NameString& name, size_t bytes) {
+#ifdef _WIN32
+            // 소유 표시: 이미 있으면 다른 쓰기측이 핸들을 쥐고 있음 (프로세스가 죽으면 사라짐)
+            m_hOwner = CreateMutexW(nullptr, FALSE, (name + L"_Owner").c_str());
+            if (!m_hOwner) return false;
+            if (GetLastError() == ERROR_ALREADY_EXISTS) { CloseHandle(m_hOwner); m_hOwner = nullptr; return false; }
+            m_hMap = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                (DWORD)((uint64_t)bytes >> 32), (DWORD)(bytes & 0xFFFFFFFF), name.c_str());
+            // 리더가 쥐고 있는 이전 매핑이 더 작으면 매핑 실패 -> 다음 슬롯
+            if (m_hMap) m_base = (uint8_t*)MapViewOfFile(m_hMap, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+#else
+            int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+            if (fd < 0) return false;
+            // 소유 표시: 같은 프로세스의 다른 인스턴스도 별도 열기라 충돌로 잡힘
+            if (flock(fd, LOCK_EX | LOCK_NB) != 0) { close(fd); return false; }
+            // 줄이지는 않음 (예전 크기로 매핑한 리더가 잘린 영역을 읽지 않도록)
+            struct stat st;
+            if (fstat(fd, &st) != 0 || ((uint64_t)st.st_size < bytes && ftruncate(fd, (off_t)bytes) != 0)) { close(fd); return false; }
+            m_ownerFd = fd;
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            m_base = (p == MAP_FAILED) ? nullptr : (uint8_t*)p;
+#endif
+            if (!m_base) { Close(); return false; }
+            m_size = bytes;
+            return true;
+        }
+
+        uint8_t* m_base = nullptr;
+        size_t m_size = 0;
+        int m_slot = -1;
+#ifdef _WIN32
+        HANDLE m_hMap = nullptr;
+        HANDLE m_hOwner = nullptr;
+#else
+        int m_ownerFd = -1;
+#endif
+    };
+
+    // -----------------------------------------------------------------------
+    // 쓰기측 (드라이버)
+    // -----------------------------------------------------------------------
+    class Writer {
+    public:
+        ~Writer() { Close(); }
+
+        bool Create(uint32_t channels, int32_t sampleType, uint32_t sampleSize, double sampleRate, uint64_t ringBytes) {
+            Close();
+            if (channels == 0 || channels > MAX_CHANNELS || ringBytes == 0 || (ringBytes & (ringBytes - 1)) != 0) return false;
+
+            size_t total = HEADER_BYTES + (size_t)ringBytes * channels;
+            if (!m_region.CreateFirstFree(SHM_NAME, total)) return false;
+            m_base = m_region.Data();
+#ifdef _WIN32
+            m_hWake = CreateSemaphoreW(nullptr, 0, MAX_WAKE_COUNT, SlotName(SHM_NAME, (uint32_t)m_region.Slot(), L"_Wake").c_str());
+#endif
+
+            // 이 슬롯의 쓰기측은 이제 자신뿐 (남은 매핑은 죽은 쓰기측 또는 리더가 쥔 것)
+            Header* h = GetHeader();
+            // 기존 리더가 세션 변경을 감지하도록 sessionId 는 이어서 증가
+            uint32_t session = (h->magic == MAGIC) ? h->sessionId.load() + 1 : 1;
+            h->magic = 0;
+            std::atomic_thread_fence(std::memory_order_release);
+            h->version = VERSION;
+            h->headerBytes = HEADER_BYTES;
+            h->channels = channels;
+            h->sampleType = sampleType;
+            h->sampleSize = sampleSize;
+            h->sampleRate.store(sampleRate, std::memory_order_relaxed);
+            h->ringBytes = ringBytes;
+            h->writeIndex.store(0, std::memory_order_relaxed);
+            h->writeTimeNs.store(0, std::memory_order_relaxed);
+            h->wakeSeq.store(0, std::memory_order_relaxed);
+            h->readersWaiting.store(0, std::memory_order_relaxed);
+            h->sessionId.store(session, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            h->magic = MAGIC;
+            m_mask = ringBytes - 1;
+            return true;
+        }
+
+        void Close() {
+#ifdef _WIN32
+            if (m_hWake) CloseHandle(m_hWake);
+            m_hWake = nullptr;
+#endif
+            m_region.Close();
+            m_base = nullptr;
+        }
+
+        bool IsOpen() const { return m_base != nullptr; }
+        Header* GetHeader() const { return (Header*)m_base; }
+        // 리더가 열 슬롯 (-1: 열리지 않음)
+        int GetSlot() const { return m_region.Slot(); }
+
+        // 재생 중 레이트 변경 (실시간 스레드, 다음 Write 부터 새 레이트)
+        // 리더는 세션 변경으로 감지해 현재 쓰기 위치부터 다시 읽음
+        void SetSampleRate(double sampleRate) {
+            if (!m_base) return;
+            Header* h = GetHeader();
+            h->sampleRate.store(sampleRate, std::memory_order_relaxed);
+            h->sessionId.fetch_add(1, std::memory_order_release);
+        }
+
+        // 실시간 스레드에서 호출. 채널별 numBytes 기록 후 커서 공개
+        void Write(const void* const* channelData, size_t numBytes) {
+            if (!m_base) return;
+            Header* h = GetHeader();
+            if (numBytes > h->ringBytes / 4) return; // 한 번에 링의 1/4 까지
+
+            uint64_t w = h->writeIndex.load(std::memory_order_relaxed);
+            size_t offset = (size_t)(w & m_mask);
+            size_t toEnd = (size_t)h->ringBytes - offset;
+            for (uint32_t c = 0; c < h->channels; c++) {
+                uint8_t* ring = m_base + HEADER_BYTES + (size_t)h->ringBytes * c;
+                const uint8_t* src = (const uint8_t*)channelData[c];
+                if (numBytes <= toEnd) {
+                    memcpy(ring + offset, src, numBytes);
+                }
+                else {
+                    memcpy(ring + offset, src, toEnd);
+                    memcpy(ring, src + toEnd, numBytes - toEnd);
+                }
+            }
+            h->writeTimeNs.store(NowNs(), std::memory_order_relaxed);
+            h->writeIndex.store(w + numBytes, std::memory_order_release);
+            // 리더의 대기 등록과 순서 보장 (seq_cst: 둘 다 놓치는 경우 없음)
+            h->wakeSeq.fetch_add(1, std::memory_order_seq_cst);
+
+            // 대기 중인 리더가 있을 때만 시스템 콜, 대기 중인 리더 모두 깨움
+            uint32_t waiting = h->readersWaiting.load(std::memory_order_seq_cst);
+            if (waiting > 0) {
+#ifdef _WIN32
+                if (m_hWake) ReleaseSemaphore(m_hWake, (LONG)((waiting < (uint32_t)MAX_WAKE_COUNT) ? waiting : MAX_WAKE_COUNT), nullptr);
+#else
+                syscall(SYS_futex, &h->wakeSeq, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+            }
+        }
+
+    private:
+        SharedRegion m_region;
+        uint8_t* m_base = nullptr;
+        uint64_t m_mask = 0;
+#ifdef _WIN32
+        HANDLE m_hWake = nullptr;
+#endif
+    };
+
+    // -----------------------------------------------------------------------
+    // 읽기측 (캡처 프로그램)
+    // 헤더 값은 Resync 에서 매핑 크기와 대조해 보관 (이후 헤더가 바뀌어도 매핑 밖을 읽지 않음)
+    // -----------------------------------------------------------------------
+    struct Span {
+        const uint8_t* data[2]; // 링 끝에서 나뉠 수 있음
+        size_t bytes[2];
+    };
+
+    class Reader {
+    public:
+        ~Reader() { Close(); }
+
+        bool Open(uint32_t slot = 0) {
+            Close();
+            if (!m_region.Open(SHM_NAME, slot) || m_region.Size() < sizeof(Header)) { Close(); return false; }
+            m_base = m_region.Data();
+#ifdef _WIN32
+            m_hWake = OpenSemaphoreW(SYNCHRONIZE, FALSE, SlotName(SHM_NAME, slot, L"_Wake").c_str());
+#endif
+            if (!Resync()) { Close(); return false; }
+            return true;
+        }
+
+        void Close() {
+#ifdef _WIN32
+            if (m_hWake) CloseHandle(m_hWake);
+            m_hWake = nullptr;
+#endif
+            m_region.Close();
+            m_base = nullptr;
+            m_valid = false;
+        }
+
+        const Header* GetHeader() const { return (const Header*)m_base; }
+        // 현재 세션의 헤더가 매핑 안에 맞는지 (아니면 읽을 것이 없음)
+        bool IsValid() const { return m_valid; }
+        uint32_t GetChannels() const { return m_valid ? m_channels : 0; }
+
+        // 세션이 바뀌었으면(포맷 변경/재시작) 헤더를 다시 검증하고 최신 위치로 맞춤
+        bool Resync() {
+            const Header* h = GetHeader();
+            m_valid = false;
+            if (!h) return false;
+            m_session = h->sessionId.load(std::memory_order_acquire);
+            if (h->magic != MAGIC || h->version != VERSION) return false;
+            uint64_t headerBytes = h->headerBytes;
+            uint64_t channels = h->channels;
+            uint64_t ringBytes = h->ringBytes;
+            uint64_t size = m_region.Size();
+            // headerBytes + channels * ringBytes <= 매핑 크기 (곱셈 넘침 없이)
+            if (headerBytes < sizeof(Header) || headerBytes > size) return false;
+            if (channels == 0 || channels > MAX_CHANNELS) return false;
+            if (ringBytes == 0 || (ringBytes & (ringBytes - 1)) != 0 || ringBytes > (size - headerBytes) / channels) return false;
+            m_headerBytes = (size_t)headerBytes;
+            m_channels = (uint32_t)channels;
+            m_ringBytes = ringBytes;
+            m_readIndex = h->writeIndex.load(std::memory_order_acquire);
+            m_valid = true;
+            return true;
+        }
+
+        size_t Available() {
+            const Header* h = GetHeader();
+            if (!h) return 0;
+            if (!m_valid || h->sessionId.load(std::memory_order_acquire) != m_session) {
+                if (!Resync()) return 0;
+            }
+            uint64_t w = h->writeIndex.load(std::memory_order_acquire);
+            if (w - m_readIndex > SafeSpan(m_ringBytes)) {
+                // 추월당함
+                m_dropped += w - m_readIndex;
+                m_readIndex = w;
+            }
+            return (size_t)(w - m_readIndex);
+        }
+
+        // 복사 없이 채널 ch 의 최대 maxBytes 구간을 가리킴 (ch 가 범위 밖이면 0)
+        size_t Peek(uint32_t ch, size_t maxBytes, Span& span) {
+            span.data[0] = span.data[1] = nullptr;
+            span.bytes[0] = span.bytes[1] = 0;
+            size_t avail = Available();
+            if (!m_valid || ch >= m_channels) return 0;
+            size_t n = (avail < maxBytes) ? avail : maxBytes;
+            const uint8_t* ring = m_base + m_headerBytes + (size_t)m_ringBytes * ch;
+            size_t offset = (size_t)(m_readIndex & (m_ringBytes - 1));
+            size_t toEnd = (size_t)m_ringBytes - offset;
+            span.data[0] = ring + offset;
+            span.bytes[0] = (n <= toEnd) ? n : toEnd;
+            span.data[1] = ring;
+            span.bytes[1] = n - span.bytes[0];
+            return n;
+        }
+
+        // 읽은 만큼 진행. 읽는 도중 덮어써졌거나 세션이 바뀌었으면 false (데이터 폐기)
+        bool Consume(size_t numBytes) {
+            const Header* h = GetHeader();
+            if (!m_valid || h->sessionId.load(std::memory_order_acquire) != m_session) return false;
+            uint64_t w = h->writeIndex.load(std::memory_order_acquire);
+            if (w - m_readIndex > SafeSpan(m_ringBytes)) {
+                m_dropped += w - m_readIndex;
+                m_readIndex = w;
+                return false;
+            }
+            m_readIndex += numBytes;
+            return true;
+        }
+
+        // 새 데이터가 올 때까지 최대 timeoutMs 대기 (헛깨움은 남은 시간만큼 다시 대기)
+        bool Wait(uint32_t timeoutMs) {
+            Header* h = (Header*)m_base;
+            if (!h) return false;
+            if (Available() > 0) return true;
+
+            uint64_t deadline = NowNs() + (uint64_t)timeoutMs * 1000000ull;
+            h->readersWaiting.fetch_add(1, std::memory_order_seq_cst);
+            for (;;) {
+                uint32_t seq = h->wakeSeq.load(std::memory_order_seq_cst);
+                if (Available() > 0) break;
+                uint64_t now = NowNs();
+                if (now >= deadline) break;
+                uint64_t remainNs = deadline - now;
+#ifdef _WIN32
+                DWORD remainMs = (DWORD)((remainNs + 999999) / 1000000);
+                if (m_hWake) WaitForSingleObject(m_hWake, remainMs);
+                else Sleep(1);
+                (void)seq;
+#else
+                timespec ts = { (time_t)(remainNs / 1000000000ull), (long)(remainNs % 1000000000ull) };
+                syscall(SYS_futex, &h->wakeSeq, FUTEX_WAIT, seq, &ts, nullptr, 0);
+#endif
+            }
+            h->readersWaiting.fetch_sub(1, std::memory_order_seq_cst);
+            return Available() > 0;
+        }
+
+        // 마지막 쓰기 이후 경과 시간 (송출 지연 측정용)
+        double GetAgeSeconds() const {
+            return (NowNs() - GetHeader()->writeTimeNs.load(std::memory_order_acquire)) * 1e-9;
+        }
+
+        uint64_t GetDroppedBytes() const { return m_dropped; }
+
+    private:
+        SharedRegion m_region;
+        uint8_t* m_base = nullptr;
+        bool m_valid = false;
+        size_t m_headerBytes = 0;
+        uint32_t m_channels = 0;
+        uint64_t m_ringBytes = 0;
+        uint64_t m_readIndex = 0;
+        uint64_t m_dropped = 0;
+        uint32_t m_session = 0;
+#ifdef _WIN32
+        HANDLE m_hWake = nullptr;
+#endif
+    };
+
+    // -----------------------------------------------------------------------
+    // 시퀀스 락 (쓰기 1, 읽기 다수, 대기 없음). 공유 메모리에 둘 수 있음
+    // -----------------------------------------------------------------------
+    template <typename T>
+    class SeqLock {
+        static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires trivially copyable T");
+    public:
+        void Store(const T& value) {
+            uint64_t words[WORDS] = {};
+            memcpy(words, &value, sizeof(T));
+            uint32_t seq = m_seq.load(std::memory_order_relaxed);
+            m_seq.store(seq + 1, std::memory_order_relaxed); // 홀수 = 쓰는 중
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < WORDS; i++) m_words[i].store(words[i], std::memory_order_relaxed);
+            m_seq.store(seq + 2, std::memory_order_release);
+        }
+
+        // 쓰는 중이면 재시도. 한 번도 기록되지 않았으면 false
+        bool Load(T& value) const {
+            uint64_t words[WORDS];
+            for (;;) {
+                uint32_t before = m_seq.load(std::memory_order_acquire);
+                if (before & 1) continue;
+                for (size_t i = 0; i < WORDS; i++) words[i] = m_words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_seq.load(std::memory_order_relaxed) == before) {
+                    memcpy(&value, words, sizeof(T));
+                    return before != 0;
+                }
+            }
+        }
+
+    private:
+        static const size_t WORDS = (sizeof(T) + 7) / 8;
+        std::atomic<uint32_t> m_seq{ 0 };
+        std::atomic<uint64_t> m_words[WORDS] = {};
+    };
+
+    // -----------------------------------------------------------------------
+    // 라우드니스 미터 스냅샷 (METER_NAME 공유 메모리)
+    // -----------------------------------------------------------------------
+    const double METER_FLOOR_DB = -120.0; // 무음/게이트 미달 표시값
+
+    struct MeterSnapshot {
+        double momentaryLufs;  // 400ms
+        double shortTermLufs;  // 3s
+        double integratedLufs; // 시작 이후 (BS.1770 게이팅)
+        double truePeakDb[2];  // 시작 이후 최대 (dBTP)
+        double rmsDb[2];       // 최근 400ms (가중치 없음)
+        uint64_t frames;       // 측정한 프레임 수
+        double sampleRate;
+    };
+
+    struct MeterBlock {
+        uint32_t magic;
+        uint32_t version;
+        SeqLock<MeterSnapshot> snapshot;
+    };
+
+    // 미터 게시/구독 (쓰기 1, 읽기 다수). 미터도 쓰기측마다 슬롯이 다름
+    class MeterChannel {
+    public:
+        ~MeterChannel() { Close(); }
+
+        bool Create() {
+            if (!m_region.CreateFirstFree(METER_NAME, sizeof(MeterBlock))) return false;
+            m_block = (MeterBlock*)m_region.Data();
+            m_block->version = VERSION;
+            m_block->magic = MAGIC;
+            return true;
+        }
+        bool Open(uint32_t slot = 0) {
+            if (!m_region.Open(METER_NAME, slot) || m_region.Size() < sizeof(MeterBlock)) { Close(); return false; }
+            m_block = (MeterBlock*)m_region.Data();
+            return true;
+        }
+
+        void Publish(const MeterSnapshot& snapshot) { if (m_block) m_block->snapshot.Store(snapshot); }
+        bool Read(MeterSnapshot& snapshot) const {
+            return m_block && m_block->magic == MAGIC && m_block->snapshot.Load(snapshot);
+        }
+        int GetSlot() const { return m_region.Slot(); }
+
+        void Close() {
+            m_region.Close();
+            m_block = nullptr;
+        }
+
+    private:
+        SharedRegion m_region;
+        MeterBlock* m_block = nullptr;
+    };
+}
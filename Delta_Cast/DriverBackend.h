@@ -10,6 +10,9 @@
 #include <string>
 
 #include "timer.h"
+#include "PacingController.h"
+#include "RenderEngine.h"
+#include "VirtualChannels.h"
 
 class CDeltaCastDriver;
 
@@ -40,6 +43,10 @@ public:
     // --- 버퍼 관리 ---
     virtual ASIOError CreateBuffers(ASIOBufferInfo* bufferInfos, long numChannels, long bufferSize, ASIOCallbacks* callbacks) = 0;
     virtual ASIOError DisposeBuffers() = 0;
+    // 호스트 버퍼를 드라이버 스트림 아레나에 둘 때 필요한 크기 (0: 백엔드/실제 드라이버 소유)
+    virtual size_t GetBufferStorageBytes(long numChannels, long bufferSize) const { return 0; }
+    // CreateBuffers 전에 아레나 구획 전달 (DisposeBuffers 까지 유효)
+    virtual void SetBufferStorage(void* storage) {}
 
     // 기타
     virtual ASIOError ControlPanel() { return ASE_NotPresent; }
@@ -51,44 +58,51 @@ public:
 // ---------------------------------------------------------------------------
 // 가상 백엔드 (Virtual)
 // ---------------------------------------------------------------------------
-class VirtualBackend : public IDriverBackend {
+class VirtualBackend : public IDriverBackend, public IRenderPeriodListener {
 public:
     VirtualBackend(CDeltaCastDriver* owner, double sampleRate);
     virtual ~VirtualBackend();
 
-    ASIOError Init(void* sysHandle) override { return ASE_OK; }
+    ASIOError Init(void* sysHandle) override;
 
     ASIOError Start() override;
     ASIOError Stop() override;
 
-    ASIOError GetBufferSize(long* min, long* max, long* pref, long* gran) override {
-        *min = 128; *max = 2048; *pref = 256; *gran = -1;
-        return ASE_OK;
-    }
+    ASIOError GetBufferSize(long* min, long* max, long* pref, long* gran) override;
 
     ASIOError GetSampleRate(ASIOSampleRate* sampleRate) override {
         *sampleRate = m_sampleRate; return ASE_OK;
     }
     ASIOError SetSampleRate(ASIOSampleRate sampleRate) override {
-        m_sampleRate = sampleRate; return ASE_OK;
+        // 믹스 서버는 모든 클라이언트가 같은 레이트 (동작 중 변경 불가)
+        if (m_mixClient && m_running && sampleRate != m_sampleRate) return ASE_NoClock;
+        m_sampleRate = sampleRate;
+        m_rateChanged.store(true, std::memory_order_release); // 동작 중이면 클럭 루프가 다시 설정
+        return ASE_OK;
     }
 
     ASIOError GetChannels(long* in, long* out) override {
-        *in = 0; *out = 2; return ASE_OK;
+        *in = m_numInputs; *out = m_numOutputs; return ASE_OK;
     }
 
+    // 입력 N 은 출력 N 의 루프백 (한 블록 뒤)
     ASIOError GetChannelInfo(ASIOChannelInfo* info) override {
-        if (info->channel < 0 || info->channel >= 2) return ASE_InvalidParameter;
+        long count = info->isInput ? m_numInputs : m_numOutputs;
+        if (info->channel < 0 || info->channel >= count) return ASE_InvalidParameter;
         info->type = ASIOSTFloat32LSB;
         info->isActive = ASIOTrue;
-        info->isInput = ASIOFalse;
-        sprintf_s(info->name, 32, "Delta Virtual %d", info->channel + 1);
+        info->channelGroup = 0;
+        sprintf_s(info->name, 32, info->isInput ? "Delta Loopback %d" : "Delta Virtual %d", info->channel + 1);
         return ASE_OK;
     }
 
     ASIOError GetSamplePosition(ASIOSamples* sPos, ASIOTimeStamp* tStamp) override;
     ASIOError CreateBuffers(ASIOBufferInfo* bufferInfos, long numChannels, long bufferSize, ASIOCallbacks* callbacks) override;
     ASIOError DisposeBuffers() override;
+    size_t GetBufferStorageBytes(long numChannels, long bufferSize) const override {
+        return (size_t)numChannels * 2 * VirtualChannels::ChannelStride(bufferSize) * sizeof(float);
+    }
+    void SetBufferStorage(void* storage) override { m_bufferStorage = static_cast<float*>(storage); }
     ASIOError OutputReady() override { return ASE_OK; }
     ASIOError SetClockSource(long reference) override { return ASE_OK; }
     ASIOError GetClockSources(ASIOClockSource* clocks, long* numSources) override {
@@ -99,31 +113,59 @@ public:
         return ASE_OK;
     }
     ASIOError GetLatencies(long* inputLatency, long* outputLatency) override {
-        *inputLatency = 0;
+        *inputLatency = (m_numInputs > 0) ? m_bufferSize : 0; // 루프백은 한 블록 뒤
         *outputLatency = m_bufferSize; // 출력 레이턴시는 버퍼 크기
         return ASE_OK;
     }
-    ASIOError CanSampleRate(ASIOSampleRate sampleRate) override {
+    ASIOError CanSampleRate(ASIOSampleRate sampleRate) override;
+    bool IsSupportedRate(ASIOSampleRate sampleRate) const {
         if (sampleRate == 44100.0 || sampleRate == 48000.0 || sampleRate == 88200.0 || 
             sampleRate == 96000.0 || sampleRate == 176400.0 || sampleRate == 192000.0 ||
             sampleRate == 352800.0 || sampleRate == 384000.0)
-            return ASE_OK;
-        return ASE_NoClock;
+            return true;
+        return false;
     }
     ASIOError Future(long selector, void* opt) override { return ASE_NotPresent; }
 
+    // 페이싱 상태 (텔레메트리)
+    PacingState GetPacingState() const { return m_pacer.GetState(); }
+
+    // 싱크 클럭 모드: 렌더 스레드에서 필요한 만큼 블록 생성
+    void OnRenderPeriod(size_t bytesNeeded) override;
+
+    friend class CVirtualMixServer;
+
 private:
     void VirtualClockLoop(); // 가상 클럭 루프
+    void RenderOneBlock();   // 호스트 블록 1개 처리
 
     CDeltaCastDriver* m_owner = nullptr;
     double m_sampleRate = 48000.0;
+    std::atomic<bool> m_rateChanged{ false };
     long m_bufferSize = 0;
 
-    // 가상 자원
-    std::vector<std::vector<float>> m_buffers;
+    // 가상 자원 (더블 버퍼, 드라이버 스트림 아레나 소유)
+    float* m_bufferStorage = nullptr;
     std::thread m_thread;
     std::atomic<bool> m_running{ false };
     std::atomic<int64_t> m_samplePos{ 0 };
+    long m_doubleBufferIndex = 0;
+
+    // 싱크 클럭 모드 (출력 장치 이벤트가 버퍼 스위치를 구동)
+    bool m_sinkClocked = false;
+    double m_sinkPeriodSeconds = 0.0;
+
+    // 믹스 서버 클라이언트 모드 (자체 클럭 없음)
+    bool m_mixClient = false;
+
+    // 채널 구성 (INI, Init 에서 고정)
+    long m_numOutputs = 2;
+    long m_numInputs = 0;
+    // 루프백 입력 -> 원본 출력 (CreateBuffers 에서 계산)
+    std::vector<VirtualChannels::LoopbackCopy> m_loopbacks;
+
+    // 링버퍼 채움량 제어
+    PacingController m_pacer;
 };
 
 // ---------------------------------------------------------------------------
@@ -0,0 +1,328 @@
+﻿#pragma once
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <immintrin.h>
+
+// 송출 이펙트 종류 (INI [EffectN] Type)
+enum class EffectType : int { None, HighPass, LowPass, Peak, LowShelf, HighShelf, Compressor };
+
+inline const char* EffectTypeName(EffectType type) {
+    switch (type) {
+    case EffectType::HighPass: return "HighPass";
+    case EffectType::LowPass: return "LowPass";
+    case EffectType::Peak: return "Peak";
+    case EffectType::LowShelf: return "LowShelf";
+    case EffectType::HighShelf: return "HighShelf";
+    case EffectType::Compressor: return "Compressor";
+    default: return "None";
+    }
+}
+
+struct EffectSettings {
+    EffectType type = EffectType::None;
+    // 필터
+    double frequencyHz = 1000.0;
+    double q = 0.7071;
+    double gainDb = 0.0;        // Peak / Shelf
+    int order = 2;              // HighPass / LowPass: 2, 4, 6, 8 (버터워스)
+    // 컴프레서 (스테레오 링크, 피크 검출)
+    double thresholdDb = -18.0;
+    double ratio = 3.0;
+    double kneeDb = 6.0;
+    double attackMs = 5.0;
+    double releaseMs = 120.0;
+    double makeupDb = 0.0;
+
+    bool operator==(const EffectSettings&) const = default;
+};
+
+// ---------------------------------------------------------------------------
+// 이펙트 노드: 고정 블록 인터페이스 (Process 의 count <= BLOCK)
+// Prepare 는 비실시간 스레드에서 (할당 가능), 이후 Reset / Process 는 할당 없음
+// ---------------------------------------------------------------------------
+class EffectNode {
+public:
+    static const size_t BLOCK = 256;
+
+    virtual ~EffectNode() = default;
+    virtual void Prepare(double sampleRate) = 0;
+    virtual void Reset() = 0;
+    // 제자리 처리
+    virtual void Process(float* left, float* right, size_t count) = 0;
+    virtual size_t GetLatencyFrames() const { return 0; }
+    // 무음 입력에 대해 상태가 0 으로 가라앉았는지 (무음 빠른 경로 판단)
+    virtual bool IsSettled() const = 0;
+};
+
+// ---------------------------------------------------------------------------
+// 바이쿼드 (RBJ, TDF-II, double) 직렬 섹션
+// 좌/우를 한 레지스터의 두 레인으로 처리 (섹션끼리는 직렬 의존이라 채널 방향으로만 벡터화)
+// ---------------------------------------------------------------------------
+class BiquadNode : public EffectNode {
+public:
+    static const int MAX_SECTIONS = 4;
+    static constexpr double SETTLE_LEVEL = 1e-12; // 상태가 이 아래면 0 으로 (디노멀 방지)
+
+    explicit BiquadNode(const EffectSettings& settings) : m_settings(settings) {}
+
+    void Prepare(double sampleRate) override {
+        const EffectSettings& s = m_settings;
+        double freq = std::clamp(s.frequencyHz, 10.0, sampleRate * 0.45);
+        bool pass = (s.type == EffectType::HighPass || s.type == EffectType::LowPass);
+        m_sections = pass ? std::clamp(s.order / 2, 1, MAX_SECTIONS) : 1;
+        for (int k = 0; k < m_sections; k++) {
+            // 2차는 지정 Q, 고차는 버터워스 섹션 Q
+            double q = (m_sections == 1) ? std::clamp(s.q, 0.1, 24.0)
+                : 1.0 / (2.0 * std::cos(3.14159265358979323846 * (2 * k + 1) / (4.0 * m_sections)));
+            Design(m_section[k], s.type, freq / sampleRate, q, s.gainDb);
+        }
+        Reset();
+    }
+
+    void Reset() override {
+        for (Section& section : m_section) section.z1 = section.z2 = _mm_setzero_pd();
+    }
+
+    void Process(float* left, float* right, size_t count) override {
+        __m128d z1[MAX_SECTIONS], z2[MAX_SECTIONS];
+        for (int k = 0; k < m_sections; k++) { z1[k] = m_section[k].z1; z2[k] = m_section[k].z2; }
+        for (size_t i = 0; i < count; i++) {
+            __m128d x = _mm_set_pd(right[i], left[i]);
+            for (int k = 0; k < m_sections; k++) {
+                const Section& c = m_section[k];
+                __m128d y = _mm_add_pd(_mm_mul_pd(c.b0, x), z1[k]);
+                z1[k] = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(c.b1, x), _mm_mul_pd(c.a1, y)), z2[k]);
+                z2[k] = _mm_sub_pd(_mm_mul_pd(c.b2, x), _mm_mul_pd(c.a2, y));
+                x = y;
+            }
+            left[i] = (float)_mm_cvtsd_f64(x);
+            right[i] = (float)_mm_cvtsd_f64(_mm_unpackhi_pd(x, x));
+        }
+        // 블록 끝에서 작은 상태는 버림
+        const __m128d settle = _mm_set1_pd(SETTLE_LEVEL);
+        const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+        for (int k = 0; k < m_sections; k++) {
+            m_section[k].z1 = _mm_and_pd(z1[k], _mm_cmpge_pd(_mm_and_pd(z1[k], absMask), settle));
+            m_section[k].z2 = _mm_and_pd(z2[k], _mm_cmpge_pd(_mm_and_pd(z2[k], absMask), settle));
+        }
+    }
+
+    bool IsSettled() const override {
+        for (int k = 0; k < m_sections; k++) {
+            __m128d any = _mm_or_pd(m_section[k].z1, m_section[k].z2);
+            if (_mm_movemask_pd(_mm_cmpneq_pd(any, _mm_setzero_pd())) != 0) return false;
+        }
+        return true;
+    }
+
+private:
+    struct Section {
+        __m128d b0, b1, b2, a1, a2; // a0 으로 정규화
+        __m128d z1, z2;
+    };
+
+    static void Design(Section& section, EffectType type, double normFreq, double q, double gainDb) {
+        double w0 = 2.0 * 3.14159265358979323846 * normFreq;
+        double cosw = std::cos(w0), sinw = std::sin(w0);
+        double alpha = sinw / (2.0 * q);
+        double A = std::pow(10.0, std::clamp(gainDb, -24.0, 24.0) / 40.0);
+        double twoSqrtAAlpha = 2.0 * std::sqrt(A) * alpha;
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+        switch (type) {
+        case EffectType::HighPass:
+            b0 = (1.0 + cosw) * 0.5; b1 = -(1.0 + cosw); b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosw; a2 = 1.0 - alpha;
+            break;
+        case EffectType::LowPass:
+            b0 = (1.0 - cosw) * 0.5; b1 = 1.0 - cosw; b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosw; a2 = 1.0 - alpha;
+            break;
+        case EffectType::Peak:
+            b0 = 1.0 + alpha * A; b1 = -2.0 * cosw; b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A; a1 = -2.0 * cosw; a2 = 1.0 - alpha / A;
+            break;
+        case EffectType::LowShelf:
+            b0 = A * ((A + 1.0) - (A - 1.0) * cosw + twoSqrtAAlpha);
+            b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosw);
+            b2 = A * ((A + 1.0) - (A - 1.0) * cosw - twoSqrtAAlpha);
+            a0 = (A + 1.0) + (A - 1.0) * cosw + twoSqrtAAlpha;
+            a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosw);
+            a2 = (A + 1.0) + (A - 1.0) * cosw - twoSqrtAAlpha;
+            break;
+        case EffectType::HighShelf:
+            b0 = A * ((A + 1.0) + (A - 1.0) * cosw + twoSqrtAAlpha);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosw);
+            b2 = A * ((A + 1.0) + (A - 1.0) * cosw - twoSqrtAAlpha);
+            a0 = (A + 1.0) - (A - 1.0) * cosw + twoSqrtAAlpha;
+            a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosw);
+            a2 = (A + 1.0) - (A - 1.0) * cosw - twoSqrtAAlpha;
+            break;
+        default:
+            break;
+        }
+        section.b0 = _mm_set1_pd(b0 / a0);
+        section.b1 = _mm_set1_pd(b1 / a0);
+        section.b2 = _mm_set1_pd(b2 / a0);
+        section.a1 = _mm_set1_pd(a1 / a0);
+        section.a2 = _mm_set1_pd(a2 / a0);
+    }
+
+    EffectSettings m_settings;
+    Section m_section[MAX_SECTIONS] = {};
+    int m_sections = 1;
+};
+
+// ---------------------------------------------------------------------------
+// 컴프레서 (피드포워드, 스테레오 링크 피크 검출, 소프트 니)
+// 레벨 검출/게인 적용은 AVX, 엔벨로프는 dB 영역에서 샘플 단위 (어택/릴리즈 1차 평활)
+// 룩어헤드 없음 (지연 0)
+// ---------------------------------------------------------------------------
+class CompressorNode : public EffectNode {
+public:
+    static constexpr float FLOOR_DB = -120.0f;
+    static constexpr float SETTLED_DB = -0.001f;
+
+    explicit CompressorNode(const EffectSettings& settings) : m_settings(settings) {}
+
+    void Prepare(double sampleRate) override {
+        const EffectSettings& s = m_settings;
+        m_threshold = (float)std::clamp(s.thresholdDb, -60.0, 0.0);
+        m_slope = (float)(1.0 / std::clamp(s.ratio, 1.0, 50.0) - 1.0);
+        m_knee = (float)std::clamp(s.kneeDb, 0.0, 24.0);
+        m_makeup = (float)std::clamp(s.makeupDb, -24.0, 24.0);
+        m_attack = (float)std::exp(-1.0 / (std::max(s.attackMs, 0.05) * 0.001 * sampleRate));
+        m_release = (float)std::exp(-1.0 / (std::max(s.releaseMs, 1.0) * 0.001 * sampleRate));
+        Reset();
+    }
+
+    void Reset() override { m_envelopeDb = 0.0f; }
+
+    void Process(float* left, float* right, size_t count) override {
+        // 스테레오 링크 피크
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 l = _mm256_and_ps(_mm256_loadu_ps(left + i), absMask);
+            __m256 r = _mm256_and_ps(_mm256_loadu_ps(right + i), absMask);
+            _mm256_storeu_ps(&m_gain[i], _mm256_max_ps(l, r));
+        }
+        for (; i < count; i++) m_gain[i] = std::max(std::abs(left[i]), std::abs(right[i]));
+
+        // 게인 계산 + 엔벨로프 (리덕션 dB, 0 이하)
+        float envelope = m_envelopeDb;
+        for (i = 0; i < count; i++) {
+            float levelDb = (m_gain[i] > 1e-6f) ? 20.0f * std::log10(m_gain[i]) : FLOOR_DB;
+            float target = Reduction(levelDb - m_threshold);
+            float coeff = (target < envelope) ? m_attack : m_release;
+            envelope = target + coeff * (envelope - target);
+            m_gain[i] = envelope + m_makeup;
+        }
+        m_envelopeDb = (envelope > SETTLED_DB) ? 0.0f : envelope;
+
+        // dB -> 선형은 블록 단위로 모아서
+        for (i = 0; i < count; i++) m_gain[i] = std::exp2(m_gain[i] * DB_TO_LOG2);
+        i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 g = _mm256_loadu_ps(&m_gain[i]);
+            _mm256_storeu_ps(left + i, _mm256_mul_ps(_mm256_loadu_ps(left + i), g));
+            _mm256_storeu_ps(right + i, _mm256_mul_ps(_mm256_loadu_ps(right + i), g));
+        }
+        for (; i < count; i++) { left[i] *= m_gain[i]; right[i] *= m_gain[i]; }
+    }
+
+    bool IsSettled() const override { return m_envelopeDb == 0.0f; }
+
+private:
+    static constexpr float DB_TO_LOG2 = 0.16609640474f; // log2(10) / 20
+
+    float Reduction(float over) const {
+        if (2.0f * over <= -m_knee) return 0.0f;
+        if (2.0f * over < m_knee) {
+            float x = over + m_knee * 0.5f;
+            return m_slope * x * x / (2.0f * m_knee);
+        }
+        return m_slope * over;
+    }
+
+    EffectSettings m_settings;
+    float m_threshold = -18.0f;
+    float m_slope = -0.5f;
+    float m_knee = 6.0f;
+    float m_makeup = 0.0f;
+    float m_attack = 0.0f;
+    float m_release = 0.0f;
+    float m_envelopeDb = 0.0f;
+    float m_gain[BLOCK] = {}; // 검출 레벨 -> 적용 게인 (블록 재사용)
+};
+
+// ---------------------------------------------------------------------------
+// 송출 이펙트 체인 (게인 스테이지와 리미터 사이, 출력 레이트)
+// Setup 은 비실시간 스레드에서 노드 생성/준비, 렌더 스레드는 RtHandoff 로 받아 Process 만 호출
+// 노드별 처리 시간을 재서 주기 길이 대비 부하로 기록 (지수 평활 + 최대값)
+// 하드웨어로 가는 호스트 버퍼는 건드리지 않음
+// ---------------------------------------------------------------------------
+class EffectChain {
+public:
+    static const size_t MAX_EFFECTS = 8;
+
+    // 비실시간 스레드에서 호출 (메모리 할당)
+    void Setup(const std::vector<EffectSettings>& effects, double sampleRate) {
+        m_nodes.clear();
+        m_sampleRate = sampleRate;
+        for (const EffectSettings& settings : effects) {
+            if (m_nodes.size() >= MAX_EFFECTS) break;
+            std::unique_ptr<EffectNode> node;
+            if (settings.type == EffectType::Compressor) node = std::make_unique<CompressorNode>(settings);
+            else if (settings.type != EffectType::None) node = std::make_unique<BiquadNode>(settings);
+            if (!node) continue;
+            node->Prepare(sampleRate);
+            m_nodes.push_back(std::move(node));
+        }
+        m_latency = 0;
+        for (const auto& node : m_nodes) m_latency += node->GetLatencyFrames();
+        for (size_t n = 0; n < MAX_EFFECTS; n++) m_load[n] = m_peak[n] = 0.0;
+    }
+
+    void Reset() {
+        for (auto& node : m_nodes) node->Reset();
+    }
+
+    bool IsEnabled() const { return !m_nodes.empty(); }
+    size_t GetCount() const { return m_nodes.size(); }
+    size_t GetLatencyFrames() const { return m_latency; }
+    double GetLoad(size_t index) const { return m_load[index]; }
+    double GetPeak(size_t index) const { return m_peak[index]; }
+
+    bool IsSettled() const {
+        for (const auto& node : m_nodes) if (!node->IsSettled()) return false;
+        return true;
+    }
+
+    // 제자리 처리 (노드 순서대로 전체 구간, 노드 안에서는 BLOCK 단위)
+    void Process(float* left, float* right, size_t count) {
+        if (count == 0) return;
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point start = Clock::now();
+        for (size_t n = 0; n < m_nodes.size(); n++) {
+            EffectNode* node = m_nodes[n].get();
+            for (size_t pos = 0; pos < count; pos += EffectNode::BLOCK) {
+                node->Process(left + pos, right + pos, std::min(EffectNode::BLOCK, count - pos));
+            }
+            Clock::time_point end = Clock::now();
+            double load = std::chrono::duration<double>(end - start).count() * m_sampleRate / count;
+            m_load[n] += 0.05 * (load - m_load[n]);
+            m_peak[n] = std::max(m_peak[n], load);
+            start = end;
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<EffectNode>> m_nodes;
+    double m_sampleRate = 48000.0;
+    size_t m_latency = 0;
+    double m_load[MAX_EFFECTS] = {};
+    double m_peak[MAX_EFFECTS] = {};
+};
@@ -0,0 +1,59 @@
+﻿#pragma once
+#include <cstdio>
+#include <filesystem>
+#include "OutputSink.h"
+#include "WavFile.h"
+
+// ---------------------------------------------------------------------------
+// 파일 싱크: 송출 출력을 실시간 속도로 float32 WAV 에 기록 (장치 없는 환경 확인용)
+// 녹음기(CWavRecorder)와 달리 렌더 체인(게인/리미터/은닉) 이후의 최종 출력
+// ---------------------------------------------------------------------------
+class FileSink : public PacedSink {
+public:
+    explicit FileSink(const std::wstring& path) : m_path(path) {}
+    ~FileSink() override { OnClose(); }
+
+    const char* GetName() const override { return "File"; }
+
+protected:
+    bool OnOpen(const std::wstring& /*deviceId*/) override {
+        if (m_file) return true;
+#ifdef _WIN32
+        if (_wfopen_s(&m_file, m_path.c_str(), L"wb") != 0 || !m_file) { m_file = nullptr; return false; }
+#else
+        m_file = fopen(std::filesystem::path(m_path).c_str(), "wb");
+        if (!m_file) return false;
+#endif
+        std::vector<uint8_t> header = WavFile::BuildHeader(WavContainer::Wav, WavSampleFormat::Float32,
+            (uint16_t)m_format.channels, (uint32_t)m_format.sampleRate, 0);
+        fwrite(header.data(), 1, header.size(), m_file);
+        m_headerBytes = header.size();
+        m_dataBytes = 0;
+        return true;
+    }
+
+    void OnClose() override {
+        if (!m_file) return;
+        // 실제 크기로 헤더 갱신
+        std::vector<uint8_t> header = WavFile::BuildHeader(WavContainer::Wav, WavSampleFormat::Float32,
+            (uint16_t)m_format.channels, (uint32_t)m_format.sampleRate, m_dataBytes);
+        if (header.size() == m_headerBytes) {
+            fseek(m_file, 0, SEEK_SET);
+            fwrite(header.data(), 1, header.size(), m_file);
+        }
+        fclose(m_file);
+        m_file = nullptr;
+    }
+
+    void OnData(const float* interleaved, uint32_t frames) override {
+        if (!m_file) return;
+        size_t bytes = (size_t)frames * m_format.channels * sizeof(float);
+        m_dataBytes += fwrite(interleaved, 1, bytes, m_file);
+    }
+
+private:
+    std::wstring m_path;
+    FILE* m_file = nullptr;
+    size_t m_headerBytes = 0;
+    uint64_t m_dataBytes = 0;
+};
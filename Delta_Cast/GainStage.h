@@ -0,0 +1,141 @@
+﻿#pragma once
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+#include <immintrin.h>
+
+// 덕킹 설정 (키: ASIO 입력 채널)
+struct DuckingSettings {
+    bool enabled = false;
+    long inputChannel = 0;     // ASIO 입력 채널 번호
+    double thresholdDb = -40.0;
+    double depthDb = -12.0;
+    double attackMs = 10.0;
+    double releaseMs = 300.0;
+    double holdMs = 200.0;
+};
+
+// ---------------------------------------------------------------------------
+// 송출 게인 스테이지 (채널별 게인/뮤트 + 사이드체인 덕킹)
+// 파라미터는 제어 스레드에서 원자적으로 기록, 렌더 스레드는 블록마다 읽어
+// 샘플 단위 선형 램프로 목표까지 이동 (0 -> 1 전체 이동에 RAMP_MS)
+// 하드웨어로 가는 호스트 버퍼는 건드리지 않음
+// ---------------------------------------------------------------------------
+class GainStage {
+public:
+    static constexpr double RAMP_MS = 10.0;
+
+    // --- 제어 스레드 ---
+    void SetGainDb(int channel, double db) {
+        if (channel < 0 || channel > 1) return;
+        m_userGain[channel].store((float)std::pow(10.0, std::clamp(db, -96.0, 24.0) / 20.0), std::memory_order_relaxed);
+    }
+    void SetMute(bool mute) { m_mute.store(mute, std::memory_order_relaxed); }
+    void SetDucking(const DuckingSettings& settings) {
+        m_duckEnabled.store(settings.enabled, std::memory_order_relaxed);
+        m_duckThreshold.store((float)std::pow(10.0, settings.thresholdDb / 20.0), std::memory_order_relaxed);
+        m_duckDepth.store((float)std::pow(10.0, std::min(settings.depthDb, 0.0) / 20.0), std::memory_order_relaxed);
+        m_duckAttackSec.store((float)(std::max(settings.attackMs, 0.1) * 0.001), std::memory_order_relaxed);
+        m_duckReleaseSec.store((float)(std::max(settings.releaseMs, 1.0) * 0.001), std::memory_order_relaxed);
+        m_duckHoldSec.store((float)(std::max(settings.holdMs, 0.0) * 0.001), std::memory_order_relaxed);
+    }
+
+    // --- ASIO 콜백: 키 채널 블록 피크 (다음 렌더 블록까지 최대값 유지) ---
+    void PushKeyPeak(float peak) {
+        float prev = m_keyPeak.load(std::memory_order_relaxed);
+        while (peak > prev && !m_keyPeak.compare_exchange_weak(prev, peak, std::memory_order_relaxed)) {}
+    }
+
+    // --- 렌더 스레드 ---
+    void Prepare(double sampleRate) {
+        m_sampleRate = sampleRate;
+        m_maxStep = (float)(1.0 / std::max(1.0, RAMP_MS * 0.001 * sampleRate));
+        m_current[0] = m_current[1] = Target(0, 1.0f);
+        m_duckGain = 1.0f;
+        m_holdRemaining = 0.0;
+        m_keyPeak.store(0.0f, std::memory_order_relaxed);
+    }
+
+    // 제자리 처리
+    void Process(float* left, float* right, size_t count) {
+        if (count == 0) return;
+        UpdateDucking(count);
+        float* ch[2] = { left, right };
+        for (int c = 0; c < 2; c++) {
+            float target = Target(c, m_duckGain);
+            float start = m_current[c];
+            float diff = target - start;
+            if (diff == 0.0f) {
+                if (start != 1.0f) ApplyRamp(ch[c], count, start, 0.0f);
+                continue;
+            }
+            // 기울기 제한: 목표까지 필요한 샘플 수만큼 램프, 나머지는 고정
+            size_t rampLen = std::min(count, (size_t)std::ceil(std::abs(diff) / m_maxStep));
+            float end = (rampLen == count && std::abs(diff) > m_maxStep * count)
+                ? start + std::copysign(m_maxStep * count, diff) : target;
+            ApplyRamp(ch[c], rampLen, start, (end - start) / (float)rampLen);
+            if (rampLen < count) ApplyRamp(ch[c] + rampLen, count - rampLen, end, 0.0f);
+            m_current[c] = end;
+        }
+    }
+
+    // 샘플 없이 램프/덕킹 상태만 진행 (무음 구간: 0 에 게인을 곱해도 0)
+    void Advance(size_t count) { Process(nullptr, nullptr, count); }
+
+    float GetDuckGain() const { return m_duckGain; }
+
+private:
+    float Target(int c, float duck) const {
+        if (m_mute.load(std::memory_order_relaxed)) return 0.0f;
+        return m_userGain[c].load(std::memory_order_relaxed) * duck;
+    }
+
+    // 블록 단위 덕킹 엔벨로프 (어택/릴리즈/홀드)
+    void UpdateDucking(size_t count) {
+        float key = m_keyPeak.exchange(0.0f, std::memory_order_relaxed);
+        if (!m_duckEnabled.load(std::memory_order_relaxed)) { m_duckGain = 1.0f; return; }
+
+        double blockSec = count / m_sampleRate;
+        if (key > m_duckThreshold.load(std::memory_order_relaxed)) m_holdRemaining = m_duckHoldSec.load(std::memory_order_relaxed);
+        else m_holdRemaining = std::max(0.0, m_holdRemaining - blockSec);
+
+        float target = (m_holdRemaining > 0.0) ? m_duckDepth.load(std::memory_order_relaxed) : 1.0f;
+        float timeConst = (target < m_duckGain) ? m_duckAttackSec.load(std::memory_order_relaxed) : m_duckReleaseSec.load(std::memory_order_relaxed);
+        float coeff = (float)(1.0 - std::exp(-blockSec / timeConst));
+        m_duckGain += coeff * (target - m_duckGain);
+    }
+
+    // x[i] *= start + inc * i (8개씩 병렬)
+    static void ApplyRamp(float* x, size_t n, float start, float inc) {
+        if (!x) return;
+        size_t i = 0;
+        __m256 g = _mm256_add_ps(_mm256_set1_ps(start),
+            _mm256_mul_ps(_mm256_set1_ps(inc), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7)));
+        const __m256 step = _mm256_set1_ps(inc * 8.0f);
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), g));
+            g = _mm256_add_ps(g, step);
+        }
+        for (; i < n; i++) x[i] *= start + inc * (float)i;
+    }
+
+    // 제어 스레드 -> 렌더 스레드
+    std::atomic<float> m_userGain[2] = { 1.0f, 1.0f };
+    std::atomic<bool> m_mute{ false };
+    std::atomic<bool> m_duckEnabled{ false };
+    std::atomic<float> m_duckThreshold{ 0.01f };
+    std::atomic<float> m_duckDepth{ 0.25f };
+    std::atomic<float> m_duckAttackSec{ 0.01f };
+    std::atomic<float> m_duckReleaseSec{ 0.3f };
+    std::atomic<float> m_duckHoldSec{ 0.2f };
+
+    // ASIO 콜백 -> 렌더 스레드
+    std::atomic<float> m_keyPeak{ 0.0f };
+
+    // 렌더 스레드 전용
+    double m_sampleRate = 48000.0;
+    float m_maxStep = 1.0f / 480.0f;
+    float m_current[2] = { 1.0f, 1.0f };
+    float m_duckGain = 1.0f;
+    double m_holdRemaining = 0.0;
+};
@@ -0,0 +1,175 @@
+﻿#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <immintrin.h>
+#include "TruePeak.h"
+
+// ---------------------------------------------------------------------------
+// 룩어헤드 트루피크 리미터 (스테레오 링크)
+// 사이드체인: TruePeakDetector (8배 오버샘플) 로 샘플 사이 피크 검출, 페이즈 사이 피크만큼 실링을 낮춤
+// 게인: 룩어헤드 구간 최소값 홀드 -> 릴리즈 -> 같은 길이 박스 평균
+//       박스 평균이 끝나는 시점에 게인이 요구치 이하로 내려가 있으므로 오버슛 없음
+// 지연: GetLatencyFrames() 와 정확히 일치 (오디오 딜레이 라인 길이)
+// ---------------------------------------------------------------------------
+struct LimiterSettings {
+    bool enabled = false;
+    double lookaheadMs = 1.5; // 0.25 ~ 5
+    double ceilingDb = -1.0;  // dBTP
+    double releaseMs = 60.0;
+};
+
+class Limiter {
+public:
+    static const int DETECT_DELAY = TruePeakDetector::DETECT_DELAY;
+    static const size_t MAX_BLOCK = 1024;     // 내부 처리 단위
+    static constexpr float SETTLED_GAIN = 0.9999f;
+
+    // 설정에 따른 지연 (프레임). 총 지연 = 검출 지연 + (홀드 길이 - 1)
+    static size_t LatencyFramesFor(const LimiterSettings& settings, double sampleRate) {
+        double lookaheadMs = std::clamp(settings.lookaheadMs, 0.25, 5.0);
+        return std::max((size_t)std::lround(lookaheadMs * 0.001 * sampleRate), (size_t)DETECT_DELAY + 1);
+    }
+
+    // 비실시간 스레드에서 호출 (메모리 할당)
+    void Setup(const LimiterSettings& settings, double sampleRate) {
+        m_enabled = settings.enabled;
+        // 검출 페이즈 사이에서 놓칠 수 있는 피크만큼 여유 (16배 측정에서도 실링 유지)
+        m_ceiling = (float)(std::pow(10.0, std::min(settings.ceilingDb, 0.0) / 20.0) * TruePeakDetector::PHASE_GAP_RATIO);
+        m_release = (float)(1.0 - std::exp(-1.0 / (std::max(settings.releaseMs, 1.0) * 0.001 * sampleRate)));
+
+        m_latency = LatencyFramesFor(settings, sampleRate);
+        m_hold = m_latency - DETECT_DELAY + 1;
+
+        for (int c = 0; c < 2; c++) {
+            m_detector[c].Setup(MAX_BLOCK);
+            m_delay[c].assign(m_latency, 0.0f);
+        }
+        m_required.assign(MAX_BLOCK, 1.0f);
+        m_minValue.assign(m_hold, 1.0f);
+        m_minIndex.assign(m_hold, 0);
+        m_boxLine.assign(m_hold, 1.0f);
+        Reset();
+    }
+
+    void Reset() {
+        for (int c = 0; c < 2; c++) {
+            m_detector[c].Reset();
+            std::fill(m_delay[c].begin(), m_delay[c].end(), 0.0f);
+        }
+        std::fill(m_boxLine.begin(), m_boxLine.end(), 1.0f);
+        m_boxSum = (double)m_hold;
+        m_boxPos = 0;
+        m_delayPos = 0;
+        m_minHead = m_minCount = 0;
+        m_sampleIndex = 0;
+        m_envelope = 1.0f;
+        m_gainReduction = 1.0f;
+    }
+
+    bool IsEnabled() const { return m_enabled; }
+    size_t GetLatencyFrames() const { return m_enabled ? m_latency : 0; }
+
+    // 게인이 원위치로 돌아왔는지 (무음 구간 건너뛰기 판단, 딜레이 라인은 호출측이 지연 이상 무음으로 비움)
+    bool IsSettled() const { return m_envelope >= SETTLED_GAIN && m_boxSum >= SETTLED_GAIN * m_hold; }
+
+    // 블록 중 최소 게인 (미터용)
+    float GetGainReduction() const { return m_gainReduction; }
+
+    // 제자리 처리
+    void Process(float* left, float* right, size_t count) {
+        while (count > 0) {
+            size_t n = std::min(count, MAX_BLOCK);
+            ProcessBlock(left, right, n);
+            left += n; right += n; count -= n;
+        }
+    }
+
+private:
+    void ProcessBlock(float* left, float* right, size_t n) {
+        m_detector[0].Process(left, n, m_required.data(), false);
+        m_detector[1].Process(right, n, m_required.data(), true);
+
+        // 피크 -> 요구 게인
+        const __m256 ceiling = _mm256_set1_ps(m_ceiling);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 peak = _mm256_max_ps(_mm256_loadu_ps(&m_required[i]), ceiling);
+            _mm256_storeu_ps(&m_required[i], _mm256_min_ps(one, _mm256_div_ps(ceiling, peak)));
+        }
+        for (; i < n; i++) m_required[i] = std::min(1.0f, m_ceiling / std::max(m_required[i], m_ceiling));
+
+        float minGain = 1.0f;
+        for (i = 0; i < n; i++) {
+            // 홀드: 최근 m_hold 개 중 최소값 (단조 덱)
+            float req = m_required[i];
+            if (m_minCount > 0 && m_sampleIndex - m_minIndex[m_minHead] >= m_hold) {
+                m_minHead = (m_minHead + 1) % m_hold;
+                m_minCount--;
+            }
+            while (m_minCount > 0 && m_minValue[BackSlot()] >= req) m_minCount--;
+            size_t slot = (m_minHead + m_minCount) % m_hold;
+            m_minValue[slot] = req;
+            m_minIndex[slot] = m_sampleIndex;
+            m_minCount++;
+            float held = m_minValue[m_minHead];
+            m_sampleIndex++;
+
+            // 릴리즈 (내려갈 때는 즉시, 박스 평균이 어택을 부드럽게 함)
+            if (held < m_envelope) m_envelope = held;
+            else m_envelope += m_release * (held - m_envelope);
+
+            // 박스 평균
+            m_boxSum += m_envelope - m_boxLine[m_boxPos];
+            m_boxLine[m_boxPos] = m_envelope;
+            if (++m_boxPos == m_hold) m_boxPos = 0;
+            float gain = (float)(m_boxSum / (double)m_hold);
+            minGain = std::min(minGain, gain);
+
+            // 지연된 오디오에 적용
+            float delayedL = m_delay[0][m_delayPos];
+            float delayedR = m_delay[1][m_delayPos];
+            m_delay[0][m_delayPos] = left[i];
+            m_delay[1][m_delayPos] = right[i];
+            if (++m_delayPos == m_latency) m_delayPos = 0;
+            left[i] = delayedL * gain;
+            right[i] = delayedR * gain;
+        }
+        // 누적 오차 제거
+        if (m_boxPos == 0) {
+            double sum = 0.0;
+            for (float v : m_boxLine) sum += v;
+            m_boxSum = sum;
+        }
+        m_gainReduction = minGain;
+    }
+
+    size_t BackSlot() const { return (m_minHead + m_minCount - 1) % m_hold; }
+
+    bool m_enabled = false;
+    float m_ceiling = 1.0f;
+    float m_release = 0.001f;
+    size_t m_latency = 0;
+    size_t m_hold = 1;
+
+    TruePeakDetector m_detector[2]; // 사이드체인
+    std::vector<float> m_delay[2]; // 오디오 딜레이 라인
+    std::vector<float> m_required; // 블록 요구 게인
+
+    // 홀드 (단조 덱, 원형)
+    std::vector<float> m_minValue;
+    std::vector<size_t> m_minIndex;
+    size_t m_minHead = 0, m_minCount = 0;
+    size_t m_sampleIndex = 0;
+
+    float m_envelope = 1.0f;
+
+    // 박스 평균
+    std::vector<float> m_boxLine;
+    double m_boxSum = 0.0;
+    size_t m_boxPos = 0;
+    size_t m_delayPos = 0;
+
+    float m_gainReduction = 1.0f;
+};
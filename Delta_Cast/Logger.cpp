@@ -0,0 +1,400 @@
+﻿#include "Logger.h"
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace DeltaLog {
+
+namespace {
+    enum : uint32_t { RING_FREE, RING_ACTIVE, RING_CLOSED };
+
+    // 스레드별 링 (단일 생산자: 소유 스레드, 단일 소비자: 기록 스레드)
+    struct ThreadRing {
+        alignas(64) std::atomic<uint64_t> head{ 0 };
+        alignas(64) std::atomic<uint64_t> tail{ 0 };
+        std::atomic<uint32_t> state{ RING_FREE };
+        std::atomic<uint64_t> dropped{ 0 };
+        Record records[RING_RECORDS];
+    };
+    ThreadRing g_rings[MAX_THREADS];
+    std::atomic<uint64_t> g_noSlotDrops{ 0 };
+
+    // 스레드 종료 시 링을 닫음 (기록 스레드가 비운 뒤 재사용)
+    struct ThreadSlot {
+        ThreadRing* ring = nullptr;
+        uint32_t threadId = 0;
+        ~ThreadSlot() {
+            if (ring) ring->state.store(RING_CLOSED, std::memory_order_release);
+        }
+    };
+    thread_local ThreadSlot t_slot;
+
+    ThreadRing* AcquireRing() {
+        for (ThreadRing& ring : g_rings) {
+            uint32_t expected = RING_FREE;
+            if (ring.state.compare_exchange_strong(expected, RING_ACTIVE)) return &ring;
+        }
+        // 종료된 스레드의 링 중 다 읽힌 것
+        for (ThreadRing& ring : g_rings) {
+            uint32_t expected = RING_CLOSED;
+            if (ring.head.load(std::memory_order_acquire) == ring.tail.load(std::memory_order_acquire) &&
+                ring.state.compare_exchange_strong(expected, RING_ACTIVE)) return &ring;
+        }
+        return nullptr;
+    }
+
+    // 기록 스레드 상태 (Start/Stop 은 g_lock)
+    std::mutex g_lock;
+    int g_refs = 0;
+    std::thread g_thread;
+    std::atomic<bool> g_running{ false };
+    FILE* g_file = nullptr;
+    int64_t g_frequency = 1;
+    int64_t g_baseTicks = 0;
+    uint64_t g_baseFileTime = 0;    // g_baseTicks 시점의 벽시계 (100ns, Windows 는 현지 FILETIME, 그 외 UTC 에포크)
+
+    struct WallTime {
+        unsigned year, month, day, hour, minute, second, millisecond;
+    };
+
+#ifdef _WIN32
+    HANDLE g_wake = nullptr;
+
+    int64_t ReadTicks() {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        return now.QuadPart;
+    }
+    int64_t TickFrequency() {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency(&freq);
+        return freq.QuadPart;
+    }
+    uint64_t ReadWallClock() {
+        FILETIME utc, local;
+        GetSystemTimeAsFileTime(&utc);
+        FileTimeToLocalFileTime(&utc, &local);
+        return ((uint64_t)local.dwHighDateTime << 32) | local.dwLowDateTime;
+    }
+    WallTime ToWallTime(uint64_t stamp) {
+        FILETIME ft = { (DWORD)stamp, (DWORD)(stamp >> 32) };
+        SYSTEMTIME st = {};
+        FileTimeToSystemTime(&ft, &st);
+        return { st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds };
+    }
+    uint32_t CurrentThreadId() { return GetCurrentThreadId(); }
+    unsigned long CurrentProcessId() { return GetCurrentProcessId(); }
+    int ToUtf8(const wchar_t* text, char* out, int cap) {
+        return WideCharToMultiByte(CP_UTF8, 0, text, -1, out, cap, nullptr, nullptr);
+    }
+    void CreateWake() { g_wake = CreateEventW(nullptr, FALSE, FALSE, nullptr); }
+    void SignalWake() { if (g_wake) SetEvent(g_wake); }
+    void WaitWake(uint32_t ms) { WaitForSingleObject(g_wake, ms); }
+    void DestroyWake() { if (g_wake) { CloseHandle(g_wake); g_wake = nullptr; } }
+    void WriteDebugger(const char* line) { OutputDebugStringA(line); }
+#else
+    std::mutex g_wakeLock;
+    std::condition_variable g_wakeCv;
+    bool g_wakeSignaled = false;
+
+    int64_t ReadTicks() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+    int64_t TickFrequency() { return 1000000000; }
+    uint64_t ReadWallClock() {
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return (uint64_t)ts.tv_sec * 10000000 + (uint64_t)ts.tv_nsec / 100;
+    }
+    WallTime ToWallTime(uint64_t stamp) {
+        time_t seconds = (time_t)(stamp / 10000000);
+        tm local = {};
+        localtime_r(&seconds, &local);
+        return { (unsigned)local.tm_year + 1900, (unsigned)local.tm_mon + 1, (unsigned)local.tm_mday,
+            (unsigned)local.tm_hour, (unsigned)local.tm_min, (unsigned)local.tm_sec, (unsigned)(stamp / 10000 % 1000) };
+    }
+    uint32_t CurrentThreadId() { return (uint32_t)syscall(SYS_gettid); }
+    unsigned long CurrentProcessId() { return (unsigned long)getpid(); }
+    // wchar_t 는 UTF-32
+    int ToUtf8(const wchar_t* text, char* out, int cap) {
+        int len = 0;
+        for (; *text; text++) {
+            uint32_t c = (uint32_t)*text;
+            char bytes[4];
+            int n = 0;
+            if (c < 0x80) bytes[n++] = (char)c;
+            else if (c < 0x800) { bytes[n++] = (char)(0xC0 | (c >> 6)); bytes[n++] = (char)(0x80 | (c & 0x3F)); }
+            else if (c < 0x10000) { bytes[n++] = (char)(0xE0 | (c >> 12)); bytes[n++] = (char)(0x80 | ((c >> 6) & 0x3F)); bytes[n++] = (char)(0x80 | (c & 0x3F)); }
+            else { bytes[n++] = (char)(0xF0 | (c >> 18)); bytes[n++] = (char)(0x80 | ((c >> 12) & 0x3F)); bytes[n++] = (char)(0x80 | ((c >> 6) & 0x3F)); bytes[n++] = (char)(0x80 | (c & 0x3F)); }
+            if (len + n + 1 > cap) break;
+            memcpy(out + len, bytes, n);
+            len += n;
+        }
+        out[len] = 0;
+        return len + 1;
+    }
+    void CreateWake() { g_wakeSignaled = false; }
+    void SignalWake() {
+        std::lock_guard<std::mutex> lock(g_wakeLock);
+        g_wakeSignaled = true;
+        g_wakeCv.notify_one();
+    }
+    void WaitWake(uint32_t ms) {
+        std::unique_lock<std::mutex> lock(g_wakeLock);
+        g_wakeCv.wait_for(lock, std::chrono::milliseconds(ms), [] { return g_wakeSignaled; });
+        g_wakeSignaled = false;
+    }
+    void DestroyWake() {}
+    void WriteDebugger(const char*) {}   // 디버거 출력 없음 (로그 파일만)
+#endif
+
+    void AppendSpec(char* spec, size_t& len, const char* suffix) {
+        while (*suffix && len + 1 < 32) spec[len++] = *suffix++;
+        spec[len] = 0;
+    }
+
+    // 변환 지정자 하나 (저장된 인자 타입에 맞춰 길이 수식자를 다시 씀)
+    int FormatArg(char* out, size_t cap, const char* flags, size_t flagsLen, char conv, const Record& r, uint8_t index) {
+        char spec[32] = "%";
+        size_t len = 1;
+        if (flagsLen > 20) flagsLen = 20;
+        memcpy(spec + len, flags, flagsLen);
+        len += flagsLen;
+        spec[len] = 0;
+
+        bool isFloat = strchr("fFeEgGaA", conv) != nullptr;
+        bool isInt = strchr("diuxXoc", conv) != nullptr;
+        const Record::Value& v = r.values[index];
+        switch (r.types[index]) {
+        case ArgType::Int:
+        case ArgType::UInt: {
+            bool isSigned = r.types[index] == ArgType::Int;
+            if (isFloat) {
+                char c[2] = { conv, 0 };
+                AppendSpec(spec, len, c);
+                return snprintf(out, cap, spec, isSigned ? (double)v.i : (double)v.u);
+            }
+            if (conv == 'c') {
+                AppendSpec(spec, len, "c");
+                return snprintf(out, cap, spec, (int)v.i);
+            }
+            char c[4] = { 'l', 'l', isInt ? conv : (isSigned ? 'd' : 'u'), 0 };
+            AppendSpec(spec, len, c);
+            return isSigned ? snprintf(out, cap, spec, (long long)v.i) : snprintf(out, cap, spec, (unsigned long long)v.u);
+        }
+        case ArgType::Double: {
+            if (isFloat) {
+                char c[2] = { conv, 0 };
+                AppendSpec(spec, len, c);
+                return snprintf(out, cap, spec, v.d);
+            }
+            AppendSpec(spec, len, "lld");
+            return snprintf(out, cap, spec, (long long)v.d);
+        }
+        case ArgType::Str: {
+            AppendSpec(spec, len, "s");
+            return snprintf(out, cap, spec, v.text == Detail::NO_TEXT ? "" : r.text + v.text);
+        }
+        case ArgType::WStr: {
+            char utf8[TEXT_BYTES * 2] = { 0 };
+            if (v.text != Detail::NO_TEXT) {
+                ToUtf8((const wchar_t*)(r.text + v.text), utf8, (int)sizeof(utf8));
+            }
+            AppendSpec(spec, len, "s");
+            return snprintf(out, cap, spec, utf8);
+        }
+        case ArgType::Ptr:
+            AppendSpec(spec, len, "p");
+            return snprintf(out, cap, spec, v.p);
+        }
+        return 0;
+    }
+
+    // 레코드 -> 한 줄 (시각, 스레드, 메시지)
+    size_t FormatRecord(const Record& r, char* out, size_t cap) {
+        int64_t elapsed = (int64_t)((r.ticks - g_baseTicks) * 10000000.0 / g_frequency);
+        WallTime t = ToWallTime(g_baseFileTime + elapsed);
+        int n = snprintf(out, cap, "%02u:%02u:%02u.%03u [%5lu] ", t.hour, t.minute, t.second, t.millisecond, (unsigned long)r.threadId);
+        size_t len = n > 0 ? (size_t)n : 0;
+
+        const char* p = r.fmt;
+        uint8_t arg = 0;
+        while (*p && len + 1 < cap) {
+            if (*p != '%') {
+                out[len++] = *p++;
+                continue;
+            }
+            if (p[1] == '%') {
+                out[len++] = '%';
+                p += 2;
+                continue;
+            }
+            // %[flags][width][.precision][length]conv
+            const char* flags = ++p;
+            while (*p && strchr("-+ #0", *p)) p++;
+            while (*p >= '0' && *p <= '9') p++;
+            if (*p == '.') {
+                p++;
+                while (*p >= '0' && *p <= '9') p++;
+            }
+            size_t flagsLen = (size_t)(p - flags);
+            while (*p && strchr("hljztL", *p)) p++;
+            char conv = *p;
+            if (!conv) break;
+            p++;
+            int written = (arg < r.argc) ? FormatArg(out + len, cap - len, flags, flagsLen, conv, r, arg++)
+                                         : snprintf(out + len, cap - len, "<?>");
+            if (written > 0) len = std::min(len + (size_t)written, cap - 1);
+        }
+        out[len] = 0;
+        // 줄바꿈으로 끝나지 않은 메시지
+        if (len > 0 && out[len - 1] != '\n' && len + 1 < cap) {
+            out[len++] = '\n';
+            out[len] = 0;
+        }
+        return len;
+    }
+
+    void WriteLine(const char* line, size_t len) {
+        WriteDebugger(line);
+        if (g_file) fwrite(line, 1, len, g_file);
+    }
+
+    // 모든 링을 비워 시간순으로 씀
+    void Flush(std::vector<Record>& batch, uint64_t& reportedDrops) {
+        batch.clear();
+        for (ThreadRing& ring : g_rings) {
+            uint32_t state = ring.state.load(std::memory_order_acquire);
+            if (state == RING_FREE) continue;
+            uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+            uint64_t head = ring.head.load(std::memory_order_acquire);
+            for (; tail != head; tail++) batch.push_back(ring.records[tail & (RING_RECORDS - 1)]);
+            ring.tail.store(tail, std::memory_order_release);
+            if (state == RING_CLOSED) {
+                uint32_t expected = RING_CLOSED;
+                ring.state.compare_exchange_strong(expected, RING_FREE);
+            }
+        }
+        std::stable_sort(batch.begin(), batch.end(), [](const Record& a, const Record& b) { return a.ticks < b.ticks; });
+
+        char line[1024];
+        for (const Record& r : batch) {
+            size_t len = FormatRecord(r, line, sizeof(line));
+            WriteLine(line, len);
+        }
+        uint64_t drops = GetDroppedCount();
+        if (drops != reportedDrops) {
+            int len = snprintf(line, sizeof(line), "[Log] %llu Records Dropped\n", (unsigned long long)(drops - reportedDrops));
+            if (len > 0) WriteLine(line, (size_t)len);
+            reportedDrops = drops;
+        }
+        if (g_file && !batch.empty()) fflush(g_file);
+    }
+
+    void WriterLoop() {
+        std::vector<Record> batch;
+        batch.reserve(RING_RECORDS * 4);
+        uint64_t reportedDrops = GetDroppedCount();
+        while (true) {
+            bool running = g_running.load(std::memory_order_acquire);
+            Flush(batch, reportedDrops);
+            if (!running) break;
+            WaitWake(FLUSH_INTERVAL_MS);
+        }
+    }
+
+    void OpenFile(const std::wstring& path) {
+        if (path.empty()) return;
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA info = {};
+        if (GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &info)) {
+            uint64_t size = ((uint64_t)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+            if (size > MAX_FILE_BYTES) MoveFileExW(path.c_str(), (path + L".old").c_str(), MOVEFILE_REPLACE_EXISTING);
+        }
+        if (_wfopen_s(&g_file, path.c_str(), L"ab") != 0) g_file = nullptr;
+#else
+        std::filesystem::path file(path);
+        std::error_code ec;
+        if (std::filesystem::file_size(file, ec) > MAX_FILE_BYTES && !ec) std::filesystem::rename(file, file.string() + ".old", ec);
+        g_file = fopen(file.c_str(), "ab");
+#endif
+    }
+}
+
+Record* BeginRecord() {
+    ThreadSlot& slot = t_slot;
+    if (!slot.ring) {
+        slot.ring = AcquireRing();
+        if (!slot.ring) {
+            g_noSlotDrops.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        slot.threadId = CurrentThreadId();
+    }
+    ThreadRing& ring = *slot.ring;
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= RING_RECORDS) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Record& r = ring.records[head & (RING_RECORDS - 1)];
+    r.ticks = ReadTicks();
+    r.threadId = slot.threadId;
+    return &r;
+}
+
+void CommitRecord() {
+    ThreadRing& ring = *t_slot.ring;
+    ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Start(const std::wstring& filePath) {
+    std::lock_guard<std::mutex> lock(g_lock);
+    if (g_refs++ > 0) return;
+
+    g_frequency = TickFrequency();
+    g_baseTicks = ReadTicks();
+    g_baseFileTime = ReadWallClock();
+
+    OpenFile(filePath);
+    if (g_file) {
+        WallTime t = ToWallTime(g_baseFileTime);
+        fprintf(g_file, "---- Delta_Cast %04u-%02u-%02u %02u:%02u:%02u (PID %lu) ----\n",
+            t.year, t.month, t.day, t.hour, t.minute, t.second, CurrentProcessId());
+    }
+    CreateWake();
+    g_running = true;
+    g_thread = std::thread(WriterLoop);
+}
+
+void Stop() {
+    std::lock_guard<std::mutex> lock(g_lock);
+    if (g_refs == 0 || --g_refs > 0) return;
+    g_running = false;
+    SignalWake();
+    if (g_thread.joinable()) g_thread.join();
+    DestroyWake();
+    if (g_file) { fclose(g_file); g_file = nullptr; }
+}
+
+uint64_t GetDroppedCount() {
+    uint64_t total = g_noSlotDrops.load(std::memory_order_relaxed);
+    for (const ThreadRing& ring : g_rings) total += ring.dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
+} // namespace DeltaLog
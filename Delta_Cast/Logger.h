@@ -0,0 +1,131 @@
+﻿#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+#include <string>
+#include <type_traits>
+
+// ---------------------------------------------------------------------------
+// 지연 바이너리 로거
+// 호출 스레드: 포맷 문자열 주소 + 인자 원시값만 스레드별 링에 복사 (포맷/잠금/할당 없음)
+// 기록 스레드: 주기적으로 모든 링을 모아 시간순으로 포맷, 디버거 출력과 로그 파일로 씀
+// 포맷 문자열은 정적 수명이어야 함 (문자열 리터럴). 문자열 인자는 레코드에 복사
+// 링이 가득 차거나 스레드 슬롯이 없으면 버리고 개수만 셈 (기록 스레드가 보고)
+// '*' 너비/정밀도는 지원하지 않음
+// ---------------------------------------------------------------------------
+namespace DeltaLog {
+    const size_t MAX_ARGS = 8;
+    const size_t TEXT_BYTES = 160;          // 레코드당 문자열 인자 공간
+    const size_t RING_RECORDS = 128;        // 스레드당 (2의 거듭제곱)
+    const size_t MAX_THREADS = 32;
+    const uint32_t FLUSH_INTERVAL_MS = 50;
+    const uint64_t MAX_FILE_BYTES = 4u << 20; // 시작 시 넘으면 .old 로 교체
+
+    enum class ArgType : uint8_t { Int, UInt, Double, Str, WStr, Ptr };
+
+    struct Record {
+        const char* fmt;
+        int64_t ticks;          // QueryPerformanceCounter
+        uint32_t threadId;
+        uint8_t argc;
+        ArgType types[MAX_ARGS];
+        uint16_t textUsed;
+        union Value {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const void* p;
+            uint32_t text;      // text[] 오프셋
+        } values[MAX_ARGS];
+        char text[TEXT_BYTES];
+    };
+
+    // 현재 스레드 링의 다음 레코드 (자리가 없으면 nullptr, 버림으로 셈)
+    Record* BeginRecord();
+    void CommitRecord();
+
+    // 기록 스레드 시작 (프로세스 공용, 참조 카운트). 경로가 비면 디버거 출력만
+    void Start(const std::wstring& filePath);
+    // 마지막 참조에서 남은 레코드를 모두 쓰고 종료
+    void Stop();
+    uint64_t GetDroppedCount();
+
+    namespace Detail {
+        const uint32_t NO_TEXT = 0xFFFFFFFFu;
+
+        inline uint32_t CopyText(Record& r, const void* src, size_t units, size_t unitSize) {
+            size_t offset = (r.textUsed + unitSize - 1) & ~(unitSize - 1);
+            if (offset + unitSize > TEXT_BYTES) return NO_TEXT;
+            size_t room = (TEXT_BYTES - offset) / unitSize - 1;
+            if (units > room) units = room;
+            memcpy(r.text + offset, src, units * unitSize);
+            memset(r.text + offset + units * unitSize, 0, unitSize);
+            r.textUsed = (uint16_t)(offset + (units + 1) * unitSize);
+            return (uint32_t)offset;
+        }
+        inline uint32_t CopyString(Record& r, const char* s) {
+            return s ? CopyText(r, s, strnlen(s, TEXT_BYTES), 1) : NO_TEXT;
+        }
+        inline uint32_t CopyString(Record& r, const wchar_t* s) {
+            return s ? CopyText(r, s, wcsnlen(s, TEXT_BYTES / 2), sizeof(wchar_t)) : NO_TEXT;
+        }
+
+        template <typename T>
+        inline void Capture(Record& r, const T& value) {
+            using V = std::decay_t<T>;
+            Record::Value& slot = r.values[r.argc];
+            ArgType& type = r.types[r.argc];
+            r.argc++;
+            if constexpr (std::is_same_v<V, const char*> || std::is_same_v<V, char*>) {
+                type = ArgType::Str;
+                slot.text = CopyString(r, value);
+            }
+            else if constexpr (std::is_same_v<V, const wchar_t*> || std::is_same_v<V, wchar_t*>) {
+                type = ArgType::WStr;
+                slot.text = CopyString(r, value);
+            }
+            else if constexpr (std::is_floating_point_v<V>) {
+                type = ArgType::Double;
+                slot.d = (double)value;
+            }
+            else if constexpr (std::is_enum_v<V>) {
+                type = ArgType::Int;
+                slot.i = (int64_t)value;
+            }
+            else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>) {
+                type = ArgType::Int;
+                slot.i = (int64_t)value;
+            }
+            else if constexpr (std::is_integral_v<V>) {
+                type = ArgType::UInt;
+                slot.u = (uint64_t)value;
+            }
+            else {
+                static_assert(std::is_pointer_v<V>, "unsupported log argument");
+                type = ArgType::Ptr;
+                slot.p = (const void*)value;
+            }
+        }
+    }
+
+    template <typename... Args>
+    inline void Write(const char* fmt, const Args&... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "too many log arguments");
+        Record* r = BeginRecord();
+        if (!r) return;
+        r->fmt = fmt;
+        r->argc = 0;
+        r->textUsed = 0;
+        (Detail::Capture(*r, args), ...);
+        CommitRecord();
+    }
+}
+
+// 드라이버 로그 (실시간 스레드에서도 호출 가능, 릴리스 빌드에서도 기록)
+template <typename... Args>
+inline void DebugLog(const char* fmt, const Args&... args) {
+    DeltaLog::Write(fmt, args...);
+}
@@ -0,0 +1,205 @@
+﻿#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <emmintrin.h>
+#include "TruePeak.h"
+#include "DeltaCastIpc.h"
+
+// ---------------------------------------------------------------------------
+// 라우드니스 분석 (ITU-R BS.1770-4 / EBU R128, 스테레오)
+// K-weighting 2단 바이쿼드를 L/R 두 레인(SSE2 double)으로 동시 처리
+// 100ms 홉 단위 에너지로 모멘터리(400ms), 숏텀(3s), 인티그레이티드(게이팅) 계산
+// 인티그레이티드는 0.1 LU 히스토그램으로 길이 제한 없이 고정 메모리
+// ---------------------------------------------------------------------------
+class LoudnessAnalyzer {
+public:
+    static const int SHORT_TERM_HOPS = 30; // 3s
+    static const int MOMENTARY_HOPS = 4;   // 400ms
+    static constexpr double ABSOLUTE_GATE = -70.0;
+    static constexpr double RELATIVE_GATE = -10.0;
+    static constexpr double HIST_MIN = -70.0;
+    static constexpr double HIST_STEP = 0.1;
+    static const int HIST_BINS = 1000;     // -70 ~ +30 LUFS
+    static const size_t PEAK_BLOCK = 1024;
+
+    void Setup(double sampleRate) {
+        m_sampleRate = sampleRate;
+        m_hopFrames = std::max<size_t>(1, (size_t)std::lround(sampleRate / 10.0));
+
+        // 1단: 하이 쉘프 (머리 효과)
+        const double PI = 3.14159265358979323846;
+        double f0 = 1681.974450955533, G = 3.999843853973347, Q = 0.7071752369554196;
+        double K = std::tan(PI * f0 / sampleRate);
+        double Vh = std::pow(10.0, G / 20.0);
+        double Vb = std::pow(Vh, 0.4996667741545416);
+        double a0 = 1.0 + K / Q + K * K;
+        m_stage[0] = { (Vh + Vb * K / Q + K * K) / a0, 2.0 * (K * K - Vh) / a0, (Vh - Vb * K / Q + K * K) / a0,
+                       2.0 * (K * K - 1.0) / a0, (1.0 - K / Q + K * K) / a0 };
+        // 2단: 하이패스 (RLB)
+        f0 = 38.13547087602444; Q = 0.5003270373238773;
+        K = std::tan(PI * f0 / sampleRate);
+        a0 = 1.0 + K / Q + K * K;
+        m_stage[1] = { 1.0, -2.0, 1.0, 2.0 * (K * K - 1.0) / a0, (1.0 - K / Q + K * K) / a0 };
+
+        for (auto& d : m_peak) d.Setup(PEAK_BLOCK);
+        m_peakScratch.assign(PEAK_BLOCK, 0.0f);
+        Reset();
+    }
+
+    void Reset() {
+        for (auto& z : m_state) z = _mm_setzero_pd();
+        m_hopWeighted = _mm_setzero_pd();
+        m_hopPlain = _mm_setzero_pd();
+        m_hopFill = 0;
+        m_hopCount = 0;
+        std::fill(std::begin(m_weighted), std::end(m_weighted), 0.0);
+        std::fill(std::begin(m_plainL), std::end(m_plainL), 0.0);
+        std::fill(std::begin(m_plainR), std::end(m_plainR), 0.0);
+        std::fill(std::begin(m_histCount), std::end(m_histCount), 0u);
+        std::fill(std::begin(m_histEnergy), std::end(m_histEnergy), 0.0);
+        m_truePeak[0] = m_truePeak[1] = 0.0f;
+        m_frames = 0;
+        for (auto& d : m_peak) d.Reset();
+    }
+
+    void Process(const float* left, const float* right, size_t count) {
+        // 트루피크
+        for (size_t offset = 0; offset < count; offset += PEAK_BLOCK) {
+            size_t n = std::min(PEAK_BLOCK, count - offset);
+            const float* ch[2] = { left + offset, right + offset };
+            for (int c = 0; c < 2; c++) {
+                m_peak[c].Process(ch[c], n, m_peakScratch.data(), false);
+                m_truePeak[c] = std::max(m_truePeak[c], *std::max_element(m_peakScratch.begin(), m_peakScratch.begin() + n));
+            }
+        }
+
+        // K-weighting (TDF-II, 레인 0 = L, 레인 1 = R)
+        const __m128d b0a = _mm_set1_pd(m_stage[0].b0), b1a = _mm_set1_pd(m_stage[0].b1), b2a = _mm_set1_pd(m_stage[0].b2);
+        const __m128d a1a = _mm_set1_pd(m_stage[0].a1), a2a = _mm_set1_pd(m_stage[0].a2);
+        const __m128d b0b = _mm_set1_pd(m_stage[1].b0), b1b = _mm_set1_pd(m_stage[1].b1), b2b = _mm_set1_pd(m_stage[1].b2);
+        const __m128d a1b = _mm_set1_pd(m_stage[1].a1), a2b = _mm_set1_pd(m_stage[1].a2);
+        __m128d z1a = m_state[0], z2a = m_state[1], z1b = m_state[2], z2b = m_state[3];
+        __m128d sumW = m_hopWeighted, sumP = m_hopPlain;
+
+        for (size_t i = 0; i < count; i++) {
+            __m128d x = _mm_set_pd((double)right[i], (double)left[i]);
+            sumP = _mm_add_pd(sumP, _mm_mul_pd(x, x));
+
+            __m128d y = _mm_add_pd(_mm_mul_pd(b0a, x), z1a);
+            z1a = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1a, x), _mm_mul_pd(a1a, y)), z2a);
+            z2a = _mm_sub_pd(_mm_mul_pd(b2a, x), _mm_mul_pd(a2a, y));
+
+            __m128d k = _mm_add_pd(_mm_mul_pd(b0b, y), z1b);
+            z1b = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1b, y), _mm_mul_pd(a1b, k)), z2b);
+            z2b = _mm_sub_pd(_mm_mul_pd(b2b, y), _mm_mul_pd(a2b, k));
+            sumW = _mm_add_pd(sumW, _mm_mul_pd(k, k));
+
+            if (++m_hopFill == m_hopFrames) {
+                m_hopWeighted = sumW;
+                m_hopPlain = sumP;
+                FinishHop();
+                sumW = sumP = _mm_setzero_pd();
+            }
+        }
+        m_state[0] = z1a; m_state[1] = z2a; m_state[2] = z1b; m_state[3] = z2b;
+        m_hopWeighted = sumW;
+        m_hopPlain = sumP;
+        m_frames += count;
+    }
+
+    void GetSnapshot(DeltaCastIpc::MeterSnapshot& s) const {
+        s.momentaryLufs = ToLufs(MeanHops(m_weighted, MOMENTARY_HOPS));
+        s.shortTermLufs = ToLufs(MeanHops(m_weighted, SHORT_TERM_HOPS));
+        s.integratedLufs = Integrated();
+        for (int c = 0; c < 2; c++) s.truePeakDb[c] = ToDb(m_truePeak[c]);
+        s.rmsDb[0] = PowerToDb(MeanHops(m_plainL, MOMENTARY_HOPS));
+        s.rmsDb[1] = PowerToDb(MeanHops(m_plainR, MOMENTARY_HOPS));
+        s.frames = m_frames;
+        s.sampleRate = m_sampleRate;
+    }
+
+private:
+    struct Biquad { double b0, b1, b2, a1, a2; };
+
+    void FinishHop() {
+        double e[2], p[2];
+        _mm_storeu_pd(e, m_hopWeighted);
+        _mm_storeu_pd(p, m_hopPlain);
+        size_t slot = m_hopCount % SHORT_TERM_HOPS;
+        m_weighted[slot] = (e[0] + e[1]) / (double)m_hopFrames; // 채널 가중치 1.0 합
+        m_plainL[slot] = p[0] / (double)m_hopFrames;
+        m_plainR[slot] = p[1] / (double)m_hopFrames;
+        m_hopCount++;
+        m_hopFill = 0;
+
+        // 400ms 게이팅 블록 (75% 겹침)
+        if (m_hopCount >= MOMENTARY_HOPS) {
+            double blockEnergy = MeanHops(m_weighted, MOMENTARY_HOPS);
+            double lufs = ToLufs(blockEnergy);
+            if (lufs > ABSOLUTE_GATE) {
+                int bin = std::clamp((int)((lufs - HIST_MIN) / HIST_STEP), 0, HIST_BINS - 1);
+                m_histCount[bin]++;
+                m_histEnergy[bin] += blockEnergy;
+            }
+        }
+    }
+
+    // 최근 hops 개 홉 평균 (채워진 만큼만)
+    double MeanHops(const double* ring, int hops) const {
+        size_t available = (size_t)std::min<uint64_t>(m_hopCount, (uint64_t)hops);
+        if (available == 0) return 0.0;
+        double sum = 0.0;
+        for (size_t i = 0; i < available; i++) sum += ring[(m_hopCount - 1 - i) % SHORT_TERM_HOPS];
+        return sum / (double)available;
+    }
+
+    double Integrated() const {
+        // 절대 게이트 통과 블록의 평균 -> 상대 게이트
+        uint64_t count = 0;
+        double energy = 0.0;
+        for (int i = 0; i < HIST_BINS; i++) { count += m_histCount[i]; energy += m_histEnergy[i]; }
+        if (count == 0) return DeltaCastIpc::METER_FLOOR_DB;
+        double gate = ToLufs(energy / (double)count) + RELATIVE_GATE;
+        int firstBin = std::clamp((int)std::ceil((gate - HIST_MIN) / HIST_STEP), 0, HIST_BINS);
+
+        count = 0;
+        energy = 0.0;
+        for (int i = firstBin; i < HIST_BINS; i++) { count += m_histCount[i]; energy += m_histEnergy[i]; }
+        return count ? ToLufs(energy / (double)count) : DeltaCastIpc::METER_FLOOR_DB;
+    }
+
+    static double ToLufs(double energy) {
+        return (energy > 0.0) ? std::max(-0.691 + 10.0 * std::log10(energy), DeltaCastIpc::METER_FLOOR_DB) : DeltaCastIpc::METER_FLOOR_DB;
+    }
+    static double PowerToDb(double power) {
+        return (power > 0.0) ? std::max(10.0 * std::log10(power), DeltaCastIpc::METER_FLOOR_DB) : DeltaCastIpc::METER_FLOOR_DB;
+    }
+    static double ToDb(float amplitude) {
+        return (amplitude > 0.0f) ? std::max(20.0 * std::log10((double)amplitude), DeltaCastIpc::METER_FLOOR_DB) : DeltaCastIpc::METER_FLOOR_DB;
+    }
+
+    double m_sampleRate = 48000.0;
+    size_t m_hopFrames = 4800;
+    Biquad m_stage[2] = {};
+    __m128d m_state[4] = {};
+
+    // 진행 중인 홉
+    __m128d m_hopWeighted = {}, m_hopPlain = {};
+    size_t m_hopFill = 0;
+    uint64_t m_hopCount = 0;
+
+    // 최근 3s 홉 에너지 (원형)
+    double m_weighted[SHORT_TERM_HOPS] = {};
+    double m_plainL[SHORT_TERM_HOPS] = {};
+    double m_plainR[SHORT_TERM_HOPS] = {};
+
+    // 인티그레이티드 게이팅 히스토그램
+    uint32_t m_histCount[HIST_BINS] = {};
+    double m_histEnergy[HIST_BINS] = {};
+
+    TruePeakDetector m_peak[2];
+    std::vector<float> m_peakScratch;
+    float m_truePeak[2] = { 0.0f, 0.0f };
+    uint64_t m_frames = 0;
+};
@@ -0,0 +1,91 @@
+﻿#include "LoudnessMeter.h"
+#include "SampleConvert.h"
+#include "ThreadPlacement.h"
+#include "Logger.h"
+#include <algorithm>
+
+CLoudnessMeter::CLoudnessMeter() {}
+CLoudnessMeter::~CLoudnessMeter() { Stop(); }
+
+bool CLoudnessMeter::Start(const ByteRingBuffer* pBufferL, const ByteRingBuffer* pBufferR,
+    ASIOSampleType sampleType, double sampleRate)
+{
+    if (m_bRunning) return true;
+
+    m_inSampleSize = GetAsioSampleSize(sampleType);
+    if (m_inSampleSize == 0) return false;
+    m_sampleType = sampleType;
+
+    // 분석기와 버퍼는 여기서 전부 준비 (미터 스레드에서 할당 없음)
+    m_analyzer.Setup(sampleRate);
+    const size_t maxFrames = 8192;
+    m_rawL.resize(maxFrames * m_inSampleSize);
+    m_rawR.resize(maxFrames * m_inSampleSize);
+    m_floatL.resize(maxFrames);
+    m_floatR.resize(maxFrames);
+
+    // 외부 표시용 (실패해도 프로세스 내 스냅샷은 동작)
+    if (m_channel.Create()) DebugLog("[DeltaCast] Meter Channel: Slot %d\n", m_channel.GetSlot());
+
+    m_tap.Attach(pBufferL, pBufferR);
+    m_hStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    m_bRunning = true;
+    m_thread = std::thread(&CLoudnessMeter::MeterThreadFunc, this);
+    return true;
+}
+
+void CLoudnessMeter::Stop() {
+    if (!m_bRunning) return;
+    m_bRunning = false;
+    if (m_hStopEvent) SetEvent(m_hStopEvent);
+    if (m_thread.joinable()) m_thread.join();
+
+    m_tap.Detach();
+    m_channel.Close();
+    if (m_hStopEvent) { CloseHandle(m_hStopEvent); m_hStopEvent = nullptr; }
+}
+
+void CLoudnessMeter::MeterThreadFunc() {
+    ThreadPlacement::Scope placement(ThreadRole::Background);
+
+    while (m_bRunning) {
+        DrainTap();
+        WaitForSingleObject(m_hStopEvent, POLL_INTERVAL_MS);
+    }
+}
+
+void CLoudnessMeter::DrainTap() {
+    const size_t maxFrames = m_floatL.size();
+    bool updated = false;
+    for (;;) {
+        // 추월당한 구간은 건너뜀 (미터는 타임라인 유지 불필요), 레이트 표시에서 끊어 읽음
+        size_t toRead = std::min(maxFrames * m_inSampleSize, m_tap.BytesToRateMark());
+        size_t got = m_tap.Pop(m_rawL.data(), m_rawR.data(), toRead);
+        size_t frames = got / m_inSampleSize;
+        if (frames > 0) {
+            ConvertSamplesToFloat(m_sampleType, m_rawL.data(), m_floatL.data(), frames);
+            ConvertSamplesToFloat(m_sampleType, m_rawR.data(), m_floatR.data(), frames);
+            m_analyzer.Process(m_floatL.data(), m_floatR.data(), frames);
+            updated = true;
+        }
+
+        // 레이트가 바뀌면 K-가중 필터를 새 레이트로 다시 설계 (적분도 새로 시작)
+        double rate = 0.0;
+        if (m_tap.TakeRateChange(rate)) {
+            if (rate > 0.0) {
+                m_analyzer.Setup(rate);
+                DebugLog("[Meter] Rate Changed: %.0f Hz\n", rate);
+                updated = true;
+            }
+            continue;
+        }
+        if (frames == 0) break;
+    }
+
+    if (updated) {
+        DeltaCastIpc::MeterSnapshot snapshot;
+        m_analyzer.GetSnapshot(snapshot);
+        m_snapshot.Store(snapshot);
+        m_channel.Publish(snapshot);
+    }
+}
@@ -0,0 +1,54 @@
+﻿#pragma once
+#include <windows.h>
+#ifndef MY_ASIO
+#define MY_ASIO
+#include <iasiodrv.h>
+#endif
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "RingBuffer.h"
+#include "Loudness.h"
+#include "DeltaCastIpc.h"
+
+// ---------------------------------------------------------------------------
+// 라우드니스/피크 미터
+// 송출 링버퍼를 보조 커서로 읽어 저우선순위 스레드에서 분석 (콜백/렌더 스레드 부담 없음)
+// 결과는 시퀀스 락 스냅샷으로 게시 (프로세스 내 + METER_NAME 공유 메모리)
+// ---------------------------------------------------------------------------
+class CLoudnessMeter {
+public:
+    static constexpr DWORD POLL_INTERVAL_MS = 50;
+
+    CLoudnessMeter();
+    ~CLoudnessMeter();
+
+    bool Start(const ByteRingBuffer* pBufferL, const ByteRingBuffer* pBufferR,
+        ASIOSampleType sampleType, double sampleRate);
+    void Stop();
+
+    bool IsRunning() const { return m_bRunning; }
+
+    // 최근 스냅샷 (아직 없으면 false)
+    bool GetSnapshot(DeltaCastIpc::MeterSnapshot& snapshot) const { return m_snapshot.Load(snapshot); }
+
+private:
+    void MeterThreadFunc();
+    void DrainTap();
+
+    std::atomic<bool> m_bRunning{ false };
+    std::thread m_thread;
+    HANDLE m_hStopEvent = nullptr;
+
+    RingTap m_tap;
+    ASIOSampleType m_sampleType = ASIOSTFloat32LSB;
+    int m_inSampleSize = 4;
+
+    LoudnessAnalyzer m_analyzer;
+    DeltaCastIpc::SeqLock<DeltaCastIpc::MeterSnapshot> m_snapshot;
+    DeltaCastIpc::MeterChannel m_channel;
+
+    // 변환용 임시 버퍼
+    std::vector<uint8_t> m_rawL, m_rawR;
+    std::vector<float> m_floatL, m_floatR;
+};
@@ -0,0 +1,116 @@
+﻿#include "OutputGroup.h"
+#include "WasapiSink.h"
+#include "FileSink.h"
+#include "Logger.h"
+
+static const char* StateName(RenderState state) {
+    switch (state) {
+    case RenderState::Opening: return "Opening";
+    case RenderState::Running: return "Running";
+    case RenderState::Recovering: return "Recovering";
+    default: return "Stopped";
+    }
+}
+
+std::unique_ptr<IOutputSink> CreateSink(SinkType type, const std::wstring& filePath) {
+    switch (type) {
+    case SinkType::Null: return std::make_unique<NullSink>();
+    case SinkType::File: return std::make_unique<FileSink>(filePath);
+    default: return std::make_unique<CWasapiSink>();
+    }
+}
+
+COutputGroup::~COutputGroup() { Close(); }
+
+void COutputGroup::Configure(const std::vector<OutputConfig>& outputs, const ArenaOptions& arenaOptions) {
+    Close();
+    m_count = 0;
+    for (const OutputConfig& config : outputs) {
+        if (m_count >= MAX_EXTRA_OUTPUTS) break;
+        std::unique_ptr<Output> output = std::make_unique<Output>();
+        output->config = config;
+        output->engine.SetTapMode(true);
+        output->engine.SetGainStage(&output->gain);
+        output->engine.SetSink(CreateSink(config.type, config.filePath));
+        output->engine.SetArenaOptions(arenaOptions);
+        m_outputs[m_count++] = std::move(output);
+    }
+    // 남은 슬롯 정리 (이전 구성이 더 많았던 경우)
+    for (size_t i = m_count; i < MAX_EXTRA_OUTPUTS; i++) m_outputs[i].reset();
+}
+
+void COutputGroup::Open() {
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->engine.Open(m_outputs[i]->config.deviceId);
+}
+
+void COutputGroup::Close() {
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->engine.Close();
+}
+
+void COutputGroup::Start(ByteRingBuffer* pBufferL, ByteRingBuffer* pBufferR,
+    ASIOSampleType sampleType, double inputSampleRate, size_t threshold)
+{
+    for (size_t i = 0; i < m_count; i++) {
+        Output& output = *m_outputs[i];
+        output.engine.Start(pBufferL, pBufferR, output.config.deviceId, sampleType, inputSampleRate, threshold);
+    }
+}
+
+void COutputGroup::Stop() {
+    // 엔진 Stop 은 렌더 스레드가 링에서 손을 뗄 때까지 대기 (출력당 최대 한 주기)
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->engine.Stop();
+}
+
+void COutputGroup::SetGain(const double gainDb[2], bool mute, const DuckingSettings& ducking) {
+    for (size_t i = 0; i < m_count; i++) {
+        GainStage& gain = m_outputs[i]->gain;
+        gain.SetGainDb(0, gainDb[0]);
+        gain.SetGainDb(1, gainDb[1]);
+        gain.SetMute(mute);
+        gain.SetDucking(ducking);
+    }
+}
+
+void COutputGroup::SetLimiter(const LimiterSettings& settings) {
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->engine.SetLimiter(settings);
+}
+
+void COutputGroup::SetEffects(const std::vector<EffectSettings>& effects) {
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->engine.SetEffects(effects);
+}
+
+void COutputGroup::SetConcealment(bool enabled) {
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->engine.SetConcealment(enabled);
+}
+
+void COutputGroup::SetThreshold(size_t threshold) {
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->engine.SetThreshold(threshold);
+}
+
+void COutputGroup::SetStallTimeout(std::chrono::milliseconds timeout) {
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->engine.SetStallTimeout(timeout);
+}
+
+void COutputGroup::PushKeyPeak(float peak) {
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->gain.PushKeyPeak(peak);
+}
+
+void COutputGroup::RecordProducerBlock(uint32_t frames) {
+    for (size_t i = 0; i < m_count; i++) m_outputs[i]->engine.RecordProducerBlock(frames);
+}
+
+RenderEngineStats COutputGroup::GetStats(size_t index) const {
+    if (index >= m_count) return RenderEngineStats();
+    return m_outputs[index]->engine.GetStats();
+}
+
+void COutputGroup::LogStats() const {
+    for (size_t i = 0; i < m_count; i++) {
+        RenderEngineStats stats = m_outputs[i]->engine.GetStats();
+        DebugLog("[Output%zu] %s, CPU %.1f%% (Peak %.1f%%), Latency %.1f ms, Drift %.1f ppm, Glitches %llu\n",
+            i + 2, StateName(stats.state), stats.cpuLoad * 100.0, stats.cpuPeak * 100.0, stats.latencyMs,
+            stats.driftPpm, stats.glitches);
+        DebugLog("[Output%zu] Tap Dropped %llu bytes, Silent Periods %llu, Host Stalls %u (Longest %.1f ms)\n", i + 2,
+            stats.tapDroppedBytes, stats.silentPeriods, stats.stalls, stats.longestStallMs);
+    }
+}
@@ -0,0 +1,68 @@
+﻿#pragma once
+#include <windows.h>
+#ifndef MY_ASIO
+#define MY_ASIO
+#include <iasiodrv.h>
+#endif
+#include <vector>
+#include <string>
+#include <memory>
+#include "RenderEngine.h"
+
+// 추가 출력 설정 (INI [Output2] ~ [Output8])
+struct OutputConfig {
+    SinkType type = SinkType::Wasapi;
+    std::wstring deviceId;  // Wasapi (빈 값: 기본 장치)
+    std::wstring filePath;  // File
+};
+
+// 싱크 생성 (주 출력과 추가 출력 공용)
+std::unique_ptr<IOutputSink> CreateSink(SinkType type, const std::wstring& filePath);
+
+// ---------------------------------------------------------------------------
+// 추가 출력 묶음 (주 출력 외 최대 7개)
+// 출력마다 탭 모드 렌더 엔진 하나: 자체 스레드, 읽기 커서, 리샘플러, 장치 포맷, 드리프트 보정
+// 각 스레드는 자기 장치 이벤트로만 깨어나므로 느리거나 레이트가 높은 출력이 다른 출력을 늦추지 않음
+// 송출 링은 주 출력만 소비 (추가 출력이 밀리면 추월 구간을 건너뜀)
+// ---------------------------------------------------------------------------
+class COutputGroup {
+public:
+    static const size_t MAX_EXTRA_OUTPUTS = 7;
+
+    ~COutputGroup();
+
+    // 출력 구성 (닫힌 상태에서, 제어 스레드)
+    void Configure(const std::vector<OutputConfig>& outputs, const ArenaOptions& arenaOptions);
+    void Open();
+    void Close();
+
+    // 재생 전환 (주 출력과 같은 링/포맷/임계값)
+    void Start(ByteRingBuffer* pBufferL, ByteRingBuffer* pBufferR,
+        ASIOSampleType sampleType, double inputSampleRate, size_t threshold);
+    // 반환 후 어떤 출력도 링에 접근하지 않음
+    void Stop();
+
+    // 처리 설정 (주 출력과 동일하게, 제어 스레드)
+    void SetGain(const double gainDb[2], bool mute, const DuckingSettings& ducking);
+    void SetLimiter(const LimiterSettings& settings);
+    void SetEffects(const std::vector<EffectSettings>& effects);
+    void SetConcealment(bool enabled);
+    void SetThreshold(size_t threshold);
+    void SetStallTimeout(std::chrono::milliseconds timeout);
+    // 덕킹 키 / 블록 도착 시각 (버퍼 스위치 스레드)
+    void PushKeyPeak(float peak);
+    void RecordProducerBlock(uint32_t frames);
+
+    size_t GetCount() const { return m_count; }
+    RenderEngineStats GetStats(size_t index) const;
+    void LogStats() const;
+
+private:
+    struct Output {
+        OutputConfig config;
+        GainStage gain;
+        CRenderEngine engine;
+    };
+    std::unique_ptr<Output> m_outputs[MAX_EXTRA_OUTPUTS];
+    size_t m_count = 0;
+};
@@ -0,0 +1,112 @@
+﻿#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+
+// ---------------------------------------------------------------------------
+// 출력 싱크 (렌더 엔진이 구동)
+// 모든 메서드는 렌더 스레드에서 호출 (Open/Close 포함 같은 스레드)
+// 실패는 SinkStatus 로 보고: Lost 는 장치 소실 (엔진이 닫고 재연결)
+// ---------------------------------------------------------------------------
+struct SinkFormat {
+    double sampleRate = 48000.0;
+    int channels = 2;
+    int bitDepth = 32;
+    bool isFloat = true;
+    uint32_t bufferFrames = 0; // 장치 버퍼 용량
+    int BlockAlign() const { return channels * bitDepth / 8; }
+};
+
+enum class SinkStatus { Ok, Timeout, Lost, Error };
+
+enum class SinkType { Wasapi, Null, File };
+
+class IOutputSink {
+public:
+    virtual ~IOutputSink() = default;
+    virtual const char* GetName() const = 0;
+
+    // deviceId 가 비어 있으면 기본 장치. preferredRate 는 장치가 레이트를 고를 수 있을 때만 사용
+    virtual bool Open(const std::wstring& deviceId, double preferredRate, SinkFormat& format) = 0;
+    virtual void Close() = 0;
+    virtual bool Start() = 0;
+
+    // 다음 주기까지 대기
+    virtual SinkStatus WaitForPeriod(uint32_t timeoutMs) = 0;
+    // 이번 주기에 쓸 버퍼 (frames == 0 이면 쓸 자리 없음)
+    virtual SinkStatus GetBuffer(uint32_t& frames, uint8_t*& data) = 0;
+    virtual SinkStatus ReleaseBuffer(uint32_t frames) = 0;
+};
+
+// ---------------------------------------------------------------------------
+// 타이머 구동 싱크 공통 (float32 스테레오, 실시간 속도로 소비)
+// ---------------------------------------------------------------------------
+class PacedSink : public IOutputSink {
+public:
+    static constexpr double PERIOD_SEC = 0.01;
+
+    using Clock = std::chrono::steady_clock;
+
+    bool Open(const std::wstring& deviceId, double preferredRate, SinkFormat& format) override {
+        format = SinkFormat();
+        if (preferredRate > 0.0) format.sampleRate = preferredRate;
+        format.bufferFrames = (uint32_t)std::lround(format.sampleRate * PERIOD_SEC * 2.0);
+        m_format = format;
+        m_buffer.assign((size_t)format.bufferFrames * format.channels, 0.0f);
+        return OnOpen(deviceId);
+    }
+
+    void Close() override { OnClose(); }
+
+    bool Start() override {
+        m_start = Clock::now();
+        m_next = m_start;
+        m_written = 0;
+        return true;
+    }
+
+    SinkStatus WaitForPeriod(uint32_t /*timeoutMs*/) override {
+        auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(PERIOD_SEC));
+        m_next += period;
+        auto now = Clock::now();
+        if (m_next < now) m_next = now;
+        std::this_thread::sleep_until(m_next);
+        return SinkStatus::Ok;
+    }
+
+    SinkStatus GetBuffer(uint32_t& frames, uint8_t*& data) override {
+        // 장치처럼 버퍼 절반을 선행 유지
+        double elapsed = std::chrono::duration<double>(Clock::now() - m_start).count();
+        uint64_t due = (uint64_t)(elapsed * m_format.sampleRate) + m_format.bufferFrames / 2;
+        uint64_t pending = (due > m_written) ? due - m_written : 0;
+        frames = (uint32_t)std::min<uint64_t>(pending, m_format.bufferFrames);
+        data = (uint8_t*)m_buffer.data();
+        return SinkStatus::Ok;
+    }
+
+    SinkStatus ReleaseBuffer(uint32_t frames) override {
+        OnData(m_buffer.data(), frames);
+        m_written += frames;
+        return SinkStatus::Ok;
+    }
+
+protected:
+    virtual bool OnOpen(const std::wstring& /*deviceId*/) { return true; }
+    virtual void OnClose() {}
+    virtual void OnData(const float* /*interleaved*/, uint32_t /*frames*/) {}
+
+    SinkFormat m_format;
+    std::vector<float> m_buffer;
+    Clock::time_point m_start, m_next;
+    uint64_t m_written = 0;
+};
+
+// 출력 없음 (장치 없이 파이프라인만 구동)
+class NullSink : public PacedSink {
+public:
+    const char* GetName() const override { return "Null"; }
+};
@@ -0,0 +1,110 @@
+﻿#pragma once
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+
+// ---------------------------------------------------------------------------
+// PLL 페이싱 컨트롤러
+// 링버퍼 채움량을 목표치에 고정하도록 가상 클럭 주기를 연속 보정 (PI 루프)
+// ---------------------------------------------------------------------------
+struct PacingState {
+    double fillSeconds = 0.0;   // 평활된 채움량 (초)
+    double targetSeconds = 0.0; // 목표 채움량 (초)
+    double errorSeconds = 0.0;  // 목표 대비 오차 (초, + 는 과잉)
+    double correctionPpm = 0.0; // 현재 적용 중인 주기 보정량
+    double driftPpm = 0.0;      // 적분기 = 추정된 소비 속도 편차
+};
+
+class PacingController {
+public:
+    // 루프 대역폭 0.05Hz, 감쇠비 0.707
+    static constexpr double LOOP_BANDWIDTH_HZ = 0.05;
+    static constexpr double DAMPING = 0.707;
+    // 채움량 평활 시정수 (소비측 주기 톱니파 제거)
+    static constexpr double FILL_SMOOTHING_SEC = 0.2;
+    // 보정 한계 (±0.5%)
+    static constexpr double MAX_CORRECTION_PPM = 5000.0;
+    // 밴드 밖에서는 비례 이득을 키워 빠르게 복귀
+    static constexpr double OUT_OF_BAND_GAIN = 4.0;
+
+    // blockSeconds: 블록 주기, targetSeconds: 목표 채움량, band: 허용 범위 (초)
+    void Setup(double blockSeconds, double targetSeconds, double bandLowSeconds, double bandHighSeconds) {
+        m_blockSeconds = blockSeconds;
+        m_targetSeconds = targetSeconds;
+        m_bandLow = bandLowSeconds;
+        m_bandHigh = bandHighSeconds;
+
+        double wn = 2.0 * 3.14159265358979323846 * LOOP_BANDWIDTH_HZ;
+        m_kp = 2.0 * DAMPING * wn;
+        m_ki = wn * wn;
+        m_alpha = std::min(1.0, blockSeconds / FILL_SMOOTHING_SEC);
+
+        Reset();
+    }
+
+    void Reset() {
+        m_fill = -1.0;
+        m_integral = 0.0;
+        m_correction = 0.0;
+        Publish(0.0, 0.0);
+    }
+
+    // 블록마다 호출. 반환값: 이번 블록 주기에 곱할 배율 (1.0 + 보정)
+    double Update(double fillSeconds) {
+        // 채움량 평활 (첫 호출은 그대로 사용)
+        if (m_fill < 0.0) m_fill = fillSeconds;
+        else m_fill += m_alpha * (fillSeconds - m_fill);
+
+        // 오차 (+ 면 버퍼 과잉 -> 주기를 늘려 생산을 늦춤)
+        double error = m_fill - m_targetSeconds;
+        double kp = m_kp;
+        if (m_fill < m_bandLow || m_fill > m_bandHigh) kp *= OUT_OF_BAND_GAIN;
+
+        // 적분기 (anti-windup: 한계 내로 고정)
+        const double limit = MAX_CORRECTION_PPM * 1e-6;
+        m_integral = std::clamp(m_integral + m_ki * error * m_blockSeconds, -limit, limit);
+
+        m_correction = std::clamp(kp * error + m_integral, -limit, limit);
+        Publish(error, m_correction);
+        return 1.0 + m_correction;
+    }
+
+    // 텔레메트리 (다른 스레드에서 호출 가능)
+    PacingState GetState() const {
+        PacingState s;
+        s.fillSeconds = m_pubFill.load(std::memory_order_relaxed);
+        s.targetSeconds = m_pubTarget.load(std::memory_order_relaxed);
+        s.errorSeconds = m_pubError.load(std::memory_order_relaxed);
+        s.correctionPpm = m_pubCorrection.load(std::memory_order_relaxed);
+        s.driftPpm = m_pubDrift.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    void Publish(double error, double correction) {
+        m_pubFill.store(m_fill < 0.0 ? 0.0 : m_fill, std::memory_order_relaxed);
+        m_pubTarget.store(m_targetSeconds, std::memory_order_relaxed);
+        m_pubError.store(error, std::memory_order_relaxed);
+        m_pubCorrection.store(correction * 1e6, std::memory_order_relaxed);
+        m_pubDrift.store(m_integral * 1e6, std::memory_order_relaxed);
+    }
+
+    double m_blockSeconds = 0.0;
+    double m_targetSeconds = 0.0;
+    double m_bandLow = 0.0;
+    double m_bandHigh = 0.0;
+    double m_kp = 0.0;
+    double m_ki = 0.0;
+    double m_alpha = 1.0;
+
+    double m_fill = -1.0;
+    double m_integral = 0.0;
+    double m_correction = 0.0;
+
+    // 텔레메트리 공개값
+    std::atomic<double> m_pubFill{ 0.0 };
+    std::atomic<double> m_pubTarget{ 0.0 };
+    std::atomic<double> m_pubError{ 0.0 };
+    std::atomic<double> m_pubCorrection{ 0.0 };
+    std::atomic<double> m_pubDrift{ 0.0 };
+};
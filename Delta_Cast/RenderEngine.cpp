@@ -0,0 +1,932 @@
+﻿#include "RenderEngine.h"
+#include "SampleConvert.h"
+#include "RtCheck.h"
+#include "Logger.h"
+#include "ThreadPlacement.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+CRenderEngine::CRenderEngine() {}
+CRenderEngine::~CRenderEngine() { Close(); }
+
+void CRenderEngine::SetSink(std::unique_ptr<IOutputSink> sink) {
+    // 열려 있는 동안 교체는 지원하지 않음 (렌더 스레드가 사용 중)
+    if (m_bRunning) return;
+    m_sink = std::move(sink);
+}
+
+bool CRenderEngine::Open(const std::wstring& deviceId) {
+    if (m_bRunning) return true;
+    if (!m_sink) return false;
+
+    // 이전 세션에서 남은 명령 정리 (스레드가 없으므로 여기서 소비해도 됨)
+    RtCommand stale;
+    while (m_commands.Pop(stale)) {}
+    m_requestedThreshold.store(NO_THRESHOLD);
+    m_appliedSeq.store(m_controlSeq);
+
+    m_targetDevice = deviceId;
+    m_openDevice = deviceId;
+    m_device.Reset(new std::wstring(deviceId));
+    m_playing = false;
+    m_glitchCount = 0;
+    m_reconnects = 0;
+    m_lastReconnectMs = 0.0;
+    m_usingFallback = false;
+
+    m_bRunning = true;
+    m_state = RenderState::Opening;
+    // 우선순위/코어 배치는 렌더 스레드가 시작하면서 스스로 적용
+    m_renderThread = std::thread(&CRenderEngine::RenderThreadFunc, this);
+    return true;
+}
+
+void CRenderEngine::Close() {
+    m_bRunning = false;
+    if (m_renderThread.joinable()) {
+        m_renderThread.join();
+    }
+    m_playing = false;
+}
+
+void CRenderEngine::SetDevice(const std::wstring& deviceId) {
+    if (!m_bRunning || deviceId == m_openDevice) return;
+    m_openDevice = deviceId;
+    // 문자열 할당은 여기서, 렌더 스레드는 포인터만 교체
+    m_device.Publish(new std::wstring(deviceId));
+    RtCommand command;
+    command.type = CMD_SET_DEVICE;
+    PostCommand(command);
+}
+
+void CRenderEngine::PostCommand(const RtCommand& command) {
+    // 큐가 가득 차면 렌더 스레드가 비울 때까지 재시도 (재생 전환/장치 변경은 유실되면 안 됨)
+    while (!m_commands.Post(command) && m_bRunning) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+uint32_t CRenderEngine::PostStreamCommand(uint32_t type) {
+    RtCommand command;
+    command.type = type;
+    command.a = (int32_t)++m_controlSeq;
+    PostCommand(command);
+    return m_controlSeq;
+}
+
+bool CRenderEngine::Start(ByteRingBuffer* pBufferL, ByteRingBuffer* pBufferR,
+    const std::wstring& deviceId,ASIOSampleType sampleType, double inputSampleRate, size_t threshold)
+{
+    if (m_playing) return true;
+
+    // 열려 있으면 싱크를 그대로 쓰고 재생만 켬
+    bool warm = m_bRunning;
+    if (warm) SetDevice(deviceId);
+    else if (!Open(deviceId)) return false;
+
+    m_pendingStream.pBufferL = pBufferL;
+    m_pendingStream.pBufferR = pBufferR;
+    m_pendingStream.sampleType = sampleType;
+    m_pendingStream.inputRate = inputSampleRate;
+    m_pendingStream.threshold = threshold;
+    m_pendingStream.requestedAt = std::chrono::steady_clock::now();
+    m_warmStart = warm;
+    m_firstAudioMs = 0.0;
+    m_glitchCount = 0;
+    m_silentPeriods = 0;
+    m_rateChanges = 0;
+    m_cpuPeak = 0.0;
+    m_producerStampNs.store(0, std::memory_order_relaxed);
+    m_stalls = 0;
+    m_lastStallMs = 0.0;
+    m_longestStallMs = 0.0;
+    // 이전에 요청한 임계값이 Start 인자를 덮어쓰지 않게
+    m_requestedThreshold.store(NO_THRESHOLD, std::memory_order_release);
+
+    PostStreamCommand(CMD_START);
+    m_playing = true;
+    return true;
+}
+
+void CRenderEngine::Stop() {
+    if (!m_playing) return;
+    m_playing = false;
+    uint32_t seq = PostStreamCommand(CMD_STOP);
+    // 렌더 스레드가 링버퍼에서 손을 뗄 때까지 대기 (호출측이 이후 링을 비우거나 해제할 수 있음)
+    while (m_bRunning && m_appliedSeq.load(std::memory_order_acquire) < seq) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void CRenderEngine::SetLimiter(const LimiterSettings& settings) {
+    std::lock_guard<std::mutex> lock(m_limiterLock);
+    m_limiterSettings = settings;
+
+    // 재생 중이면 출력 레이트로 새 리미터를 만들어 넘김 (할당은 여기서)
+    double outRate = m_outRate.load(std::memory_order_acquire);
+    if (outRate > 0.0) {
+        Limiter* limiter = new Limiter();
+        limiter->Setup(settings, outRate);
+        m_limiter.Publish(limiter);
+    }
+}
+
+void CRenderEngine::SetEffects(const std::vector<EffectSettings>& effects) {
+    std::lock_guard<std::mutex> lock(m_limiterLock);
+    m_effectSettings = effects;
+
+    // 재생 중이면 출력 레이트로 새 체인을 만들어 넘김 (노드 생성/준비는 여기서)
+    double outRate = m_outRate.load(std::memory_order_acquire);
+    if (outRate > 0.0) {
+        EffectChain* chain = new EffectChain();
+        chain->Setup(effects, outRate);
+        m_effects.Publish(chain);
+    }
+}
+
+void CRenderEngine::SetThreshold(size_t threshold) {
+    // 렌더 스레드가 주기마다 최신값을 가져감 (연속 변경은 마지막 값만 적용)
+    m_requestedThreshold.store(threshold, std::memory_order_release);
+}
+
+RenderEngineStats CRenderEngine::GetStats() const {
+    RenderEngineStats stats;
+    stats.state = m_state.load(std::memory_order_acquire);
+    stats.reconnects = m_reconnects.load();
+    stats.lastReconnectMs = m_lastReconnectMs.load();
+    stats.usingFallback = m_usingFallback.load();
+    stats.glitches = m_glitchCount.load();
+    stats.silentPeriods = m_silentPeriods.load();
+    stats.rateChanges = m_rateChanges.load();
+    stats.inputRate = m_currentInputRate.load(std::memory_order_relaxed);
+    stats.stalls = m_stalls.load();
+    stats.lastStallMs = m_lastStallMs.load();
+    stats.longestStallMs = m_longestStallMs.load();
+    stats.stalled = m_stalledFlag.load(std::memory_order_relaxed);
+    stats.firstAudioMs = m_firstAudioMs.load();
+    stats.warmStart = m_warmStart.load();
+    stats.scratchBytes = m_scratchBytes.load();
+    stats.cpuLoad = m_cpuLoad.load(std::memory_order_relaxed);
+    stats.cpuPeak = m_cpuPeak.load(std::memory_order_relaxed);
+    stats.latencyMs = m_latencyMs.load(std::memory_order_relaxed);
+    stats.effects = m_effectCount.load(std::memory_order_relaxed);
+    stats.effectLatencyFrames = m_effectLatencyFrames.load(std::memory_order_relaxed);
+    for (size_t n = 0; n < stats.effects; n++) {
+        stats.effectLoad[n] = m_effectLoad[n].load(std::memory_order_relaxed);
+        stats.effectPeak[n] = m_effectPeak[n].load(std::memory_order_relaxed);
+    }
+    if (m_tapMode) {
+        stats.driftPpm = m_drift.GetState().driftPpm;
+        stats.tapDroppedBytes = m_tap.GetDroppedBytes();
+    }
+    return stats;
+}
+
+void CRenderEngine::ConvertRawToFloat(const void* input, float* output, size_t sampleCount) {
+    ConvertSamplesToFloat(m_sampleType, input, output, sampleCount);
+}
+
+size_t CRenderEngine::MsToBytes(double ms) const {
+    return (size_t)std::lround(ms * 0.001 * m_inputRate) * m_sampleSizeBytes;
+}
+
+void CRenderEngine::SetThresholdInternal(size_t threshold) {
+    m_safeThreshold = threshold;
+    m_thresholdBytes.store(threshold, std::memory_order_release);
+    // 탭 모드: 드리프트 보정 목표도 새 임계값으로
+    if (m_tapMode && !m_isBuffering) SetupDrift();
+}
+
+void CRenderEngine::SetupDrift() {
+    // 목표: 재생 임계값, 허용 범위 0.5 ~ 1.5 배 (주기는 장치 버퍼의 절반으로 추정)
+    if (m_format.sampleRate <= 0.0) return;
+    double target = m_safeThreshold / ((double)m_sampleSizeBytes * m_inputRate);
+    double periodSeconds = m_format.bufferFrames * 0.5 / m_format.sampleRate;
+    m_drift.Setup(periodSeconds, target, target * 0.5, target * 1.5);
+}
+
+size_t CRenderEngine::SourceAvailable() const {
+    return m_tapMode ? m_tap.GetAvailableRead() : m_pBufferL->GetAvailableRead();
+}
+
+size_t CRenderEngine::SourcePop(size_t bytes) {
+    // 탭은 추월당하면 덜 읽을 수 있음
+    if (m_tapMode) return m_tap.Pop(m_rawTempL, m_rawTempR, bytes);
+    m_pBufferL->Pop(m_rawTempL, bytes);
+    m_pBufferR->Pop(m_rawTempR, bytes);
+    return bytes;
+}
+
+void CRenderEngine::SourceDiscard(size_t bytes) {
+    if (m_tapMode) {
+        m_tap.Discard(bytes);
+        return;
+    }
+    m_pBufferL->Discard(bytes);
+    m_pBufferR->Discard(bytes);
+}
+
+bool CRenderEngine::SourceIsSilent() const {
+    return m_tapMode ? m_tap.IsSilent() : m_pBufferL->IsSilentFrom(m_pBufferL->GetReadIndex());
+}
+
+size_t CRenderEngine::SourceReadIndex() const {
+    return m_tapMode ? m_tap.GetReadIndex() : m_pBufferL->GetReadIndex();
+}
+
+size_t CRenderEngine::FramesToRateMark() const {
+    // 표시는 L 링에만 있음 (탭도 같은 누적 위치 기준)
+    ByteRingBuffer::RateMark mark;
+    size_t seq = m_rateMarkSeq;
+    if (!m_pBufferL->GetRateMark(seq, mark)) return SIZE_MAX;
+    size_t pos = SourceReadIndex();
+    return (mark.pos > pos) ? (mark.pos - pos) / m_sampleSizeBytes : 0;
+}
+
+double CRenderEngine::SourceFillSeconds(size_t bytesAvailable) const {
+    // 아직 읽지 않은 표시 뒤쪽은 새 레이트로 환산 (전환 직전 채움량이 잘못 보이지 않게)
+    size_t frames = bytesAvailable / m_sampleSizeBytes;
+    size_t before = std::min(frames, FramesToRateMark());
+    double seconds = before / m_inputRate;
+    ByteRingBuffer::RateMark mark;
+    size_t seq = m_rateMarkSeq;
+    if (before < frames && m_pBufferL->GetRateMark(seq, mark) && mark.rate > 0.0) seconds += (frames - before) / mark.rate;
+    return seconds;
+}
+
+bool CRenderEngine::ApplyReachedRateMarks() {
+    // 건너뛰기/폐기로 지나친 표시도 여기서 적용
+    bool applied = false;
+    ByteRingBuffer::RateMark mark;
+    while (m_pBufferL->GetRateMark(m_rateMarkSeq, mark) && mark.pos <= SourceReadIndex()) {
+        m_rateMarkSeq++;
+        ApplyInputRate(mark.rate);
+        applied = true;
+    }
+    return applied;
+}
+
+void CRenderEngine::ApplyInputRate(double rate) {
+    if (rate <= 0.0 || rate == m_inputRate) return;
+    double previous = m_inputRate;
+    m_inputRate = rate;
+
+    // 임계값은 시간 기준 유지 (드리프트 목표도 같은 시간이므로 다시 설정하지 않음)
+    size_t frames = (size_t)std::lround((double)(m_safeThreshold / m_sampleSizeBytes) * rate / previous);
+    m_safeThreshold = frames * m_sampleSizeBytes;
+    m_thresholdBytes.store(m_safeThreshold, std::memory_order_release);
+    m_autoLatency.SetProducerRate(rate);
+
+    if (m_sinkOpen) {
+        m_needResample = m_tapMode || (std::abs(m_inputRate - m_format.sampleRate) > 1.0);
+        UpdateRatio();
+    }
+    m_currentInputRate.store(rate, std::memory_order_relaxed);
+    m_rateChanges.fetch_add(1, std::memory_order_relaxed);
+    DebugLog("[Render] Input Rate %.1f -> %.1f Hz\n", previous, rate);
+}
+
+void CRenderEngine::UpdateRatio() {
+    // 탭 모드는 드리프트 보정 포함 (항상 가변 비율)
+    if (m_tapMode) {
+        double ratio = m_inputRate / m_format.sampleRate * m_driftScale;
+        m_resamplerL.SetRatio(ratio);
+        m_resamplerR.SetRatio(ratio);
+    }
+    else {
+        m_resamplerL.ChangeRate(m_inputRate, m_format.sampleRate);
+        m_resamplerR.ChangeRate(m_inputRate, m_format.sampleRate);
+    }
+}
+
+size_t CRenderEngine::InputFramesFor(size_t outFrames) const {
+    // 리샘플러 읽기 위치 기준 (주기마다 올림하면 위치가 밀려 결국 무음이 됨)
+    return m_needResample ? m_resamplerL.GetInputNeeded(outFrames) : outFrames;
+}
+
+size_t CRenderEngine::RenderSegment(size_t inFrames, size_t offset, size_t outMax) {
+    // Pop (Byte 단위)
+    size_t bytesRead = SourcePop(inFrames * m_sampleSizeBytes);
+    inFrames = bytesRead / m_sampleSizeBytes;
+
+    // Convert (Byte -> Float)
+    ConvertRawToFloat(m_rawTempL, m_floatTempL, inFrames);
+    ConvertRawToFloat(m_rawTempR, m_floatTempR, inFrames);
+
+    // Resample (InRate -> OutRate)
+    if (m_needResample) {
+        size_t generatedL = m_resamplerL.Process(m_floatTempL, inFrames, m_resampledTempL + offset, outMax);
+        size_t generatedR = m_resamplerR.Process(m_floatTempR, inFrames, m_resampledTempR + offset, outMax);
+        return std::min(generatedL, generatedR);
+    }
+    // 비율이 1.0이면 단순 복사
+    size_t copyCount = (inFrames < outMax) ? inFrames : outMax;
+    memcpy(m_resampledTempL + offset, m_floatTempL, copyCount * sizeof(float));
+    memcpy(m_resampledTempR + offset, m_floatTempR, copyCount * sizeof(float));
+    return copyCount;
+}
+
+void CRenderEngine::RecordLoad(double busySeconds, uint32_t frames) {
+    // 주기 길이 대비 처리 시간 (지수 평활, 최대값은 Start 마다 초기화)
+    double load = busySeconds * m_format.sampleRate / frames;
+    m_loadAverage += 0.05 * (load - m_loadAverage);
+    m_cpuLoad.store(m_loadAverage, std::memory_order_relaxed);
+    if (load > m_cpuPeak.load(std::memory_order_relaxed)) m_cpuPeak.store(load, std::memory_order_relaxed);
+}
+
+bool CRenderEngine::WatchProducer(uint8_t* pData, uint32_t framesNeeded, size_t samplesToRead) {
+    double timeout = m_stallTimeoutSec.load(std::memory_order_acquire);
+    int64_t stamp = m_producerStampNs.load(std::memory_order_acquire);
+    if (timeout <= 0.0 || stamp == 0 || !m_hasPlayed) return false;
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    if (!m_stalled) {
+        // 다음 블록 예정 시각 + timeout 이 지났고 링으로도 이번 주기를 못 채울 때만 (늦어도 버퍼가 있으면 그대로 재생)
+        double blockSec = m_producerBlockFrames.load(std::memory_order_relaxed) / m_inputRate;
+        int64_t due = stamp + (int64_t)(blockSec * 1e9);
+        if (now < due + (int64_t)(timeout * 1e9) || SourceAvailable() >= samplesToRead * m_sampleSizeBytes) return false;
+        m_stalled = true;
+        m_stallStampNs = stamp;
+        m_stallDueNs = due;
+        m_stallReturnNs = 0;
+        m_stalledFlag.store(true, std::memory_order_relaxed);
+        // 정체 구간은 지터가 아님 (자동 레이턴시 목표를 끌어올리지 않게)
+        if (m_autoLatencyOn) m_autoLatency.ResetProducerClock();
+        if (!m_inGlitch) m_glitchCount.fetch_add(1, std::memory_order_relaxed);
+        m_inGlitch = true;
+        DebugLog("[Render] Producer Stalled (%.1f ms Overdue)\n", (now - due) / 1e6);
+    }
+    else if (stamp != m_stallStampNs) {
+        // 복귀: 임계값만큼 모이면 초과분(밀린 블록)을 버리고 재개 (지연이 늘어난 채로 남지 않게)
+        if (m_stallReturnNs == 0) m_stallReturnNs = stamp;
+        size_t bytesAvailable = SourceAvailable();
+        double thresholdSeconds = m_safeThreshold / ((double)m_sampleSizeBytes * m_inputRate);
+        if (SourceFillSeconds(bytesAvailable) >= thresholdSeconds) {
+            if (bytesAvailable > m_safeThreshold) {
+                size_t skip = bytesAvailable - m_safeThreshold;
+                skip -= skip % m_sampleSizeBytes;
+                SourceDiscard(skip);
+                ApplyReachedRateMarks();
+            }
+            double stallMs = (m_stallReturnNs - m_stallDueNs) / 1e6;
+            m_lastStallMs.store(stallMs, std::memory_order_relaxed);
+            if (stallMs > m_longestStallMs.load(std::memory_order_relaxed)) m_longestStallMs.store(stallMs, std::memory_order_relaxed);
+            m_stalls.fetch_add(1, std::memory_order_relaxed);
+            m_stalled = false;
+            m_stalledFlag.store(false, std::memory_order_relaxed);
+            m_isBuffering = false;
+            m_quietFrames = 0;
+            // 이펙트/리미터 지연에 남은 정체 전 오디오와 새 오디오 사이도 크로스페이드 (은닉 꼬리 -> 페이드 인은 다음 주기)
+            if (m_processLatency > 0) m_spliceDelay = m_processLatency;
+            DebugLog("[Render] Producer Resumed After %.1f ms\n", stallMs);
+            return false;
+        }
+    }
+
+    // 정체 중: 마지막 출력에서 페이드 아웃 후 무음 (링은 건드리지 않음, 자동 레이턴시도 올리지 않음)
+    m_concealer.Process(m_resampledTempL, m_resampledTempR, 0, framesNeeded);
+    WriteOutput(pData, framesNeeded, framesNeeded);
+    if (m_pGain) m_pGain->Advance(framesNeeded);
+    m_latencyMs.store(m_addedLatencySeconds.load(std::memory_order_relaxed) * 1000.0, std::memory_order_relaxed);
+    return true;
+}
+
+void CRenderEngine::DrainCommands() {
+    // 제어 스레드 명령 처리 (대기 없음)
+    RtCommand command;
+    while (m_commands.Pop(command)) {
+        switch (command.type) {
+        case CMD_START:
+            BeginStream();
+            m_appliedSeq.store((uint32_t)command.a, std::memory_order_release);
+            break;
+        case CMD_STOP:
+            // 재생 중이던 소리는 은닉 꼬리로 페이드 아웃
+            if (m_rtPlaying && m_hasPlayed && m_concealment.load(std::memory_order_relaxed)) {
+                m_stopFadeFrames = (size_t)std::lround(UnderrunConcealer::FADE_MS * 0.001 * m_format.sampleRate) + 1;
+            }
+            m_rtPlaying = false;
+            m_inGlitch = false;
+            if (m_tapMode) m_tap.Detach();
+            m_currentInputRate.store(0.0, std::memory_order_relaxed);
+            m_appliedSeq.store((uint32_t)command.a, std::memory_order_release);
+            break;
+        case CMD_SET_DEVICE:
+            // 장치 전환은 비실시간 경로 (싱크를 닫은 뒤 Opening 에서 새 장치를 가져감)
+            m_reopenRequested = true;
+            break;
+        }
+    }
+    // 임계값은 명령 뒤에 적용 (Start 이후에 바꾼 값이 시작 인자보다 우선)
+    size_t threshold = m_requestedThreshold.exchange(NO_THRESHOLD, std::memory_order_acq_rel);
+    if (threshold != NO_THRESHOLD) SetThresholdInternal(threshold);
+}
+
+void CRenderEngine::BeginStream() {
+    const StreamParams& params = m_pendingStream;
+    m_pBufferL = params.pBufferL;
+    m_pBufferR = params.pBufferR;
+    m_sampleType = params.sampleType;
+    m_sampleSizeBytes = GetAsioSampleSize(m_sampleType);
+    if (m_sampleSizeBytes == 0) m_sampleSizeBytes = 4;
+    m_inputRate = (params.inputRate > 0.0) ? params.inputRate : 48000.0;
+    // 탭은 현재 쓰기 위치부터 읽음 (임계값만큼 모일 때까지 버퍼링)
+    if (m_tapMode) m_tap.Attach(m_pBufferL, m_pBufferR);
+    // 이전 레이트 표시는 시작 레이트에 이미 반영됨
+    m_rateMarkSeq = m_pBufferL->GetRateMarkCount();
+    m_spliceDelay = SIZE_MAX;
+    m_stalled = false;
+    m_stalledFlag.store(false, std::memory_order_relaxed);
+    m_driftScale = 1.0;
+    m_currentInputRate.store(m_inputRate, std::memory_order_relaxed);
+
+    // 입력 레이트는 스트림마다 다를 수 있음 (리샘플러 설정은 할당 없음)
+    if (m_sinkOpen) {
+        m_resamplerL.Setup(m_inputRate, m_format.sampleRate);
+        m_resamplerR.Setup(m_inputRate, m_format.sampleRate);
+        m_needResample = m_tapMode || (std::abs(m_inputRate - m_format.sampleRate) > 1.0);
+    }
+
+    m_isBuffering = true;
+    m_hasPlayed = false;
+    m_inGlitch = false;
+    m_quietFrames = 0;
+    m_stopFadeFrames = 0;
+    // 첫 오디오는 페이드 인 (은닉을 끄면 원본 그대로)
+    if (m_concealment.load(std::memory_order_relaxed)) m_concealer.MarkSilent();
+    else m_concealer.Reset();
+
+    // 자동 레이턴시 (ms -> 입력 포맷 바이트)
+    SetThresholdInternal(params.threshold);
+    m_autoLatencyOn = m_autoLatency.IsEnabled();
+    if (m_autoLatencyOn) m_autoLatency.Reset(m_inputRate, params.threshold * 1000.0 / (m_sampleSizeBytes * m_inputRate));
+
+    m_startRequestedAt = params.requestedAt;
+    m_firstAudioPending = true;
+    m_rtPlaying = true;
+}
+
+void CRenderEngine::ApplyLimiter(Limiter* next) {
+    m_pLimiter = next;
+    bool useLimiter = m_pLimiter->IsEnabled();
+    m_resamplerL.SetHeadroom(!useLimiter);
+    m_resamplerR.SetHeadroom(!useLimiter);
+    UpdateAddedLatency();
+}
+
+void CRenderEngine::ApplyEffects(EffectChain* next) {
+    m_pEffects = next;
+    m_effectCount.store(m_pEffects->GetCount(), std::memory_order_relaxed);
+    m_effectLatencyFrames.store(m_pEffects->GetLatencyFrames(), std::memory_order_relaxed);
+    PublishEffectStats();
+    UpdateAddedLatency();
+}
+
+void CRenderEngine::UpdateAddedLatency() {
+    m_processLatency = (m_pLimiter ? m_pLimiter->GetLatencyFrames() : 0) + (m_pEffects ? m_pEffects->GetLatencyFrames() : 0);
+    m_addedLatencyFrames.store(m_processLatency, std::memory_order_release);
+    m_addedLatencySeconds.store(m_processLatency / m_format.sampleRate, std::memory_order_release);
+}
+
+void CRenderEngine::PublishEffectStats() {
+    for (size_t n = 0; n < m_pEffects->GetCount(); n++) {
+        m_effectLoad[n].store(m_pEffects->GetLoad(n), std::memory_order_relaxed);
+        m_effectPeak[n].store(m_pEffects->GetPeak(n), std::memory_order_relaxed);
+    }
+}
+
+bool CRenderEngine::OpenSink(const std::wstring& deviceId) {
+    SinkFormat format;
+    if (!m_sink->Open(deviceId, m_inputRate, format)) {
+        m_sink->Close();
+        return false;
+    }
+    bool supported = (format.bitDepth == 32 || format.bitDepth == 24 || format.bitDepth == 16);
+    if (!supported || format.channels < 1 || format.sampleRate <= 0.0 || format.bufferFrames == 0) {
+        DebugLog("[Render] Unsupported Sink Format: %d ch, %d bit\n", format.channels, format.bitDepth);
+        m_sink->Close();
+        return false;
+    }
+    m_format = format;
+
+    // 리샘플러 설정
+    double outRate = format.sampleRate;
+    m_resamplerL.Setup(m_inputRate, outRate);
+    m_resamplerR.Setup(m_inputRate, outRate);
+
+    // 게인 램프, 은닉 페이드는 출력 레이트 기준
+    if (m_pGain) m_pGain->Prepare(outRate);
+    m_concealer.Setup(outRate);
+    m_quietFrames = 0;
+    m_quietSettleFrames = (size_t)std::lround(SILENCE_SETTLE_MS * 0.001 * outRate);
+    // 끊긴 지점이 무음이었으므로 재개 시 페이드 인
+    if (m_concealment.load(std::memory_order_relaxed)) m_concealer.MarkSilent();
+    m_stopFadeFrames = 0;
+
+    // 리미터 (출력 레이트에서 동작, 활성 시 리샘플러 헤드룸/클리핑 대체)
+    {
+        std::lock_guard<std::mutex> lock(m_limiterLock);
+        Limiter* limiter = new Limiter();
+        limiter->Setup(m_limiterSettings, outRate);
+        m_limiter.Reset(limiter);
+        m_outRate.store(outRate, std::memory_order_release);
+    }
+    ApplyLimiter(m_limiter.Acquire());
+
+    // 이펙트 체인 (출력 레이트)
+    {
+        std::lock_guard<std::mutex> lock(m_limiterLock);
+        EffectChain* chain = new EffectChain();
+        chain->Setup(m_effectSettings, outRate);
+        m_effects.Reset(chain);
+    }
+    ApplyEffects(m_effects.Acquire());
+
+    // 탭 모드는 비율이 같아도 드리프트 보정을 위해 항상 리샘플
+    m_needResample = m_tapMode || (std::abs(m_inputRate - outRate) > 1.0);
+
+    // 여유 공간 확보
+    size_t maxFrames = (size_t)format.bufferFrames * 4;
+    if (maxFrames < 4096) maxFrames = 4096; // 최소 안전장치
+
+    // 임시 버퍼 아레나 (가장 큰 샘플 포맷 기준, 재생 전환 시 다시 할당하지 않음)
+    m_scratch.Release();
+    size_t rawL = m_scratch.Reserve(maxFrames * sizeof(double));
+    size_t rawR = m_scratch.Reserve(maxFrames * sizeof(double));
+    size_t floatL = m_scratch.Reserve(maxFrames * sizeof(float));
+    size_t floatR = m_scratch.Reserve(maxFrames * sizeof(float));
+    size_t resampledL = m_scratch.Reserve(maxFrames * sizeof(float));
+    size_t resampledR = m_scratch.Reserve(maxFrames * sizeof(float));
+    if (!m_scratch.Commit(m_arenaOptions)) {
+        m_sink->Close();
+        return false;
+    }
+    m_rawTempL = m_scratch.At<uint8_t>(rawL);
+    m_rawTempR = m_scratch.At<uint8_t>(rawR);
+    m_floatTempL = m_scratch.At<float>(floatL);
+    m_floatTempR = m_scratch.At<float>(floatR);
+    m_resampledTempL = m_scratch.At<float>(resampledL);
+    m_resampledTempR = m_scratch.At<float>(resampledR);
+    m_scratchBytes.store(m_scratch.GetCommittedBytes(), std::memory_order_relaxed);
+
+    m_isBuffering = true;
+    if (!m_sink->Start()) {
+        m_sink->Close();
+        return false;
+    }
+    m_sinkOpen = true;
+    return true;
+}
+
+void CRenderEngine::AdvanceWithoutSink(double seconds) {
+    RT_SCOPE("AdvanceWithoutSink");
+    if (!m_rtPlaying) return;
+    ApplyReachedRateMarks();
+    size_t bytes = (size_t)std::lround(seconds * m_inputRate) * m_sampleSizeBytes;
+    if (bytes == 0) return;
+
+    // 싱크 클럭 모드: 장치 대신 호스트를 계속 구동
+    IRenderPeriodListener* pListener = m_pListener.load(std::memory_order_acquire);
+    if (pListener) {
+        pListener->OnRenderPeriod(bytes);
+    }
+
+    // 재생된 것처럼 소비하고, 임계값 초과분은 버림 (복구 후 지연이 쌓이지 않게)
+    size_t fill = SourceAvailable();
+    size_t skip = (bytes < fill) ? bytes : fill;
+    if (fill - skip > m_safeThreshold) skip = fill - m_safeThreshold;
+    skip -= skip % m_sampleSizeBytes;
+    SourceDiscard(skip);
+}
+
+void CRenderEngine::RenderThreadFunc() {
+    using Clock = std::chrono::steady_clock;
+
+    ThreadPlacement::Scope placement(ThreadRole::Render);
+    DebugLog("[Render] Thread Placement: %s, CPUs %s%s\n", ThreadPlacement::PriorityName(placement.GetPriority()),
+        ThreadPlacement::FormatMask(placement.GetResult().mask).c_str(), placement.GetResult().priorityOk ? "" : " (Priority Fallback)");
+
+    // 재생 전 기본값 (CMD_START 에서 스트림 포맷으로 교체)
+    m_sampleSizeBytes = 4;
+    m_inputRate = 48000.0;
+    m_sinkOpen = false;
+    m_rtPlaying = false;
+    m_reopenRequested = false;
+    m_isBuffering = true;
+    m_hasPlayed = false;
+    m_inGlitch = false;
+
+    std::wstring deviceId = m_targetDevice;
+    RenderState state = RenderState::Opening;
+    int attempts = 0;
+    int missedPeriods = 0;
+    double backoffMs = BACKOFF_MIN_MS;
+    bool awaitingFirstPeriod = false;
+    Clock::time_point retryAt = Clock::now();
+    Clock::time_point lastTick = retryAt;
+    Clock::time_point lostAt = retryAt;
+
+    while (m_bRunning) {
+        m_state.store(state, std::memory_order_release);
+
+        if (state == RenderState::Opening) {
+            DrainCommands();
+            if (m_reopenRequested) {
+                m_reopenRequested = false;
+                if (const std::wstring* next = m_device.Acquire()) m_targetDevice = *next;
+                deviceId = m_targetDevice;
+                attempts = 0;
+            }
+            if (OpenSink(deviceId)) {
+                DebugLog("[Render] %s Sink Opened. %.0f Hz, %d ch, %d bit%s\n", m_sink->GetName(),
+                    m_format.sampleRate, m_format.channels, m_format.bitDepth, deviceId != m_targetDevice ? " (Default Fallback)" : "");
+                m_usingFallback.store(deviceId != m_targetDevice);
+                state = RenderState::Running;
+                attempts = 0;
+                missedPeriods = 0;
+                backoffMs = BACKOFF_MIN_MS;
+                continue;
+            }
+            // 재시도 간격은 지수 증가, 지정 장치가 계속 실패하면 기본 장치로
+            attempts++;
+            if (!deviceId.empty() && attempts >= FALLBACK_AFTER_ATTEMPTS) {
+                DebugLog("[Render] Device Open Failed %d Times. Falling Back To Default\n", attempts);
+                deviceId.clear();
+                attempts = 0;
+            }
+            retryAt = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(backoffMs));
+            backoffMs = std::min(backoffMs * 2.0, BACKOFF_MAX_MS);
+            state = RenderState::Recovering;
+            continue;
+        }
+
+        if (state == RenderState::Recovering) {
+            // 장치가 없는 동안에도 실시간으로 링 소비
+            std::this_thread::sleep_for(std::chrono::milliseconds(RECOVERY_TICK_MS));
+            DrainCommands();
+            Clock::time_point now = Clock::now();
+            AdvanceWithoutSink(std::chrono::duration<double>(now - lastTick).count());
+            lastTick = now;
+            if (now >= retryAt || m_reopenRequested) state = RenderState::Opening;
+            continue;
+        }
+
+        // Running
+        SinkStatus status = m_sink->WaitForPeriod(WAIT_TIMEOUT_MS);
+        if (status == SinkStatus::Ok) {
+            uint32_t framesNeeded = 0;
+            uint8_t* pData = nullptr;
+            status = m_sink->GetBuffer(framesNeeded, pData);
+            if (status == SinkStatus::Ok && framesNeeded > 0) {
+                Clock::time_point workStart = Clock::now();
+                RenderPeriod(pData, framesNeeded);
+                // 버퍼 해제
+                status = m_sink->ReleaseBuffer(framesNeeded);
+                RecordLoad(std::chrono::duration<double>(Clock::now() - workStart).count(), framesNeeded);
+            }
+        }
+
+        // 장치 변경: 같은 스레드에서 싱크만 다시 엶
+        if (m_reopenRequested) {
+            m_sink->Close();
+            m_sinkOpen = false;
+            m_isBuffering = true;
+            state = RenderState::Opening;
+            continue;
+        }
+
+        if (status == SinkStatus::Ok) {
+            missedPeriods = 0;
+            if (awaitingFirstPeriod) {
+                awaitingFirstPeriod = false;
+                double ms = std::chrono::duration<double, std::milli>(Clock::now() - lostAt).count();
+                m_lastReconnectMs.store(ms);
+                m_reconnects.fetch_add(1);
+                DebugLog("[Render] Sink Recovered In %.1f ms\n", ms);
+            }
+            continue;
+        }
+        // 이벤트가 계속 오지 않으면 (서비스 정지 등) 소실로 처리
+        if (status != SinkStatus::Lost && ++missedPeriods < LOST_AFTER_TIMEOUTS) continue;
+
+        DebugLog("[Render] Sink Lost. Reconnecting\n");
+        m_sink->Close();
+        m_sinkOpen = false;
+        if (!awaitingFirstPeriod) lostAt = Clock::now();
+        awaitingFirstPeriod = true;
+        if (m_rtPlaying && !m_inGlitch) m_glitchCount.fetch_add(1, std::memory_order_relaxed);
+        m_inGlitch = m_rtPlaying;
+        m_isBuffering = true;
+        // 소실 후에는 다시 지정 장치부터
+        deviceId = m_targetDevice;
+        attempts = 0;
+        backoffMs = BACKOFF_MIN_MS;
+        lastTick = Clock::now();
+        retryAt = lastTick + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(BACKOFF_MIN_MS));
+        state = RenderState::Recovering;
+    }
+
+    // 정리
+    if (m_sinkOpen) m_sink->Close();
+    m_sinkOpen = false;
+    m_scratch.Release();
+    m_scratchBytes.store(0, std::memory_order_relaxed);
+    m_rtPlaying = false;
+    m_state.store(RenderState::Stopped, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(m_limiterLock);
+    m_outRate.store(0.0, std::memory_order_release);
+}
+
+void CRenderEngine::RenderPeriod(uint8_t* pData, uint32_t framesNeeded) {
+    RT_SCOPE("RenderPeriod");
+    DrainCommands();
+
+    // 정지 중: 싱크는 무음으로 계속 구동 (재개 시 장치 초기화 없이 다음 주기부터)
+    if (!m_rtPlaying || m_reopenRequested) {
+        if (m_stopFadeFrames > 0) {
+            m_concealer.Process(m_resampledTempL, m_resampledTempR, 0, framesNeeded);
+            WriteOutput(pData, framesNeeded, framesNeeded);
+            m_stopFadeFrames = (m_stopFadeFrames > framesNeeded) ? m_stopFadeFrames - framesNeeded : 0;
+        }
+        else {
+            memset(pData, 0, (size_t)framesNeeded * m_format.BlockAlign());
+        }
+        return;
+    }
+
+    // 자동 레이턴시: 켜질 때 현재 임계값에서 측정 시작
+    double outRate = m_format.sampleRate;
+    if (m_autoLatency.IsEnabled() != m_autoLatencyOn) {
+        m_autoLatencyOn = !m_autoLatencyOn;
+        if (m_autoLatencyOn) m_autoLatency.Reset(m_inputRate, m_safeThreshold * 1000.0 / (m_sampleSizeBytes * m_inputRate));
+    }
+    double autoMs = 0.0;
+    if (m_autoLatencyOn && m_autoLatency.OnConsumerPeriod(framesNeeded, outRate, autoMs)) {
+        SetThresholdInternal(MsToBytes(autoMs));
+    }
+    Limiter* nextLimiter = m_limiter.Acquire();
+    if (nextLimiter != m_pLimiter) ApplyLimiter(nextLimiter);
+    EffectChain* nextEffects = m_effects.Acquire();
+    if (nextEffects != m_pEffects) ApplyEffects(nextEffects);
+    // 주기 경계에서 바뀐 레이트는 주기 시작이 이음매
+    double periodRate = m_inputRate;
+    ApplyReachedRateMarks();
+    size_t spliceAt = (m_inputRate != periodRate) ? 0 : SIZE_MAX;
+
+    // 필요한 입력 샘플 수
+    size_t samplesToRead = InputFramesFor(framesNeeded);
+
+    // 싱크 클럭 모드: 이번 주기에 필요한 만큼 호스트 블록을 바로 렌더링
+    IRenderPeriodListener* pListener = m_pListener.load(std::memory_order_acquire);
+    if (pListener) {
+        pListener->OnRenderPeriod(samplesToRead * m_sampleSizeBytes);
+    }
+    // 생산측 정체 (싱크 클럭 모드는 이 스레드가 호스트를 돌리므로 제외)
+    else if (WatchProducer(pData, framesNeeded, samplesToRead)) {
+        return;
+    }
+
+    // 초기 버퍼링
+    // 은닉 모드: 언더런 후에는 임계값 1/4 (최소 한 주기) 만 모이면 크로스페이드로 재개
+    bool conceal = m_concealment.load(std::memory_order_relaxed);
+    size_t bytesAvailable = SourceAvailable();
+    size_t resumeBytes = m_safeThreshold;
+    if (conceal && m_hasPlayed) resumeBytes = std::max(samplesToRead * m_sampleSizeBytes, m_safeThreshold / 4);
+
+    if (!m_isBuffering && bytesAvailable < 128) {
+        m_isBuffering = true;
+    }
+    if (m_isBuffering && bytesAvailable > resumeBytes) {
+        // 재생
+        // 탭 모드: 드리프트 추정은 스트림 동안 유지 (재버퍼링 후에도 장치 클럭 편차는 같음)
+        if (m_tapMode && !m_hasPlayed) SetupDrift();
+        m_isBuffering = false;
+        m_hasPlayed = true;
+        if (m_firstAudioPending) {
+            m_firstAudioPending = false;
+            m_firstAudioMs.store(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startRequestedAt).count(),
+                std::memory_order_relaxed);
+        }
+    }
+
+    bool shortfall = false;
+    if (m_isBuffering) {
+        shortfall = m_hasPlayed;
+        samplesToRead = 0;
+    }
+    else {
+        size_t samplesAvailable = bytesAvailable / m_sampleSizeBytes;
+
+        // 탭 모드: 채움량을 임계값에 고정하도록 비율 보정 (장치 간 클럭 드리프트 흡수)
+        if (m_tapMode) {
+            // 정체로 쌓인 분량은 건너뜀 (보정 루프로 천천히 줄이면 지연이 오래 남음)
+            double thresholdSeconds = m_safeThreshold / ((double)m_sampleSizeBytes * m_inputRate);
+            if (SourceFillSeconds(bytesAvailable) > thresholdSeconds * 2) {
+                size_t skip = bytesAvailable - m_safeThreshold;
+                skip -= skip % m_sampleSizeBytes;
+                SourceDiscard(skip);
+                ApplyReachedRateMarks();
+                bytesAvailable -= skip;
+                samplesAvailable = bytesAvailable / m_sampleSizeBytes;
+                shortfall = true;
+            }
+            m_driftScale = m_drift.Update(SourceFillSeconds(bytesAvailable));
+            UpdateRatio();
+            samplesToRead = m_resamplerL.GetInputNeeded(framesNeeded);
+        }
+
+        // Underrun
+        if (samplesToRead > samplesAvailable) {
+            samplesToRead = samplesAvailable;
+            shortfall = true;
+            if (m_autoLatencyOn && m_autoLatency.OnUnderrun(autoMs)) {
+                SetThresholdInternal(MsToBytes(autoMs));
+            }
+        }
+    }
+    // 끊김 횟수 (연속된 부족 주기는 1회)
+    if (shortfall && !m_inGlitch) m_glitchCount.fetch_add(1, std::memory_order_relaxed);
+    m_inGlitch = shortfall;
+    m_latencyMs.store((SourceFillSeconds(bytesAvailable) + m_addedLatencySeconds.load(std::memory_order_relaxed)) * 1000.0,
+        std::memory_order_relaxed);
+
+    if (m_isBuffering && !(conceal && m_hasPlayed)) {
+        memset(pData, 0, (size_t)framesNeeded * m_format.BlockAlign());
+        return;
+    }
+
+    // 무음 빠른 경로: 입력이 디지털 무음이고 처리 상태가 모두 0 으로 가라앉았으면
+    // 변환/리샘플/리미터/양자화를 건너뛰고 출력만 지움 (리샘플러는 위치만 진행, 이후 결과는 전체 경로와 같음)
+    // 레이트 표시가 이번 주기 입력 안에 있으면 전체 경로 (지점에서 나눠 처리)
+    size_t markFrames = FramesToRateMark();
+    bool silentInput = (samplesToRead > 0 && !shortfall && SourceIsSilent());
+    if (silentInput && markFrames >= samplesToRead && m_quietFrames >= m_quietSettleFrames && !m_concealer.IsConcealing() &&
+        m_pEffects->IsSettled() && (!m_pLimiter->IsEnabled() || m_pLimiter->IsSettled())) {
+        SourceDiscard(samplesToRead * m_sampleSizeBytes);
+        if (m_needResample) {
+            m_resamplerL.SkipSilence(samplesToRead, framesNeeded);
+            m_resamplerR.SkipSilence(samplesToRead, framesNeeded);
+        }
+        if (m_pGain) m_pGain->Advance(framesNeeded);
+        memset(pData, 0, (size_t)framesNeeded * m_format.BlockAlign());
+        m_spliceDelay = SIZE_MAX; // 무음끼리는 이음매가 없음
+        m_silentPeriods.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_quietFrames = silentInput ? m_quietFrames + framesNeeded : 0;
+
+    size_t generated = 0;
+    if (samplesToRead > 0) {
+        // 레이트 표시 지점에서 나눔: 앞은 이전 비율, 뒤는 새 비율로 이어서 생성
+        size_t toRead = samplesToRead;
+        while (toRead > 0 && generated < framesNeeded) {
+            size_t count = std::min(toRead, markFrames);
+            generated += RenderSegment(count, generated, framesNeeded - generated);
+            double previousRate = m_inputRate;
+            if (count == toRead || !ApplyReachedRateMarks()) break;
+            if (m_inputRate != previousRate) spliceAt = generated;
+            markFrames = FramesToRateMark();
+            toRead = std::min(InputFramesFor(framesNeeded - generated), SourceAvailable() / m_sampleSizeBytes);
+        }
+
+        // 게인/뮤트/덕킹 -> 이펙트 -> 리미터 순
+        if (m_pGain) {
+            m_pGain->Process(m_resampledTempL, m_resampledTempR, generated);
+        }
+        if (m_pEffects->IsEnabled()) {
+            m_pEffects->Process(m_resampledTempL, m_resampledTempR, generated);
+            PublishEffectStats();
+        }
+        if (m_pLimiter->IsEnabled()) {
+            m_pLimiter->Process(m_resampledTempL, m_resampledTempR, generated);
+        }
+    }
+
+    // 레이트 전환 이음매는 이펙트/리미터 지연만큼 늦게 나옴 (다음 주기로 넘어갈 수 있음)
+    if (spliceAt != SIZE_MAX) m_spliceDelay = spliceAt + m_processLatency;
+    spliceAt = SIZE_MAX;
+    if (m_spliceDelay != SIZE_MAX) {
+        if (m_spliceDelay < generated) { spliceAt = m_spliceDelay; m_spliceDelay = SIZE_MAX; }
+        else m_spliceDelay -= generated;
+    }
+
+    // 은닉: 모자란 구간을 페이드 꼬리로 채우고 재개 시 크로스페이드
+    // 레이트 전환 이음매는 은닉을 꺼도 크로스페이드
+    m_concealer.Process(m_resampledTempL, m_resampledTempR, generated, conceal ? framesNeeded : generated, spliceAt);
+    if (conceal) generated = framesNeeded;
+
+    if (generated > 0) {
+        WriteOutput(pData, framesNeeded, generated);
+    }
+    else {
+        // 데이터가 아예 없으면 침묵
+        memset(pData, 0, (size_t)framesNeeded * m_format.BlockAlign());
+    }
+}
+
+void CRenderEngine::WriteOutput(uint8_t* pData, uint32_t framesNeeded, size_t generated) {
+    ConvertFloatToOutput(m_resampledTempL, m_resampledTempR, generated, pData, framesNeeded,
+        m_format.channels, m_format.bitDepth, m_format.isFloat);
+}
@@ -0,0 +1,334 @@
+﻿#pragma once
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+#ifndef MY_ASIO
+#define MY_ASIO
+#include <iasiodrv.h>
+#endif
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include "RingBuffer.h"
+#include "CommandQueue.h"
+#include "OutputSink.h"
+#include "Resampler.h"
+#include "Limiter.h"
+#include "GainStage.h"
+#include "EffectChain.h"
+#include "AdaptiveLatency.h"
+#include "Concealment.h"
+#include "AudioArena.h"
+#include "PacingController.h"
+
+// 싱크 주기 이벤트 수신자 (싱크 클럭 모드)
+class IRenderPeriodListener {
+public:
+    virtual ~IRenderPeriodListener() = default;
+    // 렌더 스레드에서 호출, bytesNeeded 만큼 링버퍼를 채워야 함
+    virtual void OnRenderPeriod(size_t bytesNeeded) = 0;
+};
+
+// ---------------------------------------------------------------------------
+// 렌더 엔진: 링버퍼 -> 변환/리샘플/게인/이펙트/리미터/은닉 -> 출력 싱크
+// 상태: Opening -> Running -> (소실/오류) Recovering -> Opening ...
+// 복구 중에도 링 소비 위치는 실시간으로 진행 (임계값 초과분 폐기, 싱크 클럭은 계속 구동)
+// 지정 장치가 연속으로 열리지 않으면 기본 장치로 대체
+// 스레드와 싱크는 Open ~ Close 동안 유지, Start/Stop 은 재생만 전환 (정지 중에는 무음 출력)
+// 탭 모드: 링을 소비하지 않는 별도 읽기 커서로 재생, 채움량을 임계값에 고정하도록 리샘플 비율 보정 (추가 출력)
+// 입력 레이트 변경: 링의 레이트 표시 지점에서 주기를 나눠 비율 교체, 이음매는 은닉 크로스페이드 (싱크/재버퍼링 없음)
+// 생산측 정체 감시: 블록이 예정보다 늦고 링도 모자라면 페이드 후 무음, 복귀하면 임계값까지 건너뛰고 페이드 인
+// ---------------------------------------------------------------------------
+enum class RenderState : int { Stopped, Opening, Running, Recovering };
+
+struct RenderEngineStats {
+    RenderState state = RenderState::Stopped;
+    uint32_t reconnects = 0;        // 복구 성공 횟수
+    double lastReconnectMs = 0.0;   // 소실 -> 복구 후 첫 주기
+    bool usingFallback = false;     // 기본 장치로 대체 중
+    uint64_t glitches = 0;
+    double firstAudioMs = 0.0;      // 마지막 Start -> 첫 오디오 주기 (아직이면 0)
+    bool warmStart = false;         // 이미 열린 싱크로 재개했는지
+    size_t scratchBytes = 0;        // 임시 버퍼 아레나 크기
+    double cpuLoad = 0.0;           // 주기 처리 시간 / 주기 길이 (평활)
+    double cpuPeak = 0.0;
+    double latencyMs = 0.0;         // 링 채움 + 리미터 (장치 버퍼 제외)
+    double driftPpm = 0.0;          // 탭 모드 드리프트 보정 추정치
+    uint64_t tapDroppedBytes = 0;   // 탭 모드에서 추월로 잃은 바이트 (채널당)
+    uint64_t silentPeriods = 0;     // 무음 빠른 경로로 처리한 주기
+    uint32_t rateChanges = 0;       // 재생 중 적용한 입력 레이트 변경
+    double inputRate = 0.0;         // 현재 입력 레이트 (재생 중이 아니면 0)
+    uint32_t stalls = 0;            // 생산측 정체 횟수
+    double lastStallMs = 0.0;       // 블록 예정 시각 -> 복귀
+    double longestStallMs = 0.0;
+    bool stalled = false;           // 현재 정체 중
+    size_t effects = 0;             // 이펙트 체인 노드 수
+    double effectLoad[EffectChain::MAX_EFFECTS] = {}; // 노드별 처리 시간 / 주기 길이 (평활)
+    double effectPeak[EffectChain::MAX_EFFECTS] = {};
+    size_t effectLatencyFrames = 0;
+};
+
+class CRenderEngine {
+public:
+    static const uint32_t WAIT_TIMEOUT_MS = 200;
+    static const int LOST_AFTER_TIMEOUTS = 5;        // 1초 동안 이벤트가 없으면 소실로 판단
+    static constexpr double BACKOFF_MIN_MS = 50.0;
+    static constexpr double BACKOFF_MAX_MS = 2000.0;
+    static const int FALLBACK_AFTER_ATTEMPTS = 3;    // 지정 장치 실패 횟수 -> 기본 장치
+    static const uint32_t RECOVERY_TICK_MS = 10;
+    // 무음 빠른 경로 전에 전체 경로로 흘려보낼 무음 (리미터 룩어헤드/은닉 페이드/보간 히스토리 비움)
+    static constexpr double SILENCE_SETTLE_MS = 20.0;
+
+    CRenderEngine();
+    ~CRenderEngine();
+
+    // 출력 싱크 (Open 전, 제어 스레드). 없으면 Open 실패
+    void SetSink(std::unique_ptr<IOutputSink> sink);
+    // 임시 버퍼 아레나 옵션 (Open 전)
+    void SetArenaOptions(const ArenaOptions& options) { m_arenaOptions = options; }
+    // 탭 모드 (Open 전). 링 소비는 주 출력이 하고 이 엔진은 읽기만 함
+    void SetTapMode(bool enabled) { if (!m_bRunning) m_tapMode = enabled; }
+    bool IsTapMode() const { return m_tapMode; }
+
+    // 렌더 스레드 시작 + 싱크 열기 (재생 없이 무음 출력). 이미 열려 있으면 그대로
+    bool Open(const std::wstring& deviceId);
+    // 렌더 스레드 종료 + 싱크 닫기
+    void Close();
+    bool IsOpen() const { return m_bRunning; }
+    // 출력 장치 변경 (렌더 스레드가 싱크만 다시 염, 재생 상태 유지)
+    void SetDevice(const std::wstring& deviceId);
+
+    // 재생 시작 (열려 있지 않으면 Open). 준비된 싱크로 다음 주기부터 재개
+    bool Start(ByteRingBuffer* pBufferL, ByteRingBuffer* pBufferR,
+        const std::wstring& deviceId,
+        ASIOSampleType sampleType, double inputSampleRate, size_t threshold);
+    // 재생 중지 (짧은 페이드 아웃 후 무음). 반환 후 렌더 스레드는 링버퍼에 접근하지 않음
+    void Stop();
+    bool IsRunning() const { return m_playing; }
+
+    // 싱크 클럭 모드: 장치 이벤트마다 호출될 수신자 (nullptr 이면 해제)
+    void SetPeriodListener(IRenderPeriodListener* listener) { m_pListener.store(listener, std::memory_order_release); }
+
+    // 송출 게인 스테이지 (Start 전에 설정, 소유는 호출측)
+    void SetGainStage(GainStage* gain) { m_pGain = gain; }
+
+    // 출력단 리미터 (Start 전 또는 재생 중 교체, 제어 스레드)
+    void SetLimiter(const LimiterSettings& settings);
+    // 송출 이펙트 체인 (게인 다음, 리미터 앞). 빈 목록이면 사용 안 함
+    void SetEffects(const std::vector<EffectSettings>& effects);
+    // 재생 시작 임계값 변경 (재생 중이면 다음 주기부터 적용)
+    void SetThreshold(size_t threshold);
+    // 현재 적용 중인 임계값 (바이트, 자동 모드에서 변함)
+    size_t GetThreshold() const { return m_thresholdBytes.load(std::memory_order_acquire); }
+    // 장치 출력 레이트 (재생 중이 아니면 0)
+    double GetOutputRate() const { return m_outRate.load(std::memory_order_acquire); }
+    // 리미터로 추가된 지연 (출력 레이트 기준 프레임, 비활성 시 0)
+    size_t GetAddedLatencyFrames() const { return m_addedLatencyFrames.load(std::memory_order_acquire); }
+    double GetAddedLatencySeconds() const { return m_addedLatencySeconds.load(std::memory_order_acquire); }
+
+    // 자동 레이턴시 (켜면 고정 임계값 대신 지터 측정으로 결정)
+    void SetAutoLatency(const AutoLatencySettings& settings) { m_autoLatency.Configure(settings); }
+    bool IsAutoLatency() const { return m_autoLatency.IsEnabled(); }
+    double GetAutoLatencyMs() const { return m_autoLatency.GetTargetMs(); }
+    // 생산측 블록 도착 기록 (버퍼 스위치 스레드)
+    void RecordProducerBlock(uint32_t frames) {
+        m_producerBlockFrames.store(frames, std::memory_order_relaxed);
+        m_producerStampNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(),
+            std::memory_order_release);
+        m_autoLatency.RecordProducerBlock(frames);
+    }
+    // 정체 판정: 다음 블록 예정 시각에서 timeout 을 넘기면 (0 이면 감시 안 함, 싱크 클럭 모드 제외)
+    void SetStallTimeout(std::chrono::milliseconds timeout) { m_stallTimeoutSec.store(timeout.count() * 0.001, std::memory_order_release); }
+
+    // 언더런 은닉 (끄면 무음 후 전체 임계값까지 재버퍼링)
+    void SetConcealment(bool enabled) { m_concealment.store(enabled, std::memory_order_release); }
+    // 재생 중 발생한 끊김 횟수 (은닉 여부와 무관, 장치 소실 포함)
+    uint64_t GetGlitchCount() const { return m_glitchCount.load(std::memory_order_relaxed); }
+
+    RenderState GetState() const { return m_state.load(std::memory_order_acquire); }
+    RenderEngineStats GetStats() const;
+
+private:
+    void RenderThreadFunc();
+
+    // 싱크 열기 + 처리 체인을 장치 포맷에 맞춤 (비실시간 경로)
+    bool OpenSink(const std::wstring& deviceId);
+    // 한 주기 렌더링 (실시간 경로)
+    void RenderPeriod(uint8_t* pData, uint32_t framesNeeded);
+    void WriteOutput(uint8_t* pData, uint32_t framesNeeded, size_t generated);
+    // 싱크 없이 경과 시간만큼 링 소비 위치 진행
+    void AdvanceWithoutSink(double seconds);
+    void RecordLoad(double busySeconds, uint32_t frames);
+    // 정체 중이면 이번 주기를 무음(페이드)으로 채우고 true
+    bool WatchProducer(uint8_t* pData, uint32_t framesNeeded, size_t samplesToRead);
+
+    // 입력 소스 (주 출력: 링버퍼, 탭 모드: 읽기 커서)
+    size_t SourceAvailable() const;
+    size_t SourcePop(size_t bytes);
+    void SourceDiscard(size_t bytes);
+    bool SourceIsSilent() const;
+    size_t SourceReadIndex() const;
+    void SetupDrift();
+
+    // 입력 레이트 변경 (링 레이트 표시)
+    size_t FramesToRateMark() const;      // 다음 표시까지 입력 프레임 (없으면 SIZE_MAX)
+    double SourceFillSeconds(size_t bytesAvailable) const;
+    bool ApplyReachedRateMarks();         // 읽기 위치에 도달한 표시 적용
+    void ApplyInputRate(double rate);
+    void UpdateRatio();
+    size_t InputFramesFor(size_t outFrames) const;
+    // 입력 inFrames 를 읽어 변환/리샘플, 출력 offset 부터 최대 outMax 개 (만든 개수 반환)
+    size_t RenderSegment(size_t inFrames, size_t offset, size_t outMax);
+
+    void DrainCommands();
+    void BeginStream();
+    void PostCommand(const RtCommand& command);
+    uint32_t PostStreamCommand(uint32_t type);
+    void ApplyLimiter(Limiter* next);
+    void ApplyEffects(EffectChain* next);
+    void UpdateAddedLatency();
+    void PublishEffectStats();
+    void SetThresholdInternal(size_t threshold);
+    size_t MsToBytes(double ms) const;
+    void ConvertRawToFloat(const void* input, float* output, size_t sampleCount);
+
+    // 렌더 스레드 명령
+    enum RenderCommand : uint32_t {
+        CMD_START = 1,   // a: 순번
+        CMD_STOP,        // a: 순번
+        CMD_SET_DEVICE,
+    };
+    ControlQueue m_commands;
+    // 임계값 변경은 최신값만 의미가 있으므로 큐 대신 값으로 넘김 (큐가 가득 차도 유실 없음)
+    static const size_t NO_THRESHOLD = SIZE_MAX;
+    std::atomic<size_t> m_requestedThreshold{ NO_THRESHOLD };
+
+    // 재생 시작 인자 (제어 스레드가 쓰고 CMD_START 로 넘김)
+    struct StreamParams {
+        ByteRingBuffer* pBufferL = nullptr;
+        ByteRingBuffer* pBufferR = nullptr;
+        ASIOSampleType sampleType = ASIOSTFloat32LSB;
+        double inputRate = 48000.0;
+        size_t threshold = 0;
+        std::chrono::steady_clock::time_point requestedAt;
+    };
+    StreamParams m_pendingStream;
+    bool m_playing = false;             // 제어 스레드 기준 재생 상태
+    uint32_t m_controlSeq = 0;
+    std::atomic<uint32_t> m_appliedSeq{ 0 }; // 렌더 스레드가 처리한 마지막 순번
+    std::wstring m_openDevice;          // 제어 스레드 기준 장치
+    RtHandoff<std::wstring> m_device;   // CMD_SET_DEVICE 인자. 렌더 스레드는 재연결 경로에서만 가져감
+
+    std::atomic<bool> m_bRunning{ false };
+    std::thread m_renderThread;
+    std::unique_ptr<IOutputSink> m_sink;
+    std::atomic<RenderState> m_state{ RenderState::Stopped };
+
+    ByteRingBuffer* m_pBufferL = nullptr;
+    ByteRingBuffer* m_pBufferR = nullptr;
+
+    // 탭 모드 (렌더 스레드 전용)
+    bool m_tapMode = false;
+    RingTap m_tap;
+    PacingController m_drift;
+    double m_driftScale = 1.0;
+
+    size_t m_rateMarkSeq = 0;           // 다음에 볼 레이트 표시 순번 (렌더 스레드 전용)
+    size_t m_spliceDelay = SIZE_MAX;    // 이펙트/리미터를 지나 이음매가 나올 때까지 남은 프레임
+
+    // 생산측 정체 감시 (타임스탬프는 버퍼 스위치 스레드가 씀)
+    std::atomic<int64_t> m_producerStampNs{ 0 };
+    std::atomic<uint32_t> m_producerBlockFrames{ 0 };
+    std::atomic<double> m_stallTimeoutSec{ 0.0 };
+    bool m_stalled = false;
+    int64_t m_stallStampNs = 0;         // 정체 판정 시 마지막 블록
+    int64_t m_stallDueNs = 0;           // 다음 블록이 왔어야 할 시각
+    int64_t m_stallReturnNs = 0;        // 복귀 후 첫 블록 (0: 아직)
+    std::atomic<bool> m_stalledFlag{ false };
+    std::atomic<uint32_t> m_stalls{ 0 };
+    std::atomic<double> m_lastStallMs{ 0.0 };
+    std::atomic<double> m_longestStallMs{ 0.0 };
+    std::atomic<uint32_t> m_rateChanges{ 0 };
+    std::atomic<double> m_currentInputRate{ 0.0 };
+
+    std::atomic<IRenderPeriodListener*> m_pListener{ nullptr };
+
+    ASIOSampleType m_sampleType = ASIOSTFloat32LSB;
+    int m_sampleSizeBytes = 4;
+    double m_inputRate = 48000.0;
+
+    // 현재 싱크 포맷과 그에 맞춘 처리 상태 (렌더 스레드 전용)
+    std::wstring m_targetDevice;
+    bool m_reopenRequested = false;
+    bool m_sinkOpen = false;
+    bool m_rtPlaying = false;
+    size_t m_stopFadeFrames = 0;    // 정지 후 남은 페이드 아웃
+    bool m_firstAudioPending = false;
+    std::chrono::steady_clock::time_point m_startRequestedAt;
+    SinkFormat m_format;
+    bool m_needResample = false;
+    size_t m_safeThreshold = 0;
+    bool m_isBuffering = true;
+    bool m_hasPlayed = false;   // 첫 재생 전에는 항상 전체 임계값까지 버퍼링
+    bool m_inGlitch = false;
+    bool m_autoLatencyOn = false;
+    size_t m_quietFrames = 0;       // 전체 경로로 처리한 연속 무음 (출력 프레임)
+    size_t m_quietSettleFrames = 0;
+
+    Resampler m_resamplerL;
+    Resampler m_resamplerR;
+
+    GainStage* m_pGain = nullptr;
+    LimiterSettings m_limiterSettings;
+    RtHandoff<Limiter> m_limiter;     // 실행 중 교체는 렌더 스레드가 주기 시작 시 가져감
+    Limiter* m_pLimiter = nullptr;    // 렌더 스레드가 사용 중인 리미터
+    std::vector<EffectSettings> m_effectSettings;
+    RtHandoff<EffectChain> m_effects;
+    EffectChain* m_pEffects = nullptr; // 렌더 스레드가 사용 중인 체인
+    size_t m_processLatency = 0;      // 이펙트 + 리미터 지연 (렌더 스레드 전용)
+    std::mutex m_limiterLock;         // m_limiterSettings / m_effectSettings / m_outRate (제어측)
+    std::atomic<double> m_outRate{ 0.0 };
+    std::atomic<size_t> m_addedLatencyFrames{ 0 };
+    std::atomic<double> m_addedLatencySeconds{ 0.0 };
+    std::atomic<size_t> m_effectCount{ 0 };
+    std::atomic<size_t> m_effectLatencyFrames{ 0 };
+    std::atomic<double> m_effectLoad[EffectChain::MAX_EFFECTS] = {};
+    std::atomic<double> m_effectPeak[EffectChain::MAX_EFFECTS] = {};
+
+    AdaptiveLatency m_autoLatency;
+    std::atomic<size_t> m_thresholdBytes{ 0 };
+
+    UnderrunConcealer m_concealer;
+    std::atomic<bool> m_concealment{ true };
+    std::atomic<uint64_t> m_glitchCount{ 0 };
+    std::atomic<uint64_t> m_silentPeriods{ 0 };
+
+    // 복구 통계
+    std::atomic<uint32_t> m_reconnects{ 0 };
+    std::atomic<double> m_lastReconnectMs{ 0.0 };
+    std::atomic<bool> m_usingFallback{ false };
+    std::atomic<double> m_firstAudioMs{ 0.0 };
+    std::atomic<bool> m_warmStart{ false };
+
+    // 부하/지연 통계 (렌더 스레드가 씀)
+    double m_loadAverage = 0.0;
+    std::atomic<double> m_cpuLoad{ 0.0 };
+    std::atomic<double> m_cpuPeak{ 0.0 };
+    std::atomic<double> m_latencyMs{ 0.0 };
+
+    // 임시 버퍼 (싱크를 열 때 장치 버퍼 크기로 아레나에 배치)
+    CAudioArena m_scratch;
+    ArenaOptions m_arenaOptions;
+    std::atomic<size_t> m_scratchBytes{ 0 };
+    uint8_t* m_rawTempL = nullptr;
+    uint8_t* m_rawTempR = nullptr;
+    float* m_floatTempL = nullptr;
+    float* m_floatTempR = nullptr;
+    float* m_resampledTempL = nullptr;
+    float* m_resampledTempR = nullptr;
+};
@@ -0,0 +1,326 @@
+﻿#include "ReplayBuffer.h"
+#include "SampleConvert.h"
+#include "WavFile.h"
+#include "timer.h"
+#include "ThreadPlacement.h"
+#include "Logger.h"
+#include <algorithm>
+
+CReplayBuffer::CReplayBuffer() {}
+CReplayBuffer::~CReplayBuffer() { Stop(); }
+
+bool CReplayBuffer::Start(const ByteRingBuffer* pBufferL, const ByteRingBuffer* pBufferR,
+    ASIOSampleType sampleType, double sampleRate,
+    size_t memoryBytes, double clipSeconds, const std::wstring& outputDirectory)
+{
+    if (m_bRunning) return true;
+
+    m_sampleSize = GetAsioSampleSize(sampleType);
+    if (m_sampleSize == 0) return false;
+
+    m_sampleType = sampleType;
+    m_sampleRate = sampleRate;
+    m_clipSeconds = clipSeconds;
+    m_outputDirectory = outputDirectory;
+
+    // 아레나와 작업 버퍼는 여기서 전부 할당
+    size_t chunkCount = std::max<size_t>(2, memoryBytes / CHUNK_BYTES);
+    m_arena.assign(chunkCount * CHUNK_BYTES, 0);
+    m_chunks.assign(chunkCount, Chunk());
+    m_head = 0;
+    m_validChunks = 1;
+
+    m_readL.assign(BLOCK_FRAMES * m_sampleSize, 0);
+    m_readR.assign(BLOCK_FRAMES * m_sampleSize, 0);
+    m_droppedSeen = 0;
+    m_pendingL.assign(BLOCK_FRAMES * m_sampleSize, 0);
+    m_pendingR.assign(BLOCK_FRAMES * m_sampleSize, 0);
+    m_pendingFrames = 0;
+    m_encodeBuf.assign(ReplayCodec::MaxEncodedSize(BLOCK_FRAMES, m_sampleSize), 0);
+
+    m_retainedFrames = 0;
+    m_compressedBytes = 0;
+    m_rawBytes = 0;
+    m_clipsSaved = 0;
+    m_clipsRejected = 0;
+    m_tap.Attach(pBufferL, pBufferR);
+
+    m_hStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    m_hSaveEvent = CreateEventW(nullptr, FALSE, FALSE, SAVE_EVENT_NAME);
+    m_hExportEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    m_bRunning = true;
+    m_exportRunning = true;
+    m_thread = std::thread(&CReplayBuffer::CompressThreadFunc, this);
+    m_exportThread = std::thread(&CReplayBuffer::ExportThreadFunc, this);
+    return true;
+}
+
+void CReplayBuffer::Stop() {
+    if (!m_bRunning) return;
+    m_bRunning = false;
+    if (m_hStopEvent) SetEvent(m_hStopEvent);
+    if (m_thread.joinable()) m_thread.join();
+    // 압축 스레드가 끝난 뒤 (새 작업 없음) 이미 요청된 클립은 마저 기록하고 종료
+    m_exportRunning = false;
+    if (m_hExportEvent) SetEvent(m_hExportEvent);
+    if (m_exportThread.joinable()) m_exportThread.join();
+
+    m_tap.Detach();
+    if (m_hExportEvent) { CloseHandle(m_hExportEvent); m_hExportEvent = nullptr; }
+    if (m_hSaveEvent) { CloseHandle(m_hSaveEvent); m_hSaveEvent = nullptr; }
+    if (m_hStopEvent) { CloseHandle(m_hStopEvent); m_hStopEvent = nullptr; }
+}
+
+void CReplayBuffer::RequestSave() {
+    if (m_hSaveEvent) SetEvent(m_hSaveEvent);
+}
+
+ReplayStats CReplayBuffer::GetStats() const {
+    ReplayStats s;
+    s.retainedSeconds = m_retainedFrames.load(std::memory_order_relaxed) / m_sampleRate.load(std::memory_order_relaxed);
+    s.compressedBytes = m_compressedBytes.load(std::memory_order_relaxed);
+    s.rawBytes = m_rawBytes.load(std::memory_order_relaxed);
+    s.droppedFrames = m_tap.GetDroppedBytes() / (m_sampleSize ? m_sampleSize : 4);
+    s.clipsSaved = m_clipsSaved.load(std::memory_order_relaxed);
+    s.clipsRejected = m_clipsRejected.load(std::memory_order_relaxed);
+    return s;
+}
+
+void CReplayBuffer::CompressThreadFunc() {
+    ThreadPlacement::Scope placement(ThreadRole::Worker);
+
+    HANDLE handles[2] = { m_hStopEvent, m_hSaveEvent };
+    while (m_bRunning) {
+        DrainTap();
+        DWORD result = WaitForMultipleObjects(2, handles, FALSE, POLL_INTERVAL_MS);
+        if (result == WAIT_OBJECT_0 + 1) {
+            DrainTap();
+            SnapshotClip();
+        }
+    }
+}
+
+void CReplayBuffer::DrainTap() {
+    for (;;) {
+        // 레이트 표시에서 끊어 읽음 (표시 이후는 새 레이트)
+        size_t got = m_tap.Pop(m_readL.data(), m_readR.data(), std::min(m_readL.size(), m_tap.BytesToRateMark()));
+
+        // 추월로 건너뛴 구간은 읽은 데이터 앞에 무음으로 (Pop 은 건너뛴 뒤 읽음)
+        uint64_t dropped = m_tap.GetDroppedBytes();
+        if (dropped != m_droppedSeen) {
+            AppendSilence((dropped - m_droppedSeen) / m_sampleSize);
+            m_droppedSeen = dropped;
+        }
+        if (got > 0) AppendFrames(m_readL.data(), m_readR.data(), (uint32_t)(got / m_sampleSize));
+
+        double rate = 0.0;
+        if (m_tap.TakeRateChange(rate)) {
+            if (rate > 0.0 && rate != m_sampleRate.load(std::memory_order_relaxed)) ResetHistory(rate);
+            continue;
+        }
+        if (got == 0) break;
+    }
+}
+
+// 레이트가 바뀌면 이전 레이트의 기록은 한 클립에 섞을 수 없으므로 버리고 새로 모음
+void CReplayBuffer::ResetHistory(double sampleRate) {
+    m_pendingFrames = 0;
+    for (auto& chunk : m_chunks) chunk = Chunk();
+    m_head = 0;
+    m_validChunks = 1;
+    m_retainedFrames = 0;
+    m_compressedBytes = 0;
+    m_rawBytes = 0;
+    DebugLog("[Replay] Rate Changed: %.0f -> %.0f Hz, History Cleared\n", m_sampleRate.load(std::memory_order_relaxed), sampleRate);
+    m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+}
+
+void CReplayBuffer::AppendFrames(const uint8_t* dataL, const uint8_t* dataR, uint32_t frames) {
+    while (frames > 0) {
+        uint32_t n = std::min(frames, BLOCK_FRAMES - m_pendingFrames);
+        size_t offset = (size_t)m_pendingFrames * m_sampleSize;
+        memcpy(m_pendingL.data() + offset, dataL, (size_t)n * m_sampleSize);
+        memcpy(m_pendingR.data() + offset, dataR, (size_t)n * m_sampleSize);
+        m_pendingFrames += n;
+        dataL += (size_t)n * m_sampleSize;
+        dataR += (size_t)n * m_sampleSize;
+        frames -= n;
+        if (m_pendingFrames == BLOCK_FRAMES) CompressPending();
+    }
+}
+
+void CReplayBuffer::AppendSilence(uint64_t frames) {
+    // 모든 ASIO 샘플 타입에서 0 바이트가 무음 (전부 0 인 블록은 헤더만 저장)
+    while (frames > 0) {
+        uint32_t n = (uint32_t)std::min<uint64_t>(frames, BLOCK_FRAMES - m_pendingFrames);
+        size_t offset = (size_t)m_pendingFrames * m_sampleSize;
+        memset(m_pendingL.data() + offset, 0, (size_t)n * m_sampleSize);
+        memset(m_pendingR.data() + offset, 0, (size_t)n * m_sampleSize);
+        m_pendingFrames += n;
+        frames -= n;
+        if (m_pendingFrames == BLOCK_FRAMES) CompressPending();
+    }
+}
+
+void CReplayBuffer::CompressPending() {
+    if (m_pendingFrames == 0) return;
+    size_t bytes = ReplayCodec::Encode(m_sampleType, m_pendingL.data(), m_pendingR.data(),
+        m_pendingFrames, m_encodeBuf.data(), m_encodeBuf.size());
+    if (bytes > 0) AppendBlock(m_encodeBuf.data(), bytes, m_pendingFrames);
+    m_pendingFrames = 0;
+}
+
+void CReplayBuffer::AppendBlock(const uint8_t* data, size_t bytes, uint32_t frames) {
+    if (bytes > CHUNK_BYTES) return;
+
+    Chunk* chunk = &m_chunks[m_head];
+    if (chunk->used + bytes > CHUNK_BYTES) {
+        // 다음 청크로 이동, 가득 찼으면 가장 오래된 청크를 버림
+        m_head = (m_head + 1) % m_chunks.size();
+        if (m_validChunks < m_chunks.size()) m_validChunks++;
+        chunk = &m_chunks[m_head];
+        m_retainedFrames -= chunk->frames;
+        m_compressedBytes -= chunk->used;
+        m_rawBytes -= chunk->rawBytes;
+        *chunk = Chunk();
+    }
+
+    memcpy(&m_arena[m_head * CHUNK_BYTES + chunk->used], data, bytes);
+    chunk->used += (uint32_t)bytes;
+    chunk->frames += frames;
+    chunk->rawBytes += (uint64_t)frames * m_sampleSize * 2;
+
+    m_retainedFrames += frames;
+    m_compressedBytes += bytes;
+    m_rawBytes += (uint64_t)frames * m_sampleSize * 2;
+}
+
+void CReplayBuffer::SnapshotClip() {
+    // 누적 중인 부분 블록까지 포함
+    CompressPending();
+
+    // 최신 청크부터 거꾸로 필요한 만큼 모음
+    const double sampleRate = m_sampleRate.load(std::memory_order_relaxed);
+    uint64_t wantFrames = (uint64_t)(m_clipSeconds * sampleRate);
+    uint64_t haveFrames = 0;
+    size_t count = 0;
+    size_t totalBytes = 0;
+    while (count < m_validChunks && haveFrames < wantFrames) {
+        const Chunk& c = m_chunks[(m_head + m_chunks.size() - count) % m_chunks.size()];
+        haveFrames += c.frames;
+        totalBytes += c.used;
+        count++;
+    }
+    if (haveFrames == 0) return;
+
+    // 압축된 상태로 복사 (복호화와 파일 기록은 별도 스레드)
+    std::vector<uint8_t> blocks;
+    blocks.reserve(totalBytes);
+    for (size_t i = count; i-- > 0;) {
+        size_t idx = (m_head + m_chunks.size() - i) % m_chunks.size();
+        const uint8_t* base = &m_arena[idx * CHUNK_BYTES];
+        blocks.insert(blocks.end(), base, base + m_chunks[idx].used);
+    }
+
+    std::string date = PrecisionClock::GetDateString();
+    std::wstring path = m_outputDirectory;
+    if (!path.empty() && path.back() != L'\\' && path.back() != L'/') path += L'\\';
+    path += L"DeltaCast_Replay_" + std::wstring(date.begin(), date.end());
+    // 같은 초에 연달아 저장하면 번호를 붙임 (덮어쓰지 않게)
+    m_sameSecondSaves = (date == m_lastSaveDate) ? m_sameSecondSaves + 1 : 0;
+    m_lastSaveDate = date;
+    if (m_sameSecondSaves > 0) path += L"_" + std::to_wstring(m_sameSecondSaves + 1);
+    path += L".wav";
+
+    // 이전 내보내기를 기다리지 않음 (압축이 멈추면 탭이 추월당함)
+    ExportJob job;
+    job.blocks = std::move(blocks);
+    job.skipFrames = (haveFrames > wantFrames) ? haveFrames - wantFrames : 0;
+    job.sampleRate = (uint32_t)sampleRate;
+    job.path = path;
+    size_t pending = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_exportLock);
+        pending = m_exportQueue.size();
+        if (pending < MAX_PENDING_EXPORTS) m_exportQueue.push_back(std::move(job));
+    }
+    if (pending >= MAX_PENDING_EXPORTS) {
+        m_clipsRejected++;
+        DebugLog("[Replay] Save Rejected: %zu Exports Pending\n", pending);
+        return;
+    }
+    SetEvent(m_hExportEvent);
+}
+
+void CReplayBuffer::ExportThreadFunc() {
+    ThreadPlacement::Scope placement(ThreadRole::Background);
+
+    for (;;) {
+        ExportJob job;
+        bool haveJob = false;
+        {
+            std::lock_guard<std::mutex> lock(m_exportLock);
+            if (!m_exportQueue.empty()) {
+                job = std::move(m_exportQueue.front());
+                m_exportQueue.pop_front();
+                haveJob = true;
+            }
+        }
+        if (haveJob) { ExportClip(job); continue; }
+        if (!m_exportRunning) break;
+        WaitForSingleObject(m_hExportEvent, INFINITE);
+    }
+}
+
+void CReplayBuffer::ExportClip(const ExportJob& job) {
+    const std::vector<uint8_t>& blocks = job.blocks;
+    uint64_t skipFrames = job.skipFrames;
+
+    HANDLE hFile = CreateFileW(job.path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) return;
+
+    // float32 WAV 로 기록
+    const uint32_t rate = job.sampleRate;
+    std::vector<uint8_t> header = WavFile::BuildHeader(WavContainer::Wav, WavSampleFormat::Float32, 2, rate, 0);
+    DWORD written = 0;
+    WriteFile(hFile, header.data(), (DWORD)header.size(), &written, nullptr);
+
+    std::vector<uint8_t> rawL(BLOCK_FRAMES * m_sampleSize), rawR(BLOCK_FRAMES * m_sampleSize);
+    std::vector<float> floatL(BLOCK_FRAMES), floatR(BLOCK_FRAMES), interleaved(BLOCK_FRAMES * 2);
+    uint64_t dataBytes = 0;
+
+    size_t pos = 0;
+    while (pos + sizeof(ReplayCodec::BlockHeader) <= blocks.size()) {
+        ReplayCodec::BlockHeader hdr;
+        memcpy(&hdr, &blocks[pos], sizeof(hdr));
+        size_t blockBytes = sizeof(hdr) + hdr.payloadBytes;
+        if (hdr.frames > BLOCK_FRAMES || pos + blockBytes > blocks.size()) break;
+
+        if (ReplayCodec::Decode(m_sampleType, &blocks[pos], blockBytes, rawL.data(), rawR.data())) {
+            uint32_t start = (uint32_t)std::min<uint64_t>(skipFrames, hdr.frames);
+            skipFrames -= start;
+            uint32_t frames = hdr.frames - start;
+            if (frames > 0) {
+                ConvertSamplesToFloat(m_sampleType, rawL.data() + start * m_sampleSize, floatL.data(), frames);
+                ConvertSamplesToFloat(m_sampleType, rawR.data() + start * m_sampleSize, floatR.data(), frames);
+                for (uint32_t i = 0; i < frames; i++) {
+                    interleaved[i * 2 + 0] = floatL[i];
+                    interleaved[i * 2 + 1] = floatR[i];
+                }
+                WriteFile(hFile, interleaved.data(), frames * 2 * sizeof(float), &written, nullptr);
+                dataBytes += (uint64_t)frames * 2 * sizeof(float);
+            }
+        }
+        pos += blockBytes;
+    }
+
+    // 헤더 확정
+    header = WavFile::BuildHeader(WavContainer::Wav, WavSampleFormat::Float32, 2, rate, dataBytes);
+    LARGE_INTEGER zero;
+    zero.QuadPart = 0;
+    SetFilePointerEx(hFile, zero, nullptr, FILE_BEGIN);
+    WriteFile(hFile, header.data(), (DWORD)header.size(), &written, nullptr);
+    CloseHandle(hFile);
+
+    m_clipsSaved++;
+}
@@ -0,0 +1,280 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#ifndef MY_ASIO
+#define MY_ASIO
+#include <iasiodrv.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// 리플레이용 무손실 블록 코덱
+// 2차 고정 예측 + Rice 부호화 (FLAC fixed predictor 와 같은 계열)
+// 원본 링버퍼 바이트를 비트 단위로 그대로 복원
+// ---------------------------------------------------------------------------
+namespace ReplayCodec {
+    enum BlockMode : uint8_t {
+        MODE_STORED = 0,    // 원본 그대로 (압축 불가)
+        MODE_PREDICTED = 1, // 예측 + Rice
+        MODE_SILENT = 2     // 모든 바이트가 0
+    };
+
+    // 정수 변환 방식
+    enum IntKind : uint8_t {
+        KIND_INT16 = 0,
+        KIND_INT24 = 1,
+        KIND_INT32 = 2,
+        KIND_FLOAT24 = 3 // 정확히 24비트 정수로 표현되는 float
+    };
+
+    struct BlockHeader {
+        uint32_t payloadBytes;
+        uint32_t frames;
+        uint8_t mode;
+        uint8_t kind;
+        uint16_t reserved;
+    };
+
+    const uint32_t PARTITION = 256;  // Rice 파라미터 단위
+    const uint32_t ESCAPE_Q = 24;    // 이 이상이면 원시값 기록
+    const uint32_t ESCAPE_BITS = 40;
+    const float FLOAT24_SCALE = 8388608.0f; // 2^23
+
+    // 최악의 경우 크기 (헤더 + 원본)
+    inline size_t MaxEncodedSize(size_t frames, int sampleSize) {
+        return sizeof(BlockHeader) + frames * sampleSize * 2;
+    }
+
+    // --- 비트 입출력 ---
+    class BitWriter {
+    public:
+        BitWriter(uint8_t* out, size_t capacity) : m_out(out), m_cap(capacity) {}
+        void Put(uint64_t value, uint32_t bits) {
+            // bits <= 40
+            m_acc |= value << m_count;
+            m_count += bits;
+            while (m_count >= 8) {
+                if (m_pos >= m_cap) { m_overflow = true; m_count = 0; m_acc = 0; return; }
+                m_out[m_pos++] = (uint8_t)m_acc;
+                m_acc >>= 8;
+                m_count -= 8;
+            }
+        }
+        void PutOnes(uint32_t n) { while (n > 32) { Put(0xFFFFFFFFu, 32); n -= 32; } Put((1ull << n) - 1, n); }
+        size_t Finish() { if (m_count > 0) Put(0, 8 - m_count); return m_pos; }
+        bool Overflow() const { return m_overflow; }
+    private:
+        uint8_t* m_out;
+        size_t m_cap;
+        size_t m_pos = 0;
+        uint64_t m_acc = 0;
+        uint32_t m_count = 0;
+        bool m_overflow = false;
+    };
+
+    class BitReader {
+    public:
+        BitReader(const uint8_t* in, size_t size) : m_in(in), m_size(size) {}
+        uint64_t Get(uint32_t bits) {
+            while (m_count < bits) {
+                uint64_t byte = (m_pos < m_size) ? m_in[m_pos++] : 0;
+                m_acc |= byte << m_count;
+                m_count += 8;
+            }
+            uint64_t v = (bits == 64) ? m_acc : (m_acc & ((1ull << bits) - 1));
+            m_acc >>= bits;
+            m_count -= bits;
+            return v;
+        }
+        uint32_t GetOnes(uint32_t maxCount) {
+            uint32_t n = 0;
+            while (n < maxCount && Get(1)) n++;
+            return n;
+        }
+    private:
+        const uint8_t* m_in;
+        size_t m_size;
+        size_t m_pos = 0;
+        uint64_t m_acc = 0;
+        uint32_t m_count = 0;
+    };
+
+    // --- 샘플 <-> 정수 ---
+    inline int64_t LoadInt(IntKind kind, const uint8_t* p, size_t i) {
+        switch (kind) {
+        case KIND_INT16: { int16_t v; memcpy(&v, p + i * 2, 2); return v; }
+        case KIND_INT24: return (int32_t)((p[i * 3 + 2] << 24) | (p[i * 3 + 1] << 16) | (p[i * 3] << 8)) >> 8;
+        case KIND_INT32: { int32_t v; memcpy(&v, p + i * 4, 4); return v; }
+        case KIND_FLOAT24: { float f; memcpy(&f, p + i * 4, 4); return (int64_t)(f * FLOAT24_SCALE); }
+        }
+        return 0;
+    }
+
+    inline void StoreInt(IntKind kind, uint8_t* p, size_t i, int64_t v) {
+        switch (kind) {
+        case KIND_INT16: { int16_t s = (int16_t)v; memcpy(p + i * 2, &s, 2); break; }
+        case KIND_INT24: p[i * 3] = v & 0xFF; p[i * 3 + 1] = (v >> 8) & 0xFF; p[i * 3 + 2] = (v >> 16) & 0xFF; break;
+        case KIND_INT32: { int32_t s = (int32_t)v; memcpy(p + i * 4, &s, 4); break; }
+        case KIND_FLOAT24: { float f = (float)v / FLOAT24_SCALE; memcpy(p + i * 4, &f, 4); break; }
+        }
+    }
+
+    // float 블록이 24비트 정수 격자 위에 있는지 (비트 단위 왕복 검사)
+    inline bool IsFloat24Exact(const uint8_t* p, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            float f; memcpy(&f, p + i * 4, 4);
+            float scaled = f * FLOAT24_SCALE;
+            if (!(std::fabs(scaled) <= FLOAT24_SCALE)) return false; // NaN 포함
+            int64_t v = (int64_t)scaled;
+            float back = (float)v / FLOAT24_SCALE;
+            if (memcmp(&back, &f, 4) != 0) return false; // -0.0 등
+        }
+        return true;
+    }
+
+    inline bool IsAllZero(const uint8_t* p, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) if (p[i]) return false;
+        return true;
+    }
+
+    inline uint64_t ZigZag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+    inline int64_t UnZigZag(uint64_t u) { return (int64_t)(u >> 1) ^ -(int64_t)(u & 1); }
+
+    inline void EncodeChannel(BitWriter& bw, IntKind kind, const uint8_t* p, uint32_t frames) {
+        int64_t h1 = 0, h2 = 0;
+        uint64_t residual[PARTITION];
+        for (uint32_t base = 0; base < frames; base += PARTITION) {
+            uint32_t n = (frames - base < PARTITION) ? frames - base : PARTITION;
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < n; i++) {
+                int64_t x = LoadInt(kind, p, base + i);
+                residual[i] = ZigZag(x - (2 * h1 - h2));
+                h2 = h1; h1 = x;
+                sum += residual[i];
+            }
+            // 평균 기반 Rice 파라미터
+            uint64_t mean = sum / n;
+            uint32_t k = 0;
+            while (k < 31 && (mean >> (k + 1)) > 0) k++;
+            bw.Put(k, 5);
+            for (uint32_t i = 0; i < n; i++) {
+                uint64_t q = residual[i] >> k;
+                if (q >= ESCAPE_Q) {
+                    bw.PutOnes(ESCAPE_Q);
+                    bw.Put(residual[i], ESCAPE_BITS);
+                }
+                else {
+                    bw.PutOnes((uint32_t)q);
+                    bw.Put(0, 1);
+                    if (k) bw.Put(residual[i] & ((1ull << k) - 1), k);
+                }
+            }
+        }
+    }
+
+    inline void DecodeChannel(BitReader& br, IntKind kind, uint8_t* p, uint32_t frames) {
+        int64_t h1 = 0, h2 = 0;
+        for (uint32_t base = 0; base < frames; base += PARTITION) {
+            uint32_t n = (frames - base < PARTITION) ? frames - base : PARTITION;
+            uint32_t k = (uint32_t)br.Get(5);
+            for (uint32_t i = 0; i < n; i++) {
+                uint32_t q = br.GetOnes(ESCAPE_Q);
+                uint64_t u;
+                if (q == ESCAPE_Q) u = br.Get(ESCAPE_BITS);
+                else u = ((uint64_t)q << k) | (k ? br.Get(k) : 0);
+                int64_t x = UnZigZag(u) + (2 * h1 - h2);
+                h2 = h1; h1 = x;
+                StoreInt(kind, p, base + i, x);
+            }
+        }
+    }
+
+    // 스테레오 블록 부호화. 반환값: 헤더 포함 기록 바이트
+    inline size_t Encode(ASIOSampleType type, const uint8_t* rawL, const uint8_t* rawR,
+        uint32_t frames, uint8_t* out, size_t capacity)
+    {
+        int sampleSize = 0;
+        IntKind kind = KIND_INT32;
+        bool canPredict = true;
+        switch (type) {
+        case ASIOSTInt16LSB:   sampleSize = 2; kind = KIND_INT16; break;
+        case ASIOSTInt24LSB:   sampleSize = 3; kind = KIND_INT24; break;
+        case ASIOSTInt32LSB:   sampleSize = 4; kind = KIND_INT32; break;
+        case ASIOSTFloat32LSB: sampleSize = 4; kind = KIND_FLOAT24; break;
+        case ASIOSTFloat64LSB: sampleSize = 8; canPredict = false; break;
+        default: return 0;
+        }
+        size_t rawBytes = (size_t)frames * sampleSize;
+        if (capacity < MaxEncodedSize(frames, sampleSize)) return 0;
+
+        BlockHeader hdr = { 0, frames, MODE_STORED, (uint8_t)kind, 0 };
+        uint8_t* payload = out + sizeof(BlockHeader);
+
+        if (IsAllZero(rawL, rawBytes) && IsAllZero(rawR, rawBytes)) {
+            hdr.mode = MODE_SILENT;
+        }
+        else {
+            if (kind == KIND_FLOAT24 && canPredict) {
+                canPredict = IsFloat24Exact(rawL, frames) && IsFloat24Exact(rawR, frames);
+            }
+            bool encoded = false;
+            if (canPredict) {
+                BitWriter bw(payload, rawBytes * 2);
+                EncodeChannel(bw, kind, rawL, frames);
+                EncodeChannel(bw, kind, rawR, frames);
+                size_t used = bw.Finish();
+                if (!bw.Overflow() && used < rawBytes * 2) {
+                    hdr.mode = MODE_PREDICTED;
+                    hdr.payloadBytes = (uint32_t)used;
+                    encoded = true;
+                }
+            }
+            if (!encoded) {
+                hdr.mode = MODE_STORED;
+                memcpy(payload, rawL, rawBytes);
+                memcpy(payload + rawBytes, rawR, rawBytes);
+                hdr.payloadBytes = (uint32_t)(rawBytes * 2);
+            }
+        }
+        memcpy(out, &hdr, sizeof(hdr));
+        return sizeof(BlockHeader) + hdr.payloadBytes;
+    }
+
+    // 블록 복호화. rawL/rawR 에는 frames * sampleSize 바이트 공간 필요
+    inline bool Decode(ASIOSampleType type, const uint8_t* in, size_t inBytes, uint8_t* rawL, uint8_t* rawR) {
+        if (inBytes < sizeof(BlockHeader)) return false;
+        BlockHeader hdr;
+        memcpy(&hdr, in, sizeof(hdr));
+        if (inBytes < sizeof(BlockHeader) + hdr.payloadBytes) return false;
+
+        int sampleSize = 0;
+        switch (type) {
+        case ASIOSTInt16LSB: sampleSize = 2; break;
+        case ASIOSTInt24LSB: sampleSize = 3; break;
+        case ASIOSTInt32LSB:
+        case ASIOSTFloat32LSB: sampleSize = 4; break;
+        case ASIOSTFloat64LSB: sampleSize = 8; break;
+        default: return false;
+        }
+        size_t rawBytes = (size_t)hdr.frames * sampleSize;
+        const uint8_t* payload = in + sizeof(BlockHeader);
+
+        switch (hdr.mode) {
+        case MODE_SILENT:
+            memset(rawL, 0, rawBytes);
+            memset(rawR, 0, rawBytes);
+            return true;
+        case MODE_STORED:
+            memcpy(rawL, payload, rawBytes);
+            memcpy(rawR, payload + rawBytes, rawBytes);
+            return true;
+        case MODE_PREDICTED: {
+            BitReader br(payload, hdr.payloadBytes);
+            DecodeChannel(br, (IntKind)hdr.kind, rawL, hdr.frames);
+            DecodeChannel(br, (IntKind)hdr.kind, rawR, hdr.frames);
+            return true;
+        }
+        }
+        return false;
+    }
+}
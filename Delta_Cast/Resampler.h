@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <vector>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 
 const float HEADROOM_GAIN = 0.98f;
@@ -12,6 +13,7 @@ public:
         if (outRate == 0.0) outRate = inRate;
         m_ratio = inRate / outRate;
         m_readIndex = 0.0;
+        m_variable = false;
 		// 히스토리 초기화
         for (int i = 0; i < 4; i++) m_history[i] = 0.0f;
     }
@@ -30,11 +32,44 @@ public:
 
     double GetReadIndex() const { return m_readIndex; }
 
+    // outCount 개를 만드는 데 필요한 입력 수 (현재 읽기 위치 기준, 올림 오차가 누적되지 않음)
+    size_t GetInputNeeded(size_t outCount) const {
+        double end = m_readIndex + outCount * m_ratio;
+        return (end < 0.0) ? 0 : (size_t)std::ceil(end) + 1;
+    }
+
+    // 위치/히스토리를 유지한 채 비율만 변경 (드리프트 보정). 이후 단순 복사 경로를 쓰지 않음
+    void SetRatio(double ratio) {
+        m_ratio = ratio;
+        m_variable = true;
+    }
+
+    // 스트림 중 입력 레이트 변경: 위치/히스토리를 유지한 채 비율 교체 (같은 레이트면 단순 복사 경로로 복귀)
+    void ChangeRate(double inRate, double outRate) {
+        if (outRate == 0.0) outRate = inRate;
+        m_ratio = inRate / outRate;
+        m_variable = false;
+    }
+
+    // 뒤에 리미터가 있으면 고정 헤드룸/클리핑을 끔
+    void SetHeadroom(bool enabled) { m_headroom = enabled; }
+
+    // 무음 입력을 처리한 것과 같은 상태로 진행 (출력은 호출측이 0 으로 채움)
+    // 읽기 위치는 Process 와 같은 순서로 누적해 이후 결과가 그대로 이어짐
+    void SkipSilence(size_t inCount, size_t outCount) {
+        if (inCount == 0) return;
+        if (m_variable || std::abs(m_ratio - 1.0) >= 0.0001) {
+            for (size_t i = 0; i < outCount; i++) m_readIndex += m_ratio;
+            m_readIndex -= inCount;
+        }
+        for (int i = 0; i < 4; i++) m_history[i] = 0.0f;
+    }
+
     size_t Process(const float* input, size_t inCount, float* output, size_t maxOutCount) {
         if (inCount == 0 || !output) return 0;
 
         // 비율이 1.0 이면 단순 복사
-        if (std::abs(m_ratio - 1.0) < 0.0001) {
+        if (!m_variable && std::abs(m_ratio - 1.0) < 0.0001) {
             size_t copyCount = (inCount < maxOutCount) ? inCount : maxOutCount;
             memcpy(output, input, copyCount * sizeof(float));
             UpdateHistory(input, inCount);
@@ -84,12 +119,14 @@ public:
 
             // 3차 보간 계산
             float sample = CubicInterp(p0, p1, p2, p3, frac);
-			// 약간의 헤드룸 적용
-            sample *= HEADROOM_GAIN;
+            if (m_headroom) {
+			    // 약간의 헤드룸 적용
+                sample *= HEADROOM_GAIN;
 
-            // 클리핑 방지
-            if (sample > CLIP_LIMIT) sample = CLIP_LIMIT;
-            if (sample < -CLIP_LIMIT) sample = -CLIP_LIMIT;
+                // 클리핑 방지
+                if (sample > CLIP_LIMIT) sample = CLIP_LIMIT;
+                if (sample < -CLIP_LIMIT) sample = -CLIP_LIMIT;
+            }
 
             output[outGenerated++] = sample;
 
@@ -124,4 +161,6 @@ private:
     double m_ratio = 1.0;
     double m_readIndex = 0.0;
     float m_history[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    bool m_headroom = true;
+    bool m_variable = false;
 };
\ No newline at end of file
@@ -1,17 +1,25 @@
 ﻿#pragma once
 #include <atomic>
 #include <vector>
+#include <cstdint>
+#include <cstring>
 
 // ---------------------------------------------------------------------------
 // Lock-Free Ring Buffer
 // ---------------------------------------------------------------------------
 class ByteRingBuffer {
 public:
-	explicit ByteRingBuffer(size_t sizeBytes = 131072) // 기본 크기 128KB
-        : m_size(sizeBytes), m_mask(sizeBytes - 1), m_buffer(sizeBytes) {
-        // 읽기/쓰기 포인터 초기화
-        m_writeIndex.store(0, std::memory_order_relaxed);
-        m_readIndex.store(0, std::memory_order_relaxed);
+	explicit ByteRingBuffer(size_t sizeBytes = 131072) // 기본 크기 128KB, 0 이면 외부 메모리 연결 전까지 비어 있음
+        : m_owned(sizeBytes) {
+        SetStorage(m_owned.data(), sizeBytes);
+    }
+
+    // 외부 메모리 사용 (아레나, 크기는 2의 거듭제곱). 읽기/쓰기 측이 모두 멈춘 상태에서만 호출
+    // nullptr 이면 분리 (용량 0)
+    void AttachStorage(void* storage, size_t sizeBytes) {
+        m_owned.clear();
+        m_owned.shrink_to_fit();
+        SetStorage(static_cast<uint8_t*>(storage), storage ? sizeBytes : 0);
     }
 
     // 데이터 밀어넣기
@@ -75,6 +83,16 @@ public:
         return toRead;
     }
 
+    // 읽지 않고 버림 (소비측)
+    size_t Discard(size_t numBytes) {
+        size_t writeIdx = m_writeIndex.load(std::memory_order_acquire);
+        size_t readIdx = m_readIndex.load(std::memory_order_acquire);
+        size_t avail = writeIdx - readIdx;
+        size_t toSkip = (numBytes < avail) ? numBytes : avail;
+        m_readIndex.store(readIdx + toSkip, std::memory_order_release);
+        return toSkip;
+    }
+
     // 현재 쓸 수 있는 공간
     size_t GetAvailableWrite() const {
         size_t w = m_writeIndex.load(std::memory_order_acquire);
@@ -90,11 +108,187 @@ public:
         return w - r;
     }
 
+    // --- 보조 리더 (RingTap) 용 ---
+    size_t GetCapacity() const { return m_size; }
+    size_t GetWriteIndex() const { return m_writeIndex.load(std::memory_order_acquire); }
+    size_t GetReadIndex() const { return m_readIndex.load(std::memory_order_acquire); }
+
+    // --- 무음 표시 (블록 메타데이터, 마지막 유음 블록의 끝 위치만 유지) ---
+    // 생산측: 유음 블록을 Push 하기 직전에 호출 (쓰기 위치보다 먼저 공개되므로 소비측이 놓치지 않음)
+    void MarkAudible(size_t numBytes) {
+        m_audibleEnd.store(m_writeIndex.load(std::memory_order_relaxed) + numBytes, std::memory_order_release);
+    }
+    // 누적 위치 pos 부터 현재 쓰기 위치까지 모두 무음 블록인지
+    bool IsSilentFrom(size_t pos) const { return pos >= m_audibleEnd.load(std::memory_order_acquire); }
+
+    // --- 레이트 변경 표시 (최근 MAX_RATE_MARKS 개, 읽기측마다 순번 커서를 따로 둠) ---
+    struct RateMark {
+        size_t pos = 0;     // 새 레이트의 첫 바이트 (누적 위치)
+        double rate = 0.0;
+    };
+    static const size_t MAX_RATE_MARKS = 8;
+
+    // 생산측: 새 레이트의 첫 블록을 Push 하기 직전에 호출
+    void MarkRate(double rate) {
+        size_t count = m_rateMarkCount.load(std::memory_order_relaxed);
+        RateMark& mark = m_rateMarks[count % MAX_RATE_MARKS];
+        mark.pos = m_writeIndex.load(std::memory_order_relaxed);
+        mark.rate = rate;
+        m_rateMarkCount.store(count + 1, std::memory_order_release);
+    }
+    size_t GetRateMarkCount() const { return m_rateMarkCount.load(std::memory_order_acquire); }
+    // 순번 seq 의 표시 (아직 없으면 false). 덮어써진 순번은 남아 있는 가장 오래된 것으로 당김
+    bool GetRateMark(size_t& seq, RateMark& mark) const {
+        size_t count = m_rateMarkCount.load(std::memory_order_acquire);
+        if (count - seq > MAX_RATE_MARKS) seq = count - MAX_RATE_MARKS;
+        if (seq >= count) return false;
+        mark = m_rateMarks[seq % MAX_RATE_MARKS];
+        return true;
+    }
+
+    // 누적 위치 pos 부터 복사 (쓰기측을 막지 않음, 덮어쓰기 검증은 호출측 몫)
+    void CopyFrom(size_t pos, void* output, size_t numBytes) const {
+        uint8_t* pOut = static_cast<uint8_t*>(output);
+        size_t offset = pos & m_mask;
+        size_t toEnd = m_size - offset;
+        if (numBytes <= toEnd) {
+            memcpy(pOut, &m_buffer[offset], numBytes);
+        }
+        else {
+            memcpy(pOut, &m_buffer[offset], toEnd);
+            memcpy(pOut + toEnd, &m_buffer[0], numBytes - toEnd);
+        }
+    }
+
 private:
-    std::vector<uint8_t> m_buffer;
-    size_t m_size;
-    size_t m_mask;
+    void SetStorage(uint8_t* storage, size_t sizeBytes) {
+        m_buffer = storage;
+        m_size = sizeBytes;
+        m_mask = sizeBytes - 1;
+        // 읽기/쓰기 포인터 초기화
+        m_writeIndex.store(0, std::memory_order_relaxed);
+        m_readIndex.store(0, std::memory_order_relaxed);
+        m_audibleEnd.store(0, std::memory_order_relaxed);
+        m_rateMarkCount.store(0, std::memory_order_relaxed);
+    }
+
+    std::vector<uint8_t> m_owned;
+    uint8_t* m_buffer = nullptr;
+    size_t m_size = 0;
+    size_t m_mask = 0;
     alignas(64) std::atomic<size_t> m_writeIndex;
     alignas(64) std::atomic<size_t> m_readIndex;
+    std::atomic<size_t> m_audibleEnd{ 0 };
+    RateMark m_rateMarks[MAX_RATE_MARKS];
+    std::atomic<size_t> m_rateMarkCount{ 0 };
     char _padding[64];
+};
+
+// ---------------------------------------------------------------------------
+// 보조 리더 (L/R 공통 커서)
+// 쓰기측에 역압을 주지 않음. 추월당하면 최신 위치로 건너뛰고 드롭으로 집계
+// ---------------------------------------------------------------------------
+class RingTap {
+public:
+    // 진행 중인 Push 와 겹치지 않도록 확보하는 여유분 (용량의 1/4)
+    static constexpr size_t GUARD_DIVISOR = 4;
+
+    void Attach(const ByteRingBuffer* pBufferL, const ByteRingBuffer* pBufferR) {
+        m_pBufferL = pBufferL;
+        m_pBufferR = pBufferR ? pBufferR : pBufferL;
+        m_readIndex = m_pBufferL ? m_pBufferL->GetWriteIndex() : 0;
+        m_rateMarkSeq = m_pBufferL ? m_pBufferL->GetRateMarkCount() : 0;
+        m_droppedBytes.store(0, std::memory_order_relaxed);
+    }
+
+    void Detach() { m_pBufferL = m_pBufferR = nullptr; }
+    bool IsAttached() const { return m_pBufferL != nullptr; }
+    // 누적 읽기 위치 (원본 링의 쓰기 위치와 같은 기준)
+    size_t GetReadIndex() const { return m_readIndex; }
+
+    size_t GetAvailableRead() const {
+        if (!m_pBufferL) return 0;
+        return ReadableEnd() - m_readIndex;
+    }
+
+    // 최대 numBytes 만큼 읽음 (L/R 동일 길이)
+    size_t Pop(void* outputL, void* outputR, size_t numBytes) {
+        if (!m_pBufferL) return 0;
+        size_t limit = m_pBufferL->GetCapacity() - m_pBufferL->GetCapacity() / GUARD_DIVISOR;
+
+        size_t end = ReadableEnd();
+        if (end - m_readIndex > limit) {
+            // 추월당함 -> 최신 위치로 이동
+            Skip(end);
+        }
+
+        size_t toRead = end - m_readIndex;
+        if (toRead > numBytes) toRead = numBytes;
+        if (toRead == 0) return 0;
+
+        m_pBufferL->CopyFrom(m_readIndex, outputL, toRead);
+        m_pBufferR->CopyFrom(m_readIndex, outputR, toRead);
+
+        // 복사 도중 덮어써졌는지 검증
+        if (ReadableEnd() - m_readIndex > limit) {
+            Skip(ReadableEnd());
+            return 0;
+        }
+        m_readIndex += toRead;
+        return toRead;
+    }
+
+    // 읽기 위치부터 쓰기 위치까지 모두 무음 블록인지
+    bool IsSilent() const { return !m_pBufferL || m_pBufferL->IsSilentFrom(m_readIndex); }
+
+    // 읽지 않고 최대 numBytes 만큼 건너뜀
+    size_t Discard(size_t numBytes) {
+        if (!m_pBufferL) return 0;
+        size_t available = ReadableEnd() - m_readIndex;
+        if (numBytes > available) numBytes = available;
+        m_readIndex += numBytes;
+        return numBytes;
+    }
+
+    // 다음 레이트 표시까지 남은 바이트 (없으면 SIZE_MAX). Pop 을 여기서 끊으면 표시 지점에서 포맷 전환 가능
+    size_t BytesToRateMark() const {
+        ByteRingBuffer::RateMark mark;
+        size_t seq = m_rateMarkSeq;
+        if (!m_pBufferL || !m_pBufferL->GetRateMark(seq, mark)) return SIZE_MAX;
+        return (mark.pos > m_readIndex) ? mark.pos - m_readIndex : 0;
+    }
+
+    // 읽기 위치가 지난 레이트 표시를 소비 (건너뛴 것 포함). 있었으면 마지막 레이트를 rate 에
+    bool TakeRateChange(double& rate) {
+        if (!m_pBufferL) return false;
+        bool changed = false;
+        ByteRingBuffer::RateMark mark;
+        while (m_pBufferL->GetRateMark(m_rateMarkSeq, mark) && mark.pos <= m_readIndex) {
+            m_rateMarkSeq++;
+            rate = mark.rate;
+            changed = true;
+        }
+        return changed;
+    }
+
+    // 추월로 잃은 바이트 (채널당)
+    uint64_t GetDroppedBytes() const { return m_droppedBytes.load(std::memory_order_relaxed); }
+
+private:
+    size_t ReadableEnd() const {
+        size_t wL = m_pBufferL->GetWriteIndex();
+        size_t wR = m_pBufferR->GetWriteIndex();
+        return (wL < wR) ? wL : wR;
+    }
+
+    void Skip(size_t to) {
+        m_droppedBytes.fetch_add(to - m_readIndex, std::memory_order_relaxed);
+        m_readIndex = to;
+    }
+
+    const ByteRingBuffer* m_pBufferL = nullptr;
+    const ByteRingBuffer* m_pBufferR = nullptr;
+    size_t m_readIndex = 0;
+    size_t m_rateMarkSeq = 0;   // 다음에 볼 레이트 표시 순번
+    std::atomic<uint64_t> m_droppedBytes{ 0 };
 };
\ No newline at end of file
@@ -0,0 +1,443 @@
+﻿#include "RtCheck.h"
+
+#ifdef DELTA_RT_CHECK
+#ifdef _WIN32
+#include <windows.h>
+#include <dbghelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#else
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#endif
+#include <atomic>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+namespace {
+    const int MAX_RECORDS = 64;
+    const int MAX_FRAMES = 24;
+
+    // 위반 항목 (스택 해시별 하나, 고정 테이블이라 기록 중 할당 없음)
+    struct Record {
+        std::atomic<uint32_t> key{ 0 };     // 0: 빈 칸
+        std::atomic<bool> ready{ false };   // 내용 기록 완료
+        std::atomic<uint64_t> count{ 0 };
+        RtCheck::Violation type = RtCheck::Violation::Allocation;
+        const char* scope = nullptr;
+        const char* what = nullptr;
+        int frames = 0;
+        void* stack[MAX_FRAMES] = {};
+    };
+    Record g_records[MAX_RECORDS];
+    std::atomic<uint64_t> g_total{ 0 };
+    std::atomic<uint64_t> g_dropped{ 0 };
+
+    thread_local int t_depth = 0;
+    thread_local int t_suspended = 0;
+    thread_local const char* t_scope = nullptr;
+    thread_local bool t_busy = false;   // 검사 자체나 이미 기록한 할당의 내부 호출
+
+    const char* ViolationName(RtCheck::Violation type) {
+        switch (type) {
+        case RtCheck::Violation::Allocation: return "Allocation";
+        case RtCheck::Violation::Free: return "Free";
+        case RtCheck::Violation::Lock: return "Lock";
+        case RtCheck::Violation::Wait: return "Wait";
+        case RtCheck::Violation::Io: return "I/O";
+        }
+        return "?";
+    }
+
+    // 보고 출력 (디버거 + 표준 에러, 릴리스 검사 빌드에서도 보임)
+    void Print(const char* fmt, ...) {
+        char buf[1024];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+#ifdef _WIN32
+        OutputDebugStringA(buf);
+#endif
+        fputs(buf, stderr);
+    }
+
+    // 호출 스택과 해시 (skip: 건너뛸 호출자 수)
+    int CaptureStack(int skip, void** stack, uint32_t& hash) {
+#ifdef _WIN32
+        ULONG winHash = 0;
+        int frames = CaptureStackBackTrace(skip + 1, MAX_FRAMES, stack, &winHash);
+        hash = (uint32_t)winHash;
+        return frames;
+#else
+        void* raw[MAX_FRAMES + 4];
+        int frames = backtrace(raw, MAX_FRAMES + 4) - (skip + 1);
+        if (frames < 0) frames = 0;
+        if (frames > MAX_FRAMES) frames = MAX_FRAMES;
+        memcpy(stack, raw + skip + 1, frames * sizeof(void*));
+        hash = 2166136261u;
+        for (int i = 0; i < frames; i++) hash = (hash ^ (uint32_t)(uintptr_t)stack[i]) * 16777619u;
+        return frames;
+#endif
+    }
+
+    // 스택 한 항목씩 출력 (보고 시점, 비실시간)
+    void PrintStack(void* const* stack, int frames) {
+#ifdef _WIN32
+        HANDLE process = GetCurrentProcess();
+        bool symbols = SymInitialize(process, nullptr, TRUE) != FALSE;
+        if (symbols) SymSetOptions(SymGetOptions() | SYMOPT_LOAD_LINES | SYMOPT_UNDNAME);
+        for (int i = 0; i < frames; i++) {
+            DWORD64 address = (DWORD64)stack[i];
+            alignas(SYMBOL_INFO) char symbolBuf[sizeof(SYMBOL_INFO) + 256];
+            SYMBOL_INFO* symbol = (SYMBOL_INFO*)symbolBuf;
+            symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+            symbol->MaxNameLen = 255;
+            DWORD64 offset = 0;
+            IMAGEHLP_LINE64 line = { sizeof(IMAGEHLP_LINE64) };
+            DWORD lineOffset = 0;
+            if (symbols && SymFromAddr(process, address, &offset, symbol)) {
+                if (SymGetLineFromAddr64(process, address, &lineOffset, &line))
+                    Print("    #%d %s+0x%llx (%s:%lu)\n", i, symbol->Name, offset, line.FileName, line.LineNumber);
+                else
+                    Print("    #%d %s+0x%llx\n", i, symbol->Name, offset);
+            }
+            else {
+                Print("    #%d 0x%llx\n", i, address);
+            }
+        }
+        if (symbols) SymCleanup(process);
+#else
+        // 실행 파일 심볼은 -rdynamic 으로 링크해야 이름이 나옴
+        char** names = backtrace_symbols(stack, frames);
+        for (int i = 0; i < frames; i++) Print("    #%d %s\n", i, names ? names[i] : "?");
+        free(names);
+#endif
+    }
+
+    // 이미 기록한 호출의 내부 (operator new -> malloc -> HeapAlloc) 는 다시 기록하지 않음
+    struct BusyGuard {
+        bool previous;
+        BusyGuard() : previous(t_busy) { t_busy = true; }
+        ~BusyGuard() { t_busy = previous; }
+    };
+}
+
+namespace RtCheck {
+
+const char* Enter(const char* scope) {
+    const char* previous = t_scope;
+    t_scope = scope;
+    t_depth++;
+    return previous;
+}
+
+void Leave(const char* previous) {
+    t_depth--;
+    t_scope = previous;
+}
+
+void Suspend() { t_suspended++; }
+void Resume() { t_suspended--; }
+
+bool InScope() {
+    return t_depth > 0 && t_suspended == 0 && !t_busy;
+}
+
+void Check(Violation type, const char* what) {
+    if (!InScope()) return;
+    BusyGuard guard;
+
+    void* stack[MAX_FRAMES];
+    uint32_t hash = 0;
+    int frames = CaptureStack(1, stack, hash);
+    uint32_t key = hash ^ (((uint32_t)type + 1) * 0x9E3779B9u);
+    if (key == 0) key = 1;
+    g_total.fetch_add(1, std::memory_order_relaxed);
+
+    // 같은 스택은 한 칸에 누적 (열린 주소법)
+    bool recorded = false;
+    for (int n = 0; n < MAX_RECORDS && !recorded; n++) {
+        Record& record = g_records[(key + n) % MAX_RECORDS];
+        uint32_t current = record.key.load(std::memory_order_acquire);
+        if (current == 0) {
+            if (record.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                record.type = type;
+                record.scope = t_scope;
+                record.what = what;
+                record.frames = frames;
+                memcpy(record.stack, stack, frames * sizeof(void*));
+                record.ready.store(true, std::memory_order_release);
+                current = key;
+            }
+        }
+        if (current == key) {
+            record.count.fetch_add(1, std::memory_order_relaxed);
+            recorded = true;
+        }
+    }
+    if (!recorded) g_dropped.fetch_add(1, std::memory_order_relaxed);
+
+#if DELTA_RT_CHECK >= 2
+#ifdef _WIN32
+    __debugbreak();
+#else
+    raise(SIGTRAP);
+#endif
+#endif
+}
+
+uint64_t GetViolationCount() {
+    return g_total.load(std::memory_order_relaxed);
+}
+
+uint64_t WriteReport() {
+    BusyGuard guard;
+    uint64_t total = g_total.load(std::memory_order_relaxed);
+    if (total == 0) {
+        Print("[RtCheck] No real-time violations\n");
+        return 0;
+    }
+
+    Print("[RtCheck] %llu real-time violation(s)\n", (unsigned long long)total);
+    for (const Record& record : g_records) {
+        if (!record.ready.load(std::memory_order_acquire)) continue;
+        Print("[RtCheck] %s: %s in %s (x%llu)\n", ViolationName(record.type), record.what,
+            record.scope ? record.scope : "?", (unsigned long long)record.count.load(std::memory_order_relaxed));
+        PrintStack(record.stack, record.frames);
+    }
+    uint64_t dropped = g_dropped.load(std::memory_order_relaxed);
+    if (dropped > 0) Print("[RtCheck] %llu violation(s) not recorded (table full)\n", (unsigned long long)dropped);
+    return total;
+}
+
+} // namespace RtCheck
+
+#ifdef _WIN32
+// ---------------------------------------------------------------------------
+// 임포트 테이블 가로채기 (이 모듈이 호출하는 API만, 로드 시 한 번)
+// ---------------------------------------------------------------------------
+#define RT_HOOK(ret, conv, name, type, params, args) \
+    static ret (conv* s_orig_##name) params = nullptr; \
+    static ret conv Hook_##name params { \
+        RtCheck::Check(RtCheck::Violation::type, #name); \
+        BusyGuard guard; \
+        return s_orig_##name args; \
+    }
+
+RT_HOOK(LPVOID, WINAPI, HeapAlloc, Allocation, (HANDLE h, DWORD f, SIZE_T n), (h, f, n))
+RT_HOOK(LPVOID, WINAPI, HeapReAlloc, Allocation, (HANDLE h, DWORD f, LPVOID p, SIZE_T n), (h, f, p, n))
+RT_HOOK(BOOL, WINAPI, HeapFree, Free, (HANDLE h, DWORD f, LPVOID p), (h, f, p))
+RT_HOOK(LPVOID, WINAPI, VirtualAlloc, Allocation, (LPVOID p, SIZE_T n, DWORD t, DWORD pr), (p, n, t, pr))
+RT_HOOK(BOOL, WINAPI, VirtualFree, Free, (LPVOID p, SIZE_T n, DWORD t), (p, n, t))
+RT_HOOK(void*, __cdecl, malloc, Allocation, (size_t n), (n))
+RT_HOOK(void*, __cdecl, calloc, Allocation, (size_t c, size_t n), (c, n))
+RT_HOOK(void*, __cdecl, realloc, Allocation, (void* p, size_t n), (p, n))
+RT_HOOK(void, __cdecl, free, Free, (void* p), (p))
+RT_HOOK(void, WINAPI, EnterCriticalSection, Lock, (LPCRITICAL_SECTION cs), (cs))
+RT_HOOK(void, WINAPI, AcquireSRWLockExclusive, Lock, (PSRWLOCK lock), (lock))
+RT_HOOK(void, WINAPI, AcquireSRWLockShared, Lock, (PSRWLOCK lock), (lock))
+RT_HOOK(int, __cdecl, _Mtx_lock, Lock, (void* mtx), (mtx))
+RT_HOOK(DWORD, WINAPI, WaitForSingleObject, Wait, (HANDLE h, DWORD ms), (h, ms))
+RT_HOOK(DWORD, WINAPI, WaitForSingleObjectEx, Wait, (HANDLE h, DWORD ms, BOOL a), (h, ms, a))
+RT_HOOK(DWORD, WINAPI, WaitForMultipleObjects, Wait, (DWORD c, const HANDLE* h, BOOL all, DWORD ms), (c, h, all, ms))
+RT_HOOK(BOOL, WINAPI, SleepConditionVariableSRW, Wait, (PCONDITION_VARIABLE cv, PSRWLOCK l, DWORD ms, ULONG f), (cv, l, ms, f))
+RT_HOOK(BOOL, WINAPI, SleepConditionVariableCS, Wait, (PCONDITION_VARIABLE cv, PCRITICAL_SECTION cs, DWORD ms), (cv, cs, ms))
+RT_HOOK(void, WINAPI, Sleep, Wait, (DWORD ms), (ms))
+RT_HOOK(DWORD, WINAPI, SleepEx, Wait, (DWORD ms, BOOL a), (ms, a))
+RT_HOOK(BOOL, WINAPI, WriteFile, Io, (HANDLE h, LPCVOID b, DWORD n, LPDWORD w, LPOVERLAPPED o), (h, b, n, w, o))
+RT_HOOK(BOOL, WINAPI, ReadFile, Io, (HANDLE h, LPVOID b, DWORD n, LPDWORD r, LPOVERLAPPED o), (h, b, n, r, o))
+RT_HOOK(BOOL, WINAPI, FlushFileBuffers, Io, (HANDLE h), (h))
+
+namespace {
+    struct HookEntry {
+        const char* name;
+        void** original;
+        void* hook;
+    };
+
+#define RT_HOOK_ENTRY(name) { #name, (void**)&s_orig_##name, (void*)&Hook_##name }
+    const HookEntry g_hooks[] = {
+        RT_HOOK_ENTRY(HeapAlloc), RT_HOOK_ENTRY(HeapReAlloc), RT_HOOK_ENTRY(HeapFree),
+        RT_HOOK_ENTRY(VirtualAlloc), RT_HOOK_ENTRY(VirtualFree),
+        RT_HOOK_ENTRY(malloc), RT_HOOK_ENTRY(calloc), RT_HOOK_ENTRY(realloc), RT_HOOK_ENTRY(free),
+        RT_HOOK_ENTRY(EnterCriticalSection), RT_HOOK_ENTRY(AcquireSRWLockExclusive),
+        RT_HOOK_ENTRY(AcquireSRWLockShared), RT_HOOK_ENTRY(_Mtx_lock),
+        RT_HOOK_ENTRY(WaitForSingleObject), RT_HOOK_ENTRY(WaitForSingleObjectEx),
+        RT_HOOK_ENTRY(WaitForMultipleObjects), RT_HOOK_ENTRY(SleepConditionVariableSRW),
+        RT_HOOK_ENTRY(SleepConditionVariableCS), RT_HOOK_ENTRY(Sleep), RT_HOOK_ENTRY(SleepEx),
+        RT_HOOK_ENTRY(WriteFile), RT_HOOK_ENTRY(ReadFile), RT_HOOK_ENTRY(FlushFileBuffers),
+    };
+#undef RT_HOOK_ENTRY
+
+    // 이름으로 가져온 임포트 중 목록에 있는 항목을 후크로 교체
+    int PatchImports(HMODULE module) {
+        BYTE* base = (BYTE*)module;
+        IMAGE_DOS_HEADER* dos = (IMAGE_DOS_HEADER*)base;
+        if (dos->e_magic != IMAGE_DOS_SIGNATURE) return 0;
+        IMAGE_NT_HEADERS* nt = (IMAGE_NT_HEADERS*)(base + dos->e_lfanew);
+        IMAGE_DATA_DIRECTORY dir = nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+        if (dir.VirtualAddress == 0) return 0;
+
+        int patched = 0;
+        for (IMAGE_IMPORT_DESCRIPTOR* desc = (IMAGE_IMPORT_DESCRIPTOR*)(base + dir.VirtualAddress); desc->Name != 0; desc++) {
+            if (desc->OriginalFirstThunk == 0) continue;
+            IMAGE_THUNK_DATA* names = (IMAGE_THUNK_DATA*)(base + desc->OriginalFirstThunk);
+            IMAGE_THUNK_DATA* slots = (IMAGE_THUNK_DATA*)(base + desc->FirstThunk);
+            for (; names->u1.AddressOfData != 0; names++, slots++) {
+                if (IMAGE_SNAP_BY_ORDINAL(names->u1.Ordinal)) continue;
+                const char* name = ((IMAGE_IMPORT_BY_NAME*)(base + names->u1.AddressOfData))->Name;
+                for (const HookEntry& entry : g_hooks) {
+                    if (strcmp(name, entry.name) != 0) continue;
+                    DWORD oldProtect = 0;
+                    if (!VirtualProtect(&slots->u1.Function, sizeof(slots->u1.Function), PAGE_READWRITE, &oldProtect)) break;
+                    *entry.original = (void*)slots->u1.Function;
+                    slots->u1.Function = (ULONG_PTR)entry.hook;
+                    VirtualProtect(&slots->u1.Function, sizeof(slots->u1.Function), oldProtect, &oldProtect);
+                    patched++;
+                    break;
+                }
+            }
+        }
+        return patched;
+    }
+
+    bool InstallHooks() {
+        HMODULE self = nullptr;
+        if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            (LPCWSTR)&InstallHooks, &self)) return false;
+        int patched = PatchImports(self);
+        Print("[RtCheck] Enabled (mode %d), %d imports hooked\n", DELTA_RT_CHECK, patched);
+        return true;
+    }
+
+    const bool g_installed = InstallHooks();
+}
+
+static void* AlignedAlloc(size_t size, size_t align) { return _aligned_malloc(size, align); }
+static void AlignedFree(void* p) { _aligned_free(p); }
+
+#else
+// ---------------------------------------------------------------------------
+// 전역 심볼 가로채기 (실행 파일에 정의해 libc 보다 먼저 연결, 프로세스 전체의 호출을 잡음)
+// 할당은 glibc 의 내부 진입점으로 넘김 (dlsym 이 calloc 을 불러도 재귀 없음)
+// ---------------------------------------------------------------------------
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* p, size_t size);
+    void __libc_free(void* p);
+    void* __libc_memalign(size_t align, size_t size);
+}
+
+namespace {
+    int (*s_orig_pthread_mutex_lock)(pthread_mutex_t*) = nullptr;
+
+    bool InstallHooks() {
+        s_orig_pthread_mutex_lock = (int (*)(pthread_mutex_t*))dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        // backtrace 첫 호출은 libgcc 를 읽어 들임 (구간 안에서 처음 부르지 않도록 미리)
+        void* warm[4];
+        backtrace(warm, 4);
+        Print("[RtCheck] Enabled (mode %d), malloc/calloc/realloc/free/pthread_mutex_lock interposed\n", DELTA_RT_CHECK);
+        return s_orig_pthread_mutex_lock != nullptr;
+    }
+
+    const bool g_installed = InstallHooks();
+}
+
+extern "C" {
+    void* malloc(size_t size) {
+        RtCheck::Check(RtCheck::Violation::Allocation, "malloc");
+        BusyGuard guard;
+        return __libc_malloc(size);
+    }
+    void* calloc(size_t count, size_t size) {
+        RtCheck::Check(RtCheck::Violation::Allocation, "calloc");
+        BusyGuard guard;
+        return __libc_calloc(count, size);
+    }
+    void* realloc(void* p, size_t size) {
+        RtCheck::Check(RtCheck::Violation::Allocation, "realloc");
+        BusyGuard guard;
+        return __libc_realloc(p, size);
+    }
+    void free(void* p) {
+        if (!p) return;
+        RtCheck::Check(RtCheck::Violation::Free, "free");
+        BusyGuard guard;
+        __libc_free(p);
+    }
+    int pthread_mutex_lock(pthread_mutex_t* mutex) {
+        RtCheck::Check(RtCheck::Violation::Lock, "pthread_mutex_lock");
+        BusyGuard guard;
+        // 정적 초기화 전에 잠금이 필요하면 여기서 찾음
+        if (!s_orig_pthread_mutex_lock) s_orig_pthread_mutex_lock = (int (*)(pthread_mutex_t*))dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        return s_orig_pthread_mutex_lock(mutex);
+    }
+}
+
+static void* AlignedAlloc(size_t size, size_t align) { return __libc_memalign(align, size); }
+static void AlignedFree(void* p) { __libc_free(p); }
+
+#endif
+
+// ---------------------------------------------------------------------------
+// operator new/delete (CRT 연결 방식과 무관하게 이 모듈의 할당을 잡음)
+// ---------------------------------------------------------------------------
+static void* CheckedAlloc(size_t size, bool nothrow) {
+    RtCheck::Check(RtCheck::Violation::Allocation, "operator new");
+    BusyGuard guard;
+    void* p = malloc(size ? size : 1);
+    if (!p && !nothrow) throw std::bad_alloc();
+    return p;
+}
+
+static void* CheckedAlignedAlloc(size_t size, std::align_val_t align, bool nothrow) {
+    RtCheck::Check(RtCheck::Violation::Allocation, "operator new");
+    BusyGuard guard;
+    void* p = AlignedAlloc(size ? size : 1, (size_t)align);
+    if (!p && !nothrow) throw std::bad_alloc();
+    return p;
+}
+
+static void CheckedFree(void* p) {
+    if (!p) return;
+    RtCheck::Check(RtCheck::Violation::Free, "operator delete");
+    BusyGuard guard;
+    free(p);
+}
+
+static void CheckedAlignedFree(void* p) {
+    if (!p) return;
+    RtCheck::Check(RtCheck::Violation::Free, "operator delete");
+    BusyGuard guard;
+    AlignedFree(p);
+}
+
+void* operator new(size_t size) { return CheckedAlloc(size, false); }
+void* operator new[](size_t size) { return CheckedAlloc(size, false); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CheckedAlloc(size, true); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CheckedAlloc(size, true); }
+void operator delete(void* p) noexcept { CheckedFree(p); }
+void operator delete[](void* p) noexcept { CheckedFree(p); }
+void operator delete(void* p, size_t) noexcept { CheckedFree(p); }
+void operator delete[](void* p, size_t) noexcept { CheckedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { CheckedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { CheckedFree(p); }
+
+void* operator new(size_t size, std::align_val_t align) { return CheckedAlignedAlloc(size, align, false); }
+void* operator new[](size_t size, std::align_val_t align) { return CheckedAlignedAlloc(size, align, false); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return CheckedAlignedAlloc(size, align, true); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return CheckedAlignedAlloc(size, align, true); }
+void operator delete(void* p, std::align_val_t) noexcept { CheckedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { CheckedAlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { CheckedAlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { CheckedAlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { CheckedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { CheckedAlignedFree(p); }
+
+#endif // DELTA_RT_CHECK
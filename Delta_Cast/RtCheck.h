@@ -0,0 +1,72 @@
+﻿#pragma once
+#include <stdint.h>
+
+// ---------------------------------------------------------------------------
+// 실시간 경로 검사 (검사 빌드 전용, 전처리기 정의 DELTA_RT_CHECK)
+//   DELTA_RT_CHECK=1 : 위반을 스택별로 기록하고 계속 (RT_CHECK_REPORT 로 출력)
+//   DELTA_RT_CHECK=2 : 첫 위반에서 중단 (__debugbreak)
+// RT_SCOPE 구간 안에서 다음을 위반으로 기록
+//   - 힙 할당/해제 (operator new/delete, 이 모듈의 malloc/Heap* 임포트)
+//   - 잠금 획득 (CRITICAL_SECTION, SRWLOCK, std::mutex)
+//   - 대기/슬립/파일 입출력
+// Windows: 가로채기는 이 모듈의 임포트 테이블만 고침 (호스트/다른 드라이버 코드는 검사하지 않음)
+// Linux: malloc/calloc/realloc/free, pthread_mutex_lock 을 실행 파일에서 재정의 (프로세스 전체, 대기/입출력은 없음)
+// 호스트 콜백처럼 우리 코드가 아닌 구간은 RT_EXTERNAL 로 제외
+// 정의하지 않으면 모든 매크로는 빈 문장 (RT_CHECK_REPORT 는 0)
+// ---------------------------------------------------------------------------
+
+#ifdef DELTA_RT_CHECK
+
+namespace RtCheck {
+    enum class Violation : int { Allocation, Free, Lock, Wait, Io };
+
+    // 실시간 구간 (중첩 가능, 반환값은 이전 구간 이름)
+    const char* Enter(const char* scope);
+    void Leave(const char* previous);
+    // 외부 코드 구간 (검사 일시 중지)
+    void Suspend();
+    void Resume();
+    // 현재 스레드가 검사 대상 구간인지
+    bool InScope();
+
+    // 위반 기록 (구간 밖이면 무시, 같은 스택은 한 항목에 누적)
+    void Check(Violation type, const char* what);
+
+    uint64_t GetViolationCount();
+    // 위반 목록과 심볼화한 스택 출력 (비실시간 경로). 반환: 누적 위반 횟수
+    uint64_t WriteReport();
+
+    class Scope {
+    public:
+        explicit Scope(const char* name) : m_previous(Enter(name)) {}
+        ~Scope() { Leave(m_previous); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        const char* m_previous;
+    };
+
+    class External {
+    public:
+        External() { Suspend(); }
+        ~External() { Resume(); }
+        External(const External&) = delete;
+        External& operator=(const External&) = delete;
+    };
+}
+
+#define RT_CHECK_CONCAT_(a, b) a##b
+#define RT_CHECK_CONCAT(a, b) RT_CHECK_CONCAT_(a, b)
+#define RT_SCOPE(name) RtCheck::Scope RT_CHECK_CONCAT(rtScope_, __LINE__)(name)
+#define RT_EXTERNAL() RtCheck::External RT_CHECK_CONCAT(rtExternal_, __LINE__)
+#define RT_VIOLATION(type, what) RtCheck::Check(RtCheck::Violation::type, what)
+#define RT_CHECK_REPORT() RtCheck::WriteReport()
+
+#else
+
+#define RT_SCOPE(name) ((void)0)
+#define RT_EXTERNAL() ((void)0)
+#define RT_VIOLATION(type, what) ((void)0)
+#define RT_CHECK_REPORT() ((uint64_t)0)
+
+#endif
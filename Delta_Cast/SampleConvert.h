@@ -0,0 +1,239 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <immintrin.h>
+#ifndef MY_ASIO
+#define MY_ASIO
+#include <iasiodrv.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// ASIO 샘플 포맷 -> float 변환 (렌더러, 레코더 공용)
+// ---------------------------------------------------------------------------
+const float INT32_TO_FLOAT = 4.65661287e-10f; // 1 / 2^31
+const float INT24_TO_FLOAT = 1.19209290e-7f;  // 1 / 2^23
+const float INT16_TO_FLOAT = 3.05175781e-5f;  // 1 / 2^15
+
+// 샘플 크기 (바이트)
+inline int GetAsioSampleSize(ASIOSampleType type) {
+    switch (type) {
+    case ASIOSTInt32LSB:   return 4;
+    case ASIOSTFloat32LSB: return 4;
+    case ASIOSTInt24LSB:   return 3;
+    case ASIOSTInt16LSB:   return 2;
+    case ASIOSTFloat64LSB: return 8;
+    default: return 0;
+    }
+}
+
+inline void ConvertSamplesToFloat(ASIOSampleType type, const void* input, float* output, size_t sampleCount) {
+    if (!input || !output) return;
+
+    switch (type) {
+    case ASIOSTInt32LSB: {
+        const int32_t* src = (const int32_t*)input;
+        size_t i = 0;
+
+        // 8개씩 병렬 처리
+        __m256 mulVal = _mm256_set1_ps(INT32_TO_FLOAT);
+        for (; i + 8 <= sampleCount; i += 8) {
+            __m256i vInt = _mm256_loadu_si256((const __m256i*) & src[i]);
+            __m256 vFloat = _mm256_cvtepi32_ps(vInt);
+            vFloat = _mm256_mul_ps(vFloat, mulVal);
+            _mm256_storeu_ps(&output[i], vFloat);
+        }
+        // 남은 처리
+        for (; i < sampleCount; ++i) {
+            output[i] = (float)src[i] * INT32_TO_FLOAT;
+        }
+        break;
+    }
+    case ASIOSTFloat32LSB: {
+        memcpy(output, input, sampleCount * sizeof(float));
+        break;
+    }
+    case ASIOSTInt24LSB: {
+        const uint8_t* src = (const uint8_t*)input;
+        for (size_t i = 0; i < sampleCount; ++i) {
+            int32_t s = (int32_t)((src[i * 3 + 2] << 24) | (src[i * 3 + 1] << 16) | (src[i * 3] << 8));
+            output[i] = (float)(s >> 8) * INT24_TO_FLOAT;
+        }
+        break;
+    }
+    case ASIOSTInt16LSB: {
+        const int16_t* src = (const int16_t*)input;
+        for (size_t i = 0; i < sampleCount; ++i) output[i] = (float)src[i] * INT16_TO_FLOAT;
+        break;
+    }
+    case ASIOSTFloat64LSB: {
+        const double* src = (const double*)input;
+        for (size_t i = 0; i < sampleCount; ++i) output[i] = (float)src[i];
+        break;
+    }
+    default: // 지원 안함 -> 침묵
+        memset(output, 0, sampleCount * sizeof(float));
+        break;
+    }
+}
+
+// 블록 절대값 최대 (float 스케일). 덕킹 키 검출용
+// 디지털 무음 검사 (부동소수점은 -0 도 무음). 32바이트씩 OR 누적
+inline bool IsBlockSilent(ASIOSampleType type, const void* input, size_t bytes) {
+    if (!input) return true;
+    const uint8_t* src = (const uint8_t*)input;
+    __m256i mask = _mm256_set1_epi8(-1);
+    if (type == ASIOSTFloat32LSB) mask = _mm256_set1_epi32(0x7FFFFFFF);
+    else if (type == ASIOSTFloat64LSB) mask = _mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL);
+
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        acc = _mm256_or_si256(acc, _mm256_and_si256(mask, _mm256_loadu_si256((const __m256i*)(src + i))));
+    }
+    if (!_mm256_testz_si256(acc, acc)) return false;
+    // 남은 바이트 (마스크는 샘플 단위로 반복되므로 같은 위치 바이트를 적용)
+    uint8_t maskBytes[32];
+    _mm256_storeu_si256((__m256i*)maskBytes, mask);
+    for (; i < bytes; i++) {
+        if (src[i] & maskBytes[i & 31]) return false;
+    }
+    return true;
+}
+
+inline float MeasureBlockPeak(ASIOSampleType type, const void* input, size_t sampleCount) {
+    if (!input) return 0.0f;
+
+    switch (type) {
+    case ASIOSTFloat32LSB: {
+        const float* src = (const float*)input;
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        __m256 vPeak = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= sampleCount; i += 8) {
+            vPeak = _mm256_max_ps(vPeak, _mm256_andnot_ps(signMask, _mm256_loadu_ps(&src[i])));
+        }
+        float lanes[8];
+        _mm256_storeu_ps(lanes, vPeak);
+        float peak = 0.0f;
+        for (float v : lanes) peak = (v > peak) ? v : peak;
+        for (; i < sampleCount; ++i) { float v = src[i] < 0 ? -src[i] : src[i]; peak = (v > peak) ? v : peak; }
+        return peak;
+    }
+    case ASIOSTInt32LSB: {
+        const int32_t* src = (const int32_t*)input;
+        __m256i vPeak = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 8 <= sampleCount; i += 8) {
+            vPeak = _mm256_max_epu32(vPeak, _mm256_abs_epi32(_mm256_loadu_si256((const __m256i*) & src[i])));
+        }
+        uint32_t lanes[8];
+        _mm256_storeu_si256((__m256i*)lanes, vPeak);
+        uint32_t peak = 0;
+        for (uint32_t v : lanes) peak = (v > peak) ? v : peak;
+        for (; i < sampleCount; ++i) { uint32_t v = (uint32_t)(src[i] < 0 ? -(int64_t)src[i] : src[i]); peak = (v > peak) ? v : peak; }
+        return (float)peak * INT32_TO_FLOAT;
+    }
+    case ASIOSTInt16LSB: {
+        const int16_t* src = (const int16_t*)input;
+        int peak = 0;
+        for (size_t i = 0; i < sampleCount; ++i) { int v = src[i] < 0 ? -src[i] : src[i]; peak = (v > peak) ? v : peak; }
+        return (float)peak * INT16_TO_FLOAT;
+    }
+    case ASIOSTInt24LSB: {
+        const uint8_t* src = (const uint8_t*)input;
+        int32_t peak = 0;
+        for (size_t i = 0; i < sampleCount; ++i) {
+            int32_t s = (int32_t)((src[i * 3 + 2] << 24) | (src[i * 3 + 1] << 16) | (src[i * 3] << 8)) >> 8;
+            s = s < 0 ? -s : s;
+            peak = (s > peak) ? s : peak;
+        }
+        return (float)peak * INT24_TO_FLOAT;
+    }
+    case ASIOSTFloat64LSB: {
+        const double* src = (const double*)input;
+        double peak = 0.0;
+        for (size_t i = 0; i < sampleCount; ++i) { double v = src[i] < 0 ? -src[i] : src[i]; peak = (v > peak) ? v : peak; }
+        return (float)peak;
+    }
+    default:
+        return 0.0f;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// float (L/R) -> 출력 장치 포맷 (인터리브, 렌더러/오프라인 렌더 공용)
+// [0, valid) 만 유효 (나머지는 무음), 모노 출력은 L, 3채널 이상은 앞 두 채널만
+// ---------------------------------------------------------------------------
+inline void ConvertFloatToOutput(const float* left, const float* right, size_t valid, void* output, uint32_t frames,
+    int channels, int bitDepth, bool isFloat)
+{
+    // 앞 두 채널만 채우므로 나머지는 무음
+    if (channels > 2) memset(output, 0, (size_t)frames * channels * (bitDepth / 8));
+
+    // [32-bit Float]
+    if (bitDepth == 32 && isFloat) {
+        float* pFloat = (float*)output;
+        for (uint32_t i = 0; i < frames; i++) {
+            float sampleL = (i < valid) ? left[i] : 0.0f;
+            float sampleR = (channels > 1 && i < valid) ? right[i] : sampleL;
+
+            pFloat[i * channels + 0] = sampleL;
+            if (channels > 1) pFloat[i * channels + 1] = sampleR;
+        }
+    }
+    // [32-bit Int]
+    else if (bitDepth == 32) {
+        int32_t* pInt32 = (int32_t*)output;
+        for (uint32_t i = 0; i < frames; i++) {
+            float sampleL = (i < valid) ? left[i] : 0.0f;
+            float sampleR = (channels > 1 && i < valid) ? right[i] : sampleL;
+
+            sampleL = std::clamp(sampleL, -1.0f, 1.0f);
+            sampleR = std::clamp(sampleR, -1.0f, 1.0f);
+
+            // Float -> Int32 
+            pInt32[i * channels + 0] = (int32_t)(sampleL * 2147483647.0f);
+            if (channels > 1) pInt32[i * channels + 1] = (int32_t)(sampleR * 2147483647.0f);
+        }
+    }
+    // [16-bit Int]
+    else if (bitDepth == 16) {
+        int16_t* pInt16 = (int16_t*)output;
+        for (uint32_t i = 0; i < frames; i++) {
+            float sampleL = (i < valid) ? left[i] : 0.0f;
+            float sampleR = (channels > 1 && i < valid) ? right[i] : sampleL;
+
+            sampleL = std::clamp(sampleL, -1.0f, 1.0f);
+            sampleR = std::clamp(sampleR, -1.0f, 1.0f);
+
+            pInt16[i * channels + 0] = (int16_t)(sampleL * 32767.0f);
+            if (channels > 1) pInt16[i * channels + 1] = (int16_t)(sampleR * 32767.0f);
+        }
+    }
+    // [24-bit Int]
+    else if (bitDepth == 24) {
+        uint8_t* pBytes = (uint8_t*)output;
+        for (uint32_t i = 0; i < frames; i++) {
+            float sampleL = (i < valid) ? left[i] : 0.0f;
+            float sampleR = (channels > 1 && i < valid) ? right[i] : sampleL;
+
+            sampleL = std::clamp(sampleL, -1.0f, 1.0f);
+            sampleR = std::clamp(sampleR, -1.0f, 1.0f);
+
+            int32_t valL = (int32_t)(sampleL * 8388607.0f);
+            int32_t valR = (int32_t)(sampleR * 8388607.0f);
+
+            size_t offset = (size_t)i * channels * 3;
+            pBytes[offset + 0] = (valL >> 0) & 0xFF;
+            pBytes[offset + 1] = (valL >> 8) & 0xFF;
+            pBytes[offset + 2] = (valL >> 16) & 0xFF;
+
+            if (channels > 1) {
+                pBytes[offset + 3] = (valR >> 0) & 0xFF;
+                pBytes[offset + 4] = (valR >> 8) & 0xFF;
+                pBytes[offset + 5] = (valR >> 16) & 0xFF;
+            }
+        }
+    }
+}
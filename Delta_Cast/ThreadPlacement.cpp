@@ -0,0 +1,359 @@
+﻿#include "ThreadPlacement.h"
+#include <mutex>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <avrt.h>
+#pragma comment(lib, "avrt.lib")
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+namespace ThreadPlacement {
+
+namespace {
+    std::mutex g_lock;
+    ThreadPlacementSettings g_settings;
+
+    inline uint64_t Bit(int cpu) { return (cpu >= 0 && cpu < MAX_CPUS) ? (1ull << cpu) : 0; }
+
+#ifdef _WIN32
+    void ReadTopology(CpuTopology& topology) {
+        // 현재 스레드 그룹의 논리 CPU 만 (SetThreadAffinityMask 도 그룹 기준)
+        GROUP_AFFINITY groupAffinity = {};
+        GetThreadGroupAffinity(GetCurrentThread(), &groupAffinity);
+        WORD group = groupAffinity.Group;
+
+        DWORD length = 0;
+        GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+        std::vector<uint8_t> buffer(length);
+        auto* first = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+        if (length == 0 || !GetLogicalProcessorInformationEx(RelationAll, first, &length)) return;
+
+        CpuInfo info[MAX_CPUS];
+        bool present[MAX_CPUS] = {};
+        bool hasL2[MAX_CPUS] = {};
+        int coreIndex = 0, l2Index = 0;
+        for (DWORD offset = 0; offset < length;) {
+            auto* entry = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+            if (entry->Relationship == RelationProcessorCore) {
+                for (WORD g = 0; g < entry->Processor.GroupCount; g++) {
+                    const GROUP_AFFINITY& mask = entry->Processor.GroupMask[g];
+                    if (mask.Group != group) continue;
+                    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+                        if (!(mask.Mask & ((KAFFINITY)1 << cpu))) continue;
+                        present[cpu] = true;
+                        info[cpu].cpu = cpu;
+                        info[cpu].core = coreIndex;
+                        info[cpu].efficiency = entry->Processor.EfficiencyClass;
+                    }
+                }
+                coreIndex++;
+            }
+            else if (entry->Relationship == RelationCache && entry->Cache.Level == 2 && entry->Cache.Type != CacheInstruction) {
+                const GROUP_AFFINITY& mask = entry->Cache.GroupMask;
+                if (mask.Group == group) {
+                    for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+                        if (!(mask.Mask & ((KAFFINITY)1 << cpu))) continue;
+                        info[cpu].l2 = l2Index;
+                        hasL2[cpu] = true;
+                    }
+                }
+                l2Index++;
+            }
+            offset += entry->Size;
+        }
+        for (int cpu = 0; cpu < MAX_CPUS; cpu++) {
+            if (!present[cpu]) continue;
+            if (!hasL2[cpu]) info[cpu].l2 = l2Index + info[cpu].core; // 정보 없으면 코어별
+            topology.cpus.push_back(info[cpu]);
+        }
+    }
+#else
+    bool ReadText(const std::string& path, std::string& text) {
+        FILE* file = std::fopen(path.c_str(), "r");
+        if (!file) return false;
+        char buf[256] = {};
+        size_t n = std::fread(buf, 1, sizeof(buf) - 1, file);
+        std::fclose(file);
+        text.assign(buf, n);
+        while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.pop_back();
+        return true;
+    }
+
+    int FirstOf(const std::string& path, int fallback) {
+        std::string text;
+        if (!ReadText(path, text)) return fallback;
+        std::vector<int> list = ParseCpuList(text);
+        return list.empty() ? fallback : *std::min_element(list.begin(), list.end());
+    }
+
+    void ReadTopology(CpuTopology& topology) {
+        const std::string base = "/sys/devices/system/cpu/";
+        std::string text;
+        std::vector<int> online;
+        if (ReadText(base + "online", text)) online = ParseCpuList(text);
+        if (online.empty()) {
+            for (int cpu = 0; cpu < (int)sysconf(_SC_NPROCESSORS_ONLN) && cpu < MAX_CPUS; cpu++) online.push_back(cpu);
+        }
+        // 인텔 하이브리드: cpu_core (P) / cpu_atom (E), 그 외는 cpu_capacity (ARM big.LITTLE)
+        std::vector<int> pCores, eCores;
+        if (ReadText("/sys/devices/cpu_core/cpus", text)) pCores = ParseCpuList(text);
+        if (ReadText("/sys/devices/cpu_atom/cpus", text)) eCores = ParseCpuList(text);
+
+        for (int cpu : online) {
+            if (cpu < 0 || cpu >= MAX_CPUS) continue;
+            std::string dir = base + "cpu" + std::to_string(cpu) + "/";
+            CpuInfo info;
+            info.cpu = cpu;
+            info.core = FirstOf(dir + "topology/thread_siblings_list", cpu);
+            info.l2 = MAX_CPUS + info.core;
+            for (int index = 0; index < 8; index++) {
+                std::string cache = dir + "cache/index" + std::to_string(index) + "/";
+                std::string level, type;
+                if (!ReadText(cache + "level", level)) break;
+                ReadText(cache + "type", type);
+                if (level == "2" && type != "Instruction") { info.l2 = FirstOf(cache + "shared_cpu_list", info.l2); break; }
+            }
+            if (!pCores.empty() || !eCores.empty()) {
+                info.efficiency = std::find(pCores.begin(), pCores.end(), cpu) != pCores.end() ? 1 : 0;
+            }
+            else if (ReadText(dir + "cpu_capacity", text)) {
+                info.efficiency = std::atoi(text.c_str());
+            }
+            topology.cpus.push_back(info);
+        }
+    }
+#endif
+}
+
+void Configure(const ThreadPlacementSettings& settings) {
+    std::lock_guard<std::mutex> lock(g_lock);
+    g_settings = settings;
+}
+
+ThreadPlacementSettings GetSettings() {
+    std::lock_guard<std::mutex> lock(g_lock);
+    return g_settings;
+}
+
+const CpuTopology& GetTopology() {
+    static const CpuTopology topology = []() {
+        CpuTopology t;
+        ReadTopology(t);
+        if (!t.cpus.empty()) {
+            auto [minIt, maxIt] = std::minmax_element(t.cpus.begin(), t.cpus.end(),
+                [](const CpuInfo& a, const CpuInfo& b) { return a.efficiency < b.efficiency; });
+            t.minEfficiency = minIt->efficiency;
+            t.maxEfficiency = maxIt->efficiency;
+            t.hybrid = (t.minEfficiency != t.maxEfficiency);
+        }
+        return t;
+    }();
+    return topology;
+}
+
+uint64_t ResolveMask(const CpuTopology& topology, const ThreadPolicy& policy,
+    const std::vector<int>& avoid, AvoidScope scope) {
+    uint64_t all = 0;
+    for (const CpuInfo& info : topology.cpus) all |= Bit(info.cpu);
+    if (all == 0) return 0;
+
+    // 후보: 고정 목록, 없으면 코어 종류
+    uint64_t candidate = 0;
+    for (int cpu : policy.pin) candidate |= Bit(cpu);
+    candidate &= all;
+    if (candidate == 0) {
+        for (const CpuInfo& info : topology.cpus) {
+            bool take = (policy.cores == CoreClass::Any || !topology.hybrid) ||
+                (policy.cores == CoreClass::Performance && info.efficiency == topology.maxEfficiency) ||
+                (policy.cores == CoreClass::Efficiency && info.efficiency == topology.minEfficiency);
+            if (take) candidate |= Bit(info.cpu);
+        }
+    }
+
+    // 회피: 지정 CPU 와 같은 코어 / 같은 L2 까지 넓힘
+    uint64_t avoidMask = 0;
+    for (int cpu : avoid) {
+        auto it = std::find_if(topology.cpus.begin(), topology.cpus.end(), [cpu](const CpuInfo& info) { return info.cpu == cpu; });
+        if (it == topology.cpus.end()) continue;
+        for (const CpuInfo& info : topology.cpus) {
+            if (info.cpu == cpu || (scope == AvoidScope::Smt && info.core == it->core) ||
+                (scope == AvoidScope::L2 && (info.l2 == it->l2 || info.core == it->core))) avoidMask |= Bit(info.cpu);
+        }
+    }
+    uint64_t result = candidate & ~avoidMask;
+    if (result == 0) result = candidate;
+    return (result == all) ? 0 : result;
+}
+
+std::vector<int> ParseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    const char* p = text.c_str();
+    while (*p) {
+        char* end = nullptr;
+        long first = std::strtol(p, &end, 10);
+        if (end == p) { p++; continue; }
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = std::strtol(p + 1, &end, 10);
+            if (end == p + 1) last = first;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last && cpu < MAX_CPUS; cpu++) {
+            if (cpu >= 0) cpus.push_back((int)cpu);
+        }
+    }
+    return cpus;
+}
+
+std::string FormatMask(uint64_t mask) {
+    if (mask == 0) return "all";
+    std::string text;
+    for (int cpu = 0; cpu < MAX_CPUS;) {
+        if (!(mask & Bit(cpu))) { cpu++; continue; }
+        int last = cpu;
+        while (last + 1 < MAX_CPUS && (mask & Bit(last + 1))) last++;
+        if (!text.empty()) text += ',';
+        text += std::to_string(cpu);
+        if (last > cpu) text += '-' + std::to_string(last);
+        cpu = last + 1;
+    }
+    return text;
+}
+
+const char* PriorityName(ThreadPriorityClass priority) {
+    switch (priority) {
+    case ThreadPriorityClass::Background: return "Background";
+    case ThreadPriorityClass::Low: return "Low";
+    case ThreadPriorityClass::High: return "High";
+    case ThreadPriorityClass::Realtime: return "Realtime";
+    default: return "Normal";
+    }
+}
+
+const char* CoreClassName(CoreClass cores) {
+    switch (cores) {
+    case CoreClass::Performance: return "Performance";
+    case CoreClass::Efficiency: return "Efficiency";
+    default: return "Any";
+    }
+}
+
+Scope::Scope(ThreadRole role) {
+    ThreadPlacementSettings settings = GetSettings();
+    const ThreadPolicy& policy = settings.policy[(int)role];
+    std::vector<int> avoid = settings.avoid;
+    avoid.insert(avoid.end(), policy.avoid.begin(), policy.avoid.end());
+    m_priority = policy.priority;
+    m_result.mask = ResolveMask(GetTopology(), policy, avoid, settings.avoidScope);
+
+#ifdef _WIN32
+    // 이전 배치/우선순위 보관 (스레드 풀 스레드 등에서 소멸 시 되돌림)
+    m_savedPriority = GetThreadPriority(GetCurrentThread());
+    if (m_result.mask) {
+        m_savedMask = (uint64_t)SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)m_result.mask);
+        m_result.affinityOk = m_savedMask != 0;
+    }
+    switch (m_priority) {
+    case ThreadPriorityClass::Realtime: {
+        DWORD taskIndex = 0;
+        m_task = AvSetMmThreadCharacteristics(L"Pro Audio", &taskIndex);
+        if (m_task == NULL) {
+            // 실패 시 높은 우선순위
+            SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+            m_result.priorityOk = false;
+        }
+        break;
+    }
+    case ThreadPriorityClass::High:
+        m_result.priorityOk = SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST) != 0;
+        break;
+    case ThreadPriorityClass::Low:
+        m_result.priorityOk = SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL) != 0;
+        break;
+    case ThreadPriorityClass::Background:
+        // 저우선순위 + 백그라운드 I/O 우선순위
+        m_background = SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN) != 0;
+        m_result.priorityOk = m_background;
+        break;
+    default:
+        break;
+    }
+#else
+    if (m_result.mask) {
+        // 이전 배치 보관 (MAX_CPUS 밖 CPU 가 있으면 비트로 담을 수 없으므로 복원하지 않음)
+        cpu_set_t saved;
+        CPU_ZERO(&saved);
+        if (sched_getaffinity(0, sizeof(saved), &saved) == 0) {
+            uint64_t mask = 0;
+            for (int cpu = 0; cpu < MAX_CPUS; cpu++) if (CPU_ISSET(cpu, &saved)) mask |= Bit(cpu);
+            if (CPU_COUNT(&saved) == __builtin_popcountll(mask)) m_savedMask = mask;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < MAX_CPUS; cpu++) if (m_result.mask & Bit(cpu)) CPU_SET(cpu, &set);
+        m_result.affinityOk = sched_setaffinity(0, sizeof(set), &set) == 0; // 0: 호출 스레드
+        if (!m_result.affinityOk) m_savedMask = 0;
+    }
+    sched_param saved = {};
+    pthread_getschedparam(pthread_self(), &m_savedPolicy, &saved);
+    m_savedParam = saved.sched_priority;
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+    m_savedNice = getpriority(PRIO_PROCESS, (id_t)tid);
+    sched_param param = {};
+    switch (m_priority) {
+    case ThreadPriorityClass::Realtime:
+    case ThreadPriorityClass::High:
+        // 권한 없으면 (RLIMIT_RTPRIO / CAP_SYS_NICE) 변경 없음
+        param.sched_priority = (m_priority == ThreadPriorityClass::Realtime) ? 80 : 40;
+        m_result.priorityOk = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+        break;
+    case ThreadPriorityClass::Low:
+        m_result.priorityOk = setpriority(PRIO_PROCESS, (id_t)tid, 5) == 0;
+        break;
+    case ThreadPriorityClass::Background:
+        m_result.priorityOk = pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) == 0;
+        break;
+    default:
+        break;
+    }
+#endif
+}
+
+Scope::~Scope() {
+#ifdef _WIN32
+    if (m_task) AvRevertMmThreadCharacteristics(m_task);
+    if (m_background) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    // MMCSS 실패 시 TIME_CRITICAL 등 직접 바꾼 우선순위도 되돌림
+    if (m_priority != ThreadPriorityClass::Normal && m_savedPriority != THREAD_PRIORITY_ERROR_RETURN) {
+        SetThreadPriority(GetCurrentThread(), m_savedPriority);
+    }
+    if (m_savedMask) SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)m_savedMask);
+#else
+    if (m_savedMask) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < MAX_CPUS; cpu++) if (m_savedMask & Bit(cpu)) CPU_SET(cpu, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+    if (m_priority == ThreadPriorityClass::Normal) return;
+    sched_param saved = {};
+    saved.sched_priority = m_savedParam;
+    pthread_setschedparam(pthread_self(), m_savedPolicy, &saved);
+    setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), m_savedNice);
+#endif
+}
+
+}
@@ -0,0 +1,116 @@
+﻿#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// 스레드 역할 (INI [Threads] 키 접두사: Clock, Render, Worker, Background)
+enum class ThreadRole : int {
+    Clock,          // 가상 클럭 (가상 모드 ASIO 콜백 스레드, 믹스 서버 클럭)
+    Render,         // 렌더 엔진 (주 출력, 추가 출력)
+    Worker,         // 실시간 탭을 따라가야 하는 작업 (리플레이 압축)
+    Background,     // 녹음 기록, 미터, 내보내기
+    Count
+};
+
+// 우선순위 등급
+// Realtime: MMCSS "Pro Audio" (실패 시 TIME_CRITICAL) / Linux SCHED_FIFO 80
+// High: THREAD_PRIORITY_HIGHEST / SCHED_FIFO 40
+// Low: THREAD_PRIORITY_BELOW_NORMAL / nice 5
+// Background: THREAD_MODE_BACKGROUND (CPU/IO/메모리 우선순위 낮춤) / SCHED_IDLE
+enum class ThreadPriorityClass : int { Background, Low, Normal, High, Realtime };
+
+// 코어 종류 (하이브리드 CPU 가 아니면 모두 같음)
+enum class CoreClass : int { Any, Performance, Efficiency };
+
+// 회피 목록 확장 범위: 지정 CPU 만 / 같은 물리 코어(SMT 형제) / 같은 L2 를 쓰는 CPU
+enum class AvoidScope : int { Cpu, Smt, L2 };
+
+struct ThreadPolicy {
+    ThreadPriorityClass priority = ThreadPriorityClass::Normal;
+    CoreClass cores = CoreClass::Any;
+    std::vector<int> pin;       // 논리 CPU 번호 (있으면 코어 종류보다 우선)
+    std::vector<int> avoid;     // 이 역할만 피할 CPU
+};
+
+struct ThreadPlacementSettings {
+    ThreadPolicy policy[(int)ThreadRole::Count];
+    std::vector<int> avoid;     // 모든 역할이 피할 CPU (예: 게임 렌더 스레드가 고정된 코어)
+    AvoidScope avoidScope = AvoidScope::Smt;
+
+    // 기본값: 실시간 스레드는 P 코어 + Realtime, 백그라운드는 E 코어
+    ThreadPlacementSettings() {
+        policy[(int)ThreadRole::Clock] = { ThreadPriorityClass::Realtime, CoreClass::Performance, {}, {} };
+        policy[(int)ThreadRole::Render] = { ThreadPriorityClass::Realtime, CoreClass::Performance, {}, {} };
+        policy[(int)ThreadRole::Worker] = { ThreadPriorityClass::Low, CoreClass::Any, {}, {} };
+        policy[(int)ThreadRole::Background] = { ThreadPriorityClass::Background, CoreClass::Efficiency, {}, {} };
+    }
+};
+
+// 논리 CPU 하나 (번호는 프로세스 그룹 안, 최대 64)
+struct CpuInfo {
+    int cpu = 0;
+    int core = 0;           // 물리 코어 (SMT 형제는 같은 값)
+    int l2 = 0;             // L2 공유 그룹 (E 코어 클러스터는 같은 값)
+    int efficiency = 0;     // 클수록 성능 코어 (Windows EfficiencyClass, Linux cpu_core/capacity)
+};
+
+struct CpuTopology {
+    std::vector<CpuInfo> cpus;
+    bool hybrid = false;    // 효율 등급이 둘 이상
+    int maxEfficiency = 0;
+    int minEfficiency = 0;
+};
+
+// 배치 적용 결과 (로그용)
+struct PlacementResult {
+    uint64_t mask = 0;          // 적용한 선호 CPU (0: 변경 안 함)
+    bool affinityOk = true;
+    bool priorityOk = true;     // 실패 시 대체 우선순위 사용 또는 변경 없음
+};
+
+// ---------------------------------------------------------------------------
+// 스레드 배치 정책
+// 프로세스 공용 설정 (드라이버 LoadConfiguration 에서), 각 스레드가 시작할 때 자기 자신에게 적용
+// 토폴로지는 처음 필요할 때 한 번 읽음
+// ---------------------------------------------------------------------------
+namespace ThreadPlacement {
+    const int MAX_CPUS = 64;
+
+    void Configure(const ThreadPlacementSettings& settings);
+    ThreadPlacementSettings GetSettings();
+    const CpuTopology& GetTopology();
+
+    // 정책 -> CPU 마스크 (0: 제한 없음). 회피 후 남는 CPU 가 없으면 회피 전 후보, 그래도 없으면 0
+    uint64_t ResolveMask(const CpuTopology& topology, const ThreadPolicy& policy,
+        const std::vector<int>& avoid, AvoidScope scope);
+
+    // "0-3,8,10-11" 형식
+    std::vector<int> ParseCpuList(const std::string& text);
+    std::string FormatMask(uint64_t mask);
+
+    const char* PriorityName(ThreadPriorityClass priority);
+    const char* CoreClassName(CoreClass cores);
+
+    // 현재 스레드에 역할 정책 적용, 소멸 시 우선순위 / 코어 배치 복원 (스레드 함수 맨 앞에 둠)
+    class Scope {
+    public:
+        explicit Scope(ThreadRole role);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        const PlacementResult& GetResult() const { return m_result; }
+        ThreadPriorityClass GetPriority() const { return m_priority; }
+
+    private:
+        ThreadPriorityClass m_priority = ThreadPriorityClass::Normal;
+        PlacementResult m_result;
+        void* m_task = nullptr;     // MMCSS 핸들
+        bool m_background = false;
+        uint64_t m_savedMask = 0;   // 복원할 코어 배치 (0: 바꾸지 않음)
+        int m_savedPriority = 0;    // Windows: 복원할 스레드 우선순위
+        int m_savedPolicy = 0;      // Linux: 복원할 스케줄링 정책 / 우선순위 / nice
+        int m_savedParam = 0;
+        int m_savedNice = 0;
+    };
+}
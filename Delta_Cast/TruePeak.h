@@ -0,0 +1,84 @@
+﻿#pragma once
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <immintrin.h>
+
+// ---------------------------------------------------------------------------
+// 트루피크 검출 (채널당 1개, 8배 오버샘플 폴리페이즈 24탭)
+// 출력 i 는 입력 i - DETECT_DELAY 샘플과 그 다음 샘플 사이의 최대 절대값
+// 4배 8탭은 고역이 많은 신호 (0.4 fs 이상 잡음) 에서 16배 측정 대비 1 dB 이상 낮게 읽었음
+// ---------------------------------------------------------------------------
+class TruePeakDetector {
+public:
+    static const int OVERSAMPLE = 8;
+    static const int TAPS = 24;               // 페이즈당 탭 수
+    static const int DETECT_DELAY = TAPS / 2; // 보간 중심까지 지연
+    // 페이즈 사이 (1/OVERSAMPLE 샘플) 에 놓인 피크를 놓치는 최대 비율
+    // 나이퀴스트 대역 제한 신호의 곡률 한계 1 - pi^2 / (8 * OVERSAMPLE^2) (8배: -0.17 dB)
+    static constexpr double PHASE_GAP_RATIO = 1.0 - 9.8696044010893586 / (8.0 * OVERSAMPLE * OVERSAMPLE);
+
+    // 비실시간 스레드에서 호출 (메모리 할당)
+    void Setup(size_t maxBlock) {
+        // 보간 페이즈 계수 (Hann 창 sinc, 페이즈별 DC 이득 1)
+        const double PI = 3.14159265358979323846;
+        for (int p = 1; p < OVERSAMPLE; p++) {
+            double t = (double)p / OVERSAMPLE;
+            double sum = 0.0;
+            double taps[TAPS];
+            for (int k = 0; k < TAPS; k++) {
+                double x = t - (k - (DETECT_DELAY - 1));
+                double sinc = (std::abs(x) < 1e-9) ? 1.0 : std::sin(PI * x) / (PI * x);
+                taps[k] = sinc * 0.5 * (1.0 + std::cos(PI * x / (DETECT_DELAY + 0.5)));
+                sum += taps[k];
+            }
+            for (int k = 0; k < TAPS; k++) m_coeffs[p - 1][k] = (float)(taps[k] / sum);
+        }
+        m_maxBlock = maxBlock;
+        m_work.assign(maxBlock + TAPS, 0.0f);
+    }
+
+    void Reset() { std::fill(m_work.begin(), m_work.end(), 0.0f); }
+
+    // n <= maxBlock. accumulate 이면 peakOut 과 최대값 비교
+    void Process(const float* input, size_t n, float* peakOut, bool accumulate) {
+        float* w = m_work.data();
+        memcpy(w + TAPS - 1, input, n * sizeof(float));
+
+        // w[i .. i+TAPS-1] 가 입력 i 를 최신으로 하는 창. 중심 샘플은 w[i + DETECT_DELAY - 1]
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 peak = _mm256_andnot_ps(signMask, _mm256_loadu_ps(w + i + DETECT_DELAY - 1));
+            for (int p = 0; p < OVERSAMPLE - 1; p++) {
+                __m256 acc = _mm256_setzero_ps();
+                for (int k = 0; k < TAPS; k++) {
+                    acc = _mm256_fmadd_ps(_mm256_set1_ps(m_coeffs[p][k]), _mm256_loadu_ps(w + i + k), acc);
+                }
+                peak = _mm256_max_ps(peak, _mm256_andnot_ps(signMask, acc));
+            }
+            if (accumulate) peak = _mm256_max_ps(peak, _mm256_loadu_ps(peakOut + i));
+            _mm256_storeu_ps(peakOut + i, peak);
+        }
+        for (; i < n; i++) {
+            float peak = std::abs(w[i + DETECT_DELAY - 1]);
+            for (int p = 0; p < OVERSAMPLE - 1; p++) {
+                float acc = 0.0f;
+                for (int k = 0; k < TAPS; k++) acc += m_coeffs[p][k] * w[i + k];
+                peak = std::max(peak, std::abs(acc));
+            }
+            peakOut[i] = accumulate ? std::max(peak, peakOut[i]) : peak;
+        }
+
+        // 다음 블록을 위한 히스토리
+        memmove(w, w + n, (TAPS - 1) * sizeof(float));
+    }
+
+    size_t GetMaxBlock() const { return m_maxBlock; }
+
+private:
+    float m_coeffs[OVERSAMPLE - 1][TAPS] = {};
+    std::vector<float> m_work; // 히스토리 + 블록
+    size_t m_maxBlock = 0;
+};
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// 가상 장치 채널 버퍼 (VirtualBackend 가 호스트 블록마다 하는 일)
+// - 채널 반쪽마다 캐시 라인 정렬 (채널끼리 라인을 공유하지 않음)
+// - 루프백 입력 <- 직전 블록 출력, 클리어는 읽히는 출력만 (채널 수와 무관)
+// ---------------------------------------------------------------------------
+namespace VirtualChannels {
+    // 채널 버퍼 간격 (float 단위)
+    inline size_t ChannelStride(long bufferSize) {
+        const size_t lineFloats = 64 / sizeof(float);
+        return ((size_t)bufferSize + lineFloats - 1) & ~(lineFloats - 1);
+    }
+
+    // 루프백 입력 -> 원본 출력 (버퍼 생성 시 계산, 블록마다 채널 목록을 훑지 않음)
+    struct LoopbackCopy {
+        float* input[2];
+        float* output[2];
+    };
+
+    // 호스트 콜백 직전. index: 이번 블록 반쪽, castL/castR: 송출 채널의 이번 반쪽 (없으면 nullptr)
+    inline void PrepareBlock(const std::vector<LoopbackCopy>& loopbacks, long index, size_t bytes, void* castL, void* castR) {
+        for (const LoopbackCopy& copy : loopbacks) {
+            memcpy(copy.input[index], copy.output[1 - index], bytes);
+            memset(copy.output[index], 0, bytes);
+        }
+        // 다른 출력은 읽는 곳이 없으므로 클리어하지 않음
+        if (castL) memset(castL, 0, bytes);
+        if (castR && castR != castL) memset(castR, 0, bytes);
+    }
+}
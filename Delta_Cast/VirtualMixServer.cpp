@@ -0,0 +1,233 @@
+﻿#include "VirtualMixServer.h"
+#include "DeltaCastDriver.h"
+#include "SampleConvert.h"
+#include "RtCheck.h"
+#include "Logger.h"
+#include "timer.h"
+#include "ThreadPlacement.h"
+#include <algorithm>
+#include <immintrin.h>
+
+// 클라이언트 큐가 부족할 때 한 번의 믹스에서 당겨올 최대 호스트 블록 수
+static const int MAX_PULL_BLOCKS = 16;
+
+// acc += src (8개씩 병렬)
+static void MixAdd(float* acc, const float* src, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_loadu_ps(&acc[i]);
+        __m256 b = _mm256_loadu_ps(&src[i]);
+        _mm256_storeu_ps(&acc[i], _mm256_add_ps(a, b));
+    }
+    for (; i < count; ++i) acc[i] += src[i];
+}
+
+CVirtualMixServer& CVirtualMixServer::Instance() {
+    static CVirtualMixServer server;
+    return server;
+}
+
+CVirtualMixServer::CVirtualMixServer()
+    : m_mixL(Config::RING_BUFFER_SIZE), m_mixR(Config::RING_BUFFER_SIZE) {
+}
+
+bool CVirtualMixServer::Register(VirtualBackend* client) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_numClients > 0 && client->m_sampleRate != m_sampleRate) {
+        DebugLog("[MixServer] Rate Mismatch: %.1f (Server %.1f)\n", client->m_sampleRate, m_sampleRate);
+        return false;
+    }
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (m_slots[i].client.load() == nullptr) {
+            if (m_numClients == 0) Start(client);
+            client->m_owner->m_gain.Prepare(m_sampleRate);
+            m_slots[i].client.store(client);
+            m_numClients++;
+            DebugLog("[MixServer] Client %d Registered (%d active)\n", i, m_numClients);
+            return true;
+        }
+    }
+    return false;
+}
+
+void CVirtualMixServer::Unregister(VirtualBackend* client) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (m_slots[i].client.load() == client) {
+            m_slots[i].client.store(nullptr);
+            // 믹스 스레드가 이 클라이언트를 다 쓸 때까지 대기
+            while (m_slots[i].busy.load()) std::this_thread::yield();
+            m_numClients--;
+            DebugLog("[MixServer] Client %d Unregistered (%d active)\n", i, m_numClients);
+            if (m_numClients == 0) Stop();
+            return;
+        }
+    }
+}
+
+bool CVirtualMixServer::IsRateLocked(double sampleRate) const {
+    // Start/Stop 은 등록/해제 잠금 안에서만 일어남
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_running && sampleRate != m_sampleRate;
+}
+
+MixServerStats CVirtualMixServer::GetStats() const {
+    MixServerStats stats;
+    stats.clients = (uint32_t)m_numClients;
+    stats.blocksMixed = m_blocksMixed.load();
+    stats.clientUnderruns = m_clientUnderruns.load();
+    return stats;
+}
+
+void CVirtualMixServer::Start(VirtualBackend* first) {
+    CDeltaCastDriver* owner = first->m_owner;
+    m_sampleRate = first->m_sampleRate;
+    m_blockFrames = std::max(first->m_bufferSize, 32L);
+    m_sinkClocked = owner->m_sinkClocked;
+    m_pacingTarget = owner->m_pacingTarget;
+    // 믹스 링은 float32 (클라이언트 샘플 포맷과 무관하게 시간 목표로 환산)
+    m_latencyThreshold = owner->GetLatencyFrames() * sizeof(float);
+
+    size_t frames = (size_t)m_blockFrames;
+    m_rawL.assign(frames * 8, 0); m_rawR.assign(frames * 8, 0);
+    m_tempL.assign(frames, 0.0f); m_tempR.assign(frames, 0.0f);
+    m_accumL.assign(frames, 0.0f); m_accumR.assign(frames, 0.0f);
+    m_blocksMixed = 0;
+    m_clientUnderruns = 0;
+
+    // 믹스 결과 공유 메모리 송출 (첫 클라이언트 설정 기준)
+    if (owner->m_ipcEnabled) {
+        if (m_ipcWriter.Create(2, (int32_t)ASIOSTFloat32LSB, sizeof(float), m_sampleRate, owner->m_ipcRingBytes)) {
+            DebugLog("[DeltaCast] Mix IPC: Slot %d\n", m_ipcWriter.GetSlot());
+        }
+    }
+
+    m_running = true;
+    m_renderer.SetLimiter(owner->m_limiterSettings);
+    m_renderer.SetAutoLatency(owner->m_autoLatency);
+    m_renderer.SetConcealment(owner->m_concealment);
+    m_renderer.SetSink(owner->CreateOutputSink());
+    m_renderer.SetArenaOptions(owner->m_arenaOptions);
+    m_renderer.Start(&m_mixL, &m_mixR, owner->m_targetWasapiId, ASIOSTFloat32LSB, m_sampleRate,
+        m_sinkClocked ? 0 : m_latencyThreshold);
+    if (m_sinkClocked) {
+        m_renderer.SetPeriodListener(this);
+    }
+    else {
+        m_thread = std::thread(&CVirtualMixServer::ClockLoop, this);
+    }
+    DebugLog("[MixServer] Started. %.1f Hz, Block %ld, %s Clock\n", m_sampleRate, m_blockFrames, m_sinkClocked ? "Sink" : "Timer");
+}
+
+void CVirtualMixServer::Stop() {
+    m_running = false;
+    m_renderer.SetPeriodListener(nullptr);
+    if (m_thread.joinable()) m_thread.join();
+    m_renderer.Stop();
+    m_renderer.Close();
+    m_ipcWriter.Close();
+    DebugLog("[MixServer] Stopped. Blocks: %llu, Client Underruns: %llu, Output Glitches: %llu\n",
+        m_blocksMixed.load(), m_clientUnderruns.load(), m_renderer.GetGlitchCount());
+    // 실시간 경로 위반 보고 (DELTA_RT_CHECK 빌드). 누적 횟수는 모듈 전체라 드라이버 disposeBuffers 가 실패로 돌려줌
+    uint64_t rtViolations = RT_CHECK_REPORT();
+    if (rtViolations > 0) DebugLog("[MixServer] Error: %llu Real-Time Violations\n", (unsigned long long)rtViolations);
+}
+
+void CVirtualMixServer::MixOneBlock() {
+    RT_SCOPE("MixOneBlock");
+    size_t frames = (size_t)m_blockFrames;
+    std::fill(m_accumL.begin(), m_accumL.end(), 0.0f);
+    std::fill(m_accumR.begin(), m_accumR.end(), 0.0f);
+
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        Slot& slot = m_slots[i];
+        slot.busy.store(true);
+        VirtualBackend* client = slot.client.load();
+        if (client) {
+            CDeltaCastDriver* owner = client->m_owner;
+            ASIOSampleType type = owner->m_sampleType;
+            size_t bytes = frames * GetAsioSampleSize(type);
+
+            // 큐가 모자라면 해당 호스트를 당겨 돌림 (블록 크기가 달라도 됨)
+            for (int pull = 0; pull < MAX_PULL_BLOCKS && owner->m_loopbackBufferL.GetFillSize() < bytes; pull++) {
+                client->RenderOneBlock();
+            }
+
+            if (bytes > 0 && owner->m_loopbackBufferL.GetFillSize() >= bytes && owner->m_loopbackBufferR.GetFillSize() >= bytes) {
+                owner->m_loopbackBufferL.Pop(m_rawL.data(), bytes);
+                owner->m_loopbackBufferR.Pop(m_rawR.data(), bytes);
+                ConvertSamplesToFloat(type, m_rawL.data(), m_tempL.data(), frames);
+                ConvertSamplesToFloat(type, m_rawR.data(), m_tempR.data(), frames);
+                // 클라이언트(소스)별 게인/뮤트
+                owner->m_gain.Process(m_tempL.data(), m_tempR.data(), frames);
+                MixAdd(m_accumL.data(), m_tempL.data(), frames);
+                MixAdd(m_accumR.data(), m_tempR.data(), frames);
+            }
+            else {
+                m_clientUnderruns.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        slot.busy.store(false);
+    }
+
+    size_t mixBytes = frames * sizeof(float);
+    m_renderer.RecordProducerBlock((uint32_t)frames);
+    if (m_mixL.GetAvailableWrite() >= mixBytes) {
+        // 무음 블록 표시 (렌더 측 빠른 경로)
+        if (!IsBlockSilent(ASIOSTFloat32LSB, m_accumL.data(), mixBytes) || !IsBlockSilent(ASIOSTFloat32LSB, m_accumR.data(), mixBytes)) {
+            m_mixL.MarkAudible(mixBytes);
+        }
+        m_mixL.Push(m_accumL.data(), mixBytes);
+        m_mixR.Push(m_accumR.data(), mixBytes);
+    }
+    if (m_ipcWriter.IsOpen()) {
+        const void* channels[2] = { m_accumL.data(), m_accumR.data() };
+        m_ipcWriter.Write(channels, mixBytes);
+    }
+    m_blocksMixed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CVirtualMixServer::OnRenderPeriod(size_t bytesNeeded) {
+    if (!m_running) return;
+    for (int i = 0; i < MAX_PULL_BLOCKS; i++) {
+        if (m_mixL.GetFillSize() >= bytesNeeded) break;
+        MixOneBlock();
+    }
+}
+
+void CVirtualMixServer::ClockLoop() {
+    ThreadPlacement::Scope placement(ThreadRole::Clock);
+    DebugLog("[MixServer] Thread Placement: %s, CPUs %s%s\n", ThreadPlacement::PriorityName(placement.GetPriority()),
+        ThreadPlacement::FormatMask(placement.GetResult().mask).c_str(), placement.GetResult().priorityOk ? "" : " (Priority Fallback)");
+    TimerResolutionSetter timerRes;
+
+    // VirtualBackend::VirtualClockLoop 과 같은 페이싱 (믹스 링은 float32)
+    double idealSeconds = (double)m_blockFrames / m_sampleRate;
+    double bytesPerSecond = sizeof(float) * m_sampleRate;
+    double target = std::clamp(m_pacingTarget, Config::BUFFER_TARGET_LOW, Config::BUFFER_TARGET_HIGH);
+    size_t threshold = 0;
+    auto setupPacer = [&]() {
+        // 자동 레이턴시는 렌더러가 고른 임계값을 따름
+        threshold = m_renderer.IsAutoLatency() ? m_renderer.GetThreshold() : m_latencyThreshold;
+        if (threshold == 0) threshold = m_latencyThreshold;
+        size_t window = std::min(threshold * 2, Config::RING_BUFFER_SIZE);
+        double windowSeconds = window / bytesPerSecond;
+        m_pacer.Setup(idealSeconds, windowSeconds * target,
+            windowSeconds * Config::BUFFER_TARGET_LOW, windowSeconds * Config::BUFFER_TARGET_HIGH);
+    };
+    setupPacer();
+
+    auto wakeUpTime = std::chrono::steady_clock::now();
+    while (m_running) {
+        if (m_renderer.IsAutoLatency() && m_renderer.GetThreshold() != threshold && m_renderer.GetThreshold() > 0) setupPacer();
+        double scale = m_pacer.Update(m_mixR.GetFillSize() / bytesPerSecond);
+        wakeUpTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>(idealSeconds * scale));
+        if (wakeUpTime < std::chrono::steady_clock::now()) {
+            wakeUpTime = std::chrono::steady_clock::now();
+        }
+        PrecisionClock::WaitUntil(wakeUpTime);
+
+        MixOneBlock();
+    }
+}
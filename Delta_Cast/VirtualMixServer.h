@@ -0,0 +1,88 @@
+﻿#pragma once
+#include <windows.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "RingBuffer.h"
+#include "PacingController.h"
+#include "RenderEngine.h"
+#include "DeltaCastIpc.h"
+
+class VirtualBackend;
+
+struct MixServerStats {
+    uint32_t clients = 0;
+    uint64_t blocksMixed = 0;
+    uint64_t clientUnderruns = 0; // 호스트가 제때 블록을 내지 못한 횟수
+};
+
+// ---------------------------------------------------------------------------
+// 가상 모드 믹스 서버 (프로세스당 1개)
+// 여러 드라이버 인스턴스가 각자 링버퍼(클라이언트 큐)에 블록을 제출하면
+// 하나의 클럭 스레드가 필요한 만큼 각 호스트를 당겨 돌린 뒤 float 로 합산해
+// 단일 WASAPI 스트림과 공유 메모리로 송출
+// 서버 포맷(레이트, 블록 크기, 출력 장치)은 첫 클라이언트 기준
+// ---------------------------------------------------------------------------
+class CVirtualMixServer : public IRenderPeriodListener {
+public:
+    static const int MAX_CLIENTS = 8;
+
+    static CVirtualMixServer& Instance();
+
+    // 클라이언트 등록/해제 (제어 스레드). 첫 등록 시 시작, 마지막 해제 시 정지
+    bool Register(VirtualBackend* client);
+    void Unregister(VirtualBackend* client);
+
+    // 다른 클라이언트가 있을 때는 서버 레이트만 허용
+    bool IsRateLocked(double sampleRate) const;
+
+    MixServerStats GetStats() const;
+
+    // 싱크 클럭 모드
+    void OnRenderPeriod(size_t bytesNeeded) override;
+
+private:
+    CVirtualMixServer();
+
+    void Start(VirtualBackend* first);
+    void Stop();
+    void ClockLoop();
+    void MixOneBlock();
+
+    struct Slot {
+        std::atomic<VirtualBackend*> client{ nullptr };
+        std::atomic<bool> busy{ false }; // 믹스 스레드가 사용 중
+    };
+    Slot m_slots[MAX_CLIENTS];
+
+    mutable std::mutex m_lock; // 등록/해제 직렬화 (서버 포맷도 보호)
+    int m_numClients = 0;
+
+    // 서버 포맷
+    double m_sampleRate = 48000.0;
+    long m_blockFrames = 0;
+    bool m_sinkClocked = false;
+    double m_pacingTarget = 0.5;
+    size_t m_latencyThreshold = 0;
+
+    // 합산 결과 (float32) -> 렌더러, 공유 메모리
+    ByteRingBuffer m_mixL;
+    ByteRingBuffer m_mixR;
+    CRenderEngine m_renderer;
+    DeltaCastIpc::Writer m_ipcWriter;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{ false };
+    PacingController m_pacer;
+
+    // 믹스 스레드 전용 작업 버퍼
+    std::vector<uint8_t> m_rawL, m_rawR;
+    std::vector<float> m_tempL, m_tempR;
+    std::vector<float> m_accumL, m_accumR;
+
+    std::atomic<uint64_t> m_blocksMixed{ 0 };
+    std::atomic<uint64_t> m_clientUnderruns{ 0 };
+};
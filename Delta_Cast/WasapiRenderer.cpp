@@ -1,423 +0,0 @@
-﻿#include "WasapiRenderer.h"
-#include <functiondiscoverykeys_devpkey.h>
-#include <immintrin.h>
-#include <algorithm>
-#include <avrt.h>
-#include <cmath>
-#pragma comment(lib, "avrt.lib")
-
-const float INT32_TO_FLOAT = 4.65661287e-10f;
-const float INT24_TO_FLOAT = 1.19209290e-7f;
-const float INT16_TO_FLOAT = 3.05175781e-5f;
-
-// 해제
-template <class T> void SafeRelease(T** ppT) {
-    if (*ppT) { (*ppT)->Release(); *ppT = nullptr; }
-}
-
-CWasapiRenderer::CWasapiRenderer() {}
-CWasapiRenderer::~CWasapiRenderer() { Stop(); }
-
-bool CWasapiRenderer::Start(ByteRingBuffer* pBufferL, ByteRingBuffer* pBufferR,
-    const std::wstring& deviceId,ASIOSampleType sampleType, double inputSampleRate, size_t threshold)
-{
-    if (m_bRunning) return true;
-
-    m_pBufferL = pBufferL;
-    m_pBufferR = pBufferR;
-    m_sampleType = sampleType;
-    m_inputRate = inputSampleRate;
-
-    m_bRunning = true;
-    m_renderThread = std::thread(&CWasapiRenderer::RenderThreadFunc, this, deviceId, threshold);
-
-    // 오디오 스레드 우선순위 높임
-    SetThreadPriority(m_renderThread.native_handle(), THREAD_PRIORITY_TIME_CRITICAL);
-
-    return true;
-}
-
-void CWasapiRenderer::Stop() {
-    m_bRunning = false;
-    if (m_renderThread.joinable()) {
-        m_renderThread.join();
-    }
-}
-
-std::vector<AudioDevice> CWasapiRenderer::GetOutputDevices() {
-    std::vector<AudioDevice> devices;
-    HRESULT hr;
-
-    IMMDeviceEnumerator* pEnumerator = nullptr;
-    hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), (void**)&pEnumerator);
-    if (FAILED(hr)) return devices;
-
-    IMMDeviceCollection* pCollection = nullptr;
-    // 활성화된 장치 검색
-    hr = pEnumerator->EnumAudioEndpoints(eRender, DEVICE_STATE_ACTIVE, &pCollection);
-
-    if (SUCCEEDED(hr)) {
-        UINT count;
-        pCollection->GetCount(&count);
-
-        for (UINT i = 0; i < count; i++) {
-            IMMDevice* pDevice = nullptr;
-            if (SUCCEEDED(pCollection->Item(i, &pDevice))) {
-                LPWSTR pwszID = nullptr;
-                pDevice->GetId(&pwszID); // 장치 고유 ID
-
-                IPropertyStore* pProps = nullptr;
-                pDevice->OpenPropertyStore(STGM_READ, &pProps);
-
-                PROPVARIANT varName;
-                PropVariantInit(&varName);
-                pProps->GetValue(PKEY_Device_FriendlyName, &varName);
-
-                if (pwszID && varName.pwszVal) {
-                    devices.push_back({ pwszID, varName.pwszVal });
-                }
-
-                PropVariantClear(&varName);
-                CoTaskMemFree(pwszID);
-                SafeRelease(&pProps);
-                SafeRelease(&pDevice);
-            }
-        }
-    }
-    SafeRelease(&pCollection);
-    SafeRelease(&pEnumerator);
-    return devices;
-}
-
-void CWasapiRenderer::ConvertRawToFloat(const void* input, float* output, size_t sampleCount) {
-    if (!input || !output) return;
-
-    if (m_sampleType == ASIOSTInt32LSB) {
-        const int32_t* src = (const int32_t*)input;
-        size_t i = 0;
-
-        // 8개씩 병렬 처리
-        __m256 mulVal = _mm256_set1_ps(INT32_TO_FLOAT);
-        for (; i + 8 <= sampleCount; i += 8) {
-            __m256i vInt = _mm256_loadu_si256((const __m256i*) & src[i]);
-            __m256 vFloat = _mm256_cvtepi32_ps(vInt);
-            vFloat = _mm256_mul_ps(vFloat, mulVal);
-            _mm256_storeu_ps(&output[i], vFloat);
-        }
-        // 남은 처리
-        for (; i < sampleCount; ++i) {
-            output[i] = (float)src[i] * INT32_TO_FLOAT;
-        }
-        return;
-    }
-
-    switch (m_sampleType) {
-    case ASIOSTInt32LSB: {
-        const int32_t* src = (const int32_t*)input;
-        for (size_t i = 0; i < sampleCount; ++i) output[i] = (float)src[i] * INT32_TO_FLOAT;
-        break;
-    }
-    case ASIOSTFloat32LSB: {
-        memcpy(output, input, sampleCount * sizeof(float));
-        break;
-    }
-    case ASIOSTInt24LSB: {
-        const uint8_t* src = (const uint8_t*)input;
-        for (size_t i = 0; i < sampleCount; ++i) {
-            int32_t s = (int32_t)((src[i * 3 + 2] << 24) | (src[i * 3 + 1] << 16) | (src[i * 3] << 8));
-            output[i] = (float)(s >> 8) * INT24_TO_FLOAT;
-        }
-        break;
-    }
-    case ASIOSTInt16LSB: {
-        const int16_t* src = (const int16_t*)input;
-        for (size_t i = 0; i < sampleCount; ++i) output[i] = (float)src[i] * INT16_TO_FLOAT;
-        break;
-    }
-    case ASIOSTFloat64LSB: {
-        const double* src = (const double*)input;
-        for (size_t i = 0; i < sampleCount; ++i) output[i] = (float)src[i];
-        break;
-    }
-    default: // 지원 안함 -> 침묵
-        memset(output, 0, sampleCount * sizeof(float));
-        break;
-    }
-}
-
-void CWasapiRenderer::RenderThreadFunc(std::wstring targetDeviceId, size_t safeThreshold) {
-
-    HRESULT hrInit = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    DWORD taskIndex = 0;
-    HANDLE hTask = AvSetMmThreadCharacteristics(L"Pro Audio", &taskIndex);
-    if (hTask == NULL) {
-        // 실패 시 높은 우선순위
-        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
-    }
-    try {
-        // 스레드 시작 시 COM 초기화 
-        HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
-            __uuidof(IMMDeviceEnumerator), (void**)&m_pEnumerator);
-        if (FAILED(hr)) throw std::exception("Enum failed");
-
-        // 출력 장치 가져오기
-        if (targetDeviceId.empty()) m_pEnumerator->GetDefaultAudioEndpoint(eRender, eConsole, &m_pDevice);
-        else m_pEnumerator->GetDevice(targetDeviceId.c_str(), &m_pDevice);
-        if (!m_pDevice) throw std::exception("No Device");
-
-        // Audio Client 활성화
-        hr = m_pDevice->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, (void**)&m_pAudioClient);
-        if (FAILED(hr)) {
-            char errMsg[64];
-            sprintf_s(errMsg, "Activate Failed (HR: 0x%08X)", hr);
-            throw std::exception(errMsg);
-        }
-
-        // 포맷 설정 (Float 32bit, Stereo, 48kHz or 44.1kHz) 
-        WAVEFORMATEX* pMixFormat = nullptr;
-        m_pAudioClient->GetMixFormat(&pMixFormat);
-
-        int bitDepth = pMixFormat->wBitsPerSample;
-        bool isFloat = (pMixFormat->wFormatTag == WAVE_FORMAT_IEEE_FLOAT);
-
-        if (pMixFormat->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
-            WAVEFORMATEXTENSIBLE* pExt = (WAVEFORMATEXTENSIBLE*)pMixFormat;
-            if (IsEqualGUID(pExt->SubFormat, KSDATAFORMAT_SUBTYPE_IEEE_FLOAT)) {
-                isFloat = true;
-            }
-            else if (IsEqualGUID(pExt->SubFormat, KSDATAFORMAT_SUBTYPE_PCM)) {
-                isFloat = false;
-            }
-        }
-
-		// 리샘플러 설정
-        double outRate = (double)pMixFormat->nSamplesPerSec;
-        if (m_inputRate <= 0.0) m_inputRate = 48000.0;
-        m_resamplerL.Setup(m_inputRate, outRate);
-        m_resamplerR.Setup(m_inputRate, outRate);
-
-        bool needResample = (std::abs(m_inputRate - outRate) > 1.0);
-
-        // 버퍼 설정
-        REFERENCE_TIME hnsRequestedDuration = 50000;
-
-        // 이벤트 핸들
-        HANDLE hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-        hr = m_pAudioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
-            hnsRequestedDuration, 0, pMixFormat, nullptr);
-        if (FAILED(hr)) { CloseHandle(hEvent); throw std::exception("Init failed"); }
-
-		// 이벤트 핸들 설정
-        hr = m_pAudioClient->SetEventHandle(hEvent);
-        if (FAILED(hr)) {
-            char buf[64]; sprintf_s(buf, "SetEventHandle Failed (0x%08X)", hr);
-            throw std::exception(buf);
-        }
-
-        hr = m_pAudioClient->GetService(__uuidof(IAudioRenderClient), (void**)&m_pRenderClient);
-        if (FAILED(hr)) {
-            char buf[64]; sprintf_s(buf, "GetService Failed (0x%08X)", hr);
-            throw std::exception(buf);
-        }
-
-        // 재생 시작
-        m_pAudioClient->Start();
-
-		// 샘플 크기
-        int sampleSizeBytes = 4;
-        switch (m_sampleType) {
-        case ASIOSTInt16LSB: sampleSizeBytes = 2; break;
-        case ASIOSTInt24LSB: sampleSizeBytes = 3; break;
-        case ASIOSTFloat64LSB: sampleSizeBytes = 8; break;
-        }
-
-		// 버퍼 프레임 수 확인
-        UINT32 bufferFrameCount;
-        m_pAudioClient->GetBufferSize(&bufferFrameCount);
-
-        // 여유 공간 확보
-        size_t maxFrames = bufferFrameCount * 4;
-        if (maxFrames < 4096) maxFrames = 4096; // 최소 안전장치
-
-        // 벡터 메모리 할당
-        m_rawTempL.resize(maxFrames * sampleSizeBytes);
-        m_rawTempR.resize(maxFrames * sampleSizeBytes);
-        m_floatTempL.resize(maxFrames);
-        m_floatTempR.resize(maxFrames);
-        m_resampledTempL.resize(maxFrames);
-        m_resampledTempR.resize(maxFrames);
-
-        bool isBuffering = true;
-
-        while (m_bRunning) {
-            DWORD waitResult = WaitForSingleObject(hEvent, 2000);
-            if (waitResult == WAIT_TIMEOUT) {
-                continue;
-            }
-            if (waitResult != WAIT_OBJECT_0) {
-                break;
-            }
-            UINT32 padding;
-            if (FAILED(m_pAudioClient->GetCurrentPadding(&padding))) {
-                continue;
-            }
-            UINT32 framesNeeded = bufferFrameCount - padding;
-            if (framesNeeded == 0) {
-                continue;
-            }
-
-            BYTE* pData;
-            HRESULT hrBuffer = m_pRenderClient->GetBuffer(framesNeeded, &pData);
-            if (FAILED(hrBuffer)) {
-                if (hrBuffer == AUDCLNT_E_DEVICE_INVALIDATED) break; // 장치 연결 끊김
-                continue;
-            }
-
-            // 초기 버퍼링
-            size_t bytesAvailable = m_pBufferL->GetAvailableRead();
-            
-            if (!isBuffering && bytesAvailable < 128) {
-                isBuffering = true;
-            }
-            if (isBuffering) {
-                memset(pData, 0, framesNeeded * pMixFormat->nBlockAlign);
-                m_pRenderClient->ReleaseBuffer(framesNeeded, 0);
-
-                // 재생
-                if (bytesAvailable > safeThreshold) {
-                    isBuffering = false;
-                }
-                continue;
-            }
-
-            double ratio = m_inputRate / outRate;
-			// 필요한 입력 샘플 수 계산
-            size_t samplesToRead = (size_t)ceil(framesNeeded * ratio);
-            size_t samplesAvailable = bytesAvailable / sampleSizeBytes;
-
-            // Underrun
-            if (samplesToRead > samplesAvailable) {
-                samplesToRead = samplesAvailable;
-            }
-
-            if (samplesToRead > 0) {
-                // Pop (Byte 단위)
-                size_t bytesRead = samplesToRead * sampleSizeBytes;
-                m_pBufferL->Pop(m_rawTempL.data(), bytesRead);
-                m_pBufferR->Pop(m_rawTempR.data(), bytesRead);
-
-                // Convert (Byte -> Float)
-                ConvertRawToFloat(m_rawTempL.data(), m_floatTempL.data(), samplesToRead);
-                ConvertRawToFloat(m_rawTempR.data(), m_floatTempR.data(), samplesToRead);
-
-                // Resample (InRate -> OutRate)
-                size_t generatedL, generatedR;
-                if (needResample) {
-                    generatedL = m_resamplerL.Process(m_floatTempL.data(), samplesToRead, m_resampledTempL.data(), framesNeeded);
-                    generatedR = m_resamplerR.Process(m_floatTempR.data(), samplesToRead, m_resampledTempR.data(), framesNeeded);
-                }
-                else {
-                    // 비율이 1.0이면 단순 복사
-                    size_t copyCount = (samplesToRead < framesNeeded) ? samplesToRead : framesNeeded;
-                    memcpy(m_resampledTempL.data(), m_floatTempL.data(), copyCount * sizeof(float));
-                    memcpy(m_resampledTempR.data(), m_floatTempR.data(), copyCount * sizeof(float));
-                    generatedL = generatedR = copyCount;
-                }
-
-                // WASAPI에 쓰기
-                BYTE* pRawOut = (BYTE*)pData;
-                int channels = pMixFormat->nChannels;
-
-                // [32-bit Float]
-                if (bitDepth == 32 && isFloat) {
-                    float* pFloat = (float*)pRawOut;
-                    for (UINT32 i = 0; i < framesNeeded; i++) {
-                        float sampleL = (i < generatedL) ? m_resampledTempL[i] : 0.0f;
-                        float sampleR = (channels > 1 && i < generatedL) ? m_resampledTempR[i] : sampleL;
-
-                        pFloat[i * channels + 0] = sampleL;
-                        if (channels > 1) pFloat[i * channels + 1] = sampleR;
-                    }
-                }
-                // [32-bit Int]
-                else if (bitDepth == 32 && !isFloat) {
-                    int32_t* pInt32 = (int32_t*)pRawOut;
-                    for (UINT32 i = 0; i < framesNeeded; i++) {
-                        float sampleL = (i < generatedL) ? m_resampledTempL[i] : 0.0f;
-                        float sampleR = (channels > 1 && i < generatedL) ? m_resampledTempR[i] : sampleL;
-
-                        sampleL = std::clamp(sampleL, -1.0f, 1.0f);
-                        sampleR = std::clamp(sampleR, -1.0f, 1.0f); // [수정됨] sampleR
-
-                        // Float -> Int32 
-                        pInt32[i * channels + 0] = (int32_t)(sampleL * 2147483647.0f);
-                        if (channels > 1) pInt32[i * channels + 1] = (int32_t)(sampleR * 2147483647.0f);
-                    }
-                }
-                // [16-bit Int]
-                else if (bitDepth == 16) {
-                    int16_t* pInt16 = (int16_t*)pRawOut;
-                    for (UINT32 i = 0; i < framesNeeded; i++) {
-                        float sampleL = (i < generatedL) ? m_resampledTempL[i] : 0.0f;
-                        float sampleR = (channels > 1 && i < generatedL) ? m_resampledTempR[i] : sampleL;
-
-                        sampleL = std::clamp(sampleL, -1.0f, 1.0f);
-                        sampleR = std::clamp(sampleR, -1.0f, 1.0f); // [수정됨] sampleR
-
-                        pInt16[i * channels + 0] = (int16_t)(sampleL * 32767.0f);
-                        if (channels > 1) pInt16[i * channels + 1] = (int16_t)(sampleR * 32767.0f);
-                    }
-                }
-                // [24-bit Int]
-                else if (bitDepth == 24) {
-                    uint8_t* pBytes = (uint8_t*)pRawOut;
-                    for (UINT32 i = 0; i < framesNeeded; i++) {
-                        float sampleL = (i < generatedL) ? m_resampledTempL[i] : 0.0f;
-                        float sampleR = (channels > 1 && i < generatedL) ? m_resampledTempR[i] : sampleL;
-
-                        sampleL = std::clamp(sampleL, -1.0f, 1.0f);
-                        sampleR = std::clamp(sampleR, -1.0f, 1.0f);
-
-                        int32_t valL = (int32_t)(sampleL * 8388607.0f);
-                        int32_t valR = (int32_t)(sampleR * 8388607.0f);
-
-                        size_t offset = i * channels * 3;
-                        pBytes[offset + 0] = (valL >> 0) & 0xFF;
-                        pBytes[offset + 1] = (valL >> 8) & 0xFF;
-                        pBytes[offset + 2] = (valL >> 16) & 0xFF;
-
-                        if (channels > 1) {
-                            pBytes[offset + 3] = (valR >> 0) & 0xFF;
-                            pBytes[offset + 4] = (valR >> 8) & 0xFF;
-                            pBytes[offset + 5] = (valR >> 16) & 0xFF;
-                        }
-                    }
-                }
-            }
-            else {
-                // 데이터가 아예 없으면 침묵
-                memset(pData, 0, framesNeeded * pMixFormat->nBlockAlign);
-            }
-			// 버퍼 해제
-            m_pRenderClient->ReleaseBuffer(framesNeeded, 0);
-        }
-
-        // 정리
-        if (hTask) AvRevertMmThreadCharacteristics(hTask);
-        CloseHandle(hEvent);
-        m_pAudioClient->Stop();
-        CoTaskMemFree(pMixFormat);
-        SafeRelease(&m_pRenderClient);
-        SafeRelease(&m_pAudioClient);
-        SafeRelease(&m_pDevice);
-        SafeRelease(&m_pEnumerator);
-        CoUninitialize();
-    }
-    catch (std::exception& e) {
-        if (m_pAudioClient) m_pAudioClient->Stop();
-    }
-    catch (...) {
-        // 에러시 드라이버만 종료
-        if (m_pAudioClient) m_pAudioClient->Stop();
-    }
-}
\ No newline at end of file
@@ -0,0 +1,177 @@
+﻿#include "WasapiSink.h"
+#include <functiondiscoverykeys_devpkey.h>
+
+// 해제
+template <class T> void SafeRelease(T** ppT) {
+    if (*ppT) { (*ppT)->Release(); *ppT = nullptr; }
+}
+
+bool CWasapiSink::Open(const std::wstring& deviceId, double preferredRate, SinkFormat& format) {
+    Close();
+    HRESULT hrInit = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    m_comInitialized = SUCCEEDED(hrInit);
+
+    HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
+        __uuidof(IMMDeviceEnumerator), (void**)&m_pEnumerator);
+    if (FAILED(hr)) { Close(); return false; }
+
+    // 출력 장치 가져오기
+    if (deviceId.empty()) m_pEnumerator->GetDefaultAudioEndpoint(eRender, eConsole, &m_pDevice);
+    else m_pEnumerator->GetDevice(deviceId.c_str(), &m_pDevice);
+    if (!m_pDevice) { Close(); return false; }
+
+    // Audio Client 활성화
+    hr = m_pDevice->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, (void**)&m_pAudioClient);
+    if (FAILED(hr)) { Close(); return false; }
+
+    // 공유 모드는 믹스 포맷 고정 (preferredRate 무시)
+    WAVEFORMATEX* pMixFormat = nullptr;
+    if (FAILED(m_pAudioClient->GetMixFormat(&pMixFormat)) || !pMixFormat) { Close(); return false; }
+
+    format.sampleRate = (double)pMixFormat->nSamplesPerSec;
+    format.channels = pMixFormat->nChannels;
+    format.bitDepth = pMixFormat->wBitsPerSample;
+    format.isFloat = (pMixFormat->wFormatTag == WAVE_FORMAT_IEEE_FLOAT);
+    if (pMixFormat->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
+        WAVEFORMATEXTENSIBLE* pExt = (WAVEFORMATEXTENSIBLE*)pMixFormat;
+        if (IsEqualGUID(pExt->SubFormat, KSDATAFORMAT_SUBTYPE_IEEE_FLOAT)) {
+            format.isFloat = true;
+        }
+        else if (IsEqualGUID(pExt->SubFormat, KSDATAFORMAT_SUBTYPE_PCM)) {
+            format.isFloat = false;
+        }
+    }
+
+    // 버퍼 설정
+    REFERENCE_TIME hnsRequestedDuration = 50000;
+    m_hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    hr = m_pAudioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
+        hnsRequestedDuration, 0, pMixFormat, nullptr);
+    CoTaskMemFree(pMixFormat);
+    if (FAILED(hr)) { Close(); return false; }
+
+    // 이벤트 핸들 설정
+    if (FAILED(m_pAudioClient->SetEventHandle(m_hEvent))) { Close(); return false; }
+    if (FAILED(m_pAudioClient->GetService(__uuidof(IAudioRenderClient), (void**)&m_pRenderClient))) { Close(); return false; }
+
+    m_pAudioClient->GetBufferSize(&m_bufferFrames);
+    format.bufferFrames = m_bufferFrames;
+    return true;
+}
+
+void CWasapiSink::Close() {
+    if (m_pAudioClient) m_pAudioClient->Stop();
+    SafeRelease(&m_pRenderClient);
+    SafeRelease(&m_pAudioClient);
+    SafeRelease(&m_pDevice);
+    SafeRelease(&m_pEnumerator);
+    if (m_hEvent) { CloseHandle(m_hEvent); m_hEvent = nullptr; }
+    if (m_comInitialized) { CoUninitialize(); m_comInitialized = false; }
+}
+
+bool CWasapiSink::Start() {
+    return m_pAudioClient && SUCCEEDED(m_pAudioClient->Start());
+}
+
+SinkStatus CWasapiSink::StatusFrom(HRESULT hr) {
+    if (SUCCEEDED(hr)) return SinkStatus::Ok;
+    // 장치 연결 끊김, 오디오 서비스 재시작, 포맷 변경
+    if (hr == AUDCLNT_E_DEVICE_INVALIDATED || hr == AUDCLNT_E_SERVICE_NOT_RUNNING || hr == AUDCLNT_E_RESOURCES_INVALIDATED) return SinkStatus::Lost;
+    return SinkStatus::Error;
+}
+
+SinkStatus CWasapiSink::WaitForPeriod(uint32_t timeoutMs) {
+    DWORD waitResult = WaitForSingleObject(m_hEvent, timeoutMs);
+    if (waitResult == WAIT_TIMEOUT) return SinkStatus::Timeout;
+    if (waitResult != WAIT_OBJECT_0) return SinkStatus::Error;
+    return SinkStatus::Ok;
+}
+
+SinkStatus CWasapiSink::GetBuffer(uint32_t& frames, uint8_t*& data) {
+    frames = 0;
+    UINT32 padding = 0;
+    HRESULT hr = m_pAudioClient->GetCurrentPadding(&padding);
+    if (FAILED(hr)) return StatusFrom(hr);
+
+    UINT32 framesNeeded = m_bufferFrames - padding;
+    if (framesNeeded == 0) return SinkStatus::Ok;
+
+    BYTE* pData = nullptr;
+    hr = m_pRenderClient->GetBuffer(framesNeeded, &pData);
+    if (FAILED(hr)) return StatusFrom(hr);
+    frames = framesNeeded;
+    data = pData;
+    return SinkStatus::Ok;
+}
+
+SinkStatus CWasapiSink::ReleaseBuffer(uint32_t frames) {
+    return StatusFrom(m_pRenderClient->ReleaseBuffer(frames, 0));
+}
+
+std::vector<AudioDevice> CWasapiSink::GetOutputDevices() {
+    std::vector<AudioDevice> devices;
+    HRESULT hr;
+
+    IMMDeviceEnumerator* pEnumerator = nullptr;
+    hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), (void**)&pEnumerator);
+    if (FAILED(hr)) return devices;
+
+    IMMDeviceCollection* pCollection = nullptr;
+    // 활성화된 장치 검색
+    hr = pEnumerator->EnumAudioEndpoints(eRender, DEVICE_STATE_ACTIVE, &pCollection);
+
+    if (SUCCEEDED(hr)) {
+        UINT count;
+        pCollection->GetCount(&count);
+
+        for (UINT i = 0; i < count; i++) {
+            IMMDevice* pDevice = nullptr;
+            if (SUCCEEDED(pCollection->Item(i, &pDevice))) {
+                LPWSTR pwszID = nullptr;
+                pDevice->GetId(&pwszID); // 장치 고유 ID
+
+                IPropertyStore* pProps = nullptr;
+                pDevice->OpenPropertyStore(STGM_READ, &pProps);
+
+                PROPVARIANT varName;
+                PropVariantInit(&varName);
+                pProps->GetValue(PKEY_Device_FriendlyName, &varName);
+
+                if (pwszID && varName.pwszVal) {
+                    devices.push_back({ pwszID, varName.pwszVal });
+                }
+
+                PropVariantClear(&varName);
+                CoTaskMemFree(pwszID);
+                SafeRelease(&pProps);
+                SafeRelease(&pDevice);
+            }
+        }
+    }
+    SafeRelease(&pCollection);
+    SafeRelease(&pEnumerator);
+    return devices;
+}
+
+double CWasapiSink::QueryDevicePeriod(const std::wstring& deviceId) {
+    double periodSeconds = 0.0;
+    IMMDeviceEnumerator* pEnumerator = nullptr;
+    IMMDevice* pDevice = nullptr;
+    IAudioClient* pClient = nullptr;
+
+    HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), (void**)&pEnumerator);
+    if (SUCCEEDED(hr)) {
+        if (deviceId.empty()) pEnumerator->GetDefaultAudioEndpoint(eRender, eConsole, &pDevice);
+        else pEnumerator->GetDevice(deviceId.c_str(), &pDevice);
+    }
+    if (pDevice && SUCCEEDED(pDevice->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, (void**)&pClient))) {
+        REFERENCE_TIME defaultPeriod = 0, minPeriod = 0;
+        if (SUCCEEDED(pClient->GetDevicePeriod(&defaultPeriod, &minPeriod))) {
+            periodSeconds = defaultPeriod / 10000000.0; // 100ns 단위
+        }
+    }
+    SafeRelease(&pClient);
+    SafeRelease(&pDevice);
+    SafeRelease(&pEnumerator);
+    return periodSeconds;
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+#define NOMINMAX
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
+#include <initguid.h>
+#include <vector>
+#include <string>
+#include "OutputSink.h"
+
+struct AudioDevice {
+    std::wstring id;
+    std::wstring name;
+};
+
+// ---------------------------------------------------------------------------
+// WASAPI 공유 모드 이벤트 구동 싱크
+// COM 초기화는 Open/Close 에서 (렌더 스레드 기준 짝을 맞춤)
+// ---------------------------------------------------------------------------
+class CWasapiSink : public IOutputSink {
+public:
+    ~CWasapiSink() override { Close(); }
+
+    const char* GetName() const override { return "WASAPI"; }
+
+    bool Open(const std::wstring& deviceId, double preferredRate, SinkFormat& format) override;
+    void Close() override;
+    bool Start() override;
+
+    SinkStatus WaitForPeriod(uint32_t timeoutMs) override;
+    SinkStatus GetBuffer(uint32_t& frames, uint8_t*& data) override;
+    SinkStatus ReleaseBuffer(uint32_t frames) override;
+
+    // 장치 정보
+    static std::vector<AudioDevice> GetOutputDevices();
+    // 장치 기본 주기 조회 (초), 실패 시 0
+    static double QueryDevicePeriod(const std::wstring& deviceId);
+
+private:
+    static SinkStatus StatusFrom(HRESULT hr);
+
+    bool m_comInitialized = false;
+    HANDLE m_hEvent = nullptr;
+    UINT32 m_bufferFrames = 0;
+
+    IMMDeviceEnumerator* m_pEnumerator = nullptr;
+    IMMDevice* m_pDevice = nullptr;
+    IAudioClient* m_pAudioClient = nullptr;
+    IAudioRenderClient* m_pRenderClient = nullptr;
+};
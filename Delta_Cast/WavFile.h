@@ -0,0 +1,97 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// WAV / RF64 / W64 헤더 생성
+// ---------------------------------------------------------------------------
+enum class WavSampleFormat { Float32, Int24, Int16 };
+enum class WavContainer { Wav, W64 }; // Wav 는 4GB 초과 시 RF64 로 승격
+
+namespace WavFile {
+    const uint16_t FORMAT_PCM = 1;
+    const uint16_t FORMAT_FLOAT = 3;
+
+    // W64 청크 GUID
+    const uint8_t GUID_RIFF[16] = { 0x72,0x69,0x66,0x66, 0x2E,0x91, 0xCF,0x11, 0xA5,0xD6, 0x28,0xDB,0x04,0xC1,0x00,0x00 };
+    const uint8_t GUID_WAVE[16] = { 0x77,0x61,0x76,0x65, 0xF3,0xAC, 0xD3,0x11, 0x8C,0xD1, 0x00,0xC0,0x4F,0x8E,0xDB,0x8A };
+    const uint8_t GUID_FMT[16]  = { 0x66,0x6D,0x74,0x20, 0xF3,0xAC, 0xD3,0x11, 0x8C,0xD1, 0x00,0xC0,0x4F,0x8E,0xDB,0x8A };
+    const uint8_t GUID_DATA[16] = { 0x64,0x61,0x74,0x61, 0xF3,0xAC, 0xD3,0x11, 0x8C,0xD1, 0x00,0xC0,0x4F,0x8E,0xDB,0x8A };
+
+    // RF64 ds64 청크 크기 (JUNK 로 미리 예약)
+    const uint32_t DS64_SIZE = 28;
+
+    inline int BytesPerSample(WavSampleFormat fmt) {
+        switch (fmt) {
+        case WavSampleFormat::Float32: return 4;
+        case WavSampleFormat::Int24:   return 3;
+        case WavSampleFormat::Int16:   return 2;
+        }
+        return 4;
+    }
+
+    inline void Put16(std::vector<uint8_t>& v, uint16_t x) { v.push_back(x & 0xFF); v.push_back(x >> 8); }
+    inline void Put32(std::vector<uint8_t>& v, uint32_t x) { for (int i = 0; i < 4; i++) v.push_back((x >> (i * 8)) & 0xFF); }
+    inline void Put64(std::vector<uint8_t>& v, uint64_t x) { for (int i = 0; i < 8; i++) v.push_back((x >> (i * 8)) & 0xFF); }
+    inline void PutTag(std::vector<uint8_t>& v, const char* tag) { v.insert(v.end(), tag, tag + 4); }
+    inline void PutGuid(std::vector<uint8_t>& v, const uint8_t* g) { v.insert(v.end(), g, g + 16); }
+
+    // WAVEFORMATEX (cbSize 포함 18바이트)
+    inline void PutFormat(std::vector<uint8_t>& v, WavSampleFormat fmt, int channels, uint32_t sampleRate) {
+        uint16_t bytes = (uint16_t)BytesPerSample(fmt);
+        uint16_t blockAlign = (uint16_t)(bytes * channels);
+        Put16(v, fmt == WavSampleFormat::Float32 ? FORMAT_FLOAT : FORMAT_PCM);
+        Put16(v, (uint16_t)channels);
+        Put32(v, sampleRate);
+        Put32(v, sampleRate * blockAlign);
+        Put16(v, blockAlign);
+        Put16(v, (uint16_t)(bytes * 8));
+        Put16(v, 0);
+    }
+
+    // 헤더 생성. dataBytes 가 확정되지 않았으면 0 으로 만들고 종료 시 다시 생성
+    // 헤더 길이는 dataBytes 와 무관하게 일정 (덮어쓰기 가능)
+    inline std::vector<uint8_t> BuildHeader(WavContainer container, WavSampleFormat fmt,
+        int channels, uint32_t sampleRate, uint64_t dataBytes)
+    {
+        std::vector<uint8_t> h;
+        h.reserve(128);     // 헤더 최대 길이 (W64 112바이트)
+        if (container == WavContainer::W64) {
+            const uint64_t fmtChunk = 24 + 24; // 헤더 24 + 18바이트 포맷 (8바이트 정렬)
+            const uint64_t headerSize = 24 + 16 + fmtChunk + 24;
+            PutGuid(h, GUID_RIFF); Put64(h, headerSize + dataBytes);
+            PutGuid(h, GUID_WAVE);
+            PutGuid(h, GUID_FMT);  Put64(h, fmtChunk);
+            PutFormat(h, fmt, channels, sampleRate);
+            h.resize(h.size() + 6, 0); // 정렬 패딩
+            PutGuid(h, GUID_DATA); Put64(h, 24 + dataBytes);
+            return h;
+        }
+
+        const uint64_t headerSize = 12 + (8 + DS64_SIZE) + (8 + 18) + 8;
+        bool isRf64 = (headerSize - 8 + dataBytes) > 0xFFFFFFFFull;
+        uint64_t frames = dataBytes / ((uint64_t)BytesPerSample(fmt) * channels);
+
+        PutTag(h, isRf64 ? "RF64" : "RIFF");
+        Put32(h, isRf64 ? 0xFFFFFFFFu : (uint32_t)(headerSize - 8 + dataBytes));
+        PutTag(h, "WAVE");
+        if (isRf64) {
+            PutTag(h, "ds64"); Put32(h, DS64_SIZE);
+            Put64(h, headerSize - 8 + dataBytes); // RIFF 크기
+            Put64(h, dataBytes);                 // data 크기
+            Put64(h, frames);                    // 샘플 수
+            Put32(h, 0);                         // 테이블 길이
+        }
+        else {
+            // 4GB 초과 시 ds64 로 바꿀 자리
+            PutTag(h, "JUNK"); Put32(h, DS64_SIZE);
+            h.resize(h.size() + DS64_SIZE, 0);
+        }
+        PutTag(h, "fmt "); Put32(h, 18);
+        PutFormat(h, fmt, channels, sampleRate);
+        PutTag(h, "data");
+        Put32(h, isRf64 ? 0xFFFFFFFFu : (uint32_t)dataBytes);
+        return h;
+    }
+}
@@ -0,0 +1,266 @@
+﻿#include "WavRecorder.h"
+#include "SampleConvert.h"
+#include "ThreadPlacement.h"
+#include <algorithm>
+
+CWavRecorder::CWavRecorder() {}
+CWavRecorder::~CWavRecorder() { Stop(); }
+
+bool CWavRecorder::Start(const ByteRingBuffer* pBufferL, const ByteRingBuffer* pBufferR,
+    const std::wstring& path, ASIOSampleType sampleType, double sampleRate,
+    WavSampleFormat format, WavContainer container)
+{
+    if (m_bRunning) return true;
+
+    m_inSampleSize = GetAsioSampleSize(sampleType);
+    if (m_inSampleSize == 0) return false;
+
+    m_sampleType = sampleType;
+    m_sampleRate = (uint32_t)sampleRate;
+    m_format = format;
+    m_container = container;
+
+    // 버퍼는 여기서 전부 할당 (기록 스레드에서 할당 없음)
+    for (auto& slot : m_slots) {
+        slot.data.assign(WRITE_BLOCK_BYTES, 0);
+        slot.used = 0;
+        slot.pending = false;
+        slot.ov = {};
+        slot.ov.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    }
+
+    const size_t maxFrames = 8192;
+    m_rawL.resize(maxFrames * m_inSampleSize);
+    m_rawR.resize(maxFrames * m_inSampleSize);
+    m_floatL.resize(maxFrames);
+    m_floatR.resize(maxFrames);
+
+    m_path = path;
+    if (!OpenSegment(path)) {
+        for (auto& slot : m_slots) {
+            if (slot.ov.hEvent) { CloseHandle(slot.ov.hEvent); slot.ov.hEvent = nullptr; }
+        }
+        return false;
+    }
+    m_segments = 1;
+
+    m_framesWritten = 0;
+    m_framesDropped = 0;
+    m_lastDroppedBytes = 0;
+    m_tap.Attach(pBufferL, pBufferR);
+
+    m_hStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    m_bRunning = true;
+    m_thread = std::thread(&CWavRecorder::WriterThreadFunc, this);
+    return true;
+}
+
+void CWavRecorder::Stop() {
+    if (!m_bRunning) return;
+    m_bRunning = false;
+    if (m_hStopEvent) SetEvent(m_hStopEvent);
+    if (m_thread.joinable()) m_thread.join();
+
+    m_tap.Detach();
+    for (auto& slot : m_slots) {
+        if (slot.ov.hEvent) { CloseHandle(slot.ov.hEvent); slot.ov.hEvent = nullptr; }
+    }
+    if (m_hStopEvent) { CloseHandle(m_hStopEvent); m_hStopEvent = nullptr; }
+    if (m_hFile != INVALID_HANDLE_VALUE) { CloseHandle(m_hFile); m_hFile = INVALID_HANDLE_VALUE; }
+}
+
+// 새 파일을 열고 자리 표시용 헤더를 씀 (종료 시 덮어씀)
+bool CWavRecorder::OpenSegment(const std::wstring& path) {
+    m_hFile = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_hFile == INVALID_HANDLE_VALUE) return false;
+
+    std::vector<uint8_t> header = WavFile::BuildHeader(m_container, m_format, 2, m_sampleRate, 0);
+    m_headerBytes = header.size();
+    m_allocated = 0;
+    EnsureAllocated(m_headerBytes);
+    m_activeSlot = 0;
+    memcpy(m_slots[0].data.data(), header.data(), header.size());
+    m_slots[0].used = header.size();
+    m_slots[1].used = 0;
+    m_fileOffset = 0;
+    return true;
+}
+
+// 레이트 변경 지점: 현재 파일을 확정하고 새 레이트로 다음 파일 (이름_2, 이름_3 ..)
+void CWavRecorder::StartNextSegment(double sampleRate) {
+    if (m_hFile != INVALID_HANDLE_VALUE) {
+        Finalize();
+        CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+    m_sampleRate = (uint32_t)sampleRate;
+
+    uint32_t segment = m_segments.load(std::memory_order_relaxed) + 1;
+    std::wstring path = m_path;
+    size_t dot = path.find_last_of(L'.');
+    size_t slash = path.find_last_of(L"\\/");
+    if (dot == std::wstring::npos || (slash != std::wstring::npos && dot < slash)) dot = path.size();
+    path.insert(dot, L"_" + std::to_wstring(segment));
+    // 열지 못하면 이후는 기록하지 않음 (탭은 계속 따라감)
+    if (OpenSegment(path)) m_segments.store(segment, std::memory_order_relaxed);
+}
+
+RecorderStats CWavRecorder::GetStats() const {
+    RecorderStats s;
+    s.framesWritten = m_framesWritten.load(std::memory_order_relaxed);
+    s.framesDropped = m_framesDropped.load(std::memory_order_relaxed);
+    s.bytesOnDisk = s.framesWritten * WavFile::BytesPerSample(m_format) * 2;
+    s.segments = m_segments.load(std::memory_order_relaxed);
+    return s;
+}
+
+void CWavRecorder::WriterThreadFunc() {
+    // 저우선순위 + 백그라운드 I/O 우선순위
+    ThreadPlacement::Scope placement(ThreadRole::Background);
+
+    while (m_bRunning) {
+        DrainTap();
+        WaitForSingleObject(m_hStopEvent, POLL_INTERVAL_MS);
+    }
+    DrainTap();
+    if (m_hFile != INVALID_HANDLE_VALUE) Finalize();
+}
+
+void CWavRecorder::DrainTap() {
+    const size_t maxFrames = m_floatL.size();
+    for (;;) {
+        // 레이트 표시에서 끊어 읽음 (표시 이후는 새 파일)
+        size_t toRead = std::min(maxFrames * m_inSampleSize, m_tap.BytesToRateMark());
+        size_t got = m_tap.Pop(m_rawL.data(), m_rawR.data(), toRead);
+
+        // 추월당한 구간은 무음으로 채워 타임라인 유지
+        uint64_t dropped = m_tap.GetDroppedBytes();
+        if (dropped != m_lastDroppedBytes) {
+            uint64_t lostFrames = (dropped - m_lastDroppedBytes) / m_inSampleSize;
+            m_lastDroppedBytes = dropped;
+            m_framesDropped.fetch_add(lostFrames, std::memory_order_relaxed);
+
+            std::fill(m_floatL.begin(), m_floatL.end(), 0.0f);
+            while (lostFrames > 0) {
+                size_t chunk = (size_t)std::min<uint64_t>(lostFrames, maxFrames);
+                AppendFrames(m_floatL.data(), m_floatL.data(), chunk);
+                lostFrames -= chunk;
+            }
+        }
+
+        size_t frames = got / m_inSampleSize;
+        if (frames > 0) {
+            ConvertSamplesToFloat(m_sampleType, m_rawL.data(), m_floatL.data(), frames);
+            ConvertSamplesToFloat(m_sampleType, m_rawR.data(), m_floatR.data(), frames);
+            AppendFrames(m_floatL.data(), m_floatR.data(), frames);
+        }
+
+        double rate = 0.0;
+        if (m_tap.TakeRateChange(rate)) {
+            if (rate > 0.0 && (uint32_t)rate != m_sampleRate) StartNextSegment(rate);
+            continue;
+        }
+        if (frames == 0) break;
+    }
+}
+
+void CWavRecorder::AppendFrames(const float* left, const float* right, size_t frames) {
+    if (m_hFile == INVALID_HANDLE_VALUE) return;
+    const int bytes = WavFile::BytesPerSample(m_format);
+    const size_t frameBytes = (size_t)bytes * 2;
+
+    size_t i = 0;
+    while (i < frames) {
+        WriteSlot& slot = m_slots[m_activeSlot];
+        size_t room = (slot.data.size() - slot.used) / frameBytes;
+        if (room == 0) {
+            SubmitSlot();
+            continue;
+        }
+        size_t count = std::min(room, frames - i);
+        uint8_t* out = slot.data.data() + slot.used;
+
+        if (m_format == WavSampleFormat::Float32) {
+            float* pOut = (float*)out;
+            for (size_t k = 0; k < count; k++) {
+                pOut[k * 2 + 0] = left[i + k];
+                pOut[k * 2 + 1] = right[i + k];
+            }
+        }
+        else {
+            for (size_t k = 0; k < count; k++) {
+                int32_t valL = (int32_t)(std::clamp(left[i + k], -1.0f, 1.0f) * 8388607.0f);
+                int32_t valR = (int32_t)(std::clamp(right[i + k], -1.0f, 1.0f) * 8388607.0f);
+                uint8_t* p = out + k * 6;
+                p[0] = (valL >> 0) & 0xFF; p[1] = (valL >> 8) & 0xFF; p[2] = (valL >> 16) & 0xFF;
+                p[3] = (valR >> 0) & 0xFF; p[4] = (valR >> 8) & 0xFF; p[5] = (valR >> 16) & 0xFF;
+            }
+        }
+        slot.used += count * frameBytes;
+        i += count;
+        m_framesWritten.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+void CWavRecorder::SubmitSlot() {
+    WriteSlot& slot = m_slots[m_activeSlot];
+    if (slot.used > 0) {
+        EnsureAllocated(m_fileOffset + slot.used);
+
+        slot.ov.Offset = (DWORD)(m_fileOffset & 0xFFFFFFFF);
+        slot.ov.OffsetHigh = (DWORD)(m_fileOffset >> 32);
+        ResetEvent(slot.ov.hEvent);
+        if (WriteFile(m_hFile, slot.data.data(), (DWORD)slot.used, nullptr, &slot.ov) ||
+            GetLastError() == ERROR_IO_PENDING) {
+            slot.pending = true;
+        }
+        m_fileOffset += slot.used;
+    }
+
+    // 다음 버퍼로 교체 (이전 기록이 끝나야 재사용)
+    m_activeSlot ^= 1;
+    WaitSlot(m_slots[m_activeSlot]);
+    m_slots[m_activeSlot].used = 0;
+}
+
+void CWavRecorder::WaitSlot(WriteSlot& slot) {
+    if (!slot.pending) return;
+    DWORD written = 0;
+    GetOverlappedResult(m_hFile, &slot.ov, &written, TRUE);
+    slot.pending = false;
+}
+
+void CWavRecorder::EnsureAllocated(uint64_t endOffset) {
+    if (endOffset <= m_allocated) return;
+    // 큰 단위로 선할당해 조각화와 메타데이터 갱신 최소화
+    uint64_t target = ((endOffset + PREALLOC_BYTES - 1) / PREALLOC_BYTES) * PREALLOC_BYTES;
+    FILE_ALLOCATION_INFO info = {};
+    info.AllocationSize.QuadPart = (LONGLONG)target;
+    SetFileInformationByHandle(m_hFile, FileAllocationInfo, &info, sizeof(info));
+    m_allocated = target;
+}
+
+void CWavRecorder::Finalize() {
+    SubmitSlot();
+    WaitSlot(m_slots[0]);
+    WaitSlot(m_slots[1]);
+
+    // 실제 크기로 헤더 갱신 (4GB 초과 시 RF64)
+    uint64_t dataBytes = m_fileOffset - m_headerBytes;
+    std::vector<uint8_t> header = WavFile::BuildHeader(m_container, m_format, 2, m_sampleRate, dataBytes);
+
+    OVERLAPPED ov = {};
+    ov.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    DWORD written = 0;
+    if (WriteFile(m_hFile, header.data(), (DWORD)header.size(), nullptr, &ov) || GetLastError() == ERROR_IO_PENDING) {
+        GetOverlappedResult(m_hFile, &ov, &written, TRUE);
+    }
+    CloseHandle(ov.hEvent);
+
+    // 선할당 여분 잘라내기
+    LARGE_INTEGER end;
+    end.QuadPart = (LONGLONG)m_fileOffset;
+    SetFilePointerEx(m_hFile, end, nullptr, FILE_BEGIN);
+    SetEndOfFile(m_hFile);
+}
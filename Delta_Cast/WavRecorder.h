@@ -0,0 +1,91 @@
+﻿#pragma once
+#include <windows.h>
+#ifndef MY_ASIO
+#define MY_ASIO
+#include <iasiodrv.h>
+#endif
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include "RingBuffer.h"
+#include "WavFile.h"
+
+// 레코더 통계
+struct RecorderStats {
+    uint64_t framesWritten = 0; // 기록된 프레임
+    uint64_t framesDropped = 0; // 지연으로 놓친 프레임 (무음으로 채움)
+    uint64_t bytesOnDisk = 0;   // 데이터 크기
+    uint32_t segments = 0;      // 파일 수 (레이트가 바뀔 때마다 새 파일)
+};
+
+// ---------------------------------------------------------------------------
+// 스트리밍 WAV/RF64/W64 레코더
+// 송출 링버퍼를 보조 커서로 읽어 저우선순위 스레드에서 비동기 기록
+// 재생 중 레이트가 바뀌면 그 지점에서 파일을 닫고 새 레이트로 다음 파일(_2, _3 ..)을 엶
+// ---------------------------------------------------------------------------
+class CWavRecorder {
+public:
+    // 더블 버퍼 1개 크기, 선할당 단위
+    static constexpr size_t WRITE_BLOCK_BYTES = 1 << 20;       // 1MB
+    static constexpr uint64_t PREALLOC_BYTES = 64ull << 20;    // 64MB
+    static constexpr DWORD POLL_INTERVAL_MS = 20;
+
+    CWavRecorder();
+    ~CWavRecorder();
+
+    bool Start(const ByteRingBuffer* pBufferL, const ByteRingBuffer* pBufferR,
+        const std::wstring& path, ASIOSampleType sampleType, double sampleRate,
+        WavSampleFormat format, WavContainer container);
+    void Stop();
+
+    bool IsRunning() const { return m_bRunning; }
+    RecorderStats GetStats() const;
+
+private:
+    struct WriteSlot {
+        std::vector<uint8_t> data;
+        size_t used = 0;
+        OVERLAPPED ov = {};
+        bool pending = false;
+    };
+
+    bool OpenSegment(const std::wstring& path);
+    void StartNextSegment(double sampleRate);
+    void WriterThreadFunc();
+    void DrainTap();
+    void AppendFrames(const float* left, const float* right, size_t frames);
+    void SubmitSlot();
+    void WaitSlot(WriteSlot& slot);
+    void EnsureAllocated(uint64_t endOffset);
+    void Finalize();
+
+    std::atomic<bool> m_bRunning{ false };
+    std::thread m_thread;
+    HANDLE m_hStopEvent = nullptr;
+    HANDLE m_hFile = INVALID_HANDLE_VALUE;
+
+    RingTap m_tap;
+    ASIOSampleType m_sampleType = ASIOSTFloat32LSB;
+    int m_inSampleSize = 4;
+    uint32_t m_sampleRate = 48000;      // 현재 파일 레이트 (기록 스레드 전용)
+    std::wstring m_path;                // 첫 파일 경로 (다음 파일 이름의 기준)
+    std::atomic<uint32_t> m_segments{ 0 };
+    WavSampleFormat m_format = WavSampleFormat::Float32;
+    WavContainer m_container = WavContainer::Wav;
+
+    // 더블 버퍼
+    WriteSlot m_slots[2];
+    int m_activeSlot = 0;
+    uint64_t m_headerBytes = 0;
+    uint64_t m_fileOffset = 0;
+    uint64_t m_allocated = 0;
+    uint64_t m_lastDroppedBytes = 0;
+
+    // 변환용 임시 버퍼
+    std::vector<uint8_t> m_rawL, m_rawR;
+    std::vector<float> m_floatL, m_floatR;
+
+    std::atomic<uint64_t> m_framesWritten{ 0 };
+    std::atomic<uint64_t> m_framesDropped{ 0 };
+};
@@ -7,6 +7,7 @@
 #include <functiondiscoverykeys_devpkey.h>
 #include <shellapi.h>
 #include "Resource.h"
+#include "../Delta_Cast/DeltaCastIpc.h"
 
 #pragma comment(lib, "comctl32.lib")
 
@@ -18,6 +19,9 @@
 #define IDC_BTN_UNINIT    105 // 제거 버튼
 #define IDC_STATUS_TEXT   106 // 상태
 #define IDC_COMBO_LATENCY 107 // 지연 시간 콤보박스
+#define IDC_BTN_REPLAY    108 // 리플레이 저장 버튼
+#define IDC_METER_TEXT    109 // 라우드니스 표시
+#define IDT_METER         1   // 미터 갱신 타이머
 
 // 드라이버 정보 구조체
 struct DeviceInfo {
@@ -28,7 +32,34 @@ struct DeviceInfo {
 // 전역 변수
 std::vector<DeviceInfo> g_asioList;
 std::vector<DeviceInfo> g_wasapiList;
-HWND hComboAsio, hComboWasapi, hBtnSave, hBtnInit, hBtnUnInit, hStatus, hComboLatency;
+HWND hComboAsio, hComboWasapi, hBtnSave, hBtnInit, hBtnUnInit, hStatus, hComboLatency, hBtnReplay, hMeter;
+DeltaCastIpc::MeterChannel g_meter;
+
+// 드라이버 미터 표시 갱신 (드라이버 미실행 또는 2초 이상 갱신 없으면 빈칸)
+void UpdateMeter() {
+    static uint64_t lastFrames = 0;
+    static DWORD lastChange = 0;
+
+    DeltaCastIpc::MeterSnapshot s;
+    if (!g_meter.Read(s) && !(g_meter.Open() && g_meter.Read(s))) {
+        SetWindowText(hMeter, L"");
+        return;
+    }
+    if (s.frames != lastFrames) {
+        lastFrames = s.frames;
+        lastChange = GetTickCount();
+    }
+    else if (GetTickCount() - lastChange > 2000) {
+        g_meter.Close(); // 다음 세션에서 다시 연결
+        SetWindowText(hMeter, L"");
+        return;
+    }
+    WCHAR buf[128];
+    double truePeak = (s.truePeakDb[0] > s.truePeakDb[1]) ? s.truePeakDb[0] : s.truePeakDb[1];
+    swprintf_s(buf, L"M %.1f  S %.1f  I %.1f LUFS  TP %.1f dB",
+        s.momentaryLufs, s.shortTermLufs, s.integratedLufs, truePeak);
+    SetWindowText(hMeter, buf);
+}
 
 // 레지스트리에서 ASIO 드라이버 목록 스캔
 void ScanAsioDrivers() {
@@ -192,11 +223,12 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             hComboLatency = CreateWindow(L"COMBOBOX", NULL, WS_CHILD | WS_VISIBLE | CBS_DROPDOWNLIST | WS_VSCROLL, 20, 165, 340, 200, hWnd, (HMENU)IDC_COMBO_LATENCY, ((LPCREATESTRUCT)lParam)->hInstance, NULL);
             SendMessage(hComboLatency, WM_SETFONT, (WPARAM)hFont, 0);
 
-            // 목록 추가 (인덱스 0~3)
-            SendMessage(hComboLatency, CB_ADDSTRING, 0, (LPARAM)L"16384 samples (42ms)");
-            SendMessage(hComboLatency, CB_ADDSTRING, 0, (LPARAM)L"8192 samples (21ms)");
-            SendMessage(hComboLatency, CB_ADDSTRING, 0, (LPARAM)L"4096 samples (10ms)");
-            SendMessage(hComboLatency, CB_ADDSTRING, 0, (LPARAM)L"2048 samples (5ms)");
+            // 목록 추가 (인덱스 0~3: 고정 시간, 4: 자동)
+            SendMessage(hComboLatency, CB_ADDSTRING, 0, (LPARAM)L"42 ms");
+            SendMessage(hComboLatency, CB_ADDSTRING, 0, (LPARAM)L"21 ms");
+            SendMessage(hComboLatency, CB_ADDSTRING, 0, (LPARAM)L"10 ms");
+            SendMessage(hComboLatency, CB_ADDSTRING, 0, (LPARAM)L"5 ms");
+            SendMessage(hComboLatency, CB_ADDSTRING, 0, (LPARAM)L"Auto (measure jitter)");
 
             // 기본값: 10ms
             SendMessage(hComboLatency, CB_SETCURSEL, 2, 0);
@@ -219,6 +251,19 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 (HMENU)IDC_BTN_UNINIT, ((LPCREATESTRUCT)lParam)->hInstance, NULL);
             SendMessage(hBtnUnInit, WM_SETFONT, (WPARAM)hFont, 0);
 
+            // 리플레이 저장 버튼 (드라이버 동작 중일 때만 유효)
+            hBtnReplay = CreateWindow(L"BUTTON", L"Save Replay", 
+                WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON, 20, 280, 100, 25, hWnd, 
+                (HMENU)IDC_BTN_REPLAY, ((LPCREATESTRUCT)lParam)->hInstance, NULL);
+            SendMessage(hBtnReplay, WM_SETFONT, (WPARAM)hFont, 0);
+
+            // 라우드니스 표시 ([Meter] Enabled=1 일 때)
+            hMeter = CreateWindow(L"STATIC", L"", 
+                WS_CHILD | WS_VISIBLE, 130, 284, 250, 20, hWnd, 
+                (HMENU)IDC_METER_TEXT, ((LPCREATESTRUCT)lParam)->hInstance, NULL);
+            SendMessage(hMeter, WM_SETFONT, (WPARAM)hFont, 0);
+            SetTimer(hWnd, IDT_METER, 250, NULL);
+
             hStatus = CreateWindow(L"STATIC", L"Status: Waiting for configuration...", 
                 WS_CHILD | WS_VISIBLE, 20, 250, 340, 20, hWnd, 
                 (HMENU)IDC_STATUS_TEXT, ((LPCREATESTRUCT)lParam)->hInstance, NULL);
@@ -261,9 +306,25 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         else if (LOWORD(wParam) == IDC_BTN_UNINIT) { // Uninstall 버튼
             RunDriverCommand(hWnd, false); // 제거 (Unregister)
         }
+        else if (LOWORD(wParam) == IDC_BTN_REPLAY) { // 리플레이 저장
+            HANDLE hEvent = OpenEventW(EVENT_MODIFY_STATE, FALSE, L"Local\\DeltaCast_SaveReplay");
+            if (hEvent) {
+                SetEvent(hEvent);
+                CloseHandle(hEvent);
+                SetWindowText(hStatus, L"Status: Replay clip requested.");
+            }
+            else {
+                SetWindowText(hStatus, L"Status: Replay buffer is not running.");
+            }
+        }
+        break;
+
+    case WM_TIMER:
+        if (wParam == IDT_METER) UpdateMeter();
         break;
 
     case WM_DESTROY:
+        KillTimer(hWnd, IDT_METER);
         PostQuitMessage(0);
         break;
 
@@ -0,0 +1,878 @@
+﻿// ---------------------------------------------------------------------------
+// Delta_Cast 오프라인 렌더 (헤드리스)
+// WAV/W64 입력을 드라이버와 같은 경로로 최대 속도 처리:
+// 캡처(호스트 버퍼 -> 링) -> 변환 -> 리샘플 -> 게인/이펙트/리미터 -> 출력 양자화 -> WAV/W64
+// --effects <ini>: 드라이버 INI 의 [Effects] / [Effect1] ~ [Effect8] 를 같은 키로 읽어 같은 순서로 적용
+// 단계별 시간, 실시간 대비 배속, 출력 체크섬 보고. 디렉터리는 코어 수만큼 병렬 처리
+// --realtime: 주기마다 실제 시간으로 대기하며 처리 (스레드 배치별 기상 지연 / 데드라인 초과 측정)
+// 무음 빠른 경로: 렌더 엔진처럼 가라앉은 디지털 무음 주기는 처리 없이 0 출력 (--silence-bench 로 전후 비교)
+// --outputs N: 같은 입력을 출력 N 개가 각자의 스레드/처리 체인으로 동시에 렌더 (1, 2, 4 .. N 개 확장성)
+//
+// 실시간 경로 검사 빌드 (DELTA_RT_CHECK): 주기 처리 구간의 위반이 있으면 종료 코드 3
+//
+// Linux: g++ -O2 -std=c++20 -mavx2 -mfma -pthread -I../Delta_Cast Delta_Cast_Render.cpp ../Delta_Cast/ThreadPlacement.cpp -o delta_render
+// 검사 빌드: 위 명령에 -DDELTA_RT_CHECK=1 -rdynamic ../Delta_Cast/RtCheck.cpp -ldl 추가
+// ---------------------------------------------------------------------------
+
+// ASIO SDK 없이 빌드 (샘플 타입 값은 asio.h 와 같음)
+#define MY_ASIO
+typedef long ASIOSampleType;
+enum {
+    ASIOSTInt16LSB = 16,
+    ASIOSTInt24LSB = 17,
+    ASIOSTInt32LSB = 18,
+    ASIOSTFloat32LSB = 19,
+    ASIOSTFloat64LSB = 20,
+};
+
+#include "SampleConvert.h"
+#include "RingBuffer.h"
+#include "Resampler.h"
+#include "GainStage.h"
+#include "Limiter.h"
+#include "EffectChain.h"
+#include "WavFile.h"
+#include "ThreadPlacement.h"
+#include "RtCheck.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <map>
+#include <cctype>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------
+// 읽기 전용 메모리 매핑
+// ---------------------------------------------------------------------------
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { Close(); }
+
+    bool Open(const fs::path& path) {
+        Close();
+#ifdef _WIN32
+        m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) { Close(); return false; }
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) { Close(); return false; }
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        m_size = (size_t)size.QuadPart;
+#else
+        m_fd = open(path.c_str(), O_RDONLY);
+        if (m_fd < 0) return false;
+        struct stat st;
+        if (fstat(m_fd, &st) != 0 || st.st_size == 0) { Close(); return false; }
+        void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (data == MAP_FAILED) { Close(); return false; }
+        madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = (size_t)st.st_size;
+#endif
+        if (!m_data) { Close(); return false; }
+        return true;
+    }
+
+    void Close() {
+#ifdef _WIN32
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data) munmap((void*)m_data, m_size);
+        if (m_fd >= 0) close(m_fd);
+        m_fd = -1;
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    const uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+// ---------------------------------------------------------------------------
+// WAV / RF64 / W64 입력 헤더
+// ---------------------------------------------------------------------------
+struct InputAudio {
+    const uint8_t* data = nullptr;   // 인터리브 샘플
+    uint64_t frames = 0;
+    int channels = 0;
+    int sampleSize = 0;             // 바이트
+    ASIOSampleType type = ASIOSTFloat32LSB;
+    double sampleRate = 0.0;
+};
+
+static uint16_t Get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t Get32(const uint8_t* p) { return (uint32_t)Get16(p) | ((uint32_t)Get16(p + 2) << 16); }
+static uint64_t Get64(const uint8_t* p) { return (uint64_t)Get32(p) | ((uint64_t)Get32(p + 4) << 32); }
+
+// WAVEFORMATEX(/EXTENSIBLE) -> ASIO 샘플 타입 (드라이버가 받는 LSB 포맷만)
+static bool ParseFormat(const uint8_t* fmt, uint64_t size, InputAudio& audio, std::string& error) {
+    if (size < 16) { error = "short fmt chunk"; return false; }
+    uint16_t tag = Get16(fmt);
+    audio.channels = Get16(fmt + 2);
+    audio.sampleRate = (double)Get32(fmt + 4);
+    uint16_t blockAlign = Get16(fmt + 12);
+    uint16_t bits = Get16(fmt + 14);
+    if (tag == 0xFFFE && size >= 40) tag = Get16(fmt + 24); // 서브포맷 GUID 앞 2바이트
+    if (audio.channels < 1 || blockAlign == 0 || audio.sampleRate <= 0.0) { error = "bad format"; return false; }
+    // 컨테이너 크기 기준 (24-in-32 는 왼쪽 정렬이므로 Int32 로 읽음)
+    audio.sampleSize = blockAlign / audio.channels;
+    if (tag == WavFile::FORMAT_PCM) {
+        if (audio.sampleSize == 2) audio.type = ASIOSTInt16LSB;
+        else if (audio.sampleSize == 3) audio.type = ASIOSTInt24LSB;
+        else if (audio.sampleSize == 4) audio.type = ASIOSTInt32LSB;
+        else { error = "unsupported PCM width"; return false; }
+    }
+    else if (tag == WavFile::FORMAT_FLOAT) {
+        if (audio.sampleSize == 4) audio.type = ASIOSTFloat32LSB;
+        else if (audio.sampleSize == 8) audio.type = ASIOSTFloat64LSB;
+        else { error = "unsupported float width"; return false; }
+    }
+    else { error = "unsupported format tag"; return false; }
+    (void)bits;
+    return true;
+}
+
+static bool ParseInput(const uint8_t* p, size_t size, InputAudio& audio, std::string& error) {
+    const uint8_t* dataPtr = nullptr;
+    uint64_t dataBytes = 0;
+    bool haveFormat = false;
+
+    if (size >= 40 && memcmp(p, WavFile::GUID_RIFF, 16) == 0 && memcmp(p + 24, WavFile::GUID_WAVE, 16) == 0) {
+        // W64: 16바이트 GUID + 64비트 크기(헤더 포함), 8바이트 정렬
+        size_t pos = 40;
+        while (pos + 24 <= size) {
+            uint64_t chunk = Get64(p + pos + 16);
+            if (chunk < 24) break;
+            uint64_t body = std::min<uint64_t>(chunk - 24, size - pos - 24);
+            if (memcmp(p + pos, WavFile::GUID_FMT, 16) == 0) {
+                if (!ParseFormat(p + pos + 24, body, audio, error)) return false;
+                haveFormat = true;
+            }
+            else if (memcmp(p + pos, WavFile::GUID_DATA, 16) == 0) {
+                dataPtr = p + pos + 24;
+                dataBytes = body;
+            }
+            pos += (size_t)((chunk + 7) & ~7ull);
+        }
+    }
+    else if (size >= 12 && (memcmp(p, "RIFF", 4) == 0 || memcmp(p, "RF64", 4) == 0) && memcmp(p + 8, "WAVE", 4) == 0) {
+        uint64_t ds64Data = 0;
+        size_t pos = 12;
+        while (pos + 8 <= size) {
+            uint64_t chunk = Get32(p + pos + 4);
+            if (memcmp(p + pos, "ds64", 4) == 0 && chunk >= 16) ds64Data = Get64(p + pos + 16);
+            else if (memcmp(p + pos, "fmt ", 4) == 0) {
+                if (!ParseFormat(p + pos + 8, std::min<uint64_t>(chunk, size - pos - 8), audio, error)) return false;
+                haveFormat = true;
+            }
+            else if (memcmp(p + pos, "data", 4) == 0) {
+                // RF64 는 크기가 ds64 에 있음 (0xFFFFFFFF)
+                if (chunk == 0xFFFFFFFFull && ds64Data > 0) chunk = ds64Data;
+                dataPtr = p + pos + 8;
+                dataBytes = std::min<uint64_t>(chunk, size - pos - 8);
+                break;
+            }
+            pos += 8 + (size_t)((chunk + 1) & ~1ull);
+        }
+    }
+    else {
+        error = "not a WAV/RF64/W64 file";
+        return false;
+    }
+
+    if (!haveFormat) { error = "missing fmt chunk"; return false; }
+    if (!dataPtr) { error = "missing data chunk"; return false; }
+    audio.data = dataPtr;
+    audio.frames = dataBytes / ((uint64_t)audio.sampleSize * audio.channels);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 이펙트 설정 (드라이버 INI). 키와 기본값은 드라이버와 같음
+// GetPrivateProfile* 처럼 섹션/키 대소문자 무시, 같은 키는 처음 값, ';' 주석 줄
+// UTF-16 INI 는 ASCII 범위만 읽음 (키와 숫자 값은 모두 ASCII)
+// ---------------------------------------------------------------------------
+using IniSection = std::map<std::string, std::string>;
+
+static std::string Lower(std::string s) {
+    for (char& c : s) c = (char)tolower((unsigned char)c);
+    return s;
+}
+
+static std::string Trim(const std::string& s) {
+    size_t first = s.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return std::string();
+    return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+}
+
+static bool ReadIni(const fs::path& path, std::map<std::string, IniSection>& ini) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    const uint8_t* p = file.Data();
+    size_t size = file.Size();
+    std::string text;
+    if (size >= 2 && p[0] == 0xFF && p[1] == 0xFE) {
+        for (size_t i = 2; i + 1 < size; i += 2) text += (p[i + 1] == 0) ? (char)p[i] : '?';
+    }
+    else {
+        if (size >= 3 && p[0] == 0xEF && p[1] == 0xBB && p[2] == 0xBF) { p += 3; size -= 3; }
+        text.assign((const char*)p, size);
+    }
+
+    IniSection* section = nullptr;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t end = std::min(text.find('\n', pos), text.size());
+        std::string line = Trim(text.substr(pos, end - pos));
+        pos = end + 1;
+        if (line.empty() || line[0] == ';') continue;
+        if (line[0] == '[') {
+            size_t close = line.find(']');
+            section = (close != std::string::npos) ? &ini[Lower(Trim(line.substr(1, close - 1)))] : nullptr;
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (!section || eq == std::string::npos) continue;
+        section->emplace(Lower(Trim(line.substr(0, eq))), Trim(line.substr(eq + 1)));
+    }
+    return true;
+}
+
+// [Effect1] ~ [Effect8] 순서대로, Type 이 없거나 모르는 값이면 건너뜀 (LoadSettings 와 같은 규칙)
+static bool LoadEffects(const fs::path& path, std::vector<EffectSettings>& effects) {
+    std::map<std::string, IniSection> ini;
+    if (!ReadIni(path, ini)) return false;
+    effects.clear();
+    if (atoi(ini["effects"]["enabled"].c_str()) == 0) return true;
+
+    static const struct { const char* name; EffectType type; } EFFECT_TYPES[] = {
+        { "highpass", EffectType::HighPass }, { "lowpass", EffectType::LowPass }, { "peak", EffectType::Peak },
+        { "lowshelf", EffectType::LowShelf }, { "highshelf", EffectType::HighShelf }, { "compressor", EffectType::Compressor },
+    };
+    for (size_t i = 0; i < EffectChain::MAX_EFFECTS; i++) {
+        IniSection& section = ini["effect" + std::to_string(i + 1)];
+        auto value = [&section](const char* key, const char* fallback) {
+            auto it = section.find(key);
+            return (it != section.end()) ? it->second.c_str() : fallback;
+        };
+        EffectSettings effect;
+        std::string type = Lower(value("type", ""));
+        for (const auto& entry : EFFECT_TYPES) {
+            if (type == entry.name) effect.type = entry.type;
+        }
+        if (effect.type == EffectType::None) continue;
+        effect.frequencyHz = atof(value("frequencyhz", "1000"));
+        effect.q = atof(value("q", "0.7071"));
+        effect.gainDb = atof(value("gaindb", "0"));
+        effect.order = atoi(value("order", "2"));
+        effect.thresholdDb = atof(value("thresholddb", "-18"));
+        effect.ratio = atof(value("ratio", "3"));
+        effect.kneeDb = atof(value("kneedb", "6"));
+        effect.attackMs = atof(value("attackms", "5"));
+        effect.releaseMs = atof(value("releasems", "120"));
+        effect.makeupDb = atof(value("makeupdb", "0"));
+        effects.push_back(effect);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 렌더 설정 / 결과
+// ---------------------------------------------------------------------------
+struct RenderOptions {
+    double outRate = 48000.0;
+    WavSampleFormat outFormat = WavSampleFormat::Float32;
+    WavContainer container = WavContainer::Wav;
+    long hostBlock = 256;           // 호스트 버퍼 (입력 프레임)
+    uint32_t period = 480;          // 출력 주기 (출력 프레임)
+    double gainDb = 0.0;
+    LimiterSettings limiter;
+    std::vector<EffectSettings> effects;    // 게인 뒤, 리미터 앞 (드라이버와 같은 순서)
+    bool write = true;
+    bool realtime = false;          // 주기 길이만큼 실제로 대기 (데드라인 측정)
+    bool silenceSkip = true;        // 무음 빠른 경로 (렌더 엔진과 같은 조건)
+    double padSilenceSec = 0.0;     // 입력 뒤에 붙이는 디지털 무음
+};
+
+// 무음 빠른 경로 진입 전 무음이 이어져야 하는 시간 (CRenderEngine::SILENCE_SETTLE_MS)
+static const double SILENCE_SETTLE_MS = 20.0;
+
+enum Stage { STAGE_CAPTURE, STAGE_CONVERT, STAGE_RESAMPLE, STAGE_PROCESS, STAGE_QUANTIZE, STAGE_SILENT, STAGE_WRITE, STAGE_COUNT };
+static const char* STAGE_NAMES[STAGE_COUNT] = { "capture", "convert", "resample", "gain/fx/limit", "quantize", "silent skip", "write" };
+
+struct RenderResult {
+    fs::path input;
+    bool ok = false;
+    std::string error;
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+    double stageSeconds[STAGE_COUNT] = {};
+    uint64_t outFrames = 0;
+    uint64_t checksum = 0;          // 출력 샘플 바이트 FNV-1a 64
+    uint64_t renderPeriods = 0;
+    uint64_t silentPeriods = 0;     // 무음 빠른 경로로 건너뛴 주기
+    // --realtime
+    uint64_t periods = 0;
+    uint64_t deadlineMisses = 0;    // 주기 처리가 다음 주기 시작 후에 끝남
+    double wakeP99Us = 0.0;         // 예정 시각 대비 늦게 깬 시간
+    double wakeMaxUs = 0.0;
+    double workMaxUs = 0.0;
+    std::string placement;
+};
+
+static uint64_t Fnv1a(uint64_t hash, const uint8_t* p, size_t n) {
+    for (size_t i = 0; i < n; i++) { hash ^= p[i]; hash *= 0x100000001B3ull; }
+    return hash;
+}
+
+static FILE* OpenForWrite(const fs::path& path) {
+#ifdef _WIN32
+    return _wfopen(path.c_str(), L"wb");
+#else
+    return std::fopen(path.c_str(), "wb");
+#endif
+}
+
+// 인터리브 입력 -> 채널별 호스트 버퍼 (호스트가 ASIO 버퍼에 쓰는 것과 같은 배치)
+template <typename T>
+static void Deinterleave(const uint8_t* src, int channels, int channel, uint8_t* dst, size_t frames) {
+    const T* s = reinterpret_cast<const T*>(src) + channel;
+    T* d = reinterpret_cast<T*>(dst);
+    for (size_t i = 0; i < frames; i++) memcpy(&d[i], &s[i * channels], sizeof(T));
+}
+
+struct Pack24 { uint8_t b[3]; };
+
+static void DeinterleaveChannel(const uint8_t* src, int channels, int channel, int sampleSize, uint8_t* dst, size_t frames) {
+    switch (sampleSize) {
+    case 2: Deinterleave<uint16_t>(src, channels, channel, dst, frames); break;
+    case 3: Deinterleave<Pack24>(src, channels, channel, dst, frames); break;
+    case 4: Deinterleave<uint32_t>(src, channels, channel, dst, frames); break;
+    case 8: Deinterleave<uint64_t>(src, channels, channel, dst, frames); break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 파일 하나 렌더링 (작업 스레드마다 독립된 처리 체인)
+// ---------------------------------------------------------------------------
+static RenderResult RenderFile(const fs::path& inPath, const fs::path& outPath, const RenderOptions& opt) {
+    RenderResult result;
+    result.input = inPath;
+    auto wallStart = Clock::now();
+    ThreadPlacement::Scope placement(ThreadRole::Render);
+    result.placement = std::string(ThreadPlacement::PriorityName(placement.GetPriority())) + ", CPUs " +
+        ThreadPlacement::FormatMask(placement.GetResult().mask) + (placement.GetResult().priorityOk ? "" : " (priority not applied)");
+
+    MappedFile file;
+    if (!file.Open(inPath)) { result.error = "cannot map input"; return result; }
+    InputAudio audio;
+    if (!ParseInput(file.Data(), file.Size(), audio, result.error)) return result;
+
+    const double inRate = audio.sampleRate;
+    const double outRate = opt.outRate;
+    const int sampleSize = audio.sampleSize;
+    const size_t block = (size_t)std::max(opt.hostBlock, 1L);
+    const uint32_t period = std::max(opt.period, 1u);
+    const size_t blockBytes = block * sampleSize;
+
+    // 처리 체인 (렌더 엔진 OpenSink 와 같은 설정)
+    Resampler resamplerL, resamplerR;
+    resamplerL.Setup(inRate, outRate);
+    resamplerR.Setup(inRate, outRate);
+    bool needResample = std::abs(inRate - outRate) > 1.0;
+    GainStage gain;
+    gain.SetGainDb(0, opt.gainDb);
+    gain.SetGainDb(1, opt.gainDb);
+    gain.Prepare(outRate);
+    EffectChain effects;
+    effects.Setup(opt.effects, outRate);
+    Limiter limiter;
+    limiter.Setup(opt.limiter, outRate);
+    resamplerL.SetHeadroom(!limiter.IsEnabled());
+    resamplerR.SetHeadroom(!limiter.IsEnabled());
+
+    // 링: 한 주기 입력 + 호스트 블록 여유
+    size_t maxIn = resamplerL.GetInputNeeded(period) + 8;
+    if (!needResample) maxIn = period;
+    size_t ringBytes = 4096;
+    while (ringBytes < (maxIn + block * 2) * sampleSize * 2) ringBytes <<= 1;
+    ByteRingBuffer ringL(ringBytes), ringR(ringBytes);
+
+    std::vector<uint8_t> hostL(blockBytes), hostR(blockBytes);
+    std::vector<uint8_t> rawL(maxIn * sampleSize), rawR(maxIn * sampleSize);
+    std::vector<float> floatL(maxIn), floatR(maxIn);
+    std::vector<float> outL(period), outR(period);
+    const WavSampleFormat fmt = opt.outFormat;
+    const int outBytes = WavFile::BytesPerSample(fmt);
+    std::vector<uint8_t> outBuf((size_t)period * 2 * outBytes);
+
+    FILE* out = nullptr;
+    if (opt.write) {
+        out = OpenForWrite(outPath);
+        if (!out) { result.error = "cannot create output"; return result; }
+        std::vector<uint8_t> header = WavFile::BuildHeader(opt.container, fmt, 2, (uint32_t)outRate, 0);
+        fwrite(header.data(), 1, header.size(), out);
+    }
+
+    // 출력 길이: 입력 길이(+ 무음 패딩) + 이펙트/리미터 지연 (꼬리까지 내보냄)
+    const uint64_t inputFrames = audio.frames + (uint64_t)std::llround(opt.padSilenceSec * inRate);
+    uint64_t targetFrames = (uint64_t)std::llround(inputFrames * outRate / inRate) + effects.GetLatencyFrames()
+        + (limiter.IsEnabled() ? limiter.GetLatencyFrames() : 0);
+    const size_t settleFrames = (size_t)std::lround(SILENCE_SETTLE_MS * 0.001 * outRate);
+    size_t quietFrames = 0;
+    uint64_t framesIn = 0;
+    uint64_t hash = 0xCBF29CE484222325ull;
+    double* stage = result.stageSeconds;
+    auto lap = Clock::now();
+    auto mark = [&](Stage s) { auto now = Clock::now(); stage[s] += std::chrono::duration<double>(now - lap).count(); lap = now; };
+
+    // 실시간 모드: 주기 시작 예정 시각까지 대기, 기상 지연과 처리 시간 기록
+    const auto periodDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(period / outRate));
+    std::vector<double> wakeUs;
+    if (opt.realtime) wakeUs.reserve((size_t)(targetFrames / period) + 1);
+    Clock::time_point periodStart = Clock::now();
+
+    while (result.outFrames < targetFrames) {
+        if (opt.realtime) {
+            std::this_thread::sleep_until(periodStart);
+            lap = Clock::now();
+            wakeUs.push_back(std::chrono::duration<double, std::micro>(lap - periodStart).count());
+        }
+        size_t samplesToRead = needResample ? resamplerL.GetInputNeeded(period) : period;
+
+        // 캡처: 호스트 블록 단위로 링에 쌓음 (CopyAudioToRingBuffer 와 같은 순서, 입력이 끝나면 무음 블록)
+        while (ringL.GetFillSize() < samplesToRead * sampleSize) {
+            RT_SCOPE("CopyAudioToRingBuffer");
+            size_t frames = (size_t)std::min<uint64_t>(block, audio.frames - std::min(framesIn, audio.frames));
+            const uint8_t* src = audio.data + framesIn * sampleSize * audio.channels;
+            if (frames > 0) {
+                DeinterleaveChannel(src, audio.channels, 0, sampleSize, hostL.data(), frames);
+                if (audio.channels > 1) DeinterleaveChannel(src, audio.channels, 1, sampleSize, hostR.data(), frames);
+            }
+            memset(hostL.data() + frames * sampleSize, 0, blockBytes - frames * sampleSize);
+            if (audio.channels > 1) memset(hostR.data() + frames * sampleSize, 0, blockBytes - frames * sampleSize);
+            const uint8_t* pRawR = (audio.channels > 1) ? hostR.data() : hostL.data();
+            if (!IsBlockSilent(audio.type, hostL.data(), blockBytes) || !IsBlockSilent(audio.type, pRawR, blockBytes)) {
+                ringL.MarkAudible(blockBytes);
+            }
+            ringL.Push(hostL.data(), blockBytes);
+            ringR.Push(pRawR, blockBytes);
+            framesIn += block;
+        }
+        mark(STAGE_CAPTURE);
+        result.renderPeriods++;
+        uint32_t frames = (uint32_t)std::min<uint64_t>(period, targetFrames - result.outFrames);
+        size_t bytes = (size_t)frames * 2 * outBytes;
+
+        // 무음 빠른 경로 (RenderPeriod 와 같은 조건): 링이 무음 블록뿐이고 처리 상태가 가라앉았으면
+        // 변환/리샘플/이펙트/리미터/양자화 없이 0 출력, 리샘플러/게인은 위치만 진행
+        bool silentInput = ringL.IsSilentFrom(ringL.GetReadIndex());
+        if (opt.silenceSkip && silentInput && quietFrames >= settleFrames &&
+            effects.IsSettled() && (!limiter.IsEnabled() || limiter.IsSettled())) {
+            RT_SCOPE("RenderPeriod");
+            ringL.Discard(samplesToRead * sampleSize);
+            ringR.Discard(samplesToRead * sampleSize);
+            if (needResample) {
+                resamplerL.SkipSilence(samplesToRead, period);
+                resamplerR.SkipSilence(samplesToRead, period);
+            }
+            gain.Advance(period);
+            memset(outBuf.data(), 0, bytes);
+            hash = Fnv1a(hash, outBuf.data(), bytes);
+            result.silentPeriods++;
+            mark(STAGE_SILENT);
+        }
+        else {
+            RT_SCOPE("RenderPeriod");
+            quietFrames = silentInput ? quietFrames + period : 0;
+
+            // 렌더 주기 (RenderSegment 와 같은 순서)
+            ringL.Pop(rawL.data(), samplesToRead * sampleSize);
+            ringR.Pop(rawR.data(), samplesToRead * sampleSize);
+            ConvertSamplesToFloat(audio.type, rawL.data(), floatL.data(), samplesToRead);
+            ConvertSamplesToFloat(audio.type, rawR.data(), floatR.data(), samplesToRead);
+            mark(STAGE_CONVERT);
+
+            size_t generated;
+            if (needResample) {
+                size_t generatedL = resamplerL.Process(floatL.data(), samplesToRead, outL.data(), period);
+                size_t generatedR = resamplerR.Process(floatR.data(), samplesToRead, outR.data(), period);
+                generated = std::min(generatedL, generatedR);
+            }
+            else {
+                generated = std::min(samplesToRead, (size_t)period);
+                memcpy(outL.data(), floatL.data(), generated * sizeof(float));
+                memcpy(outR.data(), floatR.data(), generated * sizeof(float));
+            }
+            mark(STAGE_RESAMPLE);
+
+            gain.Process(outL.data(), outR.data(), generated);
+            if (effects.IsEnabled()) effects.Process(outL.data(), outR.data(), generated);
+            if (limiter.IsEnabled()) limiter.Process(outL.data(), outR.data(), generated);
+            mark(STAGE_PROCESS);
+
+            ConvertFloatToOutput(outL.data(), outR.data(), generated, outBuf.data(), frames, 2,
+                outBytes * 8, fmt == WavSampleFormat::Float32);
+            hash = Fnv1a(hash, outBuf.data(), bytes);
+            mark(STAGE_QUANTIZE);
+        }
+
+        if (out) fwrite(outBuf.data(), 1, bytes, out);
+        result.outFrames += frames;
+        mark(STAGE_WRITE);
+
+        if (opt.realtime) {
+            double workUs = std::chrono::duration<double, std::micro>(lap - periodStart).count() - wakeUs.back();
+            result.workMaxUs = std::max(result.workMaxUs, workUs);
+            if (lap > periodStart + periodDuration) result.deadlineMisses++;
+            periodStart += periodDuration;
+        }
+    }
+    if (!wakeUs.empty()) {
+        result.periods = wakeUs.size();
+        std::sort(wakeUs.begin(), wakeUs.end());
+        result.wakeP99Us = wakeUs[std::min(wakeUs.size() - 1, wakeUs.size() * 99 / 100)];
+        result.wakeMaxUs = wakeUs.back();
+    }
+
+    if (out) {
+        // 크기 확정 후 헤더 다시 씀 (길이 일정)
+        std::vector<uint8_t> header = WavFile::BuildHeader(opt.container, fmt, 2, (uint32_t)outRate, result.outFrames * 2 * outBytes);
+        fseek(out, 0, SEEK_SET);
+        fwrite(header.data(), 1, header.size(), out);
+        fclose(out);
+    }
+
+    result.audioSeconds = inputFrames / inRate;
+    result.wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+    result.checksum = hash;
+    result.ok = true;
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// 명령행
+// ---------------------------------------------------------------------------
+static void PrintUsage() {
+    printf("Usage: delta_render <input.wav|dir> <output.wav|dir> [options]\n"
+        "  --rate <Hz>            output rate (default 48000)\n"
+        "  --format f32|s24|s16   output sample format (default f32)\n"
+        "  --container wav|w64    output container (default wav)\n"
+        "  --block <frames>       host buffer size (default 256)\n"
+        "  --period <frames>      output period (default 480)\n"
+        "  --gain <dB>            output gain\n"
+        "  --limit                enable limiter\n"
+        "  --ceiling <dBTP>       limiter ceiling (default -1)\n"
+        "  --lookahead <ms>       limiter lookahead (default 1.5)\n"
+        "  --release <ms>         limiter release (default 60)\n"
+        "  --effects <ini>        effect chain from a driver INI ([Effects] Enabled=1, [Effect1]..[Effect8])\n"
+        "  --jobs <n>             parallel files for directory input (default: cores)\n"
+        "  --no-write             render and checksum only\n"
+        "  --no-silence-skip      always run the full path on digital silence\n"
+        "  --pad-silence <s>      append s seconds of digital silence to the input\n"
+        "  --silence-bench        render with and without the silent fast path, report time saved\n"
+        "  --outputs <n>          scaling run: 1, 2, 4 .. n concurrent outputs of one file, one thread each (max 8)\n"
+        "  --realtime             pace periods in real time, report wake-up latency and deadline misses\n"
+        "  --stress <n>           run n busy threads alongside (contention for --realtime)\n"
+        "  --priority <class>     render thread: background|low|normal|high|realtime (default normal)\n"
+        "  --cores any|p|e        render thread core class on hybrid CPUs (default any)\n"
+        "  --pin <cpus>           render thread CPUs, e.g. 2,3 or 4-7\n"
+        "  --avoid <cpus>         CPUs to keep off, e.g. the game's render thread core\n"
+        "  --avoid-scope cpu|smt|l2  widen avoided CPUs to SMT siblings or L2 cluster (default smt)\n"
+        "usage: delta_render --topology    print detected CPU topology\n");
+}
+
+static void PrintResult(const RenderResult& r) {
+    if (!r.ok) {
+        printf("%s: FAILED (%s)\n", r.input.filename().string().c_str(), r.error.c_str());
+        return;
+    }
+    double stageTotal = 0.0;
+    for (double s : r.stageSeconds) stageTotal += s;
+    printf("%s: %.2f s audio, %.1f ms, %.1fx real time, %llu frames, fnv64 %016llx\n", r.input.filename().string().c_str(),
+        r.audioSeconds, r.wallSeconds * 1000.0, r.audioSeconds / std::max(r.wallSeconds, 1e-9),
+        (unsigned long long)r.outFrames, (unsigned long long)r.checksum);
+    printf("   ");
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        printf(" %s %.1f ms (%.0f%%)", STAGE_NAMES[s], r.stageSeconds[s] * 1000.0, 100.0 * r.stageSeconds[s] / std::max(stageTotal, 1e-12));
+    }
+    printf("\n");
+    if (r.silentPeriods > 0) {
+        printf("    silent: %llu of %llu periods skipped (%.1f%%), %.1f ms\n", (unsigned long long)r.silentPeriods,
+            (unsigned long long)r.renderPeriods, 100.0 * r.silentPeriods / std::max<uint64_t>(r.renderPeriods, 1),
+            r.stageSeconds[STAGE_SILENT] * 1000.0);
+    }
+    if (r.periods > 0) {
+        printf("    realtime [%s]: %llu periods, %llu deadline misses (%.3f%%), wake late p99 %.1f us / max %.1f us, work max %.1f us\n",
+            r.placement.c_str(), (unsigned long long)r.periods, (unsigned long long)r.deadlineMisses,
+            100.0 * r.deadlineMisses / r.periods, r.wakeP99Us, r.wakeMaxUs, r.workMaxUs);
+    }
+}
+
+static void PrintTopology() {
+    const CpuTopology& topology = ThreadPlacement::GetTopology();
+    printf("%zu CPUs, %s\n", topology.cpus.size(), topology.hybrid ? "hybrid" : "uniform");
+    for (const CpuInfo& info : topology.cpus) {
+        printf("  cpu %2d: core %d, L2 group %d, efficiency %d%s\n", info.cpu, info.core, info.l2, info.efficiency,
+            (topology.hybrid && info.efficiency == topology.maxEfficiency) ? " (P)" : (topology.hybrid ? " (E)" : ""));
+    }
+}
+
+// 무음 빠른 경로 전후 비교: 건너뛴 주기와 줄어든 처리 시간, 출력은 같아야 함
+static int RunSilenceBench(const fs::path& input, const fs::path& output, RenderOptions opt) {
+    opt.silenceSkip = false;
+    RenderResult full = RenderFile(input, output, opt);
+    opt.silenceSkip = true;
+    opt.write = false;
+    RenderResult skip = RenderFile(input, output, opt);
+    PrintResult(full);
+    PrintResult(skip);
+    if (!full.ok || !skip.ok) return 2;
+
+    // 파일 입출력을 뺀 처리 시간 기준
+    auto work = [](const RenderResult& r) {
+        double seconds = 0.0;
+        for (int s = 0; s < STAGE_COUNT; s++) if (s != STAGE_WRITE) seconds += r.stageSeconds[s];
+        return seconds;
+    };
+    double saved = work(full) - work(skip);
+    printf("Silence bench: %llu of %llu periods skipped, processing %.1f ms -> %.1f ms (saved %.1f ms, %.0f%%)\n",
+        (unsigned long long)skip.silentPeriods, (unsigned long long)skip.renderPeriods, work(full) * 1000.0, work(skip) * 1000.0,
+        saved * 1000.0, 100.0 * saved / std::max(work(full), 1e-12));
+    if (full.checksum != skip.checksum) {
+        printf("  FAILED: output differs (fnv64 %016llx vs %016llx)\n", (unsigned long long)full.checksum, (unsigned long long)skip.checksum);
+        return 2;
+    }
+    return 0;
+}
+
+// 추가 출력 확장성: 드라이버의 출력별 탭 엔진처럼 출력마다 스레드 하나와 독립 처리 체인
+// 출력 수를 1, 2, 4 .. maxOutputs 로 늘리며 전체 처리량과 가장 느린 출력을 비교
+static int RunScaling(const fs::path& input, const fs::path& output, const RenderOptions& opt, unsigned maxOutputs) {
+    printf("Scaling: %s, up to %u outputs, %u CPUs%s\n", input.filename().string().c_str(), maxOutputs,
+        std::thread::hardware_concurrency(), opt.realtime ? ", realtime" : "");
+    double baseline = 0.0;
+    bool mismatch = false;
+    for (unsigned n = 1; n <= maxOutputs; n = (n < maxOutputs) ? std::min(n * 2, maxOutputs) : n + 1) {
+        std::vector<RenderResult> results(n);
+        std::vector<std::thread> threads;
+        auto start = Clock::now();
+        for (unsigned k = 0; k < n; k++) {
+            threads.emplace_back([&, k]() {
+                fs::path outPath = output;
+                outPath.replace_filename(output.stem().string() + "_" + std::to_string(k + 1) + output.extension().string());
+                results[k] = RenderFile(input, outPath, opt);
+            });
+        }
+        for (auto& t : threads) t.join();
+        double wall = std::chrono::duration<double>(Clock::now() - start).count();
+
+        double audioSeconds = 0.0;
+        double slowest = 1e300;
+        uint64_t misses = 0;
+        double wakeMax = 0.0;
+        for (const auto& r : results) {
+            if (!r.ok) { PrintResult(r); return 2; }
+            audioSeconds += r.audioSeconds;
+            slowest = std::min(slowest, r.audioSeconds / std::max(r.wallSeconds, 1e-9));
+            misses += r.deadlineMisses;
+            wakeMax = std::max(wakeMax, r.wakeMaxUs);
+            // 출력끼리 공유 상태가 없으므로 결과가 같아야 함
+            if (r.checksum != results[0].checksum) mismatch = true;
+        }
+        double aggregate = audioSeconds / std::max(wall, 1e-9);
+        if (n == 1) baseline = aggregate;
+        printf("  %u output%s: %.1f ms, %.1fx real time total, slowest output %.1fx, efficiency %.0f%%", n, n > 1 ? "s" : " ",
+            wall * 1000.0, aggregate, slowest, 100.0 * aggregate / std::max(baseline * n, 1e-9));
+        if (opt.realtime) printf(", %llu deadline misses, wake late max %.1f us", (unsigned long long)misses, wakeMax);
+        printf("\n");
+    }
+    if (mismatch) printf("  FAILED: outputs differ\n");
+    return mismatch ? 2 : 0;
+}
+
+static bool IsAudioFile(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext == ".wav" || ext == ".w64" || ext == ".rf64";
+}
+
+static int Run(int argc, char** argv) {
+    if (argc == 2 && std::string(argv[1]) == "--topology") { PrintTopology(); return 0; }
+    if (argc < 3) { PrintUsage(); return 1; }
+    fs::path input = argv[1];
+    fs::path output = argv[2];
+    RenderOptions opt;
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    unsigned stress = 0;
+    unsigned outputs = 1;
+    bool silenceBench = false;
+    std::string effectsPath;
+    // 렌더 스레드 배치 (기본: 변경 없음)
+    ThreadPlacementSettings placement;
+    ThreadPolicy& policy = placement.policy[(int)ThreadRole::Render];
+    policy.priority = ThreadPriorityClass::Normal;
+    policy.cores = CoreClass::Any;
+
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : ""; };
+        if (arg == "--rate") opt.outRate = atof(next());
+        else if (arg == "--format") {
+            std::string f = next();
+            if (f == "s24") opt.outFormat = WavSampleFormat::Int24;
+            else if (f == "s16") opt.outFormat = WavSampleFormat::Int16;
+            else opt.outFormat = WavSampleFormat::Float32;
+        }
+        else if (arg == "--container") opt.container = (std::string(next()) == "w64") ? WavContainer::W64 : WavContainer::Wav;
+        else if (arg == "--block") opt.hostBlock = atol(next());
+        else if (arg == "--period") opt.period = (uint32_t)atol(next());
+        else if (arg == "--gain") opt.gainDb = atof(next());
+        else if (arg == "--limit") opt.limiter.enabled = true;
+        else if (arg == "--ceiling") opt.limiter.ceilingDb = atof(next());
+        else if (arg == "--lookahead") opt.limiter.lookaheadMs = atof(next());
+        else if (arg == "--release") opt.limiter.releaseMs = atof(next());
+        else if (arg == "--effects") effectsPath = next();
+        else if (arg == "--jobs") jobs = (unsigned)std::max(1, atoi(next()));
+        else if (arg == "--no-write") opt.write = false;
+        else if (arg == "--no-silence-skip") opt.silenceSkip = false;
+        else if (arg == "--pad-silence") opt.padSilenceSec = std::max(0.0, atof(next()));
+        else if (arg == "--silence-bench") silenceBench = true;
+        else if (arg == "--outputs") outputs = (unsigned)std::clamp(atoi(next()), 1, 8);
+        else if (arg == "--realtime") opt.realtime = true;
+        else if (arg == "--stress") stress = (unsigned)std::max(0, atoi(next()));
+        else if (arg == "--priority") {
+            static const char* NAMES[] = { "background", "low", "normal", "high", "realtime" };
+            std::string name = next();
+            for (int p = 0; p < 5; p++) if (name == NAMES[p]) policy.priority = (ThreadPriorityClass)p;
+        }
+        else if (arg == "--cores") {
+            std::string name = next();
+            policy.cores = (name == "p") ? CoreClass::Performance : (name == "e") ? CoreClass::Efficiency : CoreClass::Any;
+        }
+        else if (arg == "--pin") policy.pin = ThreadPlacement::ParseCpuList(next());
+        else if (arg == "--avoid") placement.avoid = ThreadPlacement::ParseCpuList(next());
+        else if (arg == "--avoid-scope") {
+            std::string name = next();
+            placement.avoidScope = (name == "cpu") ? AvoidScope::Cpu : (name == "l2") ? AvoidScope::L2 : AvoidScope::Smt;
+        }
+        else { PrintUsage(); return 1; }
+    }
+    if (opt.outRate <= 0.0 || opt.hostBlock <= 0 || opt.period == 0) { PrintUsage(); return 1; }
+    if (!effectsPath.empty()) {
+        if (!LoadEffects(effectsPath, opt.effects)) { printf("Cannot read %s\n", effectsPath.c_str()); return 1; }
+        printf("Effects:");
+        if (opt.effects.empty()) printf(" none (disabled or no valid [EffectN])");
+        for (const EffectSettings& effect : opt.effects) printf(" %s", EffectTypeName(effect.type));
+        printf("\n");
+    }
+    ThreadPlacement::Configure(placement);
+
+    // 경합용 바쁜 스레드 (기본 스케줄링, 배치 제한 없음)
+    std::atomic<bool> stressRunning{ true };
+    std::vector<std::thread> stressThreads;
+    for (unsigned t = 0; t < stress; t++) {
+        stressThreads.emplace_back([&stressRunning]() {
+            volatile uint64_t spin = 0;
+            while (stressRunning.load(std::memory_order_relaxed)) spin = spin + 1;
+        });
+    }
+    struct StressStop {
+        std::atomic<bool>& running;
+        std::vector<std::thread>& threads;
+        ~StressStop() { running = false; for (auto& t : threads) t.join(); }
+    } stressStop{ stressRunning, stressThreads };
+
+    // 단일 파일
+    std::error_code ec;
+    if (!fs::is_directory(input, ec)) {
+        if (silenceBench) return RunSilenceBench(input, output, opt);
+        if (outputs > 1) return RunScaling(input, output, opt, outputs);
+        RenderResult r = RenderFile(input, output, opt);
+        PrintResult(r);
+        return r.ok ? 0 : 2;
+    }
+
+    // 디렉터리: 파일 단위 병렬 (파일마다 처리 체인이 독립이므로 공유 상태 없음)
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(input, ec)) {
+        if (entry.is_regular_file() && IsAudioFile(entry.path())) files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) { printf("No WAV/W64 files in %s\n", input.string().c_str()); return 1; }
+    if (opt.write) fs::create_directories(output, ec);
+
+    std::vector<RenderResult> results(files.size());
+    std::atomic<size_t> nextFile{ 0 };
+    std::mutex printLock;
+    auto worker = [&]() {
+        for (size_t i = nextFile++; i < files.size(); i = nextFile++) {
+            fs::path outPath = output / files[i].filename();
+            outPath.replace_extension(opt.container == WavContainer::W64 ? ".w64" : ".wav");
+            results[i] = RenderFile(files[i], outPath, opt);
+            std::lock_guard<std::mutex> lock(printLock);
+            PrintResult(results[i]);
+        }
+    };
+    auto start = Clock::now();
+    jobs = std::min<unsigned>(jobs, (unsigned)files.size());
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < jobs; t++) threads.emplace_back(worker);
+    for (auto& t : threads) t.join();
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+
+    double audioSeconds = 0.0;
+    size_t failed = 0;
+    for (const auto& r : results) {
+        if (r.ok) audioSeconds += r.audioSeconds;
+        else failed++;
+    }
+    printf("Total: %zu files (%zu failed), %.1f s audio in %.2f s, %.1fx real time on %u threads\n",
+        files.size(), failed, audioSeconds, wall, audioSeconds / std::max(wall, 1e-9), jobs);
+    return failed ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    int code = Run(argc, argv);
+    // 검사 빌드: 주기 처리 중 할당/잠금이 있었으면 실패
+    if (RT_CHECK_REPORT() > 0 && code == 0) code = 3;
+    return code;
+}
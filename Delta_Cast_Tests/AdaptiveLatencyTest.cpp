@@ -0,0 +1,81 @@
+﻿// ---------------------------------------------------------------------------
+// 자동 레이턴시 (AdaptiveLatency) 테스트 - 생산측 정체 후 재개
+// 렌더 스레드와 같은 순서 (주기마다 생산 블록 기록 -> OnConsumerPeriod), 가상 시각으로 구동 (지터 고정)
+// - 정체 감지 시 ResetProducerClock 을 부르면 재개 후에도 목표가 정체 전과 같게 유지되는지
+// - 부르지 않으면 정체 구간이 초과분으로 들어가 목표가 튀는지 (테스트 자체 검증)
+//
+// Linux: g++ -O2 -std=c++20 -pthread -I../Delta_Cast AdaptiveLatencyTest.cpp -o adaptive_latency_test
+// ---------------------------------------------------------------------------
+#include "AdaptiveLatency.h"
+
+#include <cstdio>
+#include <cmath>
+
+static int g_failures = 0;
+#define CHECK(cond, ...) do { if (!(cond)) { g_failures++; printf("  FAIL line %d: ", __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+static const double RATE = 48000.0;
+static const uint32_t BLOCK_FRAMES = 240;   // 5 ms (생산 블록 = 장치 주기)
+static const int64_t PERIOD_NS = 5000000;
+
+// 가상 시각의 스트림: 생산 블록은 7 개마다 0.6 ms 늦게, 장치 주기는 5 개마다 0.3 ms 늦게 도착
+struct VirtualStream {
+    AdaptiveLatency latency;
+    int64_t period = 0;
+
+    void Run(double seconds, bool produce) {
+        int64_t end = period + (int64_t)std::llround(seconds * 1e9 / PERIOD_NS);
+        for (; period < end; period++) {
+            int64_t base = 1000000000 + period * PERIOD_NS;
+            if (produce) latency.RecordProducerBlock(BLOCK_FRAMES, base + ((period % 7 == 0) ? 600000 : 0));
+            double targetMs = 0.0;
+            latency.OnConsumerPeriod(BLOCK_FRAMES, RATE, base + ((period % 5 == 0) ? 300000 : 0), targetMs);
+        }
+    }
+};
+
+struct StallResult {
+    double beforeMs = 0.0;
+    double afterMs = 0.0;
+};
+
+static StallResult StallAndResume(bool resetClock, double stallSec) {
+    AutoLatencySettings settings;
+    settings.enabled = true;
+    settings.minMs = 3.0;
+    settings.maxMs = 200.0;
+    VirtualStream stream;
+    stream.latency.Configure(settings);
+    stream.latency.Reset(RATE, settings.minMs);
+
+    StallResult result;
+    stream.Run(2.0, true);
+    result.beforeMs = stream.latency.GetTargetMs();
+    // 렌더 엔진의 정체 감지 (WatchProducer) 시점
+    if (resetClock) stream.latency.ResetProducerClock();
+    stream.Run(stallSec, false);
+    stream.Run(2.0, true);
+    result.afterMs = stream.latency.GetTargetMs();
+    return result;
+}
+
+static void TestStallResume(double stallSec) {
+    printf("Stall %.0f ms and resume\n", stallSec * 1000.0);
+    StallResult reset = StallAndResume(true, stallSec);
+    StallResult raw = StallAndResume(false, stallSec);
+    printf("  with reset: %.2f -> %.2f ms, without: %.2f -> %.2f ms\n", reset.beforeMs, reset.afterMs, raw.beforeMs, raw.afterMs);
+
+    // 정체 전 목표: 블록 + 주기 + 각 지터
+    CHECK(reset.beforeMs >= 10.0 && reset.beforeMs < 13.0, "settled target %.2f ms", reset.beforeMs);
+    // 재개 후에도 그대로
+    CHECK(std::abs(reset.afterMs - reset.beforeMs) < AdaptiveLatency::BIN_MS, "target moved %.2f -> %.2f ms after stall", reset.beforeMs, reset.afterMs);
+    // 기준을 지우지 않으면 정체 구간 전체가 초과분 (최대 빈) 으로 들어감
+    CHECK(raw.afterMs >= raw.beforeMs + 50.0, "stall gap not visible without reset (%.2f -> %.2f ms)", raw.beforeMs, raw.afterMs);
+}
+
+int main() {
+    TestStallResume(0.3);
+    TestStallResume(3.0);   // 정체 중 히스토그램 감쇠
+    printf(g_failures ? "FAILED (%d)\n" : "PASSED\n", g_failures);
+    return g_failures ? 1 : 0;
+}
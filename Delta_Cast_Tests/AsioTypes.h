@@ -0,0 +1,14 @@
+﻿#pragma once
+// ---------------------------------------------------------------------------
+// ASIO SDK 없이 드라이버 소스를 빌드할 때의 샘플 타입 (테스트 전용, asio.h 와 같은 값)
+// 여러 번역 단위가 같은 정의를 보도록 빌드 줄에서 -include 로 넣음
+// ---------------------------------------------------------------------------
+#define MY_ASIO
+typedef long ASIOSampleType;
+enum {
+    ASIOSTInt16LSB = 16,
+    ASIOSTInt24LSB = 17,
+    ASIOSTInt32LSB = 18,
+    ASIOSTFloat32LSB = 19,
+    ASIOSTFloat64LSB = 20,
+};
@@ -0,0 +1,116 @@
+﻿// ---------------------------------------------------------------------------
+// 가상 장치 채널 처리 벤치 (VirtualChannels::PrepareBlock, 호스트 콜백 제외)
+// - 정확성: 루프백 입력 N = 직전 블록 출력 N, 송출 채널은 블록마다 0 으로 시작
+// - 블록당 시간: 출력만 / 출력 + 같은 수의 루프백 입력, 2 / 8 / 32 채널
+//   비교 기준은 이전 방식 (블록마다 모든 출력 클리어)
+//
+// Linux: g++ -O2 -std=c++20 -I../Delta_Cast ChannelBench.cpp -o channel_bench
+// ---------------------------------------------------------------------------
+#include "VirtualChannels.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <chrono>
+
+using Clock = std::chrono::steady_clock;
+
+static int g_failures = 0;
+#define CHECK(cond, ...) do { if (!(cond)) { g_failures++; printf("  FAIL line %d: ", __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+// 드라이버 스트림 아레나와 같은 배치: 채널마다 반쪽 2개, 반쪽마다 캐시 라인 정렬
+struct VirtualDevice {
+    long frames = 0;
+    size_t stride = 0;
+    float* arena = nullptr;
+    std::vector<float*> outputs[2];
+    std::vector<float*> inputs[2];
+    std::vector<VirtualChannels::LoopbackCopy> loopbacks;
+
+    VirtualDevice(long bufferSize, int numOutputs, int numInputs) : frames(bufferSize) {
+        stride = VirtualChannels::ChannelStride(bufferSize);
+        size_t bytes = (size_t)(numOutputs + numInputs) * 2 * stride * sizeof(float);
+        arena = static_cast<float*>(aligned_alloc(64, bytes));
+        for (size_t i = 0; i < bytes / sizeof(float); i++) arena[i] = 0.0f;
+        for (int c = 0; c < numOutputs + numInputs; c++) {
+            float* channel = arena + (size_t)c * stride * 2;
+            for (int half = 0; half < 2; half++) (c < numOutputs ? outputs : inputs)[half].push_back(channel + stride * half);
+        }
+        // 입력 N <- 출력 N (CreateBuffers 와 같은 규칙)
+        for (int i = 0; i < numInputs && i < numOutputs; i++) {
+            VirtualChannels::LoopbackCopy copy;
+            for (int half = 0; half < 2; half++) {
+                copy.input[half] = inputs[half][i];
+                copy.output[half] = outputs[half][i];
+            }
+            loopbacks.push_back(copy);
+        }
+    }
+    ~VirtualDevice() { free(arena); }
+
+    size_t Bytes() const { return (size_t)frames * sizeof(float); }
+
+    void Prepare(long index) {
+        VirtualChannels::PrepareBlock(loopbacks, index, Bytes(), outputs[index][0], outputs[index][1]);
+    }
+
+    // 이전 방식: 모든 출력 클리어
+    void PrepareClearAll(long index) {
+        for (float* out : outputs[index]) memset(out, 0, Bytes());
+    }
+};
+
+static void TestLoopback() {
+    printf("Loopback contents\n");
+    const int channels = 8;
+    VirtualDevice device(256, channels, channels);
+    size_t mismatches = 0, dirtyCast = 0;
+    for (long block = 0; block < 16; block++) {
+        long index = block % 2;
+        device.Prepare(index);
+        for (int c = 0; c < channels; c++) {
+            for (long n = 0; n < device.frames; n++) {
+                // 입력은 직전 블록에서 호스트가 쓴 값 (첫 블록은 무음)
+                float expect = (block == 0) ? 0.0f : (float)((block - 1) * 1000 + c);
+                if (device.inputs[index][c][n] != expect) mismatches++;
+                if (c < 2 && device.outputs[index][c][n] != 0.0f) dirtyCast++;
+            }
+        }
+        // 호스트: 모든 출력에 블록 번호 기록
+        for (int c = 0; c < channels; c++) {
+            for (long n = 0; n < device.frames; n++) device.outputs[index][c][n] = (float)(block * 1000 + c);
+        }
+    }
+    CHECK(mismatches == 0, "%zu loopback samples differ from the previous output", mismatches);
+    CHECK(dirtyCast == 0, "%zu cast samples not cleared", dirtyCast);
+}
+
+template <typename Fn>
+static double NsPerBlock(VirtualDevice& device, Fn prepare) {
+    const int iterations = 200000;
+    for (int i = 0; i < 1000; i++) prepare(device, i & 1);
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++) prepare(device, i & 1);
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+}
+
+static void Bench(long bufferSize) {
+    printf("Per block, %ld frames\n", bufferSize);
+    printf("  %8s %14s %14s %14s\n", "channels", "outputs only", "clear all", "+N loopbacks");
+    for (int channels : { 2, 8, 32 }) {
+        VirtualDevice outputsOnly(bufferSize, channels, 0);
+        VirtualDevice withInputs(bufferSize, channels, channels);
+        double now = NsPerBlock(outputsOnly, [](VirtualDevice& d, long index) { d.Prepare(index); });
+        double before = NsPerBlock(outputsOnly, [](VirtualDevice& d, long index) { d.PrepareClearAll(index); });
+        double loop = NsPerBlock(withInputs, [](VirtualDevice& d, long index) { d.Prepare(index); });
+        printf("  %8d %11.0f ns %11.0f ns %11.0f ns\n", channels, now, before, loop);
+    }
+}
+
+int main(int argc, char** argv) {
+    TestLoopback();
+    if (argc > 1) Bench(atol(argv[1]));
+    else for (long frames : { 128L, 256L, 441L }) Bench(frames);
+    printf(g_failures ? "FAILED (%d)\n" : "PASSED\n", g_failures);
+    return g_failures ? 1 : 0;
+}
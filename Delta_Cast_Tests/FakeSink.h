@@ -0,0 +1,119 @@
+﻿#pragma once
+#include "OutputSink.h"
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// 스크립트 싱크 (테스트 전용): PacedSink 주기로 돌면서 열기 실패/장치 소실을 주입하고 호출을 기록
+// - FailOpens(device, n): 그 장치 열기를 n 번 실패 (FAIL_ALWAYS 면 계속)
+// - InjectLoss(): 다음 WaitForPeriod 가 Lost
+// - 기록: 열기 시도 (장치, 시각, 결과), Start 횟수, 주기 수, 첫 유음 주기 시각
+// - StartCapture(frames): 이후 출력을 미리 잡아 둔 버퍼에 기록 (가득 차면 멈춤)
+// 열기 기록은 렌더 스레드의 비실시간 경로에서만 잠금, 주기 경로 (OnData) 는 원자 변수만
+// ---------------------------------------------------------------------------
+class FakeSink : public PacedSink {
+public:
+    static const int FAIL_ALWAYS = -1;
+
+    struct OpenCall {
+        std::wstring deviceId;
+        Clock::time_point at;
+        bool ok = false;
+    };
+
+    const char* GetName() const override { return "Fake"; }
+
+    void FailOpens(const std::wstring& deviceId, int count) {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_failures[deviceId] = count;
+    }
+    void InjectLoss() { m_loseNext.store(true, std::memory_order_release); }
+
+    std::vector<OpenCall> GetOpenCalls() const {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_opens;
+    }
+    int GetStartCount() const { return m_starts.load(); }
+    uint64_t GetPeriods() const { return m_periods.load(); }
+    // 마지막으로 Lost 를 돌려준 시각
+    Clock::time_point GetLostAt() const { return Clock::time_point(Clock::duration(m_lostAt.load())); }
+
+    // 이후 처음으로 0 이 아닌 샘플을 받은 시각 (아직 없으면 time_point{})
+    void ResetAudible() { m_firstAudible.store(0); }
+    Clock::time_point GetFirstAudibleAt() const { return Clock::time_point(Clock::duration(m_firstAudible.load())); }
+
+    // 출력 기록 (엔진 Start 전에 호출, 렌더 스레드는 자리만 채움)
+    void StartCapture(size_t frames) {
+        m_capturing.store(false);
+        m_capture.assign(frames * 2, 0.0f);
+        m_captured.store(0);
+        m_capturing.store(true);
+    }
+    // 기록한 스테레오 인터리브 (기록을 멈춘 뒤 호출)
+    std::vector<float> StopCapture() {
+        m_capturing.store(false);
+        std::vector<float> out(m_capture.begin(), m_capture.begin() + m_captured.load() * 2);
+        return out;
+    }
+
+    bool Start() override {
+        m_starts.fetch_add(1);
+        return PacedSink::Start();
+    }
+
+    SinkStatus WaitForPeriod(uint32_t timeoutMs) override {
+        if (m_loseNext.exchange(false, std::memory_order_acq_rel)) {
+            m_lostAt.store(Clock::now().time_since_epoch().count());
+            return SinkStatus::Lost;
+        }
+        return PacedSink::WaitForPeriod(timeoutMs);
+    }
+
+protected:
+    bool OnOpen(const std::wstring& deviceId) override {
+        std::lock_guard<std::mutex> lock(m_lock);
+        bool ok = true;
+        auto it = m_failures.find(deviceId);
+        if (it != m_failures.end() && it->second != 0) {
+            ok = false;
+            if (it->second > 0) it->second--;
+        }
+        m_opens.push_back({ deviceId, Clock::now(), ok });
+        return ok;
+    }
+
+    void OnData(const float* interleaved, uint32_t frames) override {
+        m_periods.fetch_add(1, std::memory_order_relaxed);
+        if (m_capturing.load(std::memory_order_acquire)) {
+            size_t used = m_captured.load(std::memory_order_relaxed);
+            size_t count = std::min<size_t>(frames, m_capture.size() / 2 - used);
+            memcpy(m_capture.data() + used * 2, interleaved, count * 2 * sizeof(float));
+            m_captured.store(used + count, std::memory_order_release);
+        }
+        if (m_firstAudible.load(std::memory_order_relaxed) != 0) return;
+        for (size_t n = 0; n < (size_t)frames * m_format.channels; n++) {
+            if (interleaved[n] != 0.0f) {
+                m_firstAudible.store(Clock::now().time_since_epoch().count());
+                break;
+            }
+        }
+    }
+
+private:
+    mutable std::mutex m_lock;
+    std::map<std::wstring, int> m_failures;
+    std::vector<OpenCall> m_opens;
+    std::atomic<bool> m_loseNext{ false };
+    std::atomic<int> m_starts{ 0 };
+    std::atomic<uint64_t> m_periods{ 0 };
+    std::atomic<int64_t> m_lostAt{ 0 };
+    std::atomic<int64_t> m_firstAudible{ 0 };
+    std::vector<float> m_capture;
+    std::atomic<size_t> m_captured{ 0 };
+    std::atomic<bool> m_capturing{ false };
+};
@@ -0,0 +1,251 @@
+﻿// ---------------------------------------------------------------------------
+// 공유 메모리 송출 (DeltaCastIpc) 테스트 클라이언트 - Linux POSIX shm / futex 경로
+// 기본: 자체 시험
+// - 슬롯: 살아 있는 쓰기측이 있으면 두 번째 쓰기측은 다음 슬롯을 씀
+// - 헤더 검증: channels / ringBytes 가 매핑을 넘으면 읽지 않음, 범위 밖 채널은 0
+// - 레이트 변경: 리더가 세션 변경으로 새 레이트를 보고 그 뒤의 블록만 읽는지
+// - 깨우기: 리더 프로세스 2개가 블록마다 모두 깨는지, 쓰기 -> 리더 깨어남 지연 (p50/p99/max)
+// --attach [slot]: 실행 중인 쓰기측에 붙어 지연/손실을 1초마다 출력
+//
+// Linux: g++ -O2 -std=c++20 -pthread -I../Delta_Cast IpcClient.cpp -o ipc_client -lrt
+// ---------------------------------------------------------------------------
+#include "DeltaCastIpc.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int g_failures = 0;
+#define CHECK(cond, ...) do { if (!(cond)) { g_failures++; printf("  FAIL line %d: ", __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+static const uint32_t RATE = 48000;
+static const uint32_t BLOCK_FRAMES = 256;
+static const uint64_t RING_BYTES = 65536;
+
+struct WakeStats {
+    uint64_t wakes = 0;
+    uint64_t bytes = 0;
+    uint64_t dropped = 0;
+    std::vector<uint64_t> latencyNs;
+};
+
+static double Percentile(std::vector<uint64_t> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return (double)v[(size_t)(q * (double)(v.size() - 1))];
+}
+
+// 깨어날 때마다 쓰기 시각과의 차이를 잼 (깨어남 + 스케줄링 지연)
+static void ReadUntil(DeltaCastIpc::Reader& reader, WakeStats& stats, uint64_t targetBytes, uint32_t idleMs) {
+    DeltaCastIpc::Span span;
+    while (stats.bytes < targetBytes) {
+        if (!reader.Wait(idleMs)) break;
+        uint64_t now = DeltaCastIpc::NowNs();
+        uint64_t written = reader.GetHeader()->writeTimeNs.load(std::memory_order_acquire);
+        stats.wakes++;
+        if (written && now > written) stats.latencyNs.push_back(now - written);
+        size_t bytes = reader.Peek(0, 1 << 20, span);
+        if (reader.Consume(bytes)) stats.bytes += bytes;
+    }
+    stats.dropped = reader.GetDroppedBytes();
+}
+
+static void PrintLatency(const char* label, const WakeStats& s) {
+    printf("  %s: %llu wakes, %llu bytes, dropped %llu, latency p50 %.1f us, p99 %.1f us, max %.1f us\n", label,
+        (unsigned long long)s.wakes, (unsigned long long)s.bytes, (unsigned long long)s.dropped,
+        Percentile(s.latencyNs, 0.5) * 1e-3, Percentile(s.latencyNs, 0.99) * 1e-3,
+        s.latencyNs.empty() ? 0.0 : *std::max_element(s.latencyNs.begin(), s.latencyNs.end()) * 1e-3);
+}
+
+static void TestSlots() {
+    printf("Writer slots\n");
+    DeltaCastIpc::Writer first, second;
+    CHECK(first.Create(2, 19, 4, RATE, RING_BYTES), "first create");
+    CHECK(second.Create(2, 19, 4, RATE, RING_BYTES), "second create");
+    printf("  first slot %d, second slot %d\n", first.GetSlot(), second.GetSlot());
+    CHECK(first.GetSlot() >= 0 && second.GetSlot() >= 0 && first.GetSlot() != second.GetSlot(), "slots must differ");
+
+    // 리더는 각자 슬롯의 세션만 봄
+    DeltaCastIpc::Reader reader;
+    CHECK(reader.Open((uint32_t)second.GetSlot()), "open second slot");
+    std::vector<float> block(BLOCK_FRAMES, 0.5f);
+    const void* channels[2] = { block.data(), block.data() };
+    first.Write(channels, block.size() * sizeof(float));
+    CHECK(reader.Available() == 0, "first writer leaked into second slot");
+    second.Write(channels, block.size() * sizeof(float));
+    CHECK(reader.Available() == block.size() * sizeof(float), "second slot available %zu", reader.Available());
+
+    // 쓰기측이 닫히면 그 슬롯은 다시 쓸 수 있음
+    int freed = first.GetSlot();
+    first.Close();
+    DeltaCastIpc::Writer third;
+    CHECK(third.Create(2, 19, 4, RATE, RING_BYTES) && third.GetSlot() == freed, "freed slot %d reused as %d", freed, third.GetSlot());
+}
+
+static void TestHeaderValidation() {
+    printf("Header validation\n");
+    DeltaCastIpc::Writer writer;
+    CHECK(writer.Create(2, 19, 4, RATE, RING_BYTES), "create");
+    DeltaCastIpc::Reader reader;
+    CHECK(reader.Open((uint32_t)writer.GetSlot()), "open");
+
+    std::vector<float> block(BLOCK_FRAMES, 0.25f);
+    const void* channels[2] = { block.data(), block.data() };
+    writer.Write(channels, block.size() * sizeof(float));
+    DeltaCastIpc::Span span;
+    CHECK(reader.Peek(0, 1 << 20, span) == block.size() * sizeof(float), "peek ch0");
+    CHECK(reader.Peek(2, 1 << 20, span) == 0 && span.bytes[0] == 0, "peek ch2 of 2 must be empty");
+    CHECK(reader.Peek(7, 1 << 20, span) == 0, "peek ch7 of 2 must be empty");
+
+    // 손상된 헤더 (다른 버전의 쓰기측 등): 새 세션에서 매핑 밖을 가리키면 거부
+    DeltaCastIpc::Header* h = writer.GetHeader();
+    h->channels = 8;
+    h->sessionId.fetch_add(1);
+    CHECK(reader.Available() == 0 && !reader.IsValid(), "8 channels over a 2 channel mapping accepted");
+    CHECK(reader.Peek(5, 1 << 20, span) == 0, "peek past mapping");
+
+    h->channels = 2;
+    h->ringBytes = RING_BYTES * 4;
+    h->sessionId.fetch_add(1);
+    CHECK(reader.Available() == 0 && !reader.IsValid(), "ring larger than mapping accepted");
+
+    h->ringBytes = RING_BYTES - 1;
+    h->sessionId.fetch_add(1);
+    CHECK(!reader.Resync(), "non power of two ring accepted");
+
+    // 복구된 세션: 다시 맞춘 위치부터 읽음
+    h->ringBytes = RING_BYTES;
+    h->sessionId.fetch_add(1);
+    CHECK(reader.Available() == 0 && reader.IsValid(), "restored header rejected");
+    writer.Write(channels, block.size() * sizeof(float));
+    CHECK(reader.Available() == block.size() * sizeof(float), "restored session available %zu", reader.Available());
+}
+
+static void TestRateChange() {
+    printf("Rate change\n");
+    DeltaCastIpc::Writer writer;
+    CHECK(writer.Create(2, 19, 4, RATE, RING_BYTES), "create");
+    DeltaCastIpc::Reader reader;
+    CHECK(reader.Open((uint32_t)writer.GetSlot()), "open");
+
+    std::vector<float> block(BLOCK_FRAMES, 0.5f);
+    const void* channels[2] = { block.data(), block.data() };
+    writer.Write(channels, block.size() * sizeof(float));
+    uint32_t session = reader.GetHeader()->sessionId.load();
+
+    // 드라이버 콜백: 레이트 표시 후 같은 블록부터 새 레이트
+    writer.SetSampleRate(44100.0);
+    writer.Write(channels, block.size() * sizeof(float));
+    const DeltaCastIpc::Header* h = reader.GetHeader();
+    CHECK(h->sessionId.load() != session, "session not bumped");
+    CHECK(h->sampleRate.load() == 44100.0, "header rate %.0f", h->sampleRate.load());
+    // 이전 레이트의 블록은 버리고 다시 맞춘 위치부터 읽음
+    CHECK(reader.Available() == 0 && reader.IsValid(), "old rate data still readable");
+    writer.Write(channels, block.size() * sizeof(float));
+    CHECK(reader.Available() == block.size() * sizeof(float), "new rate available %zu", reader.Available());
+}
+
+// 리더 프로세스 2개 + 쓰기측 (실시간 속도 블록)
+static void TestWakeAllReaders(double seconds) {
+    printf("Wake all readers (%u frames @ %u Hz, %.1f s)\n", BLOCK_FRAMES, RATE, seconds);
+    DeltaCastIpc::Writer writer;
+    CHECK(writer.Create(2, 19, 4, RATE, RING_BYTES), "create");
+    if (!writer.IsOpen()) return;
+
+    const size_t blockBytes = BLOCK_FRAMES * sizeof(float);
+    const uint64_t blocks = (uint64_t)(seconds * RATE / BLOCK_FRAMES);
+    const uint64_t totalBytes = blocks * blockBytes;
+    const uint32_t slot = (uint32_t)writer.GetSlot();
+
+    int pipes[2][2];
+    pid_t pids[2];
+    fflush(stdout);
+    for (int r = 0; r < 2; r++) {
+        if (pipe(pipes[r]) != 0) { CHECK(false, "pipe"); return; }
+        pids[r] = fork();
+        if (pids[r] == 0) {
+            // 자식: 부모의 쓰기측 소멸자가 돌지 않도록 _exit
+            DeltaCastIpc::Reader reader;
+            WakeStats stats;
+            char ready = reader.Open(slot) ? 1 : 0;
+            if (write(pipes[r][1], &ready, 1) != 1) _exit(2);
+            if (ready) ReadUntil(reader, stats, totalBytes, 1000);
+            char label[32];
+            snprintf(label, sizeof(label), "reader %d", r);
+            PrintLatency(label, stats);
+            fflush(stdout);
+            // 블록마다 깨어나야 함 (합쳐진 깨어남은 소수만 허용), 손실 없음
+            bool ok = stats.bytes == totalBytes && stats.dropped == 0 && stats.wakes * 10 >= blocks * 9;
+            _exit(ok ? 0 : 1);
+        }
+        char ready = 0;
+        if (read(pipes[r][0], &ready, 1) != 1 || !ready) CHECK(false, "reader %d failed to open slot %u", r, slot);
+        close(pipes[r][0]);
+        close(pipes[r][1]);
+    }
+
+    // 두 리더가 대기에 들어갈 시간을 줌
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::vector<float> block(BLOCK_FRAMES, 0.0f);
+    const void* channels[2] = { block.data(), block.data() };
+    auto period = std::chrono::nanoseconds((uint64_t)BLOCK_FRAMES * 1000000000ull / RATE);
+    auto next = std::chrono::steady_clock::now();
+    for (uint64_t b = 0; b < blocks; b++) {
+        next += period;
+        std::this_thread::sleep_until(next);
+        block[0] = (float)b;
+        writer.Write(channels, blockBytes);
+    }
+
+    for (int r = 0; r < 2; r++) {
+        int status = 0;
+        waitpid(pids[r], &status, 0);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0, "reader %d missed blocks (status %d)", r, status);
+    }
+    printf("  writer: %llu blocks, %llu bytes\n", (unsigned long long)blocks, (unsigned long long)totalBytes);
+}
+
+// 실행 중인 쓰기측(드라이버 등)에 붙어 지연 출력
+static int Attach(uint32_t slot) {
+    DeltaCastIpc::Reader reader;
+    if (!reader.Open(slot)) {
+        printf("slot %u: no writer\n", slot);
+        return 1;
+    }
+    const DeltaCastIpc::Header* h = reader.GetHeader();
+    printf("slot %u: %u ch, type %d, %u bytes/sample, %.0f Hz, ring %llu bytes\n", slot, h->channels, h->sampleType,
+        h->sampleSize, h->sampleRate.load(), (unsigned long long)h->ringBytes);
+    for (;;) {
+        WakeStats stats;
+        auto end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        DeltaCastIpc::Span span;
+        while (std::chrono::steady_clock::now() < end) {
+            if (!reader.Wait(100)) continue;
+            uint64_t now = DeltaCastIpc::NowNs();
+            uint64_t written = h->writeTimeNs.load(std::memory_order_acquire);
+            stats.wakes++;
+            if (written && now > written) stats.latencyNs.push_back(now - written);
+            size_t bytes = reader.Peek(0, 1 << 20, span);
+            if (reader.Consume(bytes)) stats.bytes += bytes;
+        }
+        stats.dropped = reader.GetDroppedBytes();
+        PrintLatency("1 s", stats);
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--attach") == 0) return Attach(argc > 2 ? (uint32_t)atoi(argv[2]) : 0);
+    TestSlots();
+    TestHeaderValidation();
+    TestRateChange();
+    TestWakeAllReaders(2.0);
+    printf(g_failures ? "FAILED (%d)\n" : "PASSED\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,257 @@
+﻿// ---------------------------------------------------------------------------
+// 트루피크 리미터 (Limiter.h / TruePeak.h) 테스트
+// 기준 측정: 16배 오버샘플 (Blackman-Harris 창 sinc, 양쪽 64 샘플, double) 로 샘플 사이 피크를 잼
+// - 검출기: 임펄스가 DETECT_DELAY 뒤에 나오는지, 샘플 사이 피크를 PHASE_GAP_RATIO 이내로 잡는지
+// - 실링: 실링보다 12 dB 큰 톤/버스트/잡음을 넣었을 때 출력의 16배 트루피크가 실링을 넘지 않는지
+//   잡음은 0.45 fs 이하로 대역 제한 (44.1 kHz 에서 20 kHz, 나이퀴스트 바로 밑 성분은 유한 탭 보간으로 잡을 수 없음)
+//   실링보다 과하게 낮지도 않은지 (검출기 페이즈 여유 -0.17 dB + 여유)
+// - 지연: 실링 아래 신호가 GetLatencyFrames() 만큼 밀린 그대로 나오는지 (레이트, 룩어헤드, 블록 크기별)
+//
+// Linux: g++ -O2 -std=c++20 -mavx2 -mfma -I../Delta_Cast LimiterTest.cpp -o limiter_test
+// ---------------------------------------------------------------------------
+#include "Limiter.h"
+#include "TruePeak.h"
+
+#include <cstdio>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static int g_failures = 0;
+#define CHECK(cond, ...) do { if (!(cond)) { g_failures++; printf("  FAIL line %d: ", __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+static const double PI = 3.14159265358979323846;
+
+static double ToDb(double v) { return 20.0 * std::log10(std::max(v, 1e-12)); }
+
+// 16배 오버샘플 트루피크 (기준). [from, to) 의 출력만 봄 (앞뒤는 보간 창을 채우는 문맥)
+static double TruePeak16(const std::vector<float>& x, size_t from, size_t to) {
+    const int OVERSAMPLE = 16;
+    const int HALF = 64;
+    // 페이즈별 계수 (창 sinc)
+    std::vector<double> coeffs((size_t)OVERSAMPLE * HALF * 2);
+    for (int p = 0; p < OVERSAMPLE; p++) {
+        double t = (double)p / OVERSAMPLE;
+        for (int k = 0; k < HALF * 2; k++) {
+            double d = t - (k - (HALF - 1));
+            double sinc = (std::abs(d) < 1e-12) ? 1.0 : std::sin(PI * d) / (PI * d);
+            double w = (d + HALF) / (2.0 * HALF);   // 0..1
+            double window = 0.35875 - 0.48829 * std::cos(2.0 * PI * w) + 0.14128 * std::cos(4.0 * PI * w) - 0.01168 * std::cos(6.0 * PI * w);
+            coeffs[(size_t)p * HALF * 2 + k] = sinc * window;
+        }
+    }
+    double peak = 0.0;
+    for (size_t i = from; i < to; i++) {
+        peak = std::max(peak, (double)std::abs(x[i]));
+        for (int p = 1; p < OVERSAMPLE; p++) {
+            double acc = 0.0;
+            const double* c = &coeffs[(size_t)p * HALF * 2];
+            for (int k = 0; k < HALF * 2; k++) {
+                int64_t j = (int64_t)i + k - (HALF - 1);
+                if (j >= 0 && j < (int64_t)x.size()) acc += c[k] * x[(size_t)j];
+            }
+            peak = std::max(peak, std::abs(acc));
+        }
+    }
+    return peak;
+}
+
+// 창 sinc 저역 통과 (cutoff: fs 비율)
+static std::vector<float> Lowpass(const std::vector<float>& x, double cutoff) {
+    const int HALF = 64;
+    std::vector<double> taps(HALF * 2 + 1);
+    for (int k = -HALF; k <= HALF; k++) {
+        double sinc = (k == 0) ? 2.0 * cutoff : std::sin(2.0 * PI * cutoff * k) / (PI * k);
+        double window = 0.42 + 0.5 * std::cos(PI * k / (HALF + 1)) + 0.08 * std::cos(2.0 * PI * k / (HALF + 1));
+        taps[k + HALF] = sinc * window;
+    }
+    std::vector<float> y(x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        double acc = 0.0;
+        for (int k = -HALF; k <= HALF; k++) {
+            int64_t j = (int64_t)i + k;
+            if (j >= 0 && j < (int64_t)x.size()) acc += taps[k + HALF] * x[(size_t)j];
+        }
+        y[i] = (float)acc;
+    }
+    return y;
+}
+
+// 레이트 rate 의 톤 (phase: 시작 위상)
+static std::vector<float> Tone(double rate, double hz, double amplitude, size_t frames, double phase = 0.0) {
+    std::vector<float> x(frames);
+    for (size_t n = 0; n < frames; n++) x[n] = (float)(amplitude * std::sin(2.0 * PI * hz * n / rate + phase));
+    return x;
+}
+
+// ---------------------------------------------------------------------------
+// 검출기
+// ---------------------------------------------------------------------------
+static void TestDetector() {
+    printf("True peak detector\n");
+    TruePeakDetector detector;
+    detector.Setup(Limiter::MAX_BLOCK);
+
+    // 임펄스: 출력 i 는 입력 i - DETECT_DELAY 와 다음 샘플 사이
+    std::vector<float> impulse(64, 0.0f), peak(64);
+    impulse[10] = 1.0f;
+    detector.Process(impulse.data(), impulse.size(), peak.data(), false);
+    CHECK(peak[10 + TruePeakDetector::DETECT_DELAY] == 1.0f, "impulse peak %.4f at +DETECT_DELAY", peak[10 + TruePeakDetector::DETECT_DELAY]);
+    for (size_t i = 0; i < 10 + TruePeakDetector::DETECT_DELAY - TruePeakDetector::TAPS / 2; i++) {
+        CHECK(peak[i] == 0.0f, "detector output %zu = %.4f before the impulse reached the window", i, peak[i]);
+    }
+
+    // 샘플 사이 피크: fs/4 톤을 45 도 어긋나게 (샘플은 0.707, 실제 피크 1.0) 등
+    const double rate = 48000.0;
+    struct Case { double hz; double phase; };
+    for (const Case& c : { Case{ 997.0, 0.0 }, Case{ 12000.0, PI / 4.0 }, Case{ 15000.0, 0.3 }, Case{ 19000.0, 0.7 } }) {
+        std::vector<float> x = Tone(rate, c.hz, 0.5, 4096, c.phase);
+        std::vector<float> out(x.size());
+        detector.Reset();
+        for (size_t pos = 0; pos < x.size(); pos += Limiter::MAX_BLOCK) {
+            size_t n = std::min(x.size() - pos, Limiter::MAX_BLOCK);
+            detector.Process(x.data() + pos, n, out.data() + pos, false);
+        }
+        double samplePeak = 0.0, detected = 0.0;
+        for (size_t i = 256; i < x.size() - 256; i++) {
+            samplePeak = std::max(samplePeak, (double)std::abs(x[i]));
+            detected = std::max(detected, (double)out[i]);
+        }
+        double reference = TruePeak16(x, 256, x.size() - 256);
+        printf("  %5.0f Hz: sample peak %+.2f dB, detector %+.2f dB, 16x %+.2f dB\n",
+            c.hz, ToDb(samplePeak / 0.5), ToDb(detected / 0.5), ToDb(reference / 0.5));
+        CHECK(std::abs(ToDb(reference / 0.5)) < 0.01, "%.0f Hz reference true peak %+.3f dB (expected 0)", c.hz, ToDb(reference / 0.5));
+        CHECK(detected >= samplePeak, "%.0f Hz detector below the sample peak", c.hz);
+        // 페이즈 사이 피크로 놓칠 수 있는 양 이내 (리미터가 실링에서 빼는 여유)
+        CHECK(detected >= reference * TruePeakDetector::PHASE_GAP_RATIO, "%.0f Hz detector under-reads by %.2f dB", c.hz, ToDb(reference / detected));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 실링
+// ---------------------------------------------------------------------------
+static std::vector<float> RunLimiter(const LimiterSettings& settings, double rate, std::vector<float> left, std::vector<float> right, size_t block) {
+    Limiter limiter;
+    limiter.Setup(settings, rate);
+    for (size_t pos = 0; pos < left.size(); pos += block) {
+        size_t n = std::min(block, left.size() - pos);
+        limiter.Process(left.data() + pos, right.data() + pos, n);
+    }
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+}
+
+static void TestCeiling() {
+    printf("Ceiling under 16x true peak\n");
+    const double rate = 48000.0;
+    const size_t frames = (size_t)rate / 2;
+    const double drive = std::pow(10.0, 12.0 / 20.0);
+    LimiterSettings settings;
+    settings.enabled = true;
+    settings.ceilingDb = -1.0;
+
+    struct Signal { std::string name; std::vector<float> left, right; };
+    std::vector<Signal> signals;
+    for (double hz : { 997.0, 6000.0, 12000.0, 17000.0, 19500.0 }) {
+        signals.push_back({ std::to_string((int)hz) + " Hz", Tone(rate, hz, drive, frames, PI / 4.0), Tone(rate, hz, drive, frames, PI / 3.0) });
+    }
+    // 버스트: 무음 뒤 갑자기 큰 고역 톤 (어택), 짧은 간격으로 반복 (릴리즈 중 재어택)
+    {
+        std::vector<float> burst(frames, 0.0f);
+        std::vector<float> tone = Tone(rate, 11000.0, drive, frames, 0.4);
+        // 가장자리 0.5 ms 코사인 (사각 게이트는 대역 제한이 아니어서 입력 자체의 트루피크가 정의되지 않음)
+        const size_t edge = 24;
+        for (size_t n = 0; n < frames; n++) {
+            size_t pos = n % 2400;
+            if (pos < 480 || pos >= 960) continue;
+            size_t fromEdge = std::min(pos - 480, 959 - pos);
+            double env = (fromEdge >= edge) ? 1.0 : 0.5 - 0.5 * std::cos(PI * fromEdge / edge);
+            burst[n] = (float)(tone[n] * env);
+        }
+        signals.push_back({ "11 kHz bursts", burst, burst });
+    }
+    // 잡음 (양 채널 독립): 고역이 가장 많은 대역 제한 / 중역까지
+    for (double cutoff : { 0.45, 0.3 }) {
+        std::vector<float> l(frames), r(frames);
+        uint32_t seed = 12345;
+        auto next = [&]() { seed = seed * 1664525u + 1013904223u; return (float)((seed >> 8) / 8388608.0 - 1.0); };
+        for (size_t n = 0; n < frames; n++) { l[n] = (float)drive * next(); r[n] = (float)drive * next(); }
+        char name[32];
+        snprintf(name, sizeof(name), "noise < %.2f fs", cutoff);
+        signals.push_back({ name, Lowpass(l, cutoff), Lowpass(r, cutoff) });
+    }
+
+    const double ceiling = std::pow(10.0, settings.ceilingDb / 20.0);
+    for (const Signal& s : signals) {
+        std::vector<float> out = RunLimiter(settings, rate, s.left, s.right, 480);
+        std::vector<float> left(out.begin(), out.begin() + frames), right(out.begin() + frames, out.end());
+        // 앞의 시작 계단과 끝의 잘린 부분은 제외
+        double peak = std::max(TruePeak16(left, 256, frames - 256), TruePeak16(right, 256, frames - 256));
+        printf("  %-14s out %+.3f dBTP (ceiling %+.1f)\n", s.name.c_str(), ToDb(peak), settings.ceilingDb);
+        CHECK(peak <= ceiling * 1.0001, "%s overshoots the ceiling: %+.3f dBTP", s.name.c_str(), ToDb(peak));
+        CHECK(ToDb(peak) > settings.ceilingDb - 0.5, "%s limited %.3f dB below the ceiling", s.name.c_str(), settings.ceilingDb - ToDb(peak));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 지연
+// ---------------------------------------------------------------------------
+static void TestLatency() {
+    printf("Latency\n");
+    for (double rate : { 44100.0, 48000.0, 96000.0 }) {
+        for (double lookaheadMs : { 0.1, 0.25, 1.5, 5.0 }) {
+            LimiterSettings settings;
+            settings.enabled = true;
+            settings.lookaheadMs = lookaheadMs;
+            settings.ceilingDb = -1.0;
+            Limiter probe;
+            probe.Setup(settings, rate);
+            size_t latency = probe.GetLatencyFrames();
+            CHECK(latency == Limiter::LatencyFramesFor(settings, rate), "GetLatencyFrames %zu, LatencyFramesFor %zu", latency, Limiter::LatencyFramesFor(settings, rate));
+
+            // 실링 아래 신호 (게인 1): 출력 n = 입력 n - latency
+            const size_t frames = 4096;
+            std::vector<float> left(frames), right(frames);
+            uint32_t seed = 777;
+            for (size_t n = 0; n < frames; n++) {
+                seed = seed * 1664525u + 1013904223u;
+                left[n] = (float)((seed >> 8) / 8388608.0 - 1.0) * 0.25f;
+                right[n] = -left[n] * 0.5f;
+            }
+            for (size_t block : { (size_t)1, (size_t)37, (size_t)480, (size_t)3000 }) {
+                std::vector<float> out = RunLimiter(settings, rate, left, right, block);
+                size_t mismatches = 0;
+                for (size_t n = 0; n < frames; n++) {
+                    float expectL = (n >= latency) ? left[n - latency] : 0.0f;
+                    float expectR = (n >= latency) ? right[n - latency] : 0.0f;
+                    if (out[n] != expectL || out[frames + n] != expectR) mismatches++;
+                }
+                CHECK(mismatches == 0, "%.0f Hz, lookahead %.2f ms, block %zu: %zu samples differ from input delayed %zu", rate, lookaheadMs, block, mismatches, latency);
+            }
+
+            // 리미팅 중에도 같은 지연: 큰 클릭의 위치
+            std::vector<float> click(frames, 0.0f);
+            click[1000] = 4.0f;
+            std::vector<float> out = RunLimiter(settings, rate, click, click, 480);
+            size_t at = 0;
+            for (size_t n = 0; n < frames; n++) if (std::abs(out[n]) > std::abs(out[at])) at = n;
+            CHECK(at == 1000 + latency, "%.0f Hz, lookahead %.2f ms: limited click at +%zu, latency %zu", rate, lookaheadMs, at - 1000, latency);
+            printf("  %5.0f Hz, lookahead %.2f ms: %zu frames (%.3f ms)\n", rate, lookaheadMs, latency, latency * 1000.0 / rate);
+        }
+    }
+
+    // 꺼져 있으면 지연 0
+    LimiterSettings off;
+    Limiter limiter;
+    limiter.Setup(off, 48000.0);
+    CHECK(limiter.GetLatencyFrames() == 0, "disabled limiter reports %zu frames", limiter.GetLatencyFrames());
+}
+
+int main() {
+    TestDetector();
+    TestCeiling();
+    TestLatency();
+    printf(g_failures ? "FAILED (%d)\n" : "PASSED\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+﻿// ---------------------------------------------------------------------------
+// 라우드니스 미터 적합성 테스트 (LoudnessAnalyzer, EBU Tech 3341 최소 요구 사항과 같은 신호)
+// 스테레오 1 kHz 사인 (양 채널 같은 레벨, 레벨은 사인 피크 dBFS), 미터 스레드와 같이 블록 단위로 넣음
+// - 인티그레이티드 (3341 #1 ~ #5): -23 / -33 LUFS, 상대/절대 게이트, +-0.1 LU
+// - 숏텀 (#9): 1.34 s -20 dBFS / 1.66 s -30 dBFS 반복, 3 s 이후 매 홉 -23 +-0.1 LUFS
+// - 모멘터리 (#12): 0.18 s -20 dBFS / 0.22 s -30 dBFS 반복, 0.4 s 이후 매 홉 -23 +-0.1 LUFS
+// - 트루피크 (#15 ~ #18): fs/4, fs/6, fs/8 사인을 샘플 사이에 피크가 오게, -6 dBTP +0.2 / -0.4 dB
+//   구간 안쪽만 보도록 시작을 페이드 (깁스 현상 제외)
+// 44.1 / 48 / 96 kHz 에서 반복 (K-weighting 계수는 레이트별로 설계)
+//
+// Linux: g++ -O2 -std=c++20 -mavx2 -mfma -I../Delta_Cast LoudnessTest.cpp -o loudness_test
+// ---------------------------------------------------------------------------
+#include "Loudness.h"
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+
+static int g_failures = 0;
+#define CHECK(cond, ...) do { if (!(cond)) { g_failures++; printf("  FAIL line %d: ", __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+static const double PI = 3.14159265358979323846;
+static const double TOLERANCE_LU = 0.1;
+static const size_t BLOCK = 1000;   // 홉 (레이트 / 10) 과 어긋나는 블록 크기
+
+struct Segment {
+    double seconds;
+    double levelDb;     // 사인 피크 dBFS
+};
+
+// 홉마다의 스냅샷
+struct Trace {
+    std::vector<double> momentary;
+    std::vector<double> shortTerm;
+    DeltaCastIpc::MeterSnapshot last = {};
+};
+
+// 구간별 레벨의 1 kHz 사인 (위상 연속)을 블록 단위로 분석. fadeIn: 시작 코사인 페이드 길이 (초)
+static Trace Analyze(double rate, const std::vector<Segment>& segments, double hz = 1000.0, double phase = 0.0, double fadeIn = 0.0) {
+    LoudnessAnalyzer analyzer;
+    analyzer.Setup(rate);
+    Trace trace;
+    std::vector<float> left, right;
+    const size_t hop = (size_t)std::lround(rate / 10.0);
+    const double fadeFrames = fadeIn * rate;
+    uint64_t frame = 0, nextHop = hop;
+    for (const Segment& seg : segments) {
+        size_t frames = (size_t)std::llround(seg.seconds * rate);
+        double amplitude = std::pow(10.0, seg.levelDb / 20.0);
+        for (size_t pos = 0; pos < frames;) {
+            size_t n = std::min(BLOCK, frames - pos);
+            // 홉 경계에서 끊어 넣고 스냅샷 (미터 스레드는 아무 때나 읽지만 홉 단위로만 바뀜)
+            n = (size_t)std::min<uint64_t>(n, nextHop - frame);
+            left.resize(n);
+            right.resize(n);
+            for (size_t i = 0; i < n; i++) {
+                double t = (double)(frame + i);
+                double gain = (t < fadeFrames) ? 0.5 - 0.5 * std::cos(PI * t / fadeFrames) : 1.0;
+                left[i] = right[i] = (float)(gain * amplitude * std::sin(2.0 * PI * hz * t / rate + phase));
+            }
+            analyzer.Process(left.data(), right.data(), n);
+            frame += n;
+            pos += n;
+            if (frame == nextHop) {
+                analyzer.GetSnapshot(trace.last);
+                trace.momentary.push_back(trace.last.momentaryLufs);
+                trace.shortTerm.push_back(trace.last.shortTermLufs);
+                nextHop += hop;
+            }
+        }
+    }
+    analyzer.GetSnapshot(trace.last);
+    return trace;
+}
+
+// [fromHop, toHop) 의 최소/최대
+static void Range(const std::vector<double>& values, size_t fromHop, size_t toHop, double& lo, double& hi) {
+    lo = 1e9;
+    hi = -1e9;
+    for (size_t i = fromHop; i < toHop && i < values.size(); i++) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+}
+
+static void TestIntegrated(double rate) {
+    struct Case { const char* name; std::vector<Segment> segments; double expected; };
+    const Case cases[] = {
+        { "#1 -23 dBFS 20 s", { { 20.0, -23.0 } }, -23.0 },
+        { "#2 -33 dBFS 20 s", { { 20.0, -33.0 } }, -33.0 },
+        { "#3 -36/-23/-36", { { 10.0, -36.0 }, { 60.0, -23.0 }, { 10.0, -36.0 } }, -23.0 },
+        { "#4 -72/-36/-23/-36/-72", { { 10.0, -72.0 }, { 10.0, -36.0 }, { 60.0, -23.0 }, { 10.0, -36.0 }, { 10.0, -72.0 } }, -23.0 },
+        { "#5 -26/-20/-26", { { 20.0, -26.0 }, { 20.1, -20.0 }, { 20.0, -26.0 } }, -23.0 },
+    };
+    for (const Case& c : cases) {
+        Trace trace = Analyze(rate, c.segments);
+        double integrated = trace.last.integratedLufs;
+        printf("  %-24s I %+.2f LUFS (expected %+.1f)\n", c.name, integrated, c.expected);
+        CHECK(std::abs(integrated - c.expected) <= TOLERANCE_LU, "%.0f Hz %s: integrated %.2f LUFS", rate, c.name, integrated);
+    }
+
+    // 정상 상태의 모멘터리/숏텀 (#1, #2 의 3 s 이후)
+    for (double level : { -23.0, -33.0 }) {
+        Trace trace = Analyze(rate, { { 20.0, level } });
+        double mLo, mHi, sLo, sHi;
+        Range(trace.momentary, 30, trace.momentary.size(), mLo, mHi);
+        Range(trace.shortTerm, 30, trace.shortTerm.size(), sLo, sHi);
+        CHECK(mLo >= level - TOLERANCE_LU && mHi <= level + TOLERANCE_LU, "%.0f Hz %.0f dBFS: momentary %.2f..%.2f", rate, level, mLo, mHi);
+        CHECK(sLo >= level - TOLERANCE_LU && sHi <= level + TOLERANCE_LU, "%.0f Hz %.0f dBFS: short-term %.2f..%.2f", rate, level, sLo, sHi);
+    }
+
+    // 절대 게이트 (-70 LUFS) 아래뿐이면 표시값 바닥
+    Trace quiet = Analyze(rate, { { 5.0, -72.0 } });
+    CHECK(quiet.last.integratedLufs == DeltaCastIpc::METER_FLOOR_DB, "%.0f Hz: integrated %.2f for a signal under the absolute gate", rate, quiet.last.integratedLufs);
+}
+
+static void TestShortTerm(double rate) {
+    // #9: 3 s 주기 (숏텀 창과 같음) 이므로 창 위치와 무관하게 -23
+    std::vector<Segment> segments;
+    for (int i = 0; i < 20; i++) {
+        segments.push_back({ 1.34, -20.0 });
+        segments.push_back({ 1.66, -30.0 });
+    }
+    Trace trace = Analyze(rate, segments);
+    double lo, hi;
+    Range(trace.shortTerm, 30, trace.shortTerm.size(), lo, hi);
+    printf("  #9  short-term %+.2f..%+.2f LUFS\n", lo, hi);
+    CHECK(lo >= -23.0 - TOLERANCE_LU && hi <= -23.0 + TOLERANCE_LU, "%.0f Hz short-term %.2f..%.2f LUFS", rate, lo, hi);
+}
+
+static void TestMomentary(double rate) {
+    // #12: 0.4 s 주기 (모멘터리 창과 같음)
+    std::vector<Segment> segments;
+    for (int i = 0; i < 25; i++) {
+        segments.push_back({ 0.18, -20.0 });
+        segments.push_back({ 0.22, -30.0 });
+    }
+    Trace trace = Analyze(rate, segments);
+    double lo, hi;
+    Range(trace.momentary, 4, trace.momentary.size(), lo, hi);
+    printf("  #12 momentary %+.2f..%+.2f LUFS\n", lo, hi);
+    CHECK(lo >= -23.0 - TOLERANCE_LU && hi <= -23.0 + TOLERANCE_LU, "%.0f Hz momentary %.2f..%.2f LUFS", rate, lo, hi);
+}
+
+static void TestTruePeak(double rate) {
+    // 피크가 샘플 사이에 오도록 위상을 둔 사인 (샘플 피크는 최대 3 dB 낮음)
+    // 시작은 10 ms 페이드 (갑자기 시작하면 계단의 깁스 현상이 정상 상태 피크보다 크게 읽힘)
+    struct Case { const char* name; double divisor; double phaseDeg; };
+    const Case cases[] = {
+        { "#15 fs/4, 0 deg", 4.0, 0.0 },
+        { "#16 fs/4, 45 deg", 4.0, 45.0 },
+        { "#17 fs/6, 60 deg", 6.0, 60.0 },
+        { "#18 fs/8, 67.5 deg", 8.0, 67.5 },
+    };
+    for (const Case& c : cases) {
+        Trace trace = Analyze(rate, { { 1.5, -6.0 } }, rate / c.divisor, c.phaseDeg * PI / 180.0, 0.01);
+        double peak = std::max(trace.last.truePeakDb[0], trace.last.truePeakDb[1]);
+        printf("  %-20s true peak %+.2f dBTP\n", c.name, peak);
+        CHECK(peak >= -6.0 - 0.4 && peak <= -6.0 + 0.2, "%.0f Hz %s: true peak %.2f dBTP (expected -6.0 +0.2/-0.4)", rate, c.name, peak);
+    }
+}
+
+int main() {
+    for (double rate : { 44100.0, 48000.0, 96000.0 }) {
+        printf("%.0f Hz\n", rate);
+        TestIntegrated(rate);
+        TestShortTerm(rate);
+        TestMomentary(rate);
+        TestTruePeak(rate);
+    }
+    printf(g_failures ? "FAILED (%d)\n" : "PASSED\n", g_failures);
+    return g_failures ? 1 : 0;
+}
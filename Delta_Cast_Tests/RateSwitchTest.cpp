@@ -0,0 +1,202 @@
+﻿// ---------------------------------------------------------------------------
+// 재생 중 입력 레이트 변경 테스트 (렌더 엔진 + FakeSink, 48 kHz 출력)
+// 생산측은 1 kHz 톤을 시간 기준으로 이어서 만들고 레이트가 바뀌는 블록 직전에 ByteRingBuffer::MarkRate
+// 48k -> 44.1k -> 96k -> 48k 구간을 지나며
+// - 구간마다 출력 피치가 1 kHz 인지 (레이트 표시를 놓치면 비율만큼 어긋남)
+// - 비율이 표시 지점에서 바뀌는지: 출력 톤의 위상이 경계 앞뒤로 이어져야 함
+//   위상 차를 입력 프레임 어긋남으로 환산 (리샘플러가 넘겨받는 소수 위치만큼은 허용)
+// - 끊김/재버퍼링 없이 크로스페이드만 지나가는지 (엔진 끊김 횟수 0, 클릭/탈락 없음)
+//
+// 실시간 경로 검사 빌드 (DELTA_RT_CHECK): 렌더 주기 안의 할당/잠금도 실패로 셈
+//
+// Linux: g++ -O2 -std=c++20 -mavx2 -mfma -pthread -I../Delta_Cast -include AsioTypes.h RateSwitchTest.cpp ../Delta_Cast/RenderEngine.cpp ../Delta_Cast/Logger.cpp ../Delta_Cast/AudioArena.cpp ../Delta_Cast/ThreadPlacement.cpp -o rate_switch_test
+// 검사 빌드: 위 명령에 -DDELTA_RT_CHECK=1 -rdynamic ../Delta_Cast/RtCheck.cpp -ldl 추가
+// ---------------------------------------------------------------------------
+#include "RenderEngine.h"
+#include "FakeSink.h"
+#include "RtCheck.h"
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+
+using Clock = std::chrono::steady_clock;
+
+static int g_failures = 0;
+#define CHECK(cond, ...) do { if (!(cond)) { g_failures++; printf("  FAIL line %d: ", __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+static const double PI = 3.14159265358979323846;
+static const double TONE_HZ = 1000.0;
+static const float TONE_AMP = 0.25f;
+static const double OUT_RATE = 48000.0;
+static const double BLOCK_SEC = 0.005;
+static const double LEAD_SEC = 0.06;        // 생산측이 링에 앞서 채워 두는 양
+static const double THRESHOLD_SEC = 0.02;
+static const double GUARD_SEC = 0.012;      // 경계 앞뒤로 분석에서 뺄 구간 (크로스페이드 + 여유)
+static const double WINDOW_SEC = 0.02;      // 위상 측정 창 (1 kHz 20 주기)
+
+struct Segment {
+    double rate;
+    double seconds;
+};
+
+// 레이트가 바뀌어도 시간 기준으로 이어지는 톤 (구간 시작에 레이트 표시)
+struct Producer {
+    ByteRingBuffer& ringL;
+    ByteRingBuffer& ringR;
+    std::vector<Segment> segments;
+    std::atomic<bool> done{ false };
+
+    void Run() {
+        double phase = 0.0;
+        std::vector<float> block;
+        for (size_t s = 0; s < segments.size(); s++) {
+            const Segment& seg = segments[s];
+            size_t frames = (size_t)std::llround(seg.rate * seg.seconds);
+            size_t blockFrames = (size_t)std::llround(seg.rate * BLOCK_SEC);
+            bool marked = (s == 0);     // 첫 구간은 Start 의 레이트
+            for (size_t pos = 0; pos < frames;) {
+                // 링에 LEAD_SEC 만큼만 앞서 채움 (실시간 소비에 맞춰 천천히)
+                if (ringL.GetFillSize() >= (size_t)(seg.rate * LEAD_SEC) * sizeof(float)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
+                }
+                size_t count = std::min(blockFrames, frames - pos);
+                block.resize(count);
+                for (size_t n = 0; n < count; n++) {
+                    block[n] = TONE_AMP * (float)std::sin(phase);
+                    phase += 2.0 * PI * TONE_HZ / seg.rate;
+                    if (phase > 2.0 * PI) phase -= 2.0 * PI;
+                }
+                if (!marked) {
+                    ringL.MarkRate(seg.rate);
+                    ringR.MarkRate(seg.rate);
+                    marked = true;
+                }
+                for (ByteRingBuffer* ring : { &ringL, &ringR }) {
+                    ring->MarkAudible(count * sizeof(float));
+                    ring->Push(block.data(), count * sizeof(float));
+                }
+                pos += count;
+            }
+        }
+        done = true;
+    }
+};
+
+// 출력 샘플 0 기준 1 kHz 위상 (창 길이는 주기의 정수 배)
+static double PhaseAt(const std::vector<float>& mono, size_t from, size_t count) {
+    double w = 2.0 * PI * TONE_HZ / OUT_RATE;
+    double s = 0.0, c = 0.0;
+    for (size_t j = from; j < from + count; j++) {
+        s += mono[j] * std::sin(w * j);
+        c += mono[j] * std::cos(w * j);
+    }
+    return std::atan2(c, s);
+}
+
+static double Wrap(double phase) {
+    while (phase > PI) phase -= 2.0 * PI;
+    while (phase < -PI) phase += 2.0 * PI;
+    return phase;
+}
+
+static void TestRateSwitch() {
+    printf("Rate switch 48k -> 44.1k -> 96k -> 48k\n");
+    const std::vector<Segment> segments = { { 48000.0, 0.5 }, { 44100.0, 0.5 }, { 96000.0, 0.5 }, { 48000.0, 0.7 } };
+    double total = 0.0;
+    for (const Segment& seg : segments) total += seg.seconds;
+
+    auto owned = std::make_unique<FakeSink>();
+    FakeSink* sink = owned.get();
+    CRenderEngine engine;
+    engine.SetSink(std::move(owned));
+    sink->StartCapture((size_t)(OUT_RATE * (total + 1.0)));
+
+    ByteRingBuffer ringL(1 << 18), ringR(1 << 18);
+    Producer producer{ ringL, ringR, segments };
+    engine.Start(&ringL, &ringR, L"", ASIOSTFloat32LSB, segments[0].rate, (size_t)(segments[0].rate * THRESHOLD_SEC) * sizeof(float));
+    std::thread thread(&Producer::Run, &producer);
+    thread.join();
+    // 생산이 끝난 시점까지의 통계 (이후 링이 비면서 생기는 끊김은 제외)
+    RenderEngineStats stats = engine.GetStats();
+    engine.Stop();
+    engine.Close();
+    std::vector<float> out = sink->StopCapture();
+
+    printf("  rate changes %u, glitches %llu, input rate %.0f Hz\n", stats.rateChanges, (unsigned long long)stats.glitches, stats.inputRate);
+    CHECK(stats.rateChanges == segments.size() - 1, "%u rate changes applied, expected %zu", stats.rateChanges, segments.size() - 1);
+    CHECK(stats.glitches == 0, "%llu glitches (underrun/rebuffer) across the switches", (unsigned long long)stats.glitches);
+    CHECK(stats.inputRate == segments.back().rate, "input rate %.0f at the end", stats.inputRate);
+
+    std::vector<float> mono(out.size() / 2);
+    for (size_t j = 0; j < mono.size(); j++) mono[j] = out[j * 2];
+    // 첫 출력 샘플 (페이드 인 시작) = 입력 시각 0. 리미터는 꺼져 있어 추가 지연 없음
+    size_t start = 0;
+    while (start < mono.size() && mono[start] == 0.0f) start++;
+    start = start > 0 ? start - 1 : 0;
+    CHECK(start + (size_t)(OUT_RATE * (total - LEAD_SEC)) < mono.size(), "only %zu output frames captured", mono.size());
+    if (start + (size_t)(OUT_RATE * (total - LEAD_SEC)) >= mono.size()) return;
+
+    size_t window = (size_t)std::lround(WINDOW_SEC * OUT_RATE);
+    size_t guard = (size_t)std::lround(GUARD_SEC * OUT_RATE);
+    double boundary = 0.0;
+    for (size_t s = 0; s < segments.size(); s++) {
+        const Segment& seg = segments[s];
+        size_t segStart = start + (size_t)std::lround(boundary * OUT_RATE);
+        double segSeconds = (s + 1 == segments.size()) ? seg.seconds - LEAD_SEC : seg.seconds;
+        size_t segEnd = start + (size_t)std::lround((boundary + segSeconds) * OUT_RATE);
+
+        // 피치: 구간 안쪽 두 창의 위상 차 / 간격
+        size_t a = segStart + guard + window;
+        size_t b = segEnd - guard - window * 2;
+        double drift = Wrap(PhaseAt(mono, b, window) - PhaseAt(mono, a, window));
+        double pitch = TONE_HZ + drift / (2.0 * PI) * OUT_RATE / (double)(b - a);
+        // 끊김 (경계의 크로스페이드 포함): 클릭 = 톤의 최대 기울기를 넘는 샘플 간 점프, 탈락 = 1 ms 가 거의 무음
+        double maxStep = 0.0, minRms = 1e9, maxRms = 0.0;
+        size_t from = (s == 0) ? segStart + guard : segStart - guard;
+        for (size_t j = from; j + 48 <= segEnd - guard; j += 48) {
+            double sum = 0.0;
+            for (size_t k = 0; k < 48; k++) {
+                sum += (double)mono[j + k] * mono[j + k];
+                maxStep = std::max(maxStep, (double)std::abs(mono[j + k + 1] - mono[j + k]));
+            }
+            double rms = std::sqrt(sum / 48.0);
+            minRms = std::min(minRms, rms);
+            maxRms = std::max(maxRms, rms);
+        }
+        double nominal = TONE_AMP / std::sqrt(2.0);
+        double slope = 2.0 * PI * TONE_HZ / OUT_RATE * TONE_AMP;
+        printf("  %5.1f kHz: pitch %8.3f Hz, max step %.4f (tone %.4f), 1 ms RMS %.3f..%.3f (nominal %.3f)\n",
+            seg.rate / 1000.0, pitch, maxStep, slope, minRms, maxRms, nominal);
+        CHECK(std::abs(pitch - TONE_HZ) < 0.5, "%.1f kHz segment pitch %.3f Hz", seg.rate / 1000.0, pitch);
+        CHECK(maxStep < slope * 1.25, "%.1f kHz segment click: step %.4f, tone slope %.4f", seg.rate / 1000.0, maxStep, slope);
+        // 크로스페이드는 역방향 꼬리와 섞으므로 1 ms 동안 톤이 약해질 수 있음 (탈락/과증폭만 실패)
+        CHECK(minRms > nominal * 0.25 && maxRms < nominal * 1.25, "%.1f kHz segment level %.3f..%.3f", seg.rate / 1000.0, minRms, maxRms);
+
+        // 비율 전환 지점: 경계 앞뒤 창의 위상이 이어지는지
+        if (s > 0) {
+            double oldRate = segments[s - 1].rate;
+            double before = PhaseAt(mono, segStart - guard - window, window);
+            double after = PhaseAt(mono, segStart + guard, window);
+            double shiftSec = Wrap(after - before) / (2.0 * PI * TONE_HZ);
+            // d 프레임 늦게/일찍 바뀌면 d 프레임이 다른 레이트로 재생됨: 시간 어긋남 = d * |1/old - 1/new|
+            double frames = std::abs(shiftSec) / std::abs(1.0 / oldRate - 1.0 / seg.rate);
+            printf("    switch from %.1f kHz: phase shift %+.4f rad = %.2f input frames off the mark\n", oldRate / 1000.0, Wrap(after - before), frames);
+            // 전환 시 리샘플러 읽기 위치의 소수 부분은 새 레이트 프레임으로 넘어감 (최대 출력 한 샘플 = 입력 2 프레임)
+            CHECK(frames <= 2.0, "switch to %.1f kHz landed %.2f input frames off the mark", seg.rate / 1000.0, frames);
+        }
+        boundary += seg.seconds;
+    }
+}
+
+int main() {
+    TestRateSwitch();
+    uint64_t violations = RT_CHECK_REPORT();
+    CHECK(violations == 0, "%llu real-time violations in the render period", (unsigned long long)violations);
+    printf(g_failures ? "FAILED (%d)\n" : "PASSED\n", g_failures);
+    return g_failures ? 1 : 0;
+}
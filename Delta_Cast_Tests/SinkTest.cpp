@@ -0,0 +1,420 @@
+﻿// ---------------------------------------------------------------------------
+// 출력 싱크 테스트 (Null / File / 싱크 클럭 구동)
+// 렌더 엔진과 같은 순서로 싱크를 돌림: WaitForPeriod -> GetBuffer -> (주기 수신자) -> ReleaseBuffer
+// - NullSink: 실시간 속도로 소비하는지 (경과 시간 * 레이트 + 장치 버퍼 절반)
+// - FileSink: 쓴 샘플과 헤더 크기가 파일에 그대로 남는지
+// - 싱크 클럭: 주기마다 필요한 만큼만 호스트 블록을 만들 때 끊김이 없고 링 점유가 한 블록 미만인지
+// - 렌더 엔진 복구 (FakeSink 주입): 소실 후 재연결 간격이 50 ms -> 2 s 백오프를 따르는지,
+//   지정 장치가 3 번 실패하면 기본 장치로 대체하는지, Recovering 중에도 링 읽기 위치가 실시간으로 진행하는지
+// - 웜 스타트: 열린 엔진의 Start/Stop/Start 가 싱크를 다시 열지 않고 첫 오디오를 싱크 주기 하나 안에 내보내는지
+// - 임계값 연속 변경: 명령 큐 용량보다 많이 바꿔도 마지막 값이 적용되는지
+//
+// 실시간 경로 검사 빌드 (DELTA_RT_CHECK): 렌더 주기 안의 할당/잠금도 실패로 셈
+//
+// Linux: g++ -O2 -std=c++20 -mavx2 -mfma -pthread -I../Delta_Cast -include AsioTypes.h SinkTest.cpp ../Delta_Cast/RenderEngine.cpp ../Delta_Cast/Logger.cpp ../Delta_Cast/AudioArena.cpp ../Delta_Cast/ThreadPlacement.cpp -o sink_test
+// 검사 빌드: 위 명령에 -DDELTA_RT_CHECK=1 -rdynamic ../Delta_Cast/RtCheck.cpp -ldl 추가
+// ---------------------------------------------------------------------------
+#include "OutputSink.h"
+#include "FileSink.h"
+#include "RingBuffer.h"
+#include "RenderEngine.h"
+#include "FakeSink.h"
+#include "RtCheck.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static int g_failures = 0;
+#define CHECK(cond, ...) do { if (!(cond)) { g_failures++; printf("  FAIL line %d: ", __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+// 싱크 클럭 호스트 (VirtualBackend::OnRenderPeriod 와 같은 규칙)
+// 링이 이번 주기 요구량을 채울 때까지 호스트 블록을 만듦
+struct SinkClockedHost {
+    static const int MAX_BLOCKS_PER_PERIOD = 16;
+    ByteRingBuffer ring{ 65536 };
+    std::vector<float> block;
+    uint64_t blocks = 0;
+
+    explicit SinkClockedHost(size_t blockFrames) : block(blockFrames) {}
+
+    void OnRenderPeriod(size_t bytesNeeded) {
+        for (int i = 0; i < MAX_BLOCKS_PER_PERIOD; i++) {
+            if (ring.GetFillSize() >= bytesNeeded) break;
+            for (size_t n = 0; n < block.size(); n++) block[n] = (float)((blocks * block.size() + n) % 1000) * 0.001f;
+            ring.Push(block.data(), block.size() * sizeof(float));
+            blocks++;
+        }
+    }
+};
+
+struct PeriodStats {
+    uint64_t periods = 0;
+    uint64_t frames = 0;
+    uint64_t underruns = 0;
+    size_t maxLeftoverBytes = 0;    // 주기 처리 후 링에 남은 양
+    double seconds = 0.0;
+};
+
+// 렌더 스레드 루프 축약판. host 가 있으면 싱크 클럭 모드
+static PeriodStats RunSink(IOutputSink& sink, double seconds, SinkClockedHost* host, uint64_t sampleBase = 0) {
+    PeriodStats stats;
+    std::vector<float> mono;
+    auto start = Clock::now();
+    while (std::chrono::duration<double>(Clock::now() - start).count() < seconds) {
+        if (sink.WaitForPeriod(200) != SinkStatus::Ok) continue;
+        uint32_t frames = 0;
+        uint8_t* data = nullptr;
+        if (sink.GetBuffer(frames, data) != SinkStatus::Ok || frames == 0) continue;
+        float* out = reinterpret_cast<float*>(data);
+        if (host) {
+            size_t bytes = (size_t)frames * sizeof(float);
+            host->OnRenderPeriod(bytes);
+            mono.resize(frames);
+            if (host->ring.Pop(mono.data(), bytes) < bytes) stats.underruns++;
+            stats.maxLeftoverBytes = std::max(stats.maxLeftoverBytes, host->ring.GetFillSize());
+            for (uint32_t i = 0; i < frames; i++) { out[i * 2] = mono[i]; out[i * 2 + 1] = mono[i]; }
+        }
+        else {
+            // 위치를 알 수 있는 램프 (파일 검증용)
+            for (uint32_t i = 0; i < frames; i++) {
+                uint64_t n = sampleBase + stats.frames + i;
+                out[i * 2] = (float)(n % 4096) / 4096.0f;
+                out[i * 2 + 1] = -(float)(n % 4096) / 4096.0f;
+            }
+        }
+        sink.ReleaseBuffer(frames);
+        stats.frames += frames;
+        stats.periods++;
+    }
+    stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return stats;
+}
+
+static uint32_t Get32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t Get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+static void TestNullSinkPacing() {
+    printf("NullSink pacing\n");
+    NullSink sink;
+    SinkFormat format;
+    CHECK(sink.Open(L"", 44100.0, format), "open");
+    CHECK(format.sampleRate == 44100.0 && format.channels == 2 && format.isFloat, "format %.0f Hz %d ch", format.sampleRate, format.channels);
+    CHECK(sink.Start(), "start");
+    PeriodStats stats = RunSink(sink, 1.0, nullptr);
+    sink.Close();
+
+    // 장치처럼 버퍼 절반을 선행 유지하므로 소비량 = 경과 * 레이트 + 버퍼 절반 (주기 하나 오차)
+    double expected = stats.seconds * format.sampleRate + format.bufferFrames / 2;
+    double error = (double)stats.frames - expected;
+    printf("  %llu periods, %llu frames in %.3f s (expected %.0f, error %+.0f)\n",
+        (unsigned long long)stats.periods, (unsigned long long)stats.frames, stats.seconds, expected, error);
+    CHECK(std::abs(error) <= format.bufferFrames, "consumed %llu frames, expected %.0f", (unsigned long long)stats.frames, expected);
+}
+
+static void TestFileSinkContents() {
+    printf("FileSink contents\n");
+    fs::path path = fs::temp_directory_path() / "delta_sink_test.wav";
+    uint64_t frames = 0;
+    SinkFormat format;
+    {
+        FileSink sink(path.wstring());
+        CHECK(sink.Open(L"", 48000.0, format), "open %s", path.string().c_str());
+        sink.Start();
+        frames = RunSink(sink, 0.3, nullptr).frames;
+        sink.Close();
+    }
+
+    FILE* f = fopen(path.string().c_str(), "rb");
+    CHECK(f != nullptr, "reopen");
+    if (!f) return;
+    std::vector<uint8_t> file;
+    uint8_t chunk[65536];
+    for (size_t n; (n = fread(chunk, 1, sizeof(chunk), f)) > 0;) file.insert(file.end(), chunk, chunk + n);
+    fclose(f);
+    fs::remove(path);
+
+    CHECK(file.size() >= 12 && memcmp(file.data(), "RIFF", 4) == 0 && memcmp(file.data() + 8, "WAVE", 4) == 0, "RIFF/WAVE");
+    CHECK(file.size() >= 12 && Get32(file.data() + 4) == file.size() - 8, "RIFF size %u, file %zu", Get32(file.data() + 4), file.size());
+    const uint8_t* fmt = nullptr;
+    const uint8_t* data = nullptr;
+    uint32_t dataBytes = 0;
+    for (size_t pos = 12; pos + 8 <= file.size();) {
+        uint32_t size = Get32(&file[pos + 4]);
+        if (memcmp(&file[pos], "fmt ", 4) == 0) fmt = &file[pos + 8];
+        if (memcmp(&file[pos], "data", 4) == 0) { data = &file[pos + 8]; dataBytes = size; break; }
+        pos += 8 + ((size + 1) & ~1u);
+    }
+    CHECK(fmt && Get16(fmt) == 3 && Get16(fmt + 2) == 2 && Get32(fmt + 4) == 48000, "fmt float32 stereo 48000");
+    CHECK(data && dataBytes == frames * 2 * sizeof(float), "data %u bytes, wrote %llu frames", dataBytes, (unsigned long long)frames);
+    if (!data || data + dataBytes > file.data() + file.size()) return;
+
+    size_t mismatches = 0;
+    const float* samples = reinterpret_cast<const float*>(data);
+    for (uint64_t n = 0; n < frames; n++) {
+        float expect = (float)(n % 4096) / 4096.0f;
+        if (samples[n * 2] != expect || samples[n * 2 + 1] != -expect) mismatches++;
+    }
+    printf("  %llu frames, %zu mismatched\n", (unsigned long long)frames, mismatches);
+    CHECK(mismatches == 0, "%zu mismatched frames", mismatches);
+}
+
+static void TestSinkClocked(size_t blockFrames) {
+    printf("Sink clocked, host block %zu\n", blockFrames);
+    NullSink sink;
+    SinkFormat format;
+    sink.Open(L"", 48000.0, format);
+    sink.Start();
+    SinkClockedHost host(blockFrames);
+    PeriodStats stats = RunSink(sink, 1.0, &host);
+    sink.Close();
+
+    // 사전 버퍼 임계값 없이 주기마다 필요한 만큼만: 남는 양은 한 블록 미만
+    size_t blockBytes = blockFrames * sizeof(float);
+    printf("  %llu periods, %llu host blocks, %llu underruns, max leftover %zu bytes (%.2f ms)\n",
+        (unsigned long long)stats.periods, (unsigned long long)host.blocks, (unsigned long long)stats.underruns,
+        stats.maxLeftoverBytes, stats.maxLeftoverBytes / sizeof(float) * 1000.0 / format.sampleRate);
+    CHECK(stats.underruns == 0, "%llu underruns", (unsigned long long)stats.underruns);
+    CHECK(stats.maxLeftoverBytes < blockBytes, "leftover %zu >= block %zu", stats.maxLeftoverBytes, blockBytes);
+    CHECK(host.blocks * blockFrames >= stats.frames && host.blocks * blockFrames < stats.frames + blockFrames,
+        "host produced %llu frames for %llu consumed", (unsigned long long)(host.blocks * blockFrames), (unsigned long long)stats.frames);
+}
+
+// 조건이 참이 될 때까지 폴링 (시간 초과면 false)
+template <typename Fn>
+static bool WaitUntil(Fn done, double seconds) {
+    auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    while (!done()) {
+        if (Clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+static double MsBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+// 엔진 + 주입용 싱크 (엔진이 소유, 테스트는 포인터로 조작)
+struct FakeEngine {
+    CRenderEngine engine;
+    FakeSink* sink = nullptr;
+
+    FakeEngine() {
+        auto owned = std::make_unique<FakeSink>();
+        sink = owned.get();
+        engine.SetSink(std::move(owned));
+    }
+    bool WaitRunning(double seconds) {
+        uint64_t periods = sink->GetPeriods();
+        return WaitUntil([&] { return engine.GetState() == RenderState::Running && sink->GetPeriods() >= periods + 3; }, seconds);
+    }
+};
+
+static void TestEngineBackoff() {
+    printf("Engine reconnect backoff\n");
+    const int failures = 7;     // 마지막 간격이 2 s 상한에 걸리도록
+    FakeEngine fake;
+    fake.engine.Open(L"");
+    CHECK(fake.WaitRunning(2.0), "engine not running");
+
+    fake.sink->FailOpens(L"", failures);
+    fake.sink->InjectLoss();
+    CHECK(WaitUntil([&] { return fake.engine.GetStats().reconnects == 1; }, 10.0), "no reconnect");
+    RenderEngineStats stats = fake.engine.GetStats();
+    std::vector<FakeSink::OpenCall> opens = fake.sink->GetOpenCalls();
+    Clock::time_point lostAt = fake.sink->GetLostAt();
+    fake.engine.Close();
+
+    // 소실 -> 첫 시도는 최소 간격, 이후 실패마다 두 배 (상한 BACKOFF_MAX_MS)
+    // 재시도는 Recovering 틱에서 확인하므로 틱 하나 + 스케줄링 여유만큼 늦을 수 있음
+    const double lateMs = CRenderEngine::RECOVERY_TICK_MS + 15.0;
+    CHECK(opens.size() == (size_t)failures + 2, "%zu open calls, expected %d", opens.size(), failures + 2);
+    double expected = CRenderEngine::BACKOFF_MIN_MS;
+    double totalMs = 0.0;
+    Clock::time_point previous = lostAt;
+    for (size_t n = 1; n < opens.size(); n++) {
+        double gap = MsBetween(previous, opens[n].at);
+        printf("  attempt %zu after %7.1f ms (schedule %6.0f)%s\n", n, gap, expected, opens[n].ok ? " ok" : "");
+        CHECK(gap >= expected - 1.0 && gap <= expected + lateMs, "attempt %zu after %.1f ms, schedule %.0f ms", n, gap, expected);
+        CHECK(opens[n].deviceId.empty(), "attempt %zu not on the default device", n);
+        CHECK(opens[n].ok == (n == opens.size() - 1), "attempt %zu result", n);
+        totalMs += expected;
+        if (n > 1) expected = std::min(expected * 2.0, CRenderEngine::BACKOFF_MAX_MS);
+        previous = opens[n].at;
+    }
+    CHECK(expected == CRenderEngine::BACKOFF_MAX_MS, "schedule never reached the %.0f ms cap", CRenderEngine::BACKOFF_MAX_MS);
+
+    // 재연결 시간 = 일정 합계 + 첫 주기 (시도마다 틱 하나까지 늦음)
+    double upper = totalMs + (failures + 1) * lateMs + PacedSink::PERIOD_SEC * 1000.0 * 2;
+    printf("  reconnected in %.1f ms (schedule %.0f ms)\n", stats.lastReconnectMs, totalMs);
+    CHECK(stats.lastReconnectMs >= totalMs && stats.lastReconnectMs <= upper, "reconnect %.1f ms, expected %.0f..%.0f", stats.lastReconnectMs, totalMs, upper);
+    CHECK(stats.glitches == 0, "%llu glitches while not playing", (unsigned long long)stats.glitches);
+}
+
+static void TestEngineFallback() {
+    printf("Engine default device fallback\n");
+    FakeEngine fake;
+    fake.sink->FailOpens(L"usb", FakeSink::FAIL_ALWAYS);
+    fake.engine.Open(L"usb");
+    CHECK(fake.WaitRunning(3.0), "engine not running on the fallback");
+    RenderEngineStats stats = fake.engine.GetStats();
+    std::vector<FakeSink::OpenCall> opens = fake.sink->GetOpenCalls();
+    fake.engine.Close();
+
+    // 지정 장치 FALLBACK_AFTER_ATTEMPTS 번 실패 -> 기본 장치 성공
+    const size_t named = CRenderEngine::FALLBACK_AFTER_ATTEMPTS;
+    for (size_t n = 0; n < opens.size(); n++) printf("  open %zu: \"%ls\" %s\n", n, opens[n].deviceId.c_str(), opens[n].ok ? "ok" : "failed");
+    CHECK(opens.size() == named + 1, "%zu open calls, expected %zu", opens.size(), named + 1);
+    for (size_t n = 0; n < opens.size() && n < named; n++) {
+        CHECK(opens[n].deviceId == L"usb" && !opens[n].ok, "attempt %zu should fail on the named device", n);
+    }
+    CHECK(!opens.empty() && opens.back().deviceId.empty() && opens.back().ok, "last attempt should open the default device");
+    CHECK(stats.usingFallback, "fallback not reported");
+}
+
+static void TestEngineRecoveringAdvancesRing() {
+    printf("Engine ring advance while recovering\n");
+    const double rate = 48000.0;
+    const size_t frameBytes = sizeof(float);
+    const size_t threshold = (size_t)rate * frameBytes;        // 1 s
+    ByteRingBuffer ringL(1 << 21), ringR(1 << 21);
+    std::vector<float> prefill((size_t)rate * 2, 0.25f);      // 2 s
+    for (ByteRingBuffer* ring : { &ringL, &ringR }) {
+        ring->MarkAudible(prefill.size() * frameBytes);
+        ring->Push(prefill.data(), prefill.size() * frameBytes);
+    }
+
+    FakeEngine fake;
+    fake.sink->FailOpens(L"", FakeSink::FAIL_ALWAYS);
+    fake.engine.Open(L"");
+    fake.engine.Start(&ringL, &ringR, L"", ASIOSTFloat32LSB, rate, threshold);
+
+    // 첫 틱에 임계값 초과분을 버림
+    bool trimmed = WaitUntil([&] { return ringL.GetFillSize() <= threshold; }, 0.5);
+    CHECK(trimmed, "fill %zu above threshold %zu", ringL.GetFillSize(), threshold);
+
+    Clock::time_point t0 = Clock::now();
+    size_t read0 = ringL.GetReadIndex();
+    bool running = false;
+    while (MsBetween(t0, Clock::now()) < 400.0) {
+        running |= fake.engine.GetState() == RenderState::Running;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    Clock::time_point t1 = Clock::now();
+    size_t read1 = ringL.GetReadIndex();
+    size_t readR = ringR.GetReadIndex();
+    fake.engine.Stop();
+    fake.engine.Close();
+
+    double expected = std::chrono::duration<double>(t1 - t0).count() * rate * frameBytes;
+    double advanced = (double)(read1 - read0);
+    printf("  read advanced %.0f bytes in %.0f ms (expected %.0f, %.2fx)\n", advanced, MsBetween(t0, t1), expected, advanced / expected);
+    CHECK(!running, "sink should never open");
+    // 소비는 틱 단위 (RECOVERY_TICK_MS) 로 진행하므로 구간 양끝에서 틱 하나씩 어긋날 수 있음
+    double slack = 2.0 * CRenderEngine::RECOVERY_TICK_MS * 0.001 * rate * frameBytes;
+    CHECK(std::abs(advanced - expected) <= slack + expected * 0.05, "advanced %.0f bytes, expected %.0f", advanced, expected);
+    CHECK(readR == read1, "R read %zu != L read %zu", readR, read1);
+}
+
+// 임계값을 넘는 유음 (1 kHz) 을 미리 채움
+static void PrefillTone(ByteRingBuffer& ringL, ByteRingBuffer& ringR, double rate, double seconds) {
+    std::vector<float> tone((size_t)(rate * seconds));
+    for (size_t n = 0; n < tone.size(); n++) tone[n] = 0.5f * (float)std::sin(2.0 * 3.14159265358979 * 1000.0 * n / rate);
+    for (ByteRingBuffer* ring : { &ringL, &ringR }) {
+        ring->MarkAudible(tone.size() * sizeof(float));
+        ring->Push(tone.data(), tone.size() * sizeof(float));
+    }
+}
+
+static void TestEngineWarmStart() {
+    printf("Engine warm start\n");
+    const double rate = 48000.0;
+    const double periodMs = PacedSink::PERIOD_SEC * 1000.0;
+    const double scheduleMs = 2.0;      // 렌더 스레드 깨어남 여유
+    const size_t threshold = (size_t)(rate * 0.02) * sizeof(float);
+    FakeEngine fake;
+    fake.engine.Open(L"");
+    CHECK(fake.WaitRunning(2.0), "engine not running");
+
+    for (int round = 0; round < 2; round++) {
+        ByteRingBuffer ringL(1 << 18), ringR(1 << 18);
+        PrefillTone(ringL, ringR, rate, 0.2);
+        fake.sink->ResetAudible();
+        Clock::time_point startAt = Clock::now();
+        fake.engine.Start(&ringL, &ringR, L"", ASIOSTFloat32LSB, rate, threshold);
+        bool audible = WaitUntil([&] { return fake.sink->GetFirstAudibleAt() != Clock::time_point(); }, 1.0);
+        RenderEngineStats stats = fake.engine.GetStats();
+        fake.engine.Stop();
+
+        // 열린 싱크를 그대로 사용 (열기/Start 는 Open 때 한 번뿐)
+        double firstMs = MsBetween(startAt, fake.sink->GetFirstAudibleAt());
+        printf("  start %d: first audio after %.2f ms (engine %.2f ms), opens %zu, sink starts %d\n", round + 1,
+            audible ? firstMs : -1.0, stats.firstAudioMs, fake.sink->GetOpenCalls().size(), fake.sink->GetStartCount());
+        CHECK(audible, "start %d: no audio", round + 1);
+        CHECK(stats.warmStart, "start %d: not reported as warm", round + 1);
+        CHECK(fake.sink->GetOpenCalls().size() == 1 && fake.sink->GetStartCount() == 1, "start %d: sink reopened (%zu opens, %d starts)",
+            round + 1, fake.sink->GetOpenCalls().size(), fake.sink->GetStartCount());
+        CHECK(firstMs <= periodMs + scheduleMs, "start %d: first audio after %.2f ms, sink period %.0f ms", round + 1, firstMs, periodMs);
+        CHECK(stats.firstAudioMs > 0.0 && stats.firstAudioMs <= periodMs + scheduleMs, "start %d: engine first audio %.2f ms", round + 1, stats.firstAudioMs);
+    }
+    fake.engine.Close();
+
+    // 비교: 닫힌 엔진의 Start 는 싱크를 여는 콜드 스타트
+    FakeEngine cold;
+    ByteRingBuffer ringL(1 << 18), ringR(1 << 18);
+    PrefillTone(ringL, ringR, rate, 0.2);
+    cold.engine.Start(&ringL, &ringR, L"", ASIOSTFloat32LSB, rate, threshold);
+    CHECK(WaitUntil([&] { return cold.sink->GetFirstAudibleAt() != Clock::time_point(); }, 1.0), "cold start: no audio");
+    CHECK(!cold.engine.GetStats().warmStart, "cold start reported as warm");
+    cold.engine.Stop();
+    cold.engine.Close();
+}
+
+static void TestEngineThresholdBurst() {
+    printf("Engine threshold burst\n");
+    const double rate = 48000.0;
+    FakeEngine fake;
+    ByteRingBuffer ringL(1 << 18), ringR(1 << 18);
+    PrefillTone(ringL, ringR, rate, 0.2);
+    fake.engine.Start(&ringL, &ringR, L"", ASIOSTFloat32LSB, rate, 4800);
+    CHECK(fake.WaitRunning(2.0), "engine not running");
+
+    // 한 주기 안에 큐 용량의 몇 배를 보냄
+    const int changes = (int)ControlQueue::CAPACITY * 8;
+    size_t last = 0;
+    for (int n = 1; n <= changes; n++) {
+        last = 4800 + (size_t)n * 4;
+        fake.engine.SetThreshold(last);
+    }
+    bool applied = WaitUntil([&] { return fake.engine.GetThreshold() == last; }, 0.5);
+    printf("  %d changes, applied %zu (last %zu)\n", changes, fake.engine.GetThreshold(), last);
+    CHECK(applied, "threshold %zu, last requested %zu", fake.engine.GetThreshold(), last);
+    fake.engine.Stop();
+    fake.engine.Close();
+}
+
+int main() {
+    TestNullSinkPacing();
+    TestFileSinkContents();
+    TestSinkClocked(480);
+    TestSinkClocked(256);
+    TestSinkClocked(441);
+    TestEngineBackoff();
+    TestEngineFallback();
+    TestEngineRecoveringAdvancesRing();
+    TestEngineWarmStart();
+    TestEngineThresholdBurst();
+    uint64_t violations = RT_CHECK_REPORT();
+    CHECK(violations == 0, "%llu real-time violations in the render period", (unsigned long long)violations);
+    printf(g_failures ? "FAILED (%d)\n" : "PASSED\n", g_failures);
+    return g_failures ? 1 : 0;
+}